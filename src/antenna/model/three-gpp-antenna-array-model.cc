@@ -23,6 +23,7 @@
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
 #include "ns3/boolean.h"
+#include "ns3/hash.h"
 
 namespace ns3 {
 
@@ -34,6 +35,7 @@ ThreeGppAntennaArrayModel::ThreeGppAntennaArrayModel (void)
 {
   NS_LOG_FUNCTION (this);
   m_isOmniTx = false;
+  m_beamformingVectorHash = 0;
 }
 
 ThreeGppAntennaArrayModel::~ThreeGppAntennaArrayModel (void)
@@ -111,6 +113,8 @@ ThreeGppAntennaArrayModel::SetBeamformingVector (const ComplexVector &beamformin
   NS_LOG_FUNCTION (this);
   m_isOmniTx = false;
   m_beamformingVector = beamformingVector;
+  m_beamformingVectorHash = Hash64 (reinterpret_cast<const char *> (beamformingVector.data ()),
+                                    beamformingVector.size () * sizeof (std::complex<double>));
 }
 
 const ThreeGppAntennaArrayModel::ComplexVector &
@@ -120,6 +124,13 @@ ThreeGppAntennaArrayModel::GetBeamformingVector(void) const
   return m_beamformingVector;
 }
 
+uint64_t
+ThreeGppAntennaArrayModel::GetBeamformingVectorHash (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_beamformingVectorHash;
+}
+
 std::pair<double, double>
 ThreeGppAntennaArrayModel::GetElementFieldPattern (Angles a) const
 {
@@ -108,6 +108,14 @@ public:
    */
   const ComplexVector & GetBeamformingVector (void) const;
 
+  /**
+   * Returns a hash of the beamforming vector that is currently being used.
+   * The hash is computed once when the vector is set, and allows the users
+   * of the antenna to cheaply detect whether the beamforming vector changed.
+   * \return the hash of the current beamforming vector
+   */
+  uint64_t GetBeamformingVectorHash (void) const;
+
 private:
   /**
    * Returns the radiation power pattern of a single antenna element in dB,
@@ -120,6 +128,7 @@ private:
 
   bool m_isOmniTx; //!< true if the antenna is configured for omni transmissions
   ComplexVector m_beamformingVector; //!< the beamforming vector in use
+  uint64_t m_beamformingVectorHash; //!< the hash of the beamforming vector in use
   uint32_t m_numColumns; //!< number of columns
   uint32_t m_numRows; //!< number of rows
   double m_disV; //!< antenna spacing in the vertical direction in multiples of wave length
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-workload-helper.h"
+#include "ns3/flow-workload-application.h"
+#include "ns3/abort.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include <sstream>
+#include <iomanip>
+
+namespace ns3 {
+
+FlowWorkloadHelper::FlowWorkloadHelper (std::string protocol)
+{
+  m_factory.SetTypeId ("ns3::FlowWorkloadApplication");
+  m_factory.Set ("Protocol", StringValue (protocol));
+}
+
+void
+FlowWorkloadHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+void
+FlowWorkloadHelper::SetWorkload (std::string workload)
+{
+  // check the name now, the distributions are created by Install
+  FlowWorkloadApplication::GetWorkloadMeanFlowSize (workload);
+  m_workload = workload;
+}
+
+void
+FlowWorkloadHelper::SetLoad (std::string workload, double load, DataRate rate)
+{
+  NS_ABORT_MSG_IF (load <= 0, "The load must be positive");
+  SetWorkload (workload);
+  // mean time between two flows, so that load * rate bits are sent per second
+  double mean = FlowWorkloadApplication::GetWorkloadMeanFlowSize (workload) * 8
+    / (load * rate.GetBitRate ());
+  std::ostringstream oss;
+  oss << std::setprecision (17) << "ns3::ExponentialRandomVariable[Mean=" << mean << "]";
+  m_factory.Set ("FlowInterArrival", StringValue (oss.str ()));
+}
+
+void
+FlowWorkloadHelper::AddRemote (const Address &remote)
+{
+  m_remotes.push_back (remote);
+}
+
+ApplicationContainer
+FlowWorkloadHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      apps.Add (Install (*i));
+    }
+  return apps;
+}
+
+ApplicationContainer
+FlowWorkloadHelper::Install (Ptr<Node> node) const
+{
+  Ptr<FlowWorkloadApplication> app = m_factory.Create<FlowWorkloadApplication> ();
+  if (!m_workload.empty ())
+    {
+      app->SetAttribute ("FlowSize", PointerValue (FlowWorkloadApplication::GetWorkloadFlowSizes (m_workload)));
+    }
+  for (std::vector<Address>::const_iterator it = m_remotes.begin (); it != m_remotes.end (); ++it)
+    {
+      app->AddRemote (*it);
+    }
+  node->AddApplication (app);
+  return ApplicationContainer (app);
+}
+
+int64_t
+FlowWorkloadHelper::AssignStreams (NodeContainer c, int64_t stream)
+{
+  int64_t currentStream = stream;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNApplications (); j++)
+        {
+          Ptr<FlowWorkloadApplication> app = DynamicCast<FlowWorkloadApplication> (node->GetApplication (j));
+          if (app)
+            {
+              currentStream += app->AssignStreams (currentStream);
+            }
+        }
+    }
+  return (currentStream - stream);
+}
+
+} // namespace ns3
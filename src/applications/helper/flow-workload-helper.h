@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_WORKLOAD_HELPER_H
+#define FLOW_WORKLOAD_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/object-factory.h"
+#include "ns3/address.h"
+#include "ns3/attribute.h"
+#include "ns3/data-rate.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ * \brief A helper to make it easier to instantiate an
+ * ns3::FlowWorkloadApplication on a set of nodes.
+ */
+class FlowWorkloadHelper
+{
+public:
+  /**
+   * Create a FlowWorkloadHelper to make it easier to work with
+   * FlowWorkloadApplications.
+   *
+   * \param protocol the name of the protocol to use to send the flows
+   *        (e.g., ns3::TcpSocketFactory).
+   */
+  FlowWorkloadHelper (std::string protocol);
+
+  /**
+   * Helper function used to set the underlying application attributes.
+   *
+   * \param name the name of the application attribute to set
+   * \param value the value of the application attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Draw the flow sizes from a workload. This overrides the FlowSize
+   * attribute of the applications.
+   *
+   * \param workload "websearch" or "datamining"
+   */
+  void SetWorkload (std::string workload);
+
+  /**
+   * Draw the flow arrivals from a Poisson process, so that each node
+   * generates a given load of the workload on a link.
+   *
+   * \param workload "websearch" or "datamining"
+   * \param load the load, between 0 and 1
+   * \param rate the link rate
+   */
+  void SetLoad (std::string workload, double load, DataRate rate);
+
+  /**
+   * Add a remote address the flows can be sent to.
+   *
+   * \param remote the remote address (InetSocketAddress or Inet6SocketAddress)
+   */
+  void AddRemote (const Address &remote);
+
+  /**
+   * Install a FlowWorkloadApplication on each node of the input container.
+   *
+   * \param c NodeContainer of the set of nodes on which a
+   *          FlowWorkloadApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+
+  /**
+   * Install a FlowWorkloadApplication on the node.
+   *
+   * \param node The node on which a FlowWorkloadApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.  The Install() method should have previously been
+   * called by the user.
+   *
+   * \param stream first stream index to use
+   * \param c NodeContainer of the set of nodes for which the
+   *          FlowWorkloadApplication should be modified to use a fixed stream
+   * \return the number of stream indices assigned by this helper
+   */
+  int64_t AssignStreams (NodeContainer c, int64_t stream);
+
+private:
+  ObjectFactory m_factory;        //!< Object factory.
+  std::string m_workload;         //!< The workload of the flow sizes, if any.
+  std::vector<Address> m_remotes; //!< The remote addresses.
+};
+
+} // namespace ns3
+
+#endif /* FLOW_WORKLOAD_HELPER_H */
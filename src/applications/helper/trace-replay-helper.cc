@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "trace-replay-helper.h"
+#include "ns3/trace-replay-application.h"
+
+namespace ns3 {
+
+TraceReplayHelper::TraceReplayHelper (std::string filename)
+{
+  m_factory.SetTypeId (TraceReplayApplication::GetTypeId ());
+  m_trace = Create<TraceReplayFile> ();
+  m_trace->Open (filename);
+}
+
+void
+TraceReplayHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+Ptr<TraceReplayFile>
+TraceReplayHelper::GetTrace (void) const
+{
+  return m_trace;
+}
+
+ApplicationContainer
+TraceReplayHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      apps.Add (Install (*i));
+    }
+  return apps;
+}
+
+ApplicationContainer
+TraceReplayHelper::Install (Ptr<Node> node) const
+{
+  Ptr<TraceReplayApplication> app = m_factory.Create<TraceReplayApplication> ();
+  app->SetTrace (m_trace);
+  node->AddApplication (app);
+  return ApplicationContainer (app);
+}
+
+} // namespace ns3
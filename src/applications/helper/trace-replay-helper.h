@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_REPLAY_HELPER_H
+#define TRACE_REPLAY_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include "ns3/object-factory.h"
+#include "ns3/attribute.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/trace-replay-file.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ * \brief A helper to make it easier to instantiate an
+ * ns3::TraceReplayApplication on a set of nodes.
+ *
+ * The trace file is opened once, and shared by all the applications.
+ */
+class TraceReplayHelper
+{
+public:
+  /**
+   * Create a TraceReplayHelper to make it easier to work with
+   * TraceReplayApplications.
+   *
+   * \param filename the trace file, written by TraceReplayFile
+   */
+  TraceReplayHelper (std::string filename);
+
+  /**
+   * Helper function used to set the underlying application attributes.
+   *
+   * \param name the name of the application attribute to set
+   * \param value the value of the application attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \return the trace shared by the applications
+   */
+  Ptr<TraceReplayFile> GetTrace (void) const;
+
+  /**
+   * Install a TraceReplayApplication on each node of the input container.
+   *
+   * \param c NodeContainer of the set of nodes on which a
+   *          TraceReplayApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+
+  /**
+   * Install a TraceReplayApplication on the node.
+   *
+   * \param node The node on which a TraceReplayApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+private:
+  ObjectFactory m_factory;      //!< Object factory.
+  Ptr<TraceReplayFile> m_trace; //!< The trace.
+};
+
+} // namespace ns3
+
+#endif /* TRACE_REPLAY_HELPER_H */
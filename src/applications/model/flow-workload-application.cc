@@ -0,0 +1,420 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/tcp-socket-factory.h"
+#include "flow-workload-application.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowWorkloadApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (FlowWorkloadApplication);
+
+namespace {
+
+/**
+ * \brief A point of a flow size CDF.
+ */
+struct FlowSizeCdf
+{
+  double size; //!< flow size, in bytes
+  double cdf;  //!< probability of a smaller flow
+};
+
+/// Web search workload (DCTCP paper)
+const FlowSizeCdf g_websearch[] = {
+  { 0, 0 },
+  { 10000, 0.15 },
+  { 20000, 0.2 },
+  { 30000, 0.3 },
+  { 50000, 0.4 },
+  { 80000, 0.53 },
+  { 200000, 0.6 },
+  { 1000000, 0.7 },
+  { 2000000, 0.8 },
+  { 5000000, 0.9 },
+  { 10000000, 0.97 },
+  { 30000000, 1 }
+};
+
+/// Data mining workload (VL2 paper), in 1460 bytes packets
+const FlowSizeCdf g_datamining[] = {
+  { 1460, 0 },
+  { 1460, 0.5 },
+  { 2920, 0.6 },
+  { 4380, 0.7 },
+  { 10220, 0.8 },
+  { 389820, 0.9 },
+  { 3076220, 0.95 },
+  { 97333820, 0.99 },
+  { 973333820, 1 }
+};
+
+/**
+ * \brief Get the CDF of a workload.
+ * \param workload the workload name
+ * \param [out] n the number of points of the CDF
+ * \return the CDF
+ */
+const FlowSizeCdf *
+GetWorkloadCdf (std::string workload, uint32_t &n)
+{
+  if (workload == "websearch")
+    {
+      n = sizeof (g_websearch) / sizeof (g_websearch[0]);
+      return g_websearch;
+    }
+  if (workload == "datamining")
+    {
+      n = sizeof (g_datamining) / sizeof (g_datamining[0]);
+      return g_datamining;
+    }
+  NS_FATAL_ERROR ("Unknown workload " << workload);
+  return 0;
+}
+
+} // anonymous namespace
+
+TypeId
+FlowWorkloadApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FlowWorkloadApplication")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<FlowWorkloadApplication> ()
+    .AddAttribute ("Protocol", "The type of protocol to use.",
+                   TypeIdValue (TcpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&FlowWorkloadApplication::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("SendSize", "The amount of data to send each time.",
+                   UintegerValue (1448),
+                   MakeUintegerAccessor (&FlowWorkloadApplication::m_sendSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxFlows",
+                   "The number of flows to start. "
+                   "Once these flows are started, no flow is started again. "
+                   "The value zero means that there is no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FlowWorkloadApplication::m_maxFlows),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("FlowSize",
+                   "A RandomVariableStream used to pick the size of the flows, in bytes.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=100000]"),
+                   MakePointerAccessor (&FlowWorkloadApplication::m_sizeRv),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("FlowInterArrival",
+                   "A RandomVariableStream used to pick the time between two flow arrivals, in seconds.",
+                   StringValue ("ns3::ExponentialRandomVariable[Mean=0.001]"),
+                   MakePointerAccessor (&FlowWorkloadApplication::m_interArrivalRv),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddTraceSource ("FlowCompletion", "A flow is completed",
+                     MakeTraceSourceAccessor (&FlowWorkloadApplication::m_flowCompletionTrace),
+                     "ns3::FlowWorkloadApplication::FlowCompletionTracedCallback")
+  ;
+  return tid;
+}
+
+FlowWorkloadApplication::FlowWorkloadApplication ()
+  : m_startedFlows (0),
+    m_completedFlows (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_remoteRv = CreateObject<UniformRandomVariable> ();
+}
+
+FlowWorkloadApplication::~FlowWorkloadApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FlowWorkloadApplication::AddRemote (const Address &remote)
+{
+  NS_LOG_FUNCTION (this << remote);
+  NS_ABORT_MSG_IF (!InetSocketAddress::IsMatchingType (remote) && !Inet6SocketAddress::IsMatchingType (remote),
+                   "The remote addresses must be InetSocketAddress or Inet6SocketAddress");
+  m_remotes.push_back (remote);
+}
+
+uint32_t
+FlowWorkloadApplication::GetNActiveFlows (void) const
+{
+  return m_socketFlows.size ();
+}
+
+uint64_t
+FlowWorkloadApplication::GetNCompletedFlows (void) const
+{
+  return m_completedFlows;
+}
+
+int64_t
+FlowWorkloadApplication::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_sizeRv->SetStream (stream);
+  m_interArrivalRv->SetStream (stream + 1);
+  m_remoteRv->SetStream (stream + 2);
+  return 3;
+}
+
+Ptr<EmpiricalRandomVariable>
+FlowWorkloadApplication::GetWorkloadFlowSizes (std::string workload)
+{
+  uint32_t n;
+  const FlowSizeCdf *cdf = GetWorkloadCdf (workload, n);
+  Ptr<EmpiricalRandomVariable> sizes = CreateObject<EmpiricalRandomVariable> ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sizes->CDF (cdf[i].size, cdf[i].cdf);
+    }
+  sizes->SetInterpolate (true);
+  return sizes;
+}
+
+double
+FlowWorkloadApplication::GetWorkloadMeanFlowSize (std::string workload)
+{
+  uint32_t n;
+  const FlowSizeCdf *cdf = GetWorkloadCdf (workload, n);
+  // the sizes are interpolated linearly between the points of the CDF
+  double mean = cdf[0].size * cdf[0].cdf;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      mean += (cdf[i].cdf - cdf[i - 1].cdf) * (cdf[i].size + cdf[i - 1].size) / 2;
+    }
+  return mean;
+}
+
+void
+FlowWorkloadApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sizeRv = 0;
+  m_interArrivalRv = 0;
+  m_remoteRv = 0;
+  m_flowSocket.clear ();
+  m_socketFlows.clear ();
+  Application::DoDispose ();
+}
+
+void
+FlowWorkloadApplication::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // the flows are not sent to the node itself
+  Ptr<Ipv4> ipv4 = GetNode ()->GetObject<Ipv4> ();
+  Ptr<Ipv6> ipv6 = GetNode ()->GetObject<Ipv6> ();
+  m_remoteIndexes.clear ();
+  for (uint32_t i = 0; i < m_remotes.size (); i++)
+    {
+      if (InetSocketAddress::IsMatchingType (m_remotes[i]) && ipv4
+          && ipv4->GetInterfaceForAddress (InetSocketAddress::ConvertFrom (m_remotes[i]).GetIpv4 ()) != -1)
+        {
+          continue;
+        }
+      if (Inet6SocketAddress::IsMatchingType (m_remotes[i]) && ipv6
+          && ipv6->GetInterfaceForAddress (Inet6SocketAddress::ConvertFrom (m_remotes[i]).GetIpv6 ()) != -1)
+        {
+          continue;
+        }
+      m_remoteIndexes.push_back (i);
+    }
+  if (m_remoteIndexes.empty ())
+    {
+      NS_LOG_WARN ("No remote address to send flows to");
+      return;
+    }
+
+  m_arrivalEvent = Simulator::Schedule (Seconds (m_interArrivalRv->GetValue ()),
+                                        &FlowWorkloadApplication::StartFlow, this);
+}
+
+void
+FlowWorkloadApplication::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_arrivalEvent);
+  for (uint32_t flow = 0; flow < m_flowSocket.size (); flow++)
+    {
+      if (m_flowSocket[flow] != 0)
+        {
+          ReleaseFlow (flow);
+        }
+    }
+}
+
+void
+FlowWorkloadApplication::StartFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t flow;
+  if (m_freeFlows.empty ())
+    {
+      flow = m_flowSocket.size ();
+      m_flowSocket.push_back (0);
+      m_flowId.push_back (0);
+      m_flowRemote.push_back (0);
+      m_flowSize.push_back (0);
+      m_flowSent.push_back (0);
+      m_flowTxBuffer.push_back (0);
+      m_flowStart.push_back (Time ());
+    }
+  else
+    {
+      flow = m_freeFlows.back ();
+      m_freeFlows.pop_back ();
+    }
+
+  uint32_t remote = m_remoteIndexes[m_remoteRv->GetInteger (0, m_remoteIndexes.size () - 1)];
+  Ptr<Socket> socket = Socket::CreateSocket (GetNode (), m_tid);
+  int ret = InetSocketAddress::IsMatchingType (m_remotes[remote]) ? socket->Bind () : socket->Bind6 ();
+  if (ret == -1)
+    {
+      NS_FATAL_ERROR ("Failed to bind socket");
+    }
+  m_flowSocket[flow] = socket;
+  m_flowId[flow] = FlowIdTag::AllocateFlowId ();
+  m_flowRemote[flow] = remote;
+  m_flowSize[flow] = std::max (1.0, std::round (m_sizeRv->GetValue ()));
+  m_flowSent[flow] = 0;
+  m_flowTxBuffer[flow] = socket->GetTxAvailable ();
+  m_flowStart[flow] = Simulator::Now ();
+  m_socketFlows[PeekPointer (socket)] = flow;
+  NS_LOG_LOGIC ("Flow " << m_flowId[flow] << " of " << m_flowSize[flow] << " bytes to " << m_remotes[remote]);
+
+  socket->SetConnectCallback (MakeCallback (&FlowWorkloadApplication::ConnectionSucceeded, this),
+                              MakeCallback (&FlowWorkloadApplication::ConnectionFailed, this));
+  socket->SetSendCallback (MakeCallback (&FlowWorkloadApplication::DataSend, this));
+  socket->Connect (m_remotes[remote]);
+  socket->ShutdownRecv ();
+
+  m_startedFlows++;
+  if (m_maxFlows == 0 || m_startedFlows < m_maxFlows)
+    {
+      m_arrivalEvent = Simulator::Schedule (Seconds (m_interArrivalRv->GetValue ()),
+                                            &FlowWorkloadApplication::StartFlow, this);
+    }
+}
+
+void
+FlowWorkloadApplication::SendData (uint32_t flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  Ptr<Socket> socket = m_flowSocket[flow];
+  while (m_flowSent[flow] < m_flowSize[flow])
+    {
+      uint64_t toSend = std::min<uint64_t> (m_sendSize, m_flowSize[flow] - m_flowSent[flow]);
+      toSend = std::min<uint64_t> (toSend, socket->GetTxAvailable ());
+      if (toSend == 0)
+        {
+          // the DataSend callback is called when some space is freed
+          return;
+        }
+      Ptr<Packet> packet = Create<Packet> (toSend);
+      packet->AddPacketTag (FlowIdTag (m_flowId[flow]));
+      int actual = socket->Send (packet);
+      if (actual <= 0)
+        {
+          return;
+        }
+      m_flowSent[flow] += actual;
+    }
+  if (socket->GetTxAvailable () >= m_flowTxBuffer[flow])
+    {
+      CompleteFlow (flow);
+    }
+}
+
+void
+FlowWorkloadApplication::CompleteFlow (uint32_t flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  Time duration = Simulator::Now () - m_flowStart[flow];
+  NS_LOG_LOGIC ("Flow " << m_flowId[flow] << " completed in " << duration.As (Time::US));
+  m_completedFlows++;
+  m_flowCompletionTrace (m_flowId[flow], m_remotes[m_flowRemote[flow]], m_flowSize[flow], duration);
+  ReleaseFlow (flow);
+}
+
+void
+FlowWorkloadApplication::ReleaseFlow (uint32_t flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  // the callbacks of the socket are kept, as this may be called from one
+  // of them: they ignore the sockets which are not in m_socketFlows
+  Ptr<Socket> socket = m_flowSocket[flow];
+  socket->Close ();
+  m_socketFlows.erase (PeekPointer (socket));
+  m_flowSocket[flow] = 0;
+  m_freeFlows.push_back (flow);
+}
+
+void
+FlowWorkloadApplication::ConnectionSucceeded (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  std::unordered_map<Socket *, uint32_t>::const_iterator it = m_socketFlows.find (PeekPointer (socket));
+  if (it != m_socketFlows.end ())
+    {
+      SendData (it->second);
+    }
+}
+
+void
+FlowWorkloadApplication::ConnectionFailed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  std::unordered_map<Socket *, uint32_t>::const_iterator it = m_socketFlows.find (PeekPointer (socket));
+  if (it != m_socketFlows.end ())
+    {
+      NS_LOG_WARN ("Connection of flow " << m_flowId[it->second] << " failed");
+      ReleaseFlow (it->second);
+    }
+}
+
+void
+FlowWorkloadApplication::DataSend (Ptr<Socket> socket, uint32_t available)
+{
+  NS_LOG_FUNCTION (this << socket << available);
+  std::unordered_map<Socket *, uint32_t>::const_iterator it = m_socketFlows.find (PeekPointer (socket));
+  if (it != m_socketFlows.end () && m_flowSent[it->second] > 0)
+    {
+      SendData (it->second);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_WORKLOAD_APPLICATION_H
+#define FLOW_WORKLOAD_APPLICATION_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include <vector>
+#include <unordered_map>
+
+namespace ns3 {
+
+class Socket;
+class RandomVariableStream;
+class UniformRandomVariable;
+class EmpiricalRandomVariable;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Generate the flows of a workload from a single application per node.
+ *
+ * The application starts flows at the times drawn from the FlowInterArrival
+ * random variable, each one towards a remote address drawn uniformly among
+ * the remote addresses of the application (but the local ones), and sends
+ * the number of bytes drawn from the FlowSize random variable over a new
+ * socket of the Protocol type. A flow completes when all its bytes are
+ * acknowledged (i.e., when they left the socket transmission buffer), then
+ * its socket is closed, and the FlowCompletion trace source is fired.
+ *
+ * The flows are not objects: the state of the active flows is kept in
+ * arrays indexed by the flow slots, which are reused by the next flows,
+ * and there is a single pending event per application, the arrival of
+ * the next flow. A node can thus generate thousands of concurrent flows
+ * without the overhead of thousands of OnOffApplication or
+ * BulkSendApplication instances.
+ *
+ * The flow sizes of the websearch (DCTCP) and datamining (VL2) workloads
+ * are available with GetWorkloadFlowSizes.
+ */
+class FlowWorkloadApplication : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FlowWorkloadApplication ();
+  virtual ~FlowWorkloadApplication ();
+
+  /**
+   * \brief Add a remote address the flows can be sent to.
+   * \param remote the remote address (InetSocketAddress or Inet6SocketAddress)
+   */
+  void AddRemote (const Address &remote);
+
+  /**
+   * \return the number of flows in progress
+   */
+  uint32_t GetNActiveFlows (void) const;
+
+  /**
+   * \return the number of flows completed
+   */
+  uint64_t GetNCompletedFlows (void) const;
+
+  /**
+   * \brief Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \brief Get the flow size distribution of a workload.
+   * \param workload "websearch" or "datamining"
+   * \return the flow sizes, in bytes
+   */
+  static Ptr<EmpiricalRandomVariable> GetWorkloadFlowSizes (std::string workload);
+
+  /**
+   * \brief Get the mean flow size of a workload.
+   * \param workload "websearch" or "datamining"
+   * \return the mean flow size, in bytes
+   */
+  static double GetWorkloadMeanFlowSize (std::string workload);
+
+  /**
+   * TracedCallback signature for the flow completions.
+   *
+   * \param [in] flowId The flow identifier.
+   * \param [in] remote The remote address of the flow.
+   * \param [in] size The flow size, in bytes.
+   * \param [in] duration The flow completion time.
+   */
+  typedef void (* FlowCompletionTracedCallback)
+    (uint32_t flowId, const Address &remote, uint64_t size, Time duration);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief Start a flow, and schedule the arrival of the next one.
+   */
+  void StartFlow (void);
+
+  /**
+   * \brief Send as many bytes of a flow as the socket accepts.
+   * \param flow the flow slot
+   */
+  void SendData (uint32_t flow);
+
+  /**
+   * \brief Complete a flow, and release its slot.
+   * \param flow the flow slot
+   */
+  void CompleteFlow (uint32_t flow);
+
+  /**
+   * \brief Release the slot of a flow.
+   * \param flow the flow slot
+   */
+  void ReleaseFlow (uint32_t flow);
+
+  /**
+   * \brief Connection Succeeded (called by Socket through a callback)
+   * \param socket the connected socket
+   */
+  void ConnectionSucceeded (Ptr<Socket> socket);
+  /**
+   * \brief Connection Failed (called by Socket through a callback)
+   * \param socket the connected socket
+   */
+  void ConnectionFailed (Ptr<Socket> socket);
+  /**
+   * \brief Send more data as soon as some has been transmitted.
+   * \param socket the socket
+   * \param available the number of bytes available in the transmission buffer
+   */
+  void DataSend (Ptr<Socket> socket, uint32_t available);
+
+  TypeId m_tid;                          //!< the type of protocol to use
+  uint32_t m_sendSize;                   //!< the size of the data sent at once
+  uint64_t m_maxFlows;                   //!< the number of flows to start (0 for no limit)
+  Ptr<RandomVariableStream> m_sizeRv;    //!< the flow size
+  Ptr<RandomVariableStream> m_interArrivalRv; //!< the time between two flow arrivals
+  Ptr<UniformRandomVariable> m_remoteRv; //!< the choice of the remote address
+
+  std::vector<Address> m_remotes;        //!< the remote addresses
+  std::vector<uint32_t> m_remoteIndexes; //!< the remote addresses but the local ones
+  EventId m_arrivalEvent;                //!< the arrival of the next flow
+  uint64_t m_startedFlows;               //!< the number of flows started
+  uint64_t m_completedFlows;             //!< the number of flows completed
+
+  // the flows, indexed by slot
+  std::vector<Ptr<Socket> > m_flowSocket; //!< the socket of the flow
+  std::vector<uint32_t> m_flowId;        //!< the identifier of the flow
+  std::vector<uint32_t> m_flowRemote;    //!< the remote address of the flow
+  std::vector<uint64_t> m_flowSize;      //!< the size of the flow
+  std::vector<uint64_t> m_flowSent;      //!< the bytes of the flow given to the socket
+  std::vector<uint32_t> m_flowTxBuffer;  //!< the size of the empty transmission buffer
+  std::vector<Time> m_flowStart;         //!< the start time of the flow
+  std::vector<uint32_t> m_freeFlows;     //!< the unused slots
+  std::unordered_map<Socket *, uint32_t> m_socketFlows; //!< the slot of each socket
+
+  /// Traced Callback: completed flows.
+  TracedCallback<uint32_t, const Address &, uint64_t, Time> m_flowCompletionTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_WORKLOAD_APPLICATION_H */
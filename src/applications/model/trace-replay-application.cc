@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/ipv4.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/udp-socket-factory.h"
+#include "trace-replay-application.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceReplayApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceReplayApplication);
+
+TypeId
+TraceReplayApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceReplayApplication")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<TraceReplayApplication> ()
+    .AddAttribute ("RemotePort",
+                   "The destination port of the outbound packets",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&TraceReplayApplication::m_peerPort),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddTraceSource ("Tx", "A packet of the trace is sent",
+                     MakeTraceSourceAccessor (&TraceReplayApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+TraceReplayApplication::TraceReplayApplication ()
+  : m_peerPort (100),
+    m_sent (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TraceReplayApplication::~TraceReplayApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TraceReplayApplication::SetTrace (Ptr<TraceReplayFile> trace)
+{
+  NS_LOG_FUNCTION (this << trace);
+  m_trace = trace;
+}
+
+uint64_t
+TraceReplayApplication::GetSent (void) const
+{
+  return m_sent;
+}
+
+void
+TraceReplayApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_trace = 0;
+  m_sources.clear ();
+  Application::DoDispose ();
+}
+
+void
+TraceReplayApplication::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_trace == 0, "No trace to replay");
+  Ptr<Ipv4> ipv4 = GetNode ()->GetObject<Ipv4> ();
+  NS_ABORT_MSG_IF (ipv4 == 0, "TraceReplayApplication requires the IPv4 stack");
+
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  m_sources.clear ();
+  for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+    {
+      for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+        {
+          Ipv4Address address = ipv4->GetAddress (i, j).GetLocal ();
+          Source source;
+          m_trace->GetRecords (address, source.next, source.end);
+          while (source.next < source.end && m_trace->GetRecord (source.next).time < now)
+            {
+              source.next++;
+            }
+          if (source.next == source.end)
+            {
+              continue;
+            }
+          source.socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+          if (source.socket->Bind (InetSocketAddress (address, 0)) == -1)
+            {
+              NS_FATAL_ERROR ("Failed to bind socket");
+            }
+          NS_LOG_LOGIC ("Replaying " << source.end - source.next << " packets from " << address);
+          m_sources.push_back (source);
+        }
+    }
+  ScheduleNextBurst ();
+}
+
+void
+TraceReplayApplication::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sendEvent);
+  for (std::vector<Source>::iterator it = m_sources.begin (); it != m_sources.end (); it++)
+    {
+      it->socket->Close ();
+    }
+  m_sources.clear ();
+}
+
+void
+TraceReplayApplication::ScheduleNextBurst (void)
+{
+  NS_LOG_FUNCTION (this);
+  bool found = false;
+  int64_t next = 0;
+  for (std::vector<Source>::const_iterator it = m_sources.begin (); it != m_sources.end (); it++)
+    {
+      if (it->next < it->end && (!found || m_trace->GetRecord (it->next).time < next))
+        {
+          next = m_trace->GetRecord (it->next).time;
+          found = true;
+        }
+    }
+  if (found)
+    {
+      m_sendEvent = Simulator::Schedule (NanoSeconds (next) - Simulator::Now (),
+                                         &TraceReplayApplication::SendBurst, this);
+    }
+}
+
+void
+TraceReplayApplication::SendBurst (void)
+{
+  NS_LOG_FUNCTION (this);
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  for (std::vector<Source>::iterator it = m_sources.begin (); it != m_sources.end (); it++)
+    {
+      for (; it->next < it->end; it->next++)
+        {
+          const TraceReplayRecord &record = m_trace->GetRecord (it->next);
+          if (record.time > now)
+            {
+              break;
+            }
+          Ptr<Packet> packet = Create<Packet> (record.size);
+          packet->AddPacketTag (FlowIdTag (record.flowId));
+          m_txTrace (packet);
+          if (it->socket->SendTo (packet, 0, InetSocketAddress (Ipv4Address (record.dst), m_peerPort)) < 0)
+            {
+              NS_LOG_INFO ("Error while sending " << record.size << " bytes to " << Ipv4Address (record.dst));
+              continue;
+            }
+          m_sent++;
+        }
+    }
+  ScheduleNextBurst ();
+}
+
+} // namespace ns3
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_REPLAY_APPLICATION_H
+#define TRACE_REPLAY_APPLICATION_H
+
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include "trace-replay-file.h"
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Replay the packets of a TraceReplayFile sent by a node.
+ *
+ * A single application per node sends, over UDP, all the packets of the
+ * trace whose source is one of the IPv4 addresses of the node, at the
+ * time given by the trace, to the destination address of the packet and
+ * the RemotePort port, from a socket bound to the source address. The
+ * flows of the trace are not objects: the application walks the records
+ * of the node in the trace, and sends all the packets due at the same
+ * time from a single event. Each packet carries a FlowIdTag with the flow
+ * identifier of the trace.
+ *
+ * The trace times are absolute: the packets due before the start of the
+ * application are skipped.
+ */
+class TraceReplayApplication : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TraceReplayApplication ();
+  virtual ~TraceReplayApplication ();
+
+  /**
+   * \brief Set the trace to replay.
+   * \param trace the trace, which can be shared by several applications
+   */
+  void SetTrace (Ptr<TraceReplayFile> trace);
+
+  /**
+   * \return the number of packets sent
+   */
+  uint64_t GetSent (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief Send the packets due now, and schedule the next burst.
+   */
+  void SendBurst (void);
+
+  /**
+   * \brief Schedule the next burst, if any.
+   */
+  void ScheduleNextBurst (void);
+
+  /**
+   * \brief The records of an address of the node.
+   */
+  struct Source
+  {
+    Ptr<Socket> socket; //!< the socket, bound to the address
+    uint64_t next;      //!< the next record to send
+    uint64_t end;       //!< the end of the records of the address
+  };
+
+  Ptr<TraceReplayFile> m_trace;    //!< the trace
+  std::vector<Source> m_sources;   //!< the addresses of the node found in the trace
+  uint16_t m_peerPort;             //!< the destination port
+  uint64_t m_sent;                 //!< the number of packets sent
+  EventId m_sendEvent;             //!< the next burst
+
+  /// Traced Callback: transmitted packets.
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* TRACE_REPLAY_APPLICATION_H */
@@ -0,0 +1,404 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/nstime.h"
+#include "ns3/pcap-file.h"
+#include "ns3/trace-helper.h"
+#include "ns3/core-config.h"
+#include "trace-replay-file.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <cctype>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceReplayFile");
+
+namespace {
+
+/// Magic number of the trace files ("NS3R" in the byte order of the host)
+const uint32_t TRACE_REPLAY_MAGIC = 0x5233534e;
+/// Version of the trace file format
+const uint32_t TRACE_REPLAY_VERSION = 1;
+
+/**
+ * \ingroup applications
+ * \brief Header of the trace files.
+ */
+struct TraceReplayFileHeader
+{
+  uint32_t magic;    //!< TRACE_REPLAY_MAGIC
+  uint32_t version;  //!< TRACE_REPLAY_VERSION
+  uint64_t nRecords; //!< number of records following the header
+};
+
+/**
+ * \brief Sort the records by source address, then by time.
+ * \param a the first record
+ * \param b the second record
+ * \return true if a comes before b
+ */
+bool
+RecordLess (const TraceReplayRecord &a, const TraceReplayRecord &b)
+{
+  return a.src < b.src || (a.src == b.src && a.time < b.time);
+}
+
+/**
+ * \brief Read a big endian 16 bits integer.
+ * \param p the buffer
+ * \return the integer
+ */
+uint16_t
+ReadNtoh16 (const uint8_t *p)
+{
+  return (p[0] << 8) | p[1];
+}
+
+/**
+ * \brief Read a big endian 32 bits integer.
+ * \param p the buffer
+ * \return the integer
+ */
+uint32_t
+ReadNtoh32 (const uint8_t *p)
+{
+  return (uint32_t (p[0]) << 24) | (uint32_t (p[1]) << 16) | (uint32_t (p[2]) << 8) | p[3];
+}
+
+} // anonymous namespace
+
+TraceReplayFile::TraceReplayFile ()
+  : m_data (0),
+    m_dataSize (0),
+    m_mapped (false),
+    m_records (0),
+    m_nRecords (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TraceReplayFile::~TraceReplayFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+TraceReplayFile::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_filename = filename;
+
+#ifdef HAVE_SYS_MMAN_H
+  int fd = open (filename.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Can not open the trace file " << filename);
+  struct stat st;
+  if (fstat (fd, &st) == 0 && st.st_size > 0)
+    {
+      void *data = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED)
+        {
+          m_data = static_cast<const uint8_t *> (data);
+          m_dataSize = st.st_size;
+          m_mapped = true;
+        }
+    }
+  close (fd);
+#endif
+
+  if (!m_mapped)
+    {
+      std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary | std::ios::ate);
+      NS_ABORT_MSG_IF (!file.good (), "Can not open the trace file " << filename);
+      m_dataSize = file.tellg ();
+      file.seekg (0);
+      uint8_t *data = new uint8_t [m_dataSize];
+      file.read (reinterpret_cast<char *> (data), m_dataSize);
+      m_data = data;
+      NS_ABORT_MSG_IF (!file.good (), "Can not read the trace file " << filename);
+    }
+
+  TraceReplayFileHeader header;
+  NS_ABORT_MSG_IF (m_dataSize < sizeof (header), "Invalid trace file " << filename);
+  std::memcpy (&header, m_data, sizeof (header));
+  NS_ABORT_MSG_IF (header.magic != TRACE_REPLAY_MAGIC,
+                   "Invalid trace file " << filename << " (or written with another byte order)");
+  NS_ABORT_MSG_IF (header.version != TRACE_REPLAY_VERSION,
+                   "Unsupported version " << header.version << " of trace file " << filename);
+  // the number of records is checked first, so that their size does not overflow
+  NS_ABORT_MSG_IF (header.nRecords > (m_dataSize - sizeof (header)) / sizeof (TraceReplayRecord)
+                   || m_dataSize != sizeof (header) + header.nRecords * sizeof (TraceReplayRecord),
+                   "Truncated trace file " << filename);
+  m_records = reinterpret_cast<const TraceReplayRecord *> (m_data + sizeof (header));
+  m_nRecords = header.nRecords;
+  NS_LOG_LOGIC ("Opened " << filename << ", " << m_nRecords << " records" <<
+                (m_mapped ? " (memory-mapped)" : ""));
+
+  IndexRecords ();
+}
+
+void
+TraceReplayFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data == 0)
+    {
+      return;
+    }
+#ifdef HAVE_SYS_MMAN_H
+  if (m_mapped)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_dataSize);
+    }
+#endif
+  if (!m_mapped)
+    {
+      delete [] m_data;
+    }
+  m_data = 0;
+  m_dataSize = 0;
+  m_mapped = false;
+  m_records = 0;
+  m_nRecords = 0;
+  m_sources.clear ();
+}
+
+void
+TraceReplayFile::IndexRecords (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t begin = 0;
+  for (uint64_t i = 1; i <= m_nRecords; i++)
+    {
+      if (i < m_nRecords && m_records[i].src == m_records[begin].src)
+        {
+          NS_ABORT_MSG_IF (m_records[i].time < m_records[i - 1].time,
+                           "Trace file " << m_filename << " not sorted by time");
+          continue;
+        }
+      bool inserted = m_sources.insert (std::make_pair (m_records[begin].src,
+                                                        std::make_pair (begin, i))).second;
+      NS_ABORT_MSG_IF (!inserted, "Trace file " << m_filename << " not sorted by source");
+      begin = i;
+    }
+}
+
+uint64_t
+TraceReplayFile::GetNRecords (void) const
+{
+  return m_nRecords;
+}
+
+const TraceReplayRecord &
+TraceReplayFile::GetRecord (uint64_t i) const
+{
+  NS_ASSERT (i < m_nRecords);
+  return m_records[i];
+}
+
+void
+TraceReplayFile::GetRecords (Ipv4Address src, uint64_t &begin, uint64_t &end) const
+{
+  std::unordered_map<uint32_t, std::pair<uint64_t, uint64_t> >::const_iterator it = m_sources.find (src.Get ());
+  if (it == m_sources.end ())
+    {
+      begin = end = 0;
+      return;
+    }
+  begin = it->second.first;
+  end = it->second.second;
+}
+
+void
+TraceReplayFile::Write (std::string filename, std::vector<TraceReplayRecord> records)
+{
+  NS_LOG_FUNCTION (filename << records.size ());
+  std::stable_sort (records.begin (), records.end (), RecordLess);
+
+  std::ofstream file (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_IF (!file.good (), "Can not create the trace file " << filename);
+  TraceReplayFileHeader header;
+  header.magic = TRACE_REPLAY_MAGIC;
+  header.version = TRACE_REPLAY_VERSION;
+  header.nRecords = records.size ();
+  file.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  if (!records.empty ())
+    {
+      file.write (reinterpret_cast<const char *> (&records[0]), records.size () * sizeof (TraceReplayRecord));
+    }
+  NS_ABORT_MSG_IF (!file.good (), "Can not write the trace file " << filename);
+}
+
+uint64_t
+TraceReplayFile::ConvertCsv (std::string csvFilename, std::string filename)
+{
+  NS_LOG_FUNCTION (csvFilename << filename);
+  std::ifstream csv (csvFilename.c_str ());
+  NS_ABORT_MSG_IF (!csv.good (), "Can not open the CSV file " << csvFilename);
+
+  std::vector<TraceReplayRecord> records;
+  std::string line;
+  uint32_t lineNumber = 0;
+  while (std::getline (csv, line))
+    {
+      lineNumber++;
+      std::string::size_type first = line.find_first_not_of (" \t\r");
+      if (first == std::string::npos || line[first] == '#' || std::isalpha (static_cast<unsigned char> (line[first])))
+        {
+          continue;
+        }
+      std::replace (line.begin (), line.end (), ',', ' ');
+      std::istringstream iss (line);
+      std::string time, src, dst;
+      TraceReplayRecord record;
+      iss >> time >> src >> dst >> record.size >> record.flowId;
+      NS_ABORT_MSG_IF (iss.fail (), "Invalid line " << lineNumber << " in CSV file " << csvFilename);
+      if (time.find_first_not_of ("+-0123456789.eE") == std::string::npos)
+        {
+          // seconds, rounded to the nanosecond
+          record.time = std::llround (std::atof (time.c_str ()) * 1e9);
+        }
+      else
+        {
+          record.time = Time (time).GetNanoSeconds ();
+        }
+      record.src = Ipv4Address (src.c_str ()).Get ();
+      record.dst = Ipv4Address (dst.c_str ()).Get ();
+      records.push_back (record);
+    }
+
+  Write (filename, records);
+  return records.size ();
+}
+
+uint64_t
+TraceReplayFile::ConvertPcap (std::string pcapFilename, std::string filename)
+{
+  NS_LOG_FUNCTION (pcapFilename << filename);
+  PcapFile pcap;
+  pcap.Open (pcapFilename, std::ios::in);
+  NS_ABORT_MSG_IF (pcap.Fail (), "Can not open the pcap file " << pcapFilename);
+  uint32_t dataLinkType = pcap.GetDataLinkType ();
+  NS_ABORT_MSG_IF (dataLinkType != PcapHelper::DLT_EN10MB && dataLinkType != PcapHelper::DLT_PPP
+                   && dataLinkType != PcapHelper::DLT_RAW && dataLinkType != PcapHelper::DLT_LINUX_SLL,
+                   "Unsupported data link type " << dataLinkType << " in pcap file " << pcapFilename);
+  int64_t tsScale = pcap.IsNanoSecMode () ? 1 : 1000;
+
+  // the transport headers fit in the first bytes of the packets
+  uint8_t data[128];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  std::map<std::pair<std::pair<uint32_t, uint32_t>, uint64_t>, uint32_t> flows;
+  std::vector<TraceReplayRecord> records;
+  bool first = true;
+  int64_t start = 0;
+  while (true)
+    {
+      pcap.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      if (pcap.Fail ())
+        {
+          break;
+        }
+
+      // find the IPv4 header
+      uint32_t offset = 0;
+      bool ipv4 = false;
+      switch (dataLinkType)
+        {
+        case PcapHelper::DLT_EN10MB:
+          offset = 14;
+          if (readLen >= 18 && ReadNtoh16 (data + 12) == 0x8100)
+            {
+              offset = 18;
+            }
+          ipv4 = readLen >= offset && ReadNtoh16 (data + offset - 2) == 0x0800;
+          break;
+        case PcapHelper::DLT_PPP:
+          offset = 2;
+          ipv4 = readLen >= offset && ReadNtoh16 (data) == 0x0021;
+          break;
+        case PcapHelper::DLT_LINUX_SLL:
+          offset = 16;
+          ipv4 = readLen >= offset && ReadNtoh16 (data + 14) == 0x0800;
+          break;
+        default:
+          ipv4 = true;
+          break;
+        }
+      if (!ipv4 || readLen < offset + 20 || (data[offset] >> 4) != 4)
+        {
+          continue;
+        }
+      const uint8_t *ip = data + offset;
+      if ((ReadNtoh16 (ip + 6) & 0x1fff) != 0)
+        {
+          // the other fragments of a packet have no transport header
+          continue;
+        }
+      uint32_t headerSize = (ip[0] & 0x0f) * 4;
+      uint32_t totalSize = ReadNtoh16 (ip + 2);
+      uint8_t protocol = ip[9];
+      uint32_t src = ReadNtoh32 (ip + 12);
+      uint32_t dst = ReadNtoh32 (ip + 16);
+      uint64_t ports = protocol;
+      uint32_t transportSize = 0;
+      if ((protocol == 6 || protocol == 17) && readLen >= offset + headerSize + 4)
+        {
+          ports |= uint64_t (ReadNtoh32 (ip + headerSize)) << 8;
+          transportSize = 8;
+          if (protocol == 6 && readLen >= offset + headerSize + 13)
+            {
+              transportSize = (ip[headerSize + 12] >> 4) * 4;
+            }
+        }
+
+      TraceReplayRecord record;
+      int64_t time = (int64_t (tsSec) * 1000000000) + tsUsec * tsScale;
+      if (first)
+        {
+          start = time;
+          first = false;
+        }
+      record.time = time - start;
+      record.src = src;
+      record.dst = dst;
+      record.size = totalSize > headerSize + transportSize ? totalSize - headerSize - transportSize : 0;
+      std::pair<std::map<std::pair<std::pair<uint32_t, uint32_t>, uint64_t>, uint32_t>::iterator, bool> flow =
+        flows.insert (std::make_pair (std::make_pair (std::make_pair (src, dst), ports), flows.size () + 1));
+      record.flowId = flow.first->second;
+      records.push_back (record);
+    }
+
+  Write (filename, records);
+  return records.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_REPLAY_FILE_H
+#define TRACE_REPLAY_FILE_H
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/ipv4-address.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief A packet of a replayed trace.
+ *
+ * The records are stored as is in the trace files, in the byte order of
+ * the host, without padding (24 bytes per record).
+ */
+struct TraceReplayRecord
+{
+  int64_t time;    //!< transmission time, in nanoseconds
+  uint32_t src;    //!< source IPv4 address, as returned by Ipv4Address::Get
+  uint32_t dst;    //!< destination IPv4 address, as returned by Ipv4Address::Get
+  uint32_t size;   //!< payload size, in bytes
+  uint32_t flowId; //!< flow identifier
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief A binary packet trace shared by the TraceReplayApplication instances.
+ *
+ * The file starts with a 16 bytes header (magic number, version, number
+ * of records) followed by the TraceReplayRecord array, sorted by source
+ * address and then by time, so that the packets sent by a given address
+ * are contiguous. The file is memory-mapped when the platform allows it,
+ * otherwise it is read in memory once; in both cases the records are
+ * never copied, and a trace of millions of packets can be shared by all
+ * the nodes of a simulation.
+ *
+ * The trace files are written by Write, ConvertCsv and ConvertPcap,
+ * which sort the records as needed.
+ */
+class TraceReplayFile : public SimpleRefCount<TraceReplayFile>
+{
+public:
+  TraceReplayFile ();
+  ~TraceReplayFile ();
+
+  /**
+   * \brief Open a trace file.
+   *
+   * The simulation is aborted if the file can not be read, or if it is
+   * not a valid trace file.
+   *
+   * \param filename the trace file
+   */
+  void Open (std::string filename);
+
+  /**
+   * \brief Close the trace file.
+   */
+  void Close (void);
+
+  /**
+   * \return the number of records in the trace
+   */
+  uint64_t GetNRecords (void) const;
+
+  /**
+   * \param i the index of the record
+   * \return the record
+   */
+  const TraceReplayRecord & GetRecord (uint64_t i) const;
+
+  /**
+   * \brief Get the records sent by an address.
+   * \param src the source address
+   * \param [out] begin the index of the first record sent by the address
+   * \param [out] end the index following the last record sent by the address
+   */
+  void GetRecords (Ipv4Address src, uint64_t &begin, uint64_t &end) const;
+
+  /**
+   * \brief Write a trace file.
+   * \param filename the trace file
+   * \param records the records of the trace, in any order
+   */
+  static void Write (std::string filename, std::vector<TraceReplayRecord> records);
+
+  /**
+   * \brief Convert a CSV file into a trace file.
+   *
+   * Each line of the CSV file holds the time, the source address, the
+   * destination address, the payload size and the flow identifier of a
+   * packet, separated by commas. The time is either a number of seconds
+   * or a time with its unit (e.g., "1.5ms"). Empty lines, and lines
+   * starting with '#' or with a letter (e.g., a header), are ignored.
+   *
+   * \param csvFilename the CSV file
+   * \param filename the trace file
+   * \return the number of records written
+   */
+  static uint64_t ConvertCsv (std::string csvFilename, std::string filename);
+
+  /**
+   * \brief Convert a pcap file into a trace file.
+   *
+   * The IPv4 packets of Ethernet, PPP or raw IP captures are converted;
+   * the other packets, and the IPv4 fragments but the first one of each
+   * packet, are ignored. The payload size is the size of the IPv4 packet
+   * (or first fragment) without the IPv4 and the UDP or TCP headers. The flow
+   * identifiers are allocated from 1, one per 5-tuple. The times are
+   * relative to the first packet of the capture.
+   *
+   * \param pcapFilename the pcap file
+   * \param filename the trace file
+   * \return the number of records written
+   */
+  static uint64_t ConvertPcap (std::string pcapFilename, std::string filename);
+
+private:
+  /**
+   * \brief Index the records by source address.
+   */
+  void IndexRecords (void);
+
+  std::string m_filename;               //!< the trace file
+  const uint8_t *m_data;                //!< the content of the trace file
+  uint64_t m_dataSize;                  //!< the size of the trace file
+  bool m_mapped;                        //!< true if m_data is memory-mapped
+  const TraceReplayRecord *m_records;   //!< the records
+  uint64_t m_nRecords;                  //!< the number of records
+  /// first and last+1 records of each source address
+  std::unordered_map<uint32_t, std::pair<uint64_t, uint64_t> > m_sources;
+};
+
+} // namespace ns3
+
+#endif /* TRACE_REPLAY_FILE_H */
@@ -0,0 +1,229 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/node.h"
+#include "ns3/data-rate.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/packet-sink.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/flow-workload-application.h"
+#include "ns3/flow-workload-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications
+ * \ingroup tests
+ *
+ * \brief Flows of a FlowWorkloadApplication.
+ */
+class FlowWorkloadBasicTestCase : public TestCase
+{
+public:
+  FlowWorkloadBasicTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Completion of a flow.
+   * \param context the index of the sending node
+   * \param flowId the flow identifier
+   * \param remote the remote address of the flow
+   * \param size the flow size
+   * \param duration the flow completion time
+   */
+  void FlowCompletion (std::string context, uint32_t flowId, const Address &remote, uint64_t size, Time duration);
+
+  Ipv4InterfaceContainer m_interfaces; //!< the interfaces of the nodes
+  uint32_t m_completed;                //!< the number of completed flows
+  uint64_t m_completedBytes;           //!< the bytes of the completed flows
+  uint32_t m_selfFlows;                //!< the number of flows sent to the sending node
+  Time m_minDuration;                  //!< the shortest flow completion time
+};
+
+FlowWorkloadBasicTestCase::FlowWorkloadBasicTestCase ()
+  : TestCase ("Flows of a FlowWorkloadApplication are completed"),
+    m_completed (0),
+    m_completedBytes (0),
+    m_selfFlows (0),
+    m_minDuration (Time::Max ())
+{
+}
+
+void
+FlowWorkloadBasicTestCase::FlowCompletion (std::string context, uint32_t flowId, const Address &remote,
+                                           uint64_t size, Time duration)
+{
+  m_completed++;
+  m_completedBytes += size;
+  m_minDuration = std::min (m_minDuration, duration);
+  uint32_t sender = std::stoul (context);
+  if (InetSocketAddress::ConvertFrom (remote).GetIpv4 () == m_interfaces.GetAddress (sender))
+    {
+      m_selfFlows++;
+    }
+}
+
+void
+FlowWorkloadBasicTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Mbps")));
+  simpleHelper.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  NetDeviceContainer devices = simpleHelper.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  m_interfaces = ipv4.Assign (devices);
+
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9));
+  ApplicationContainer sinks = sinkHelper.Install (nodes);
+
+  FlowWorkloadHelper workloadHelper ("ns3::TcpSocketFactory");
+  workloadHelper.SetAttribute ("FlowSize", StringValue ("ns3::ConstantRandomVariable[Constant=20000]"));
+  workloadHelper.SetAttribute ("FlowInterArrival", StringValue ("ns3::ConstantRandomVariable[Constant=0.001]"));
+  workloadHelper.SetAttribute ("MaxFlows", UintegerValue (20));
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      workloadHelper.AddRemote (InetSocketAddress (m_interfaces.GetAddress (i), 9));
+    }
+  ApplicationContainer senders = workloadHelper.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  for (uint32_t i = 0; i < senders.GetN (); i++)
+    {
+      senders.Get (i)->TraceConnect ("FlowCompletion", std::to_string (i),
+                                     MakeCallback (&FlowWorkloadBasicTestCase::FlowCompletion, this));
+    }
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_completed, 40, "Flows not completed");
+  NS_TEST_EXPECT_MSG_EQ (m_completedBytes, 40 * 20000, "Wrong flow sizes");
+  NS_TEST_EXPECT_MSG_EQ (m_selfFlows, 0, "Flows sent to the sending node");
+  NS_TEST_EXPECT_MSG_GT (m_minDuration, MilliSeconds (2), "Flows completed before being acknowledged");
+  uint64_t received = 0;
+  for (uint32_t i = 0; i < sinks.GetN (); i++)
+    {
+      received += DynamicCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (received, 40 * 20000, "Wrong number of bytes received");
+  for (uint32_t i = 0; i < senders.GetN (); i++)
+    {
+      Ptr<FlowWorkloadApplication> sender = DynamicCast<FlowWorkloadApplication> (senders.Get (i));
+      NS_TEST_EXPECT_MSG_EQ (sender->GetNActiveFlows (), 0, "Flows still active");
+      NS_TEST_EXPECT_MSG_EQ (sender->GetNCompletedFlows (), 20, "Wrong number of completed flows");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications
+ * \ingroup tests
+ *
+ * \brief Flow size distributions of the workloads.
+ */
+class FlowWorkloadSizesTestCase : public TestCase
+{
+public:
+  FlowWorkloadSizesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FlowWorkloadSizesTestCase::FlowWorkloadSizesTestCase ()
+  : TestCase ("Flow size distributions of the workloads")
+{
+}
+
+void
+FlowWorkloadSizesTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ_TOL (FlowWorkloadApplication::GetWorkloadMeanFlowSize ("websearch"), 1711250, 1,
+                             "Wrong websearch mean flow size");
+
+  const char *workloads[] = { "websearch", "datamining" };
+  for (uint32_t w = 0; w < 2; w++)
+    {
+      Ptr<EmpiricalRandomVariable> sizes = FlowWorkloadApplication::GetWorkloadFlowSizes (workloads[w]);
+      sizes->SetStream (1);
+      double mean = FlowWorkloadApplication::GetWorkloadMeanFlowSize (workloads[w]);
+      double sum = 0;
+      double min = 1e12;
+      const uint32_t n = 100000;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          double size = sizes->GetValue ();
+          sum += size;
+          min = std::min (min, size);
+        }
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (min, 0, "Negative flow size for " << workloads[w]);
+      // the datamining sizes have a heavy tail
+      NS_TEST_EXPECT_MSG_EQ_TOL (sum / n, mean, mean * (w == 0 ? 0.05 : 0.25),
+                                 "Wrong mean flow size for " << workloads[w]);
+    }
+
+  // half of a 10 Gb/s link
+  FlowWorkloadHelper workloadHelper ("ns3::TcpSocketFactory");
+  workloadHelper.SetLoad ("websearch", 0.5, DataRate ("10Gbps"));
+  ApplicationContainer apps = workloadHelper.Install (CreateObject<Node> ());
+  PointerValue interArrival;
+  apps.Get (0)->GetAttribute ("FlowInterArrival", interArrival);
+  Ptr<ExponentialRandomVariable> exponential = interArrival.Get<ExponentialRandomVariable> ();
+  NS_TEST_EXPECT_MSG_NE (exponential, 0, "Flow arrivals not drawn from a Poisson process");
+  if (exponential)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (exponential->GetMean (), 1711250 * 8 / 5e9, 1e-12, "Wrong flow arrival rate");
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications
+ * \ingroup tests
+ *
+ * \brief FlowWorkloadApplication TestSuite
+ */
+class FlowWorkloadTestSuite : public TestSuite
+{
+public:
+  FlowWorkloadTestSuite ();
+};
+
+FlowWorkloadTestSuite::FlowWorkloadTestSuite ()
+  : TestSuite ("flow-workload", UNIT)
+{
+  AddTestCase (new FlowWorkloadBasicTestCase, TestCase::QUICK);
+  AddTestCase (new FlowWorkloadSizesTestCase, TestCase::QUICK);
+}
+
+static FlowWorkloadTestSuite g_flowWorkloadTestSuite; //!< Static variable for test initialization
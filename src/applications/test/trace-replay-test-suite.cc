@@ -0,0 +1,282 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/pcap-file.h"
+#include "ns3/trace-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet-sink.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/trace-replay-file.h"
+#include "ns3/trace-replay-application.h"
+#include "ns3/trace-replay-helper.h"
+#include <fstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup applications
+ * \ingroup tests
+ *
+ * \brief Conversion of CSV and pcap files into replay traces.
+ */
+class TraceReplayConvertTestCase : public TestCase
+{
+public:
+  TraceReplayConvertTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TraceReplayConvertTestCase::TraceReplayConvertTestCase ()
+  : TestCase ("Convert CSV and pcap files into replay traces")
+{
+}
+
+void
+TraceReplayConvertTestCase::DoRun (void)
+{
+  std::string csvFilename = CreateTempDirFilename ("trace-replay.csv");
+  std::string filename = CreateTempDirFilename ("trace-replay-csv.trace");
+  std::ofstream csv (csvFilename.c_str ());
+  csv << "time,src,dst,size,flow" << std::endl
+      << "2.5,10.1.1.2,10.1.1.3,200,3" << std::endl
+      << "# comment" << std::endl
+      << "1,10.1.1.1,10.1.1.3,100,1" << std::endl
+      << std::endl
+      << "1500ms,10.1.1.2,10.1.1.1,300,2" << std::endl
+      << "1.2,10.1.1.1,10.1.1.2,400,4" << std::endl;
+  csv.close ();
+
+  NS_TEST_EXPECT_MSG_EQ (TraceReplayFile::ConvertCsv (csvFilename, filename), 4, "Wrong number of records");
+  Ptr<TraceReplayFile> trace = Create<TraceReplayFile> ();
+  trace->Open (filename);
+  NS_TEST_EXPECT_MSG_EQ (trace->GetNRecords (), 4, "Wrong number of records");
+
+  uint64_t begin, end;
+  trace->GetRecords (Ipv4Address ("10.1.1.1"), begin, end);
+  NS_TEST_EXPECT_MSG_EQ (end - begin, 2, "Wrong records for 10.1.1.1");
+  if (end - begin == 2)
+    {
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (begin).time, Seconds (1).GetNanoSeconds (), "Records not sorted by time");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (begin).size, 100, "Wrong size");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (begin).flowId, 1, "Wrong flow");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (begin + 1).time, MilliSeconds (1200).GetNanoSeconds (), "Records not sorted by time");
+      NS_TEST_EXPECT_MSG_EQ (Ipv4Address (trace->GetRecord (begin + 1).dst), Ipv4Address ("10.1.1.2"), "Wrong destination");
+    }
+  trace->GetRecords (Ipv4Address ("10.1.1.2"), begin, end);
+  NS_TEST_EXPECT_MSG_EQ (end - begin, 2, "Wrong records for 10.1.1.2");
+  if (end - begin == 2)
+    {
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (begin).time, MilliSeconds (1500).GetNanoSeconds (), "Wrong time unit");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (begin + 1).flowId, 3, "Records not sorted by time");
+    }
+  trace->GetRecords (Ipv4Address ("10.1.1.3"), begin, end);
+  NS_TEST_EXPECT_MSG_EQ (end - begin, 0, "No records for 10.1.1.3");
+
+  // IPv4 packets of a raw IP capture: two packets of a UDP flow, one of
+  // another flow, and a non-first fragment that is skipped
+  std::string pcapFilename = CreateTempDirFilename ("trace-replay.pcap");
+  filename = CreateTempDirFilename ("trace-replay-pcap.trace");
+  PcapFile pcap;
+  pcap.Open (pcapFilename, std::ios::out);
+  pcap.Init (PcapHelper::DLT_RAW);
+  uint8_t packet[28] = {
+    0x45, 0, 0, 0, 0, 0, 0, 0, 64, 17, 0, 0, // version, length, protocol
+    10, 1, 1, 1, 10, 1, 1, 3,                // addresses
+    0x12, 0x34, 0, 100, 0, 0, 0, 0           // UDP header
+  };
+  packet[3] = 128; // 100 bytes of payload
+  pcap.Write (10, 0, packet, sizeof (packet));
+  packet[3] = 58;
+  pcap.Write (10, 500, packet, sizeof (packet));
+  packet[21] = 0x35; // other source port
+  pcap.Write (11, 0, packet, sizeof (packet));
+  packet[7] = 185; // fragment offset of 1480 bytes
+  pcap.Write (11, 100, packet, sizeof (packet));
+  pcap.Close ();
+
+  NS_TEST_EXPECT_MSG_EQ (TraceReplayFile::ConvertPcap (pcapFilename, filename), 3, "Wrong number of records");
+  trace->Open (filename);
+  NS_TEST_EXPECT_MSG_EQ (trace->GetNRecords (), 3, "Wrong number of records");
+  if (trace->GetNRecords () == 3)
+    {
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (0).time, 0, "Times not relative to the first packet");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (0).size, 100, "Wrong payload size");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (1).time, MicroSeconds (500).GetNanoSeconds (), "Wrong time");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (1).size, 30, "Wrong payload size");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (1).flowId, trace->GetRecord (0).flowId, "Same 5-tuple, same flow");
+      NS_TEST_EXPECT_MSG_EQ (trace->GetRecord (2).time, Seconds (1).GetNanoSeconds (), "Wrong time");
+      NS_TEST_EXPECT_MSG_NE (trace->GetRecord (2).flowId, trace->GetRecord (0).flowId, "Other 5-tuple, other flow");
+      NS_TEST_EXPECT_MSG_EQ (Ipv4Address (trace->GetRecord (2).src), Ipv4Address ("10.1.1.1"), "Wrong source");
+      NS_TEST_EXPECT_MSG_EQ (Ipv4Address (trace->GetRecord (2).dst), Ipv4Address ("10.1.1.3"), "Wrong destination");
+    }
+  trace->Close ();
+}
+
+/**
+ * \ingroup applications
+ * \ingroup tests
+ *
+ * \brief Replay of a trace by the TraceReplayApplication.
+ */
+class TraceReplayBasicTestCase : public TestCase
+{
+public:
+  TraceReplayBasicTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Transmission of a packet.
+   * \param p the packet
+   */
+  void SendTx (Ptr<const Packet> p);
+  /**
+   * \brief Reception of a packet.
+   * \param p the packet
+   * \param addr the source address
+   */
+  void ReceiveRx (Ptr<const Packet> p, const Address &addr);
+
+  std::vector<Time> m_txTimes;      //!< the transmission times
+  uint64_t m_received;              //!< the number of packets received
+  uint64_t m_receivedBytes;         //!< the number of bytes received
+  uint32_t m_flowIds;               //!< the sum of the received flow identifiers
+};
+
+TraceReplayBasicTestCase::TraceReplayBasicTestCase ()
+  : TestCase ("Replay a trace on the sending nodes"),
+    m_received (0),
+    m_receivedBytes (0),
+    m_flowIds (0)
+{
+}
+
+void
+TraceReplayBasicTestCase::SendTx (Ptr<const Packet> p)
+{
+  m_txTimes.push_back (Simulator::Now ());
+}
+
+void
+TraceReplayBasicTestCase::ReceiveRx (Ptr<const Packet> p, const Address &addr)
+{
+  m_received++;
+  m_receivedBytes += p->GetSize ();
+  FlowIdTag tag;
+  if (p->PeekPacketTag (tag))
+    {
+      m_flowIds += tag.GetFlowId ();
+    }
+}
+
+void
+TraceReplayBasicTestCase::DoRun (void)
+{
+  std::vector<TraceReplayRecord> records;
+  TraceReplayRecord record;
+  // before the start of the applications
+  record = { MilliSeconds (500).GetNanoSeconds (), Ipv4Address ("10.1.1.1").Get (), Ipv4Address ("10.1.1.3").Get (), 10, 1 };
+  records.push_back (record);
+  // a burst of two flows on the first node
+  record = { Seconds (2).GetNanoSeconds (), Ipv4Address ("10.1.1.1").Get (), Ipv4Address ("10.1.1.3").Get (), 100, 2 };
+  records.push_back (record);
+  record = { Seconds (2).GetNanoSeconds (), Ipv4Address ("10.1.1.1").Get (), Ipv4Address ("10.1.1.3").Get (), 200, 4 };
+  records.push_back (record);
+  record = { Seconds (3).GetNanoSeconds (), Ipv4Address ("10.1.1.1").Get (), Ipv4Address ("10.1.1.3").Get (), 300, 8 };
+  records.push_back (record);
+  record = { MilliSeconds (2500).GetNanoSeconds (), Ipv4Address ("10.1.1.2").Get (), Ipv4Address ("10.1.1.3").Get (), 400, 16 };
+  records.push_back (record);
+  // a node which is not simulated
+  record = { Seconds (2).GetNanoSeconds (), Ipv4Address ("10.1.1.9").Get (), Ipv4Address ("10.1.1.3").Get (), 500, 32 };
+  records.push_back (record);
+  std::string filename = CreateTempDirFilename ("trace-replay.trace");
+  TraceReplayFile::Write (filename, records);
+
+  NodeContainer nodes;
+  nodes.Create (3);
+  SimpleNetDeviceHelper simpleHelper;
+  NetDeviceContainer devices = simpleHelper.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (devices);
+
+  TraceReplayHelper replayHelper (filename);
+  replayHelper.SetAttribute ("RemotePort", UintegerValue (9));
+  ApplicationContainer senders = replayHelper.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  senders.Start (Seconds (1));
+  for (ApplicationContainer::Iterator i = senders.Begin (); i != senders.End (); ++i)
+    {
+      (*i)->TraceConnectWithoutContext ("Tx", MakeCallback (&TraceReplayBasicTestCase::SendTx, this));
+    }
+
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9));
+  ApplicationContainer sinks = sinkHelper.Install (nodes.Get (2));
+  sinks.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&TraceReplayBasicTestCase::ReceiveRx, this));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_txTimes.size (), 4, "Wrong number of packets sent");
+  if (m_txTimes.size () == 4)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_txTimes[0], Seconds (2), "Wrong transmission time");
+      NS_TEST_EXPECT_MSG_EQ (m_txTimes[1], Seconds (2), "Wrong transmission time");
+      NS_TEST_EXPECT_MSG_EQ (m_txTimes[2], MilliSeconds (2500), "Wrong transmission time");
+      NS_TEST_EXPECT_MSG_EQ (m_txTimes[3], Seconds (3), "Wrong transmission time");
+    }
+  uint64_t sent = DynamicCast<TraceReplayApplication> (senders.Get (0))->GetSent ()
+    + DynamicCast<TraceReplayApplication> (senders.Get (1))->GetSent ();
+  NS_TEST_EXPECT_MSG_EQ (sent, 4, "Wrong number of packets sent");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 4, "Wrong number of packets received");
+  NS_TEST_EXPECT_MSG_EQ (m_receivedBytes, 1000, "Wrong number of bytes received");
+  NS_TEST_EXPECT_MSG_EQ (m_flowIds, 2 + 4 + 8 + 16, "Wrong flows received");
+}
+
+/**
+ * \ingroup applications
+ * \ingroup tests
+ *
+ * \brief TraceReplayApplication TestSuite
+ */
+class TraceReplayTestSuite : public TestSuite
+{
+public:
+  TraceReplayTestSuite ();
+};
+
+TraceReplayTestSuite::TraceReplayTestSuite ()
+  : TestSuite ("trace-replay", UNIT)
+{
+  AddTestCase (new TraceReplayConvertTestCase, TestCase::QUICK);
+  AddTestCase (new TraceReplayBasicTestCase, TestCase::QUICK);
+}
+
+static TraceReplayTestSuite g_traceReplayTestSuite; //!< Static variable for test initialization
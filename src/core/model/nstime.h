@@ -30,6 +30,7 @@
 #include <cmath>
 #include <ostream>
 #include <set>
+#include <unordered_set>
 
 /**
  * \file
@@ -622,8 +623,13 @@ private:
    *
    *  > & sect;23.1/3 states that std::set key types must be assignable
    *  > and copy constructable; clearly a const type will not be assignable.
+   *
+   *  Every Time constructed or destroyed before the simulation starts
+   *  goes through this container, so a hash set is used: it keeps the
+   *  setup of large topologies from paying a tree lookup for each
+   *  temporary Time.
    */
-  typedef std::set< Time * > MarkedTimes;
+  typedef std::unordered_set< Time * > MarkedTimes;
   /**
    *  Record of outstanding Time objects which will need conversion
    *  when the resolution is set.
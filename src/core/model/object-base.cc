@@ -172,6 +172,11 @@ ObjectBase::DoSet (Ptr<const AttributeAccessor> accessor,
                    const AttributeValue &value)
 {
   NS_LOG_FUNCTION (this << accessor << checker << &value);
+  if (checker->Check (value))
+    {
+      // already valid: no need for the copy CreateValidValue would make
+      return accessor->Set (this, value);
+    }
   Ptr<AttributeValue> v = checker->CreateValidValue (value);
   if (v == 0)
     {
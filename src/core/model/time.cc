@@ -320,12 +320,11 @@ Time::Clear (Time * const time)
 
   if (g_markingTimes)
     {
-      NS_ASSERT_MSG (g_markingTimes->count (time) == 1,
+      MarkedTimes::size_type num = g_markingTimes->erase (time);
+      NS_ASSERT_MSG (num == 1,
                      "Time object " << time <<
-                     " registered " << g_markingTimes->count (time) <<
+                     " registered " << num <<
                      " times (should be 1)." );
-
-      MarkedTimes::size_type num = g_markingTimes->erase (time);
       if (num != 1)
         {
           NS_LOG_WARN ("unexpected result erasing " << time << "!");
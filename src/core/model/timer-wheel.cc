@@ -0,0 +1,567 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelTimer implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED (TimerWheel);
+
+namespace {
+
+/**
+ * \ingroup timer
+ * \brief Find the first bit set in a bitmap, starting from a position
+ * and wrapping around.
+ * \param bitmap the bitmap, which must not be empty
+ * \param position the position of the first bit to check
+ * \returns the distance from position to the first bit set
+ */
+uint32_t
+FirstSetFrom (uint64_t bitmap, uint32_t position)
+{
+  NS_ASSERT (bitmap != 0);
+  uint64_t rotated = bitmap >> position;
+  if (position != 0)
+    {
+      rotated |= bitmap << (64 - position);
+    }
+#if defined (__GNUC__)
+  return __builtin_ctzll (rotated);
+#else
+  uint32_t distance = 0;
+  while ((rotated & 1) == 0)
+    {
+      rotated >>= 1;
+      distance++;
+    }
+  return distance;
+#endif
+}
+
+} // unnamed namespace
+
+TypeId
+TimerWheel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimerWheel")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimerWheel> ()
+    .AddAttribute ("Resolution",
+                   "The duration of a slot of the lowest level of the wheel. "
+                   "It can only be changed while no timer is running.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TimerWheel::m_resolution),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+TimerWheel::TimerWheel ()
+  : m_tick (0),
+    m_context (Simulator::NO_CONTEXT),
+    m_nTimers (0),
+    m_nextSequence (0),
+    m_expiring (false),
+    m_wakeupPending (false)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      m_bitmap[level] = 0;
+      for (uint32_t index = 0; index < SLOTS; index++)
+        {
+          m_slots[level][index].head = 0;
+          m_slots[level][index].tail = 0;
+        }
+    }
+  m_expired.head = 0;
+  m_expired.tail = 0;
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TimerWheel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint8_t level = 0; level <= LEVELS; level++)
+    {
+      for (uint8_t index = 0; index < (level < LEVELS ? SLOTS : 1); index++)
+        {
+          Slot &slot = GetSlot (level, index);
+          while (slot.head != 0)
+            {
+              Unlink (slot.head);
+            }
+        }
+    }
+  m_nTimers = 0;
+  m_wakeupPending = false;
+  Object::DoDispose ();
+}
+
+void
+TimerWheel::SetContext (uint32_t context)
+{
+  NS_LOG_FUNCTION (this << context);
+  m_context = context;
+}
+
+uint32_t
+TimerWheel::GetNTimers (void) const
+{
+  return m_nTimers;
+}
+
+void
+TimerWheel::Add (WheelTimer *timer)
+{
+  NS_LOG_FUNCTION (this << timer);
+  timer->m_tick = GetTick (timer->m_expiry);
+  timer->m_sequence = m_nextSequence++;
+  Insert (timer);
+  m_nTimers++;
+  if (!m_expiring && (!m_wakeupPending || timer->m_expiry < m_wakeupTime))
+    {
+      ScheduleWakeup (timer->m_expiry);
+    }
+}
+
+void
+TimerWheel::Remove (WheelTimer *timer)
+{
+  NS_LOG_FUNCTION (this << timer);
+  Unlink (timer);
+  m_nTimers--;
+}
+
+void
+TimerWheel::Insert (WheelTimer *timer)
+{
+  NS_ASSERT (timer->m_tick >= m_tick);
+  if (timer->m_tick - m_tick < SLOTS)
+    {
+      Link (timer, 0, timer->m_tick & SLOT_MASK);
+      return;
+    }
+  for (uint8_t level = 1; level < LEVELS; level++)
+    {
+      uint32_t shift = level * SLOT_BITS;
+      if ((timer->m_tick >> shift) - (m_tick >> shift) < SLOTS)
+        {
+          Link (timer, level, (timer->m_tick >> shift) & SLOT_MASK);
+          return;
+        }
+    }
+  // Beyond the range of the wheel: park it in the last slot
+  uint32_t shift = (LEVELS - 1) * SLOT_BITS;
+  Link (timer, LEVELS - 1, ((m_tick >> shift) + SLOTS - 1) & SLOT_MASK);
+}
+
+TimerWheel::Slot &
+TimerWheel::GetSlot (uint8_t level, uint8_t index)
+{
+  if (level == EXPIRED)
+    {
+      return m_expired;
+    }
+  NS_ASSERT (level < LEVELS && index < SLOTS);
+  return m_slots[level][index];
+}
+
+void
+TimerWheel::Link (WheelTimer *timer, uint8_t level, uint8_t index)
+{
+  Slot &slot = GetSlot (level, index);
+  timer->m_prev = slot.tail;
+  timer->m_next = 0;
+  if (slot.tail != 0)
+    {
+      slot.tail->m_next = timer;
+    }
+  else
+    {
+      slot.head = timer;
+    }
+  slot.tail = timer;
+  timer->m_level = level;
+  timer->m_index = index;
+  if (level < LEVELS)
+    {
+      m_bitmap[level] |= (uint64_t (1) << index);
+    }
+}
+
+void
+TimerWheel::LinkExpired (WheelTimer *timer)
+{
+  // The slots are not sorted, as the timers moved down from a higher level
+  // are appended after the ones armed later directly in the lower level
+  WheelTimer *prev = m_expired.tail;
+  while (prev != 0 && prev->m_sequence > timer->m_sequence)
+    {
+      prev = prev->m_prev;
+    }
+  WheelTimer *next = (prev != 0 ? prev->m_next : m_expired.head);
+  timer->m_prev = prev;
+  timer->m_next = next;
+  if (prev != 0)
+    {
+      prev->m_next = timer;
+    }
+  else
+    {
+      m_expired.head = timer;
+    }
+  if (next != 0)
+    {
+      next->m_prev = timer;
+    }
+  else
+    {
+      m_expired.tail = timer;
+    }
+  timer->m_level = EXPIRED;
+  timer->m_index = 0;
+}
+
+void
+TimerWheel::Unlink (WheelTimer *timer)
+{
+  NS_ASSERT (timer->m_level != UNLINKED);
+  Slot &slot = GetSlot (timer->m_level, timer->m_index);
+  if (timer->m_prev != 0)
+    {
+      timer->m_prev->m_next = timer->m_next;
+    }
+  else
+    {
+      slot.head = timer->m_next;
+    }
+  if (timer->m_next != 0)
+    {
+      timer->m_next->m_prev = timer->m_prev;
+    }
+  else
+    {
+      slot.tail = timer->m_prev;
+    }
+  if (slot.head == 0 && timer->m_level < LEVELS)
+    {
+      m_bitmap[timer->m_level] &= ~(uint64_t (1) << timer->m_index);
+    }
+  timer->m_prev = 0;
+  timer->m_next = 0;
+  timer->m_level = UNLINKED;
+}
+
+uint64_t
+TimerWheel::GetTick (Time time) const
+{
+  NS_ASSERT (!time.IsNegative ());
+  return time.GetTimeStep () / m_resolution.GetTimeStep ();
+}
+
+bool
+TimerWheel::GetNextTick (uint64_t &tick, bool &cascade) const
+{
+  bool found = false;
+  if (m_bitmap[0] != 0)
+    {
+      // The slots of the lowest level hold the next SLOTS ticks
+      tick = m_tick + FirstSetFrom (m_bitmap[0], m_tick & SLOT_MASK);
+      cascade = false;
+      found = true;
+    }
+  for (uint8_t level = 1; level < LEVELS; level++)
+    {
+      if (m_bitmap[level] == 0)
+        {
+          continue;
+        }
+      // The current slot of a higher level is always empty, as it has
+      // been moved down when entered.
+      uint32_t shift = level * SLOT_BITS;
+      uint64_t current = m_tick >> shift;
+      uint64_t next = current + 1 + FirstSetFrom (m_bitmap[level], (current + 1) & SLOT_MASK);
+      NS_ASSERT (next < current + SLOTS);
+      uint64_t start = next << shift;
+      if (!found || start <= tick)
+        {
+          tick = start;
+          cascade = true;
+          found = true;
+        }
+    }
+  return found;
+}
+
+void
+TimerWheel::Advance (uint64_t tick)
+{
+  NS_ASSERT (tick >= m_tick);
+  uint64_t previous = m_tick;
+  m_tick = tick;
+  for (uint8_t level = LEVELS - 1; level > 0; level--)
+    {
+      uint32_t shift = level * SLOT_BITS;
+      if ((tick >> shift) == (previous >> shift))
+        {
+          continue;
+        }
+      uint8_t index = (tick >> shift) & SLOT_MASK;
+      if ((m_bitmap[level] & (uint64_t (1) << index)) == 0)
+        {
+          continue;
+        }
+      // Entering a non-empty slot: move its timers down
+      WheelTimer *timer = m_slots[level][index].head;
+      m_slots[level][index].head = 0;
+      m_slots[level][index].tail = 0;
+      m_bitmap[level] &= ~(uint64_t (1) << index);
+      while (timer != 0)
+        {
+          WheelTimer *next = timer->m_next;
+          Insert (timer);
+          timer = next;
+        }
+    }
+}
+
+void
+TimerWheel::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  if (!m_wakeupPending || now != m_wakeupTime)
+    {
+      NS_LOG_LOGIC ("Ignoring a stale wakeup");
+      return;
+    }
+  m_wakeupPending = false;
+  m_expiring = true;
+
+  uint64_t target = GetTick (now);
+  uint64_t tick;
+  bool cascade;
+  while (GetNextTick (tick, cascade) && tick <= target)
+    {
+      Advance (tick);
+      // Collect the timers expired in the current slot.  Only the slot of
+      // the current tick may hold timers which are not expired yet.
+      Slot &slot = m_slots[0][tick & SLOT_MASK];
+      WheelTimer *timer = slot.head;
+      while (timer != 0)
+        {
+          WheelTimer *next = timer->m_next;
+          if (timer->m_expiry <= now)
+            {
+              Unlink (timer);
+              LinkExpired (timer);
+            }
+          timer = next;
+        }
+      if (tick == target)
+        {
+          break;
+        }
+    }
+  if (m_tick < target)
+    {
+      Advance (target);
+    }
+
+  // The timers invoked can arm and cancel timers, including the ones
+  // which are about to be invoked.
+  while (m_expired.head != 0)
+    {
+      WheelTimer *timer = m_expired.head;
+      Unlink (timer);
+      m_nTimers--;
+      timer->Invoke ();
+    }
+  m_expiring = false;
+  ScheduleWakeup ();
+}
+
+void
+TimerWheel::ScheduleWakeup (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t tick;
+  bool cascade;
+  if (!GetNextTick (tick, cascade))
+    {
+      return;
+    }
+  if (cascade)
+    {
+      // Wake up when the slot is entered, and check it then
+      ScheduleWakeup (TimeStep (tick * m_resolution.GetTimeStep ()));
+      return;
+    }
+  const Slot &slot = m_slots[0][tick & SLOT_MASK];
+  Time expiry = slot.head->m_expiry;
+  for (const WheelTimer *timer = slot.head->m_next; timer != 0; timer = timer->m_next)
+    {
+      expiry = std::min (expiry, timer->m_expiry);
+    }
+  ScheduleWakeup (expiry);
+}
+
+void
+TimerWheel::ScheduleWakeup (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  m_wakeupPending = true;
+  m_wakeupTime = time;
+  Time delay = time - Simulator::Now ();
+  if (m_context == Simulator::NO_CONTEXT)
+    {
+      Simulator::Schedule (delay, &TimerWheel::Expire, Ptr<TimerWheel> (this));
+    }
+  else
+    {
+      Simulator::ScheduleWithContext (m_context, delay, &TimerWheel::Expire, Ptr<TimerWheel> (this));
+    }
+}
+
+
+WheelTimer::WheelTimer ()
+  : m_impl (0),
+    m_delay (FemtoSeconds (0)),
+    m_event (),
+    m_wheel (0),
+    m_tick (0),
+    m_sequence (0),
+    m_prev (0),
+    m_next (0),
+    m_level (TimerWheel::UNLINKED),
+    m_index (0)
+{
+}
+
+WheelTimer::~WheelTimer ()
+{
+  Cancel ();
+  delete m_impl;
+}
+
+void
+WheelTimer::SetWheel (Ptr<TimerWheel> wheel)
+{
+  NS_ASSERT_MSG (!IsRunning (), "Changing the wheel of a running timer");
+  m_wheel = wheel;
+}
+
+Ptr<TimerWheel>
+WheelTimer::GetWheel (void) const
+{
+  return m_wheel;
+}
+
+void
+WheelTimer::SetDelay (const Time &delay)
+{
+  m_delay = delay;
+}
+
+Time
+WheelTimer::GetDelay (void) const
+{
+  return m_delay;
+}
+
+Time
+WheelTimer::GetDelayLeft (void) const
+{
+  if (m_level != TimerWheel::UNLINKED)
+    {
+      return m_expiry - Simulator::Now ();
+    }
+  return Simulator::GetDelayLeft (m_event);
+}
+
+void
+WheelTimer::Cancel (void)
+{
+  if (m_level != TimerWheel::UNLINKED)
+    {
+      m_wheel->Remove (this);
+    }
+  m_event.Cancel ();
+}
+
+bool
+WheelTimer::IsExpired (void) const
+{
+  return !IsRunning ();
+}
+
+bool
+WheelTimer::IsRunning (void) const
+{
+  return m_level != TimerWheel::UNLINKED || m_event.IsRunning ();
+}
+
+void
+WheelTimer::Schedule (void)
+{
+  Schedule (m_delay);
+}
+
+void
+WheelTimer::Schedule (Time delay)
+{
+  NS_ASSERT (m_impl != 0);
+  if (IsRunning ())
+    {
+      NS_FATAL_ERROR ("Event is still running while re-scheduling.");
+    }
+  if (m_wheel != 0)
+    {
+      NS_ASSERT (!delay.IsNegative ());
+      m_expiry = Simulator::Now () + delay;
+      m_wheel->Add (this);
+    }
+  else
+    {
+      m_event = m_impl->Schedule (delay);
+    }
+}
+
+void
+WheelTimer::Invoke (void)
+{
+  m_impl->Invoke ();
+}
+
+} // namespace ns3
@@ -0,0 +1,374 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "object.h"
+#include "ptr.h"
+#include "nstime.h"
+#include "event-id.h"
+#include "fatal-error.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelTimer declarations.
+ */
+
+namespace ns3 {
+
+class TimerImpl;
+class WheelTimer;
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timer wheel multiplexing many timers on a
+ * single simulator event.
+ *
+ * Protocols which arm and disarm a large number of timers (e.g., one
+ * retransmission timer per TCP connection, re-armed on every ACK) can
+ * register their WheelTimer instances with a TimerWheel, usually the one
+ * aggregated to their Node.  Arming and cancelling a timer then only
+ * links and unlinks it in the wheel, in constant time, and the wheel only
+ * needs one event in the simulator scheduler.  That event is not moved
+ * when timers are cancelled or pushed later: when it fires without
+ * anything to do, it is simply rescheduled for the next timer.  It is
+ * only moved when a timer expiring before it is armed.
+ *
+ * The wheel is made of four levels of 64 slots.  A slot of the first
+ * level spans one tick (see the Resolution attribute), and a slot of the
+ * next levels spans 64 slots of the level below.  Timers are moved to the
+ * lower levels as their expiration time gets closer.  Timers expiring
+ * beyond the range of the wheel (2^24 ticks) are parked in the last
+ * slot of the highest level and reinserted when it is reached.
+ *
+ * The resolution only affects the bookkeeping: each timer still expires
+ * exactly at the time it has been scheduled for.  Timers expiring at the
+ * same time are invoked in the order they have been scheduled.
+ */
+class TimerWheel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TimerWheel ();
+  virtual ~TimerWheel ();
+
+  /**
+   * \brief Set the context of the events used by the wheel.
+   *
+   * The timers are invoked in this context, usually the id of the Node
+   * owning the wheel.  By default, the context of the code arming the
+   * timers is used.
+   *
+   * \param context the context
+   */
+  void SetContext (uint32_t context);
+
+  /**
+   * \returns the number of timers currently running on the wheel
+   */
+  uint32_t GetNTimers (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class WheelTimer;
+
+  /// Number of levels of the wheel
+  static const uint32_t LEVELS = 4;
+  /// Number of bits of the slot index in a level
+  static const uint32_t SLOT_BITS = 6;
+  /// Number of slots in a level
+  static const uint32_t SLOTS = 1 << SLOT_BITS;
+  /// Mask of the slot index in a level
+  static const uint64_t SLOT_MASK = SLOTS - 1;
+  /// Pseudo level of the timers which are being invoked
+  static const uint8_t EXPIRED = LEVELS;
+  /// Pseudo level of the timers which are not linked to the wheel
+  static const uint8_t UNLINKED = LEVELS + 1;
+
+  /// Doubly linked list of timers
+  struct Slot
+  {
+    WheelTimer *head; //!< first timer
+    WheelTimer *tail; //!< last timer
+  };
+
+  /**
+   * \brief Start a timer.
+   * \param timer the timer, whose expiration time is set
+   */
+  void Add (WheelTimer *timer);
+  /**
+   * \brief Stop a running timer.
+   * \param timer the timer
+   */
+  void Remove (WheelTimer *timer);
+
+  /**
+   * \brief Link a timer in the slot matching its expiration time.
+   * \param timer the timer
+   */
+  void Insert (WheelTimer *timer);
+  /**
+   * \brief Link a timer at the end of a slot.
+   * \param timer the timer
+   * \param level the level of the slot, or EXPIRED
+   * \param index the index of the slot in the level
+   */
+  void Link (WheelTimer *timer, uint8_t level, uint8_t index);
+  /**
+   * \brief Link an expired timer to the timers to invoke, which are kept
+   * in the order they have been armed.
+   * \param timer the timer
+   */
+  void LinkExpired (WheelTimer *timer);
+  /**
+   * \brief Unlink a timer from its slot.
+   * \param timer the timer
+   */
+  void Unlink (WheelTimer *timer);
+  /**
+   * \param level the level, or EXPIRED
+   * \param index the index of the slot in the level
+   * \returns the slot
+   */
+  Slot & GetSlot (uint8_t level, uint8_t index);
+
+  /**
+   * \brief Convert a time to a number of ticks.
+   * \param time the time
+   * \returns the tick containing the time
+   */
+  uint64_t GetTick (Time time) const;
+  /**
+   * \brief Find the next tick at which a timer may expire, or at which
+   * a slot of a higher level must be moved down.
+   * \param [out] tick the tick
+   * \param [out] cascade true if a slot of a higher level starts at tick
+   * \returns false if the wheel is empty
+   */
+  bool GetNextTick (uint64_t &tick, bool &cascade) const;
+  /**
+   * \brief Move the current tick forward, moving down the timers of the
+   * slots of the higher levels entered.
+   * \param tick the new current tick
+   */
+  void Advance (uint64_t tick);
+
+  /**
+   * \brief Invoke the expired timers and rearm the wheel.
+   *
+   * Events scheduled for a wakeup which has since been moved earlier
+   * are not cancelled, and are ignored here.
+   */
+  void Expire (void);
+  /**
+   * \brief Schedule the simulator event for the next tick of interest.
+   */
+  void ScheduleWakeup (void);
+  /**
+   * \brief Schedule the simulator event.
+   * \param time the absolute time of the event
+   */
+  void ScheduleWakeup (Time time);
+
+  Slot m_slots[LEVELS][SLOTS];  //!< slots of all the levels
+  uint64_t m_bitmap[LEVELS];    //!< non-empty slots of each level
+  Slot m_expired;               //!< timers being invoked
+  uint64_t m_tick;              //!< current tick
+  Time m_resolution;            //!< duration of a tick
+  uint32_t m_context;           //!< context of the events
+  uint32_t m_nTimers;           //!< number of running timers
+  uint64_t m_nextSequence;      //!< sequence number of the next timer armed
+  bool m_expiring;              //!< true while invoking the timers
+  bool m_wakeupPending;         //!< true if an event is pending at m_wakeupTime
+  Time m_wakeupTime;            //!< time of the pending event in the simulator
+};
+
+/**
+ * \ingroup timer
+ * \brief A timer which can be multiplexed on a TimerWheel.
+ *
+ * The interface is a subset of the one of Timer.  As long as no wheel
+ * is set, a WheelTimer schedules its own simulator event, exactly like
+ * a Timer.  Once a wheel is set, the timer is kept by the wheel.
+ *
+ * A running WheelTimer is always cancelled when it is destroyed.
+ */
+class WheelTimer
+{
+public:
+  WheelTimer ();
+  ~WheelTimer ();
+
+  /**
+   * \brief Set the wheel keeping the timer.
+   *
+   * The timer must not be running.
+   *
+   * \param wheel the wheel, or null to use simulator events
+   */
+  void SetWheel (Ptr<TimerWheel> wheel);
+  /**
+   * \returns the wheel keeping the timer, if any
+   */
+  Ptr<TimerWheel> GetWheel (void) const;
+
+  /**
+   * \tparam FN \deduced The type of the function.
+   * \param [in] fn the function
+   *
+   * Store this function in this timer for later use by Schedule.
+   */
+  template <typename FN>
+  void SetFunction (FN fn);
+  /**
+   * \tparam MEM_PTR \deduced Class method function type.
+   * \tparam OBJ_PTR \deduced Class type containing the function.
+   * \param [in] memPtr the member function pointer
+   * \param [in] objPtr the pointer to object
+   *
+   * Store this function and object in this timer for later use by Schedule.
+   */
+  template <typename MEM_PTR, typename OBJ_PTR>
+  void SetFunction (MEM_PTR memPtr, OBJ_PTR objPtr);
+  /**
+   * \tparam Ts \deduced Argument types
+   * \param [in] args arguments
+   *
+   * Store these arguments in this timer for later use by Schedule.
+   */
+  template <typename... Ts>
+  void SetArguments (Ts... args);
+
+  /**
+   * \param [in] delay The delay
+   *
+   * The next call to Schedule will schedule the timer with this delay.
+   */
+  void SetDelay (const Time &delay);
+  /**
+   * \returns The currently-configured delay for the next Schedule.
+   */
+  Time GetDelay (void) const;
+  /**
+   * \returns The amount of time left until this timer expires,
+   * or zero if it is not running.
+   */
+  Time GetDelayLeft (void) const;
+
+  /**
+   * Cancel the timer, if it is running.
+   */
+  void Cancel (void);
+  /**
+   * \returns \c true if there is no currently pending event.
+   */
+  bool IsExpired (void) const;
+  /**
+   * \returns \c true if there is a currently pending event.
+   */
+  bool IsRunning (void) const;
+
+  /**
+   * Schedule a new event using the currently-configured delay,
+   * function, and arguments.
+   */
+  void Schedule (void);
+  /**
+   * \param [in] delay the delay to use
+   *
+   * Schedule a new event using the specified delay (ignore the delay
+   * set by SetDelay), function, and arguments.
+   */
+  void Schedule (Time delay);
+
+private:
+  friend class TimerWheel;
+
+  /** Invoke the function of an expired timer. */
+  void Invoke (void);
+
+  /** Copy is not allowed. */
+  WheelTimer (const WheelTimer &);
+  /**
+   * Copy is not allowed.
+   * \returns this timer
+   */
+  WheelTimer & operator = (const WheelTimer &);
+
+  TimerImpl *m_impl;       //!< the bound function and arguments
+  Time m_delay;            //!< the delay configured by SetDelay
+  EventId m_event;         //!< the simulator event, when no wheel is used
+  Ptr<TimerWheel> m_wheel; //!< the wheel keeping the timer, if any
+  Time m_expiry;           //!< expiration time on the wheel
+  uint64_t m_tick;         //!< expiration tick on the wheel
+  uint64_t m_sequence;     //!< order in which the timer has been armed on the wheel
+  WheelTimer *m_prev;      //!< previous timer in the slot
+  WheelTimer *m_next;      //!< next timer in the slot
+  uint8_t m_level;         //!< level of the slot, EXPIRED or UNLINKED
+  uint8_t m_index;         //!< index of the slot in the level
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+#include "timer-impl.h"
+
+namespace ns3 {
+
+template <typename FN>
+void
+WheelTimer::SetFunction (FN fn)
+{
+  delete m_impl;
+  m_impl = MakeTimerImpl (fn);
+}
+
+template <typename MEM_PTR, typename OBJ_PTR>
+void
+WheelTimer::SetFunction (MEM_PTR memPtr, OBJ_PTR objPtr)
+{
+  delete m_impl;
+  m_impl = MakeTimerImpl (memPtr, objPtr);
+}
+
+template <typename... Ts>
+void
+WheelTimer::SetArguments (Ts... args)
+{
+  if (m_impl == 0)
+    {
+      NS_FATAL_ERROR ("You cannot set the arguments of a WheelTimer before setting its function.");
+      return;
+    }
+  m_impl->SetArgs (args...);
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
@@ -0,0 +1,335 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/timer-wheel.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup timer-tests
+ *  Check that the timers of a wheel expire at the exact time
+ */
+class TimerWheelExpiryTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelExpiryTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Function to invoke when a timer expires.
+   * \param [in] index The index of the timer.
+   */
+  void Expire (uint32_t index);
+
+  std::vector<Time> m_expected; //!< Expected expiration times
+  std::vector<Time> m_expired;  //!< Actual expiration times
+  std::vector<uint32_t> m_order; //!< Indexes of the timers, in expiration order
+};
+
+TimerWheelExpiryTestCase::TimerWheelExpiryTestCase ()
+  : TestCase ("Check the expiration times of the timers of a wheel")
+{}
+
+void
+TimerWheelExpiryTestCase::Expire (uint32_t index)
+{
+  m_expired[index] = Simulator::Now ();
+  m_order.push_back (index);
+}
+
+void
+TimerWheelExpiryTestCase::DoRun (void)
+{
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+  m_expected = { MicroSeconds (250), MicroSeconds (1300), MilliSeconds (70), Seconds (5),
+                 Seconds (5), Hours (10), MicroSeconds (1300)};
+  m_expired.assign (m_expected.size (), Seconds (-1));
+  std::vector<WheelTimer> timers (m_expected.size ());
+  for (uint32_t i = 0; i < timers.size (); i++)
+    {
+      timers[i].SetWheel (wheel);
+      timers[i].SetFunction (&TimerWheelExpiryTestCase::Expire, this);
+      timers[i].SetArguments (i);
+      timers[i].Schedule (m_expected[i]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (wheel->GetNTimers (), timers.size (), "Wrong number of timers");
+  NS_TEST_EXPECT_MSG_EQ (timers[3].GetDelayLeft (), Seconds (5), "Wrong delay left");
+
+  Simulator::Run ();
+
+  for (uint32_t i = 0; i < timers.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_expired[i], m_expected[i], "Timer " << i << " expired at the wrong time");
+      NS_TEST_EXPECT_MSG_EQ (timers[i].IsExpired (), true, "Timer " << i << " still running");
+    }
+  std::vector<uint32_t> order = { 0, 1, 6, 2, 3, 4, 5 };
+  NS_TEST_EXPECT_MSG_EQ ((m_order == order), true, "Timers expired in the wrong order");
+  NS_TEST_EXPECT_MSG_EQ (wheel->GetNTimers (), 0, "Wrong number of timers");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ *  Check that the timers of a wheel can be cancelled and re-armed
+ *  from anywhere, including from an expiring timer.
+ */
+class TimerWheelRearmTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelRearmTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Function to invoke when a timer expires.
+   * \param [in] index The index of the timer.
+   */
+  void Expire (uint32_t index);
+  /**
+   * Cancel a timer, and re-arm it if requested.
+   * \param [in] index The index of the timer.
+   * \param [in] delay The delay, or a negative value to leave the timer cancelled.
+   */
+  void Rearm (uint32_t index, Time delay);
+
+  static const uint32_t N_TIMERS = 500; //!< Number of timers
+  std::vector<WheelTimer> m_timers;     //!< The timers
+  std::vector<Time> m_expected;         //!< Expected expiration times
+  uint32_t m_rng;                       //!< State of the pseudo-random generator
+  uint32_t m_errors;                    //!< Number of timers expired at the wrong time
+  uint32_t m_nExpired;                  //!< Number of timers expired
+};
+
+TimerWheelRearmTestCase::TimerWheelRearmTestCase ()
+  : TestCase ("Check that the timers of a wheel can be cancelled and re-armed"),
+    m_timers (N_TIMERS)
+{}
+
+void
+TimerWheelRearmTestCase::Rearm (uint32_t index, Time delay)
+{
+  m_timers[index].Cancel ();
+  m_expected[index] = Seconds (-1);
+  if (!delay.IsNegative ())
+    {
+      m_timers[index].Schedule (delay);
+      m_expected[index] = Simulator::Now () + delay;
+    }
+}
+
+void
+TimerWheelRearmTestCase::Expire (uint32_t index)
+{
+  if (Simulator::Now () != m_expected[index])
+    {
+      m_errors++;
+    }
+  m_nExpired++;
+  // Shuffle the timers of a few other connections
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_rng = m_rng * 1103515245 + 12345;
+      uint32_t other = (m_rng >> 8) % N_TIMERS;
+      m_rng = m_rng * 1103515245 + 12345;
+      uint32_t delay = (m_rng >> 8) % 300000;
+      if (Simulator::Now () < Seconds (20))
+        {
+          Rearm (other, delay % 7 == 0 ? Seconds (-1) : MicroSeconds (delay * 13));
+        }
+    }
+}
+
+void
+TimerWheelRearmTestCase::DoRun (void)
+{
+  m_rng = 1;
+  m_errors = 0;
+  m_nExpired = 0;
+  m_expected.assign (N_TIMERS, Seconds (-1));
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+  for (uint32_t i = 0; i < N_TIMERS; i++)
+    {
+      m_timers[i].SetWheel (wheel);
+      m_timers[i].SetFunction (&TimerWheelRearmTestCase::Expire, this);
+      m_timers[i].SetArguments (i);
+      Rearm (i, MicroSeconds (i * 997));
+    }
+  // Cancel and re-arm from outside the timers, like an ACK clock would
+  for (uint32_t i = 0; i < N_TIMERS; i += 5)
+    {
+      Simulator::Schedule (MicroSeconds (i * 500), &TimerWheelRearmTestCase::Rearm, this, i, MilliSeconds (200));
+    }
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_GT (m_nExpired, N_TIMERS, "Too few timers expired");
+  NS_TEST_EXPECT_MSG_EQ (m_errors, 0, "Timers expired at the wrong time");
+  NS_TEST_EXPECT_MSG_EQ (wheel->GetNTimers (), 0, "Wrong number of timers");
+  for (uint32_t i = 0; i < N_TIMERS; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_timers[i].IsRunning (), false, "Timer " << i << " still running");
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ *  Check that the timers of a wheel expiring at the same time are invoked
+ *  in the order they have been armed, even when the first one has been
+ *  moved down from a higher level of the wheel.
+ */
+class TimerWheelOrderTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelOrderTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Function to invoke when a timer expires.
+   * \param [in] index The index of the timer.
+   */
+  void Expire (uint32_t index);
+
+  std::vector<uint32_t> m_order; //!< Indexes of the timers, in expiration order
+};
+
+TimerWheelOrderTestCase::TimerWheelOrderTestCase ()
+  : TestCase ("Check the order of the timers of a wheel expiring at the same time")
+{}
+
+void
+TimerWheelOrderTestCase::Expire (uint32_t index)
+{
+  m_order.push_back (index);
+}
+
+void
+TimerWheelOrderTestCase::DoRun (void)
+{
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+  std::vector<WheelTimer> timers (4);
+  for (uint32_t i = 0; i < timers.size (); i++)
+    {
+      timers[i].SetWheel (wheel);
+      timers[i].SetFunction (&TimerWheelOrderTestCase::Expire, this);
+      timers[i].SetArguments (i);
+    }
+  // The first timer is beyond the lowest level (64 slots of 1 ms) when
+  // armed, and is only moved down at 64 ms.  The wheel moves forward at
+  // 40 ms, with the last timer, so that the second and third timers are
+  // armed directly in the lowest level.
+  void (WheelTimer::*schedule)(Time) = &WheelTimer::Schedule;
+  timers[0].Schedule (MilliSeconds (100));
+  timers[3].Schedule (MilliSeconds (40));
+  Simulator::Schedule (MilliSeconds (50), schedule, &timers[1], MilliSeconds (50));
+  Simulator::Schedule (MilliSeconds (80), schedule, &timers[2], MilliSeconds (20));
+
+  Simulator::Run ();
+
+  std::vector<uint32_t> order = { 3, 0, 1, 2 };
+  NS_TEST_EXPECT_MSG_EQ ((m_order == order), true, "Timers expired in the wrong order");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ *  Check that a timer without wheel behaves like a Timer
+ */
+class WheelTimerNoWheelTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  WheelTimerNoWheelTestCase ();
+  virtual void DoRun (void);
+  /** Function to invoke when the timer expires. */
+  void Expire (void);
+
+  Time m_expired; //!< Expiration time
+};
+
+WheelTimerNoWheelTestCase::WheelTimerNoWheelTestCase ()
+  : TestCase ("Check a timer without wheel")
+{}
+
+void
+WheelTimerNoWheelTestCase::Expire (void)
+{
+  m_expired = Simulator::Now ();
+}
+
+void
+WheelTimerNoWheelTestCase::DoRun (void)
+{
+  WheelTimer timer;
+  timer.SetFunction (&WheelTimerNoWheelTestCase::Expire, this);
+  timer.SetDelay (MilliSeconds (3));
+  timer.Schedule ();
+  NS_TEST_EXPECT_MSG_EQ (timer.IsRunning (), true, "Timer not running");
+  Simulator::Schedule (MilliSeconds (1), &WheelTimer::Cancel, &timer);
+  Simulator::Schedule (MilliSeconds (2), static_cast<void (WheelTimer::*)(void)> (&WheelTimer::Schedule), &timer);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_expired, MilliSeconds (5), "Timer expired at the wrong time");
+  NS_TEST_EXPECT_MSG_EQ (timer.IsExpired (), true, "Timer still running");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ *  TimerWheel test suite
+ */
+class TimerWheelTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  TimerWheelTestSuite ()
+    : TestSuite ("timer-wheel", UNIT)
+  {
+    AddTestCase (new TimerWheelExpiryTestCase ());
+    AddTestCase (new TimerWheelRearmTestCase ());
+    AddTestCase (new TimerWheelOrderTestCase ());
+    AddTestCase (new WheelTimerNoWheelTestCase ());
+  }
+};
+
+/**
+ * \ingroup timer-tests
+ * TimerWheelTestSuite instance variable.
+ */
+static TimerWheelTestSuite g_timerWheelTestSuite;
+
+
+}    // namespace tests
+
+}    // namespace ns3
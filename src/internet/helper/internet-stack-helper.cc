@@ -28,6 +28,7 @@
 #include "ns3/packet-socket-factory.h"
 #include "ns3/config.h"
 #include "ns3/simulator.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/string.h"
 #include "ns3/net-device.h"
 #include "ns3/callback.h"
@@ -107,7 +108,8 @@ InternetStackHelper::InternetStackHelper ()
     m_ipv4Enabled (true),
     m_ipv6Enabled (true),
     m_ipv4ArpJitterEnabled (true),
-    m_ipv6NsRsJitterEnabled (true)
+    m_ipv6NsRsJitterEnabled (true),
+    m_timerWheelEnabled (false)
 
 {
   Initialize ();
@@ -143,6 +145,7 @@ InternetStackHelper::InternetStackHelper (const InternetStackHelper &o)
   m_tcpFactory = o.m_tcpFactory;
   m_ipv4ArpJitterEnabled = o.m_ipv4ArpJitterEnabled;
   m_ipv6NsRsJitterEnabled = o.m_ipv6NsRsJitterEnabled;
+  m_timerWheelEnabled = o.m_timerWheelEnabled;
 }
 
 InternetStackHelper &
@@ -168,6 +171,7 @@ InternetStackHelper::Reset (void)
   m_ipv6Enabled = true;
   m_ipv4ArpJitterEnabled = true;
   m_ipv6NsRsJitterEnabled = true;
+  m_timerWheelEnabled = false;
   Initialize ();
 }
 
@@ -206,6 +210,11 @@ void InternetStackHelper::SetIpv6NsRsJitter (bool enable)
   m_ipv6NsRsJitterEnabled = enable;
 }
 
+void InternetStackHelper::SetTimerWheel (bool enable)
+{
+  m_timerWheelEnabled = enable;
+}
+
 int64_t
 InternetStackHelper::AssignStreams (NodeContainer c, int64_t stream)
 {
@@ -229,6 +238,16 @@ InternetStackHelper::AssignStreams (NodeContainer c, int64_t stream)
           NS_ASSERT (fe);  // should always exist in the demux
           currentStream += fe->AssignStreams (currentStream);
         }
+      else
+        {
+          // the extensions of a node installed with InstallBulk may not be
+          // created yet, their stream is then applied when they are
+          Ptr<Ipv6L3Protocol> ipv6L3Protocol = node->GetObject<Ipv6L3Protocol> ();
+          if (ipv6L3Protocol != 0)
+            {
+              currentStream += ipv6L3Protocol->AssignDeferredExtensionStreams (currentStream);
+            }
+        }
       Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
       if (ipv4 != 0)
         {
@@ -273,6 +292,124 @@ InternetStackHelper::Install (NodeContainer c) const
     }
 }
 
+void
+InternetStackHelper::InstallBulk (NodeContainer c) const
+{
+  NS_LOG_FUNCTION (this << c.GetN ());
+
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      if (m_ipv4Enabled && (*i)->GetObject<Ipv4> () != 0)
+        {
+          NS_FATAL_ERROR ("InternetStackHelper::InstallBulk (): Aggregating "
+                          "an InternetStack to a node with an existing Ipv4 object");
+          return;
+        }
+      if (m_ipv6Enabled && (*i)->GetObject<Ipv6> () != 0)
+        {
+          NS_FATAL_ERROR ("InternetStackHelper::InstallBulk (): Aggregating "
+                          "an InternetStack to a node with an existing Ipv6 object");
+          return;
+        }
+    }
+  if (!m_ipv4Enabled && !m_ipv6Enabled)
+    {
+      return;
+    }
+
+  // The factories are set up once, in the aggregation order of
+  // Install (Ptr<Node>).  The jitters are given at construction time,
+  // each object still gets its own random variable.
+  std::vector<ObjectFactory> factories;
+  if (m_ipv4Enabled)
+    {
+      factories.push_back (ObjectFactory ("ns3::ArpL3Protocol"));
+      if (m_ipv4ArpJitterEnabled == false)
+        {
+          factories.back ().Set ("RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+        }
+      factories.push_back (ObjectFactory ("ns3::Ipv4L3Protocol"));
+      factories.push_back (ObjectFactory ("ns3::Icmpv4L4Protocol"));
+    }
+  if (m_ipv6Enabled)
+    {
+      factories.push_back (ObjectFactory ("ns3::Ipv6L3Protocol"));
+      factories.push_back (ObjectFactory ("ns3::Icmpv6L4Protocol"));
+      if (m_ipv6NsRsJitterEnabled == false)
+        {
+          factories.back ().Set ("SolicitationJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+        }
+    }
+  factories.push_back (ObjectFactory ("ns3::TrafficControlLayer"));
+  factories.push_back (ObjectFactory ("ns3::UdpL4Protocol"));
+  factories.push_back (m_tcpFactory);
+
+  // The objects are created one protocol at a time, for all the nodes:
+  // the objects of protocol k for node i are at k * n + i.
+  uint32_t n = c.GetN ();
+  std::vector<Ptr<Object> > objects;
+  objects.reserve (factories.size () * n);
+  for (std::vector<ObjectFactory>::const_iterator f = factories.begin (); f != factories.end (); ++f)
+    {
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          objects.push_back (f->Create<Object> ());
+        }
+    }
+
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ptr<Node> node = c.Get (i);
+      std::size_t k = 0;
+
+      if (m_timerWheelEnabled && node->GetObject<TimerWheel> () == 0)
+        {
+          Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+          wheel->SetContext (node->GetId ());
+          node->AggregateObject (wheel);
+        }
+
+      if (m_ipv4Enabled)
+        {
+          // ARP, IPv4 and ICMPv4
+          for (; k < 3; ++k)
+            {
+              node->AggregateObject (objects[k * n + i]);
+            }
+          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+          ipv4->SetRoutingProtocol (m_routing->Create (node));
+        }
+
+      if (m_ipv6Enabled)
+        {
+          // IPv6 and ICMPv6
+          for (std::size_t last = k + 2; k < last; ++k)
+            {
+              node->AggregateObject (objects[k * n + i]);
+            }
+          Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol> ();
+          ipv6->SetRoutingProtocol (m_routingv6->Create (node));
+          ipv6->DeferExtensionsAndOptions ();
+        }
+
+      // traffic control, UDP and TCP
+      for (; k < factories.size (); ++k)
+        {
+          node->AggregateObject (objects[k * n + i]);
+        }
+      node->AggregateObject (CreateObject<PacketSocketFactory> ());
+
+      if (m_ipv4Enabled)
+        {
+          Ptr<ArpL3Protocol> arp = node->GetObject<ArpL3Protocol> ();
+          Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+          NS_ASSERT (arp);
+          NS_ASSERT (tc);
+          arp->SetTrafficControl (tc);
+        }
+    }
+}
+
 void 
 InternetStackHelper::InstallAll (void) const
 {
@@ -291,6 +428,13 @@ InternetStackHelper::CreateAndAggregateObjectFromTypeId (Ptr<Node> node, const s
 void
 InternetStackHelper::Install (Ptr<Node> node) const
 {
+  if (m_timerWheelEnabled && node->GetObject<TimerWheel> () == 0)
+    {
+      Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+      wheel->SetContext (node->GetId ());
+      node->AggregateObject (wheel);
+    }
+
   if (m_ipv4Enabled)
     {
       if (node->GetObject<Ipv4> () != 0)
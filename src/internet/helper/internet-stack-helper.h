@@ -167,6 +167,26 @@ public:
    */
   void Install (NodeContainer c) const;
 
+  /**
+   * For each node in the input container, aggregate the same stack as
+   * Install (NodeContainer), building all the stacks in one pass.
+   *
+   * The object factories and the attribute values common to all the
+   * stacks are set up once, the objects of each protocol are created in a
+   * contiguous batch, and the IPv6 extensions and options of a node are
+   * only created when its first IPv6 interface is added (see
+   * Ipv6L3Protocol::DeferExtensionsAndOptions).  This is meant for large
+   * topologies, whose setup time is dominated by the stack installation.
+   *
+   * As the objects are created in another order, the random variables get
+   * other automatic stream numbers than with Install (NodeContainer): use
+   * AssignStreams for the same random numbers with either method.
+   *
+   * \param c NodeContainer that holds the set of nodes on which to install the
+   * new stacks.
+   */
+  void InstallBulk (NodeContainer c) const;
+
   /**
    * Aggregate IPv4, IPv6, UDP, and TCP stacks to all nodes in the simulation
    */
@@ -223,6 +243,17 @@ public:
    */
   void SetIpv6NsRsJitter (bool enable);
 
+  /**
+   * \brief Enable/disable the aggregation of a TimerWheel to the nodes.
+   *
+   * When enabled, the TCP sockets and the ARP and NDISC caches of the
+   * nodes keep their timers in the TimerWheel of the node, which reduces
+   * the number of events scheduled and cancelled in the simulator.
+   *
+   * \param enable enable state
+   */
+  void SetTimerWheel (bool enable);
+
   /**
   * Assign a fixed random variable stream number to the random variables
   * used by this model.  Return the number of streams (possibly zero) that
@@ -369,6 +400,11 @@ private:
    * \brief IPv6 IPv6 NS and RS Jitter state (enabled/disabled) ?
    */
   bool m_ipv6NsRsJitterEnabled;
+
+  /**
+   * \brief TimerWheel aggregation state (enabled/disabled) ?
+   */
+  bool m_timerWheelEnabled;
 };
 
 } // namespace ns3
@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/channel-list.h"
+#include "ns3/bridge-net-device.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ndisc-cache.h"
+#include "neighbor-cache-helper.h"
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NeighborCacheHelper");
+
+/**
+ * \brief Find the bridge a device is a port of, if any.
+ * \param device the device
+ * \return the bridge, or null
+ */
+static Ptr<BridgeNetDevice>
+GetBridge (Ptr<NetDevice> device)
+{
+  Ptr<Node> node = device->GetNode ();
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<BridgeNetDevice> bridge = DynamicCast<BridgeNetDevice> (node->GetDevice (i));
+      if (bridge)
+        {
+          for (uint32_t j = 0; j < bridge->GetNBridgePorts (); j++)
+            {
+              if (bridge->GetBridgePort (j) == device)
+                {
+                  return bridge;
+                }
+            }
+        }
+    }
+  return 0;
+}
+
+NeighborCacheHelper::NeighborCacheHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+NeighborCacheHelper::Domain
+NeighborCacheHelper::CollectDomain (Ptr<Channel> channel, std::set<uint32_t> &visited) const
+{
+  NS_LOG_FUNCTION (this << channel);
+
+  Domain domain;
+  std::set<Ptr<BridgeNetDevice> > bridges;
+  std::vector<Ptr<Channel> > channels (1, channel);
+
+  while (!channels.empty ())
+    {
+      Ptr<Channel> ch = channels.back ();
+      channels.pop_back ();
+      if (!visited.insert (ch->GetId ()).second)
+        {
+          continue;
+        }
+
+      for (std::size_t i = 0; i < ch->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> device = ch->GetDevice (i);
+          Ptr<BridgeNetDevice> bridge = GetBridge (device);
+          if (bridge)
+            {
+              // the bridge is the interface, and its other ports extend the domain
+              if (!bridges.insert (bridge).second)
+                {
+                  continue;
+                }
+              device = bridge;
+              for (uint32_t j = 0; j < bridge->GetNBridgePorts (); j++)
+                {
+                  Ptr<Channel> port = bridge->GetBridgePort (j)->GetChannel ();
+                  if (port)
+                    {
+                      channels.push_back (port);
+                    }
+                }
+            }
+
+          Neighbor neighbor;
+          neighbor.device = device;
+          Ptr<Ipv4L3Protocol> ipv4 = device->GetNode ()->GetObject<Ipv4L3Protocol> ();
+          int32_t ifIndex = (ipv4 ? ipv4->GetInterfaceForDevice (device) : -1);
+          if (ifIndex >= 0)
+            {
+              Ptr<Ipv4Interface> iface = ipv4->GetInterface (ifIndex);
+              for (uint32_t j = 0; j < iface->GetNAddresses (); j++)
+                {
+                  neighbor.ipv4Addresses.push_back (iface->GetAddress (j).GetLocal ());
+                }
+            }
+          Ptr<Ipv6L3Protocol> ipv6 = device->GetNode ()->GetObject<Ipv6L3Protocol> ();
+          ifIndex = (ipv6 ? ipv6->GetInterfaceForDevice (device) : -1);
+          if (ifIndex >= 0)
+            {
+              Ptr<Ipv6Interface> iface = ipv6->GetInterface (ifIndex);
+              for (uint32_t j = 0; j < iface->GetNAddresses (); j++)
+                {
+                  neighbor.ipv6Addresses.push_back (iface->GetAddress (j).GetAddress ());
+                }
+            }
+          if (!neighbor.ipv4Addresses.empty () || !neighbor.ipv6Addresses.empty ())
+            {
+              domain.push_back (neighbor);
+            }
+        }
+    }
+  return domain;
+}
+
+void
+NeighborCacheHelper::PopulateCaches (const Domain &domain, const Neighbor &self) const
+{
+  NS_LOG_FUNCTION (this << self.device);
+
+  Ptr<Node> node = self.device->GetNode ();
+  Ptr<ArpCache> arpCache;
+  Ptr<NdiscCache> ndiscCache;
+  Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol> ();
+  if (!self.ipv4Addresses.empty ())
+    {
+      arpCache = ipv4->GetInterface (ipv4->GetInterfaceForDevice (self.device))->GetArpCache ();
+    }
+  Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol> ();
+  if (!self.ipv6Addresses.empty ())
+    {
+      ndiscCache = ipv6->GetInterface (ipv6->GetInterfaceForDevice (self.device))->GetNdiscCache ();
+    }
+
+  for (Domain::const_iterator it = domain.begin (); it != domain.end (); it++)
+    {
+      if (it->device == self.device)
+        {
+          continue;
+        }
+      Address mac = it->device->GetAddress ();
+      if (arpCache)
+        {
+          for (std::vector<Ipv4Address>::const_iterator a = it->ipv4Addresses.begin (); a != it->ipv4Addresses.end (); a++)
+            {
+              ArpCache::Entry *entry = arpCache->Lookup (*a);
+              if (entry == 0)
+                {
+                  entry = arpCache->Add (*a);
+                }
+              entry->SetMacAddress (mac);
+              entry->MarkPermanent ();
+            }
+        }
+      if (ndiscCache)
+        {
+          for (std::vector<Ipv6Address>::const_iterator a = it->ipv6Addresses.begin (); a != it->ipv6Addresses.end (); a++)
+            {
+              NdiscCache::Entry *entry = ndiscCache->Lookup (*a);
+              if (entry == 0)
+                {
+                  entry = ndiscCache->Add (*a);
+                }
+              entry->SetMacAddress (mac);
+              entry->MarkPermanent ();
+            }
+        }
+    }
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::set<uint32_t> visited;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); i++)
+    {
+      if (visited.find ((*i)->GetId ()) != visited.end ())
+        {
+          continue;
+        }
+      Domain domain = CollectDomain (*i, visited);
+      for (Domain::const_iterator it = domain.begin (); it != domain.end (); it++)
+        {
+          PopulateCaches (domain, *it);
+        }
+    }
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (Ptr<Channel> channel) const
+{
+  NS_LOG_FUNCTION (this << channel);
+  std::set<uint32_t> visited;
+  Domain domain = CollectDomain (channel, visited);
+  for (Domain::const_iterator it = domain.begin (); it != domain.end (); it++)
+    {
+      PopulateCaches (domain, *it);
+    }
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (const NetDeviceContainer &c) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // the domains are collected once, whatever the number of devices in each
+  std::vector<Domain> domains;
+  std::map<uint32_t, std::size_t> channelDomain;
+
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); i++)
+    {
+      Ptr<NetDevice> device = *i;
+      Ptr<BridgeNetDevice> bridge = DynamicCast<BridgeNetDevice> (device);
+      Ptr<Channel> channel;
+      if (bridge && bridge->GetNBridgePorts () > 0)
+        {
+          channel = bridge->GetBridgePort (0)->GetChannel ();
+        }
+      else
+        {
+          channel = device->GetChannel ();
+        }
+      if (!channel)
+        {
+          continue;
+        }
+
+      std::map<uint32_t, std::size_t>::const_iterator d = channelDomain.find (channel->GetId ());
+      if (d == channelDomain.end ())
+        {
+          std::set<uint32_t> domainChannels;
+          domains.push_back (CollectDomain (channel, domainChannels));
+          for (std::set<uint32_t>::const_iterator ch = domainChannels.begin (); ch != domainChannels.end (); ch++)
+            {
+              channelDomain[*ch] = domains.size () - 1;
+            }
+          d = channelDomain.find (channel->GetId ());
+        }
+
+      const Domain &domain = domains[d->second];
+      for (Domain::const_iterator it = domain.begin (); it != domain.end (); it++)
+        {
+          if (it->device == device)
+            {
+              PopulateCaches (domain, *it);
+              break;
+            }
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NEIGHBOR_CACHE_HELPER_H
+#define NEIGHBOR_CACHE_HELPER_H
+
+#include <set>
+#include <vector>
+#include "ns3/channel.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Helper filling the ARP and NDISC caches with permanent entries.
+ *
+ * For each broadcast domain (a channel, or the channels connected by
+ * bridges), the helper adds to the ARP cache (resp. NDISC cache) of each
+ * IPv4 (resp. IPv6) interface a permanent entry for each address of the
+ * other interfaces of the domain. Address resolution is then never
+ * performed between these interfaces.
+ *
+ * The caches must be populated after the addresses have been assigned;
+ * addresses assigned afterwards are resolved as usual.
+ */
+class NeighborCacheHelper
+{
+public:
+  NeighborCacheHelper ();
+
+  /**
+   * \brief Populate the caches of all the interfaces of all the channels.
+   */
+  void PopulateNeighborCache (void) const;
+
+  /**
+   * \brief Populate the caches of the interfaces of the broadcast domain
+   * containing a channel.
+   * \param channel the channel
+   */
+  void PopulateNeighborCache (Ptr<Channel> channel) const;
+
+  /**
+   * \brief Populate the caches of the interfaces of some devices, with the
+   * addresses of their broadcast domains.
+   * \param c the devices
+   */
+  void PopulateNeighborCache (const NetDeviceContainer &c) const;
+
+private:
+  /// An interface of a broadcast domain
+  struct Neighbor
+  {
+    Ptr<NetDevice> device;                 //!< the device
+    std::vector<Ipv4Address> ipv4Addresses; //!< the IPv4 addresses of the interface
+    std::vector<Ipv6Address> ipv6Addresses; //!< the IPv6 addresses of the interface
+  };
+
+  /// The interfaces of a broadcast domain
+  typedef std::vector<Neighbor> Domain;
+
+  /**
+   * \brief Collect the interfaces of the broadcast domain containing a channel.
+   * \param channel the channel
+   * \param [in,out] visited the ids of the channels already visited, updated
+   * with the channels of the domain
+   * \return the interfaces of the domain
+   */
+  Domain CollectDomain (Ptr<Channel> channel, std::set<uint32_t> &visited) const;
+
+  /**
+   * \brief Add the addresses of the other interfaces of a domain to the
+   * caches of an interface.
+   * \param domain the domain
+   * \param self the interface, in the domain
+   */
+  void PopulateCaches (const Domain &domain, const Neighbor &self) const;
+};
+
+} // namespace ns3
+
+#endif /* NEIGHBOR_CACHE_HELPER_H */
@@ -89,6 +89,7 @@ ArpCache::ArpCache ()
     m_interface (0)
 {
   NS_LOG_FUNCTION (this);
+  m_waitReplyTimer.SetFunction (&ArpCache::HandleWaitReplyTimeout, this);
 }
 
 ArpCache::~ArpCache ()
@@ -116,6 +117,10 @@ ArpCache::SetDevice (Ptr<NetDevice> device, Ptr<Ipv4Interface> interface)
   NS_LOG_FUNCTION (this << device << interface);
   m_device = device;
   m_interface = interface;
+  if (device->GetNode () != 0)
+    {
+      m_waitReplyTimer.SetWheel (device->GetNode ()->GetObject<TimerWheel> ());
+    }
 }
 
 Ptr<NetDevice>
@@ -186,8 +191,7 @@ ArpCache::StartWaitReplyTimer (void)
     {
       NS_LOG_LOGIC ("Starting WaitReplyTimer at " << Simulator::Now () << " for " <<
                     m_waitReplyTimeout);
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
+      m_waitReplyTimer.Schedule (m_waitReplyTimeout);
     }
 }
 
@@ -197,46 +201,46 @@ ArpCache::HandleWaitReplyTimeout (void)
   NS_LOG_FUNCTION (this);
   ArpCache::Entry* entry;
   bool restartWaitReplyTimer = false;
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  // only the entries waiting for a reply are visited; MarkDead removes
+  // the current entry from the list
+  std::list<Entry *>::iterator next;
+  for (std::list<Entry *>::iterator i = m_waitReplyEntries.begin (); i != m_waitReplyEntries.end (); i = next)
     {
-      entry = (*i).second;
-      if (entry != 0 && entry->IsWaitReply ())
+      next = std::next (i);
+      entry = *i;
+      NS_ASSERT (entry->IsWaitReply ());
+      if (entry->GetRetries () < m_maxRetries)
         {
-          if (entry->GetRetries () < m_maxRetries)
-            {
-              NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
-                            ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
-                            " expired -- retransmitting arp request since retries = " <<
-                            entry->GetRetries ());
-              m_arpRequestCallback (this, entry->GetIpv4Address ());
-              restartWaitReplyTimer = true;
-              entry->IncrementRetries ();
-            }
-          else
+          NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
+                        ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
+                        " expired -- retransmitting arp request since retries = " <<
+                        entry->GetRetries ());
+          m_arpRequestCallback (this, entry->GetIpv4Address ());
+          restartWaitReplyTimer = true;
+          entry->IncrementRetries ();
+        }
+      else
+        {
+          NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
+                        ", wait reply for " << entry->GetIpv4Address () <<
+                        " expired -- drop since max retries exceeded: " <<
+                        entry->GetRetries ());
+          entry->MarkDead ();
+          entry->ClearRetries ();
+          Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
+          while (pending.first != 0)
             {
-              NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
-                            ", wait reply for " << entry->GetIpv4Address () <<
-                            " expired -- drop since max retries exceeded: " <<
-                            entry->GetRetries ());
-              entry->MarkDead ();
-              entry->ClearRetries ();
-              Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
-              while (pending.first != 0)
-                {
-                  // add the Ipv4 header for tracing purposes
-                  pending.first->AddHeader (pending.second);
-                  m_dropTrace (pending.first);
-                  pending = entry->DequeuePending ();
-                }
+              // add the Ipv4 header for tracing purposes
+              pending.first->AddHeader (pending.second);
+              m_dropTrace (pending.first);
+              pending = entry->DequeuePending ();
             }
         }
-
     }
   if (restartWaitReplyTimer)
     {
       NS_LOG_LOGIC ("Restarting WaitReplyTimer at " << Simulator::Now ().GetSeconds ());
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
+      m_waitReplyTimer.Schedule (m_waitReplyTimeout);
     }
 }
 
@@ -249,6 +253,7 @@ ArpCache::Flush (void)
       delete (*i).second;
     }
   m_arpCache.erase (m_arpCache.begin (), m_arpCache.end ());
+  m_waitReplyEntries.clear ();
   if (m_waitReplyTimer.IsRunning ())
     {
       NS_LOG_LOGIC ("Stopping WaitReplyTimer at " << Simulator::Now ().GetSeconds () << " due to ArpCache flush");
@@ -343,15 +348,14 @@ ArpCache::Remove (ArpCache::Entry *entry)
 {
   NS_LOG_FUNCTION (this << entry);
   
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++)
+  CacheI i = m_arpCache.find (entry->GetIpv4Address ());
+  if (i != m_arpCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_arpCache.erase (i);
-          entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
-          delete entry;
-          return;
-        }
+      m_arpCache.erase (i);
+      entry->LeaveWaitReply ();
+      entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
+      delete entry;
+      return;
     }
   NS_LOG_WARN ("Entry not found in this ARP Cache");
 }
@@ -396,6 +400,7 @@ ArpCache::Entry::MarkDead (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_state == ALIVE || m_state == WAIT_REPLY || m_state == DEAD);
+  LeaveWaitReply ();
   m_state = DEAD;
   ClearRetries ();
   UpdateSeen ();
@@ -405,6 +410,7 @@ ArpCache::Entry::MarkAlive (Address macAddress)
 {
   NS_LOG_FUNCTION (this << macAddress);
   NS_ASSERT (m_state == WAIT_REPLY);
+  LeaveWaitReply ();
   m_macAddress = macAddress;
   m_state = ALIVE;
   ClearRetries ();
@@ -416,6 +422,7 @@ ArpCache::Entry::MarkPermanent (void)
   NS_LOG_FUNCTION (this << m_macAddress);
   NS_ASSERT (!m_macAddress.IsInvalid ());
 
+  LeaveWaitReply ();
   m_state = PERMANENT;
   ClearRetries ();
   UpdateSeen ();
@@ -445,6 +452,7 @@ ArpCache::Entry::MarkWaitReply (Ipv4PayloadHeaderPair waiting)
   NS_ASSERT_MSG (waiting.first, "Can not add a null packet to the ARP queue");
 
   m_state = WAIT_REPLY;
+  m_waitReplyPosition = m_arp->m_waitReplyEntries.insert (m_arp->m_waitReplyEntries.end (), this);
   m_pending.push_back (waiting);
   UpdateSeen ();
   m_arp->StartWaitReplyTimer ();
@@ -474,6 +482,15 @@ ArpCache::Entry::SetIpv4Address (Ipv4Address destination)
   NS_LOG_FUNCTION (this << destination);
   m_ipv4Address = destination;
 }
+void
+ArpCache::Entry::LeaveWaitReply (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == WAIT_REPLY)
+    {
+      m_arp->m_waitReplyEntries.erase (m_waitReplyPosition);
+    }
+}
 Time
 ArpCache::Entry::GetTimeout (void) const
 {
@@ -26,6 +26,7 @@
 #include "ns3/callback.h"
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/net-device.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/address.h"
@@ -284,6 +285,8 @@ public:
     void UpdateSeen (void);
 
 private:
+    friend class ArpCache;
+
     /**
      * \brief ARP cache entry states
      */
@@ -299,6 +302,11 @@ private:
      * \returns the entry timeout
      */
     Time GetTimeout (void) const;
+    /**
+     * \brief Remove the entry from the list of entries waiting for a
+     * reply, if it is in WAIT_REPLY state
+     */
+    void LeaveWaitReply (void);
 
     ArpCache *m_arp; //!< pointer to the ARP cache owning the entry
     ArpCacheEntryState_e m_state; //!< state of the entry
@@ -307,6 +315,7 @@ private:
     Ipv4Address m_ipv4Address; //!< entry's IP address
     std::list<Ipv4PayloadHeaderPair> m_pending; //!< list of pending packets for the entry's IP
     uint32_t m_retries; //!< rerty counter
+    std::list<Entry *>::iterator m_waitReplyPosition; //!< position in the list of entries waiting for a reply
   };
 
 private:
@@ -326,7 +335,7 @@ private:
   Time m_aliveTimeout; //!< cache alive state timeout
   Time m_deadTimeout; //!< cache dead state timeout
   Time m_waitReplyTimeout; //!< cache reply state timeout
-  EventId m_waitReplyTimer;  //!< cache alive state timer
+  WheelTimer m_waitReplyTimer;  //!< cache alive state timer
   Callback<void, Ptr<const ArpCache>, Ipv4Address> m_arpRequestCallback;  //!< reply timeout callback
   uint32_t m_maxRetries; //!< max retries for a resolution
 
@@ -338,6 +347,7 @@ private:
   void HandleWaitReplyTimeout (void);
   uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
   Cache m_arpCache; //!< the ARP cache
+  std::list<Entry *> m_waitReplyEntries; //!< the entries in WAIT_REPLY state, scanned by HandleWaitReplyTimeout
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
 
@@ -16,7 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
-#include <list>
+#include <map>
 #include "ns3/abort.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
@@ -174,16 +174,15 @@ public:
   NetworkState m_netTable[N_BITS]; //!< the available networks
 
   /**
-   * \brief This class holds the allocated addresses
+   * \brief The blocks of allocated addresses: the highest address of
+   * each block, by lowest address.
+   *
+   * The blocks are disjoint, so the block that may contain an address is
+   * found in logarithmic time.
    */
-  class Entry
-  {
-public:
-    uint32_t addrLow;  //!< the lowest allocated address
-    uint32_t addrHigh; //!< the highest allocated address
-  };
+  typedef std::map<uint32_t, uint32_t> Entries;
 
-  std::list<Entry> m_entries; //!< contained of allocated addresses
+  Entries m_entries; //!< contained of allocated addresses
   bool m_test; //!< test mode (if true)
 };
 
@@ -366,18 +365,24 @@ Ipv4AddressGeneratorImpl::AddAllocated (const Ipv4Address address)
   uint32_t addr = address.Get ();
 
   NS_ABORT_MSG_UNLESS (addr, "Ipv4AddressGeneratorImpl::Add(): Allocating the broadcast address is not a good idea"); 
- 
-  std::list<Entry>::iterator i;
 
-  for (i = m_entries.begin (); i != m_entries.end (); ++i)
+//
+// Find the first block above the new address, and the block below it, which
+// is the only one that can contain the new address.
+//
+  Entries::iterator next = m_entries.upper_bound (addr);
+  Entries::iterator prev = m_entries.end ();
+  if (next != m_entries.begin ())
     {
-      NS_LOG_LOGIC ("examine entry: " << Ipv4Address ((*i).addrLow) << 
-                    " to " << Ipv4Address ((*i).addrHigh));
+      prev = next;
+      --prev;
+      NS_LOG_LOGIC ("examine entry: " << Ipv4Address (prev->first) <<
+                    " to " << Ipv4Address (prev->second));
 //
 // First things first.  Is there an address collision -- that is, does the
 // new address fall in a previously allocated block of addresses.
 //
-      if (addr >= (*i).addrLow && addr <= (*i).addrHigh)
+      if (addr <= prev->second)
         {
           NS_LOG_LOGIC ("Ipv4AddressGeneratorImpl::Add(): Address Collision: " << Ipv4Address (addr)); 
           if (!m_test) 
@@ -387,62 +392,32 @@ Ipv4AddressGeneratorImpl::AddAllocated (const Ipv4Address address)
           return false;
         }
 //
-// If the new address is less than the lowest address in the current block,
-// and can't be merged into to the current block, then insert it as a new
-// block before the current block.
+// If the new address fits at the end of the block below, just extend this
+// block by one address.  We expect that completely filled network ranges
+// will be a fairly rare occurrence, so we don't worry about collapsing
+// address range blocks.
 //
-      if (addr < (*i).addrLow - 1)
+      if (addr == prev->second + 1)
         {
-          break;
-        }
-//
-// If the new address fits at the end of the block, look ahead to the next 
-// block and make sure it's not a collision there.  If we won't overlap, then
-// just extend the current block by one address.  We expect that completely
-// filled network ranges will be a fairly rare occurrence, so we don't worry
-// about collapsing address range blocks.
-// 
-      if (addr == (*i).addrHigh + 1)
-        {
-          std::list<Entry>::iterator j = i;
-          ++j;
-
-          if (j != m_entries.end ())
-            {
-              if (addr == (*j).addrLow)
-                {
-                  NS_LOG_LOGIC ("Ipv4AddressGeneratorImpl::Add(): "
-                                "Address Collision: " << Ipv4Address (addr));
-                  if (!m_test)
-                    {
-                      NS_FATAL_ERROR ("Ipv4AddressGeneratorImpl::Add(): Address Collision: " << Ipv4Address (addr));
-                    }
-                  return false;
-                }
-            }
-
           NS_LOG_LOGIC ("New addrHigh = " << Ipv4Address (addr));
-          (*i).addrHigh = addr;
+          prev->second = addr;
           return true;
         }
+    }
 //
-// If we get here, we know that the next lower block of addresses couldn't 
-// have been extended to include this new address since the code immediately 
-// above would have been executed and that next lower block extended upward.
-// So we know it's safe to extend the current block down to include the new
-// address.
+// Otherwise, if the new address fits at the beginning of the block above,
+// extend this block down to include the new address.
 //
-      if (addr == (*i).addrLow - 1)
-        {
-          NS_LOG_LOGIC ("New addrLow = " << Ipv4Address (addr));
-          (*i).addrLow = addr;
-          return true;
-        }
+  if (next != m_entries.end () && addr == next->first - 1)
+    {
+      NS_LOG_LOGIC ("New addrLow = " << Ipv4Address (addr));
+      uint32_t addrHigh = next->second;
+      m_entries.erase (next++);
+      m_entries.insert (next, std::make_pair (addr, addrHigh));
+      return true;
     }
 
-  Entry entry;
-  entry.addrLow = entry.addrHigh = addr;
-  m_entries.insert (i, entry);
+  m_entries.insert (next, std::make_pair (addr, addr));
   return true;
 }
 
@@ -455,13 +430,13 @@ Ipv4AddressGeneratorImpl::IsAddressAllocated (const Ipv4Address address)
 
   NS_ABORT_MSG_UNLESS (addr, "Ipv4AddressGeneratorImpl::IsAddressAllocated(): Don't check for the broadcast address...");
 
-  std::list<Entry>::iterator i;
-
-  for (i = m_entries.begin (); i != m_entries.end (); ++i)
+  Entries::const_iterator i = m_entries.upper_bound (addr);
+  if (i != m_entries.begin ())
     {
-      NS_LOG_LOGIC ("examine entry: " << Ipv4Address ((*i).addrLow) <<
-                    " to " << Ipv4Address ((*i).addrHigh));
-      if (addr >= (*i).addrLow && addr <= (*i).addrHigh)
+      --i;
+      NS_LOG_LOGIC ("examine entry: " << Ipv4Address (i->first) <<
+                    " to " << Ipv4Address (i->second));
+      if (addr <= i->second)
         {
           NS_LOG_LOGIC ("Ipv4AddressGeneratorImpl::IsAddressAllocated(): Address Collision: " << Ipv4Address (addr));
           return false;
@@ -478,26 +453,28 @@ Ipv4AddressGeneratorImpl::IsNetworkAllocated (const Ipv4Address address, const I
   NS_ABORT_MSG_UNLESS (address == address.CombineMask (mask),
                        "Ipv4AddressGeneratorImpl::IsNetworkAllocated(): network address and mask don't match " << address << " " << mask);
 
-  std::list<Entry>::iterator i;
+  uint32_t low = address.Get ();
+  uint32_t high = low | ~mask.Get ();
 
-  for (i = m_entries.begin (); i != m_entries.end (); ++i)
+//
+// The network is allocated if a block overlaps it: either the last block
+// starting at or below the network end reaches the network start.
+//
+  Entries::const_iterator i = m_entries.upper_bound (high);
+  if (i != m_entries.begin ())
     {
-      NS_LOG_LOGIC ("examine entry: " << Ipv4Address ((*i).addrLow) << " to " << Ipv4Address ((*i).addrHigh));
-      Ipv4Address low = Ipv4Address ((*i).addrLow);
-      Ipv4Address high = Ipv4Address ((*i).addrHigh);
-
-      if (address == low.CombineMask (mask) || address == high.CombineMask (mask))
+      --i;
+      NS_LOG_LOGIC ("examine entry: " << Ipv4Address (i->first) << " to " << Ipv4Address (i->second));
+      if (i->second >= low)
         {
           NS_LOG_LOGIC ("Ipv4AddressGeneratorImpl::IsNetworkAllocated(): Network already allocated: " <<
-                        address << " " << low << "-" << high);
+                        address << " " << Ipv4Address (i->first) << "-" << Ipv4Address (i->second));
           return false;
         }
-
     }
   return true;
 }
 
-
 void
 Ipv4AddressGeneratorImpl::TestMode (void)
 {
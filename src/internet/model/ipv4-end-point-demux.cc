@@ -23,6 +23,8 @@
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <vector>
 
 namespace ns3 {
 
@@ -40,23 +42,109 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_positions.clear ();
+  m_exact.clear ();
+  m_wildcard.clear ();
+  m_portUsers.clear ();
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPointDemux::FourTuple::operator== (const FourTuple &other) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return localAddress == other.localAddress
+         && peerAddress == other.peerAddress
+         && localPort == other.localPort
+         && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::FourTupleHash::operator() (const FourTuple &tuple) const
+{
+  Ipv4AddressHash addressHash;
+  size_t hash = addressHash (tuple.localAddress);
+  hash = hash * 31 + addressHash (tuple.peerAddress);
+  hash = hash * 31 + ((static_cast<size_t> (tuple.localPort) << 16) | tuple.peerPort);
+  return hash;
+}
+
+bool
+Ipv4EndPointDemux::IsFullySpecified (Ipv4EndPoint *endPoint)
+{
+  return endPoint->GetLocalAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+void
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_positions[endPoint] = m_endPoints.insert (m_endPoints.end (), endPoint);
+  endPoint->m_demux = this;
+  Index (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_portUsers[endPoint->GetLocalPort ()]++;
+  if (IsFullySpecified (endPoint))
     {
-      if ((*i)->GetLocalPort  () == port) 
+      FourTuple tuple = {endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                         endPoint->GetLocalPort (), endPoint->GetPeerPort ()};
+      m_exact[tuple].push_back (endPoint);
+    }
+  else
+    {
+      m_wildcard[endPoint->GetLocalPort ()].push_back (endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::unordered_map<uint16_t, uint32_t>::iterator users = m_portUsers.find (endPoint->GetLocalPort ());
+  NS_ASSERT (users != m_portUsers.end ());
+  if (--users->second == 0)
+    {
+      m_portUsers.erase (users);
+    }
+  if (IsFullySpecified (endPoint))
+    {
+      FourTuple tuple = {endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                         endPoint->GetLocalPort (), endPoint->GetPeerPort ()};
+      std::unordered_map<FourTuple, EndPoints, FourTupleHash>::iterator it = m_exact.find (tuple);
+      NS_ASSERT (it != m_exact.end ());
+      it->second.remove (endPoint);
+      if (it->second.empty ())
         {
-          return true;
+          m_exact.erase (it);
+        }
+    }
+  else
+    {
+      std::unordered_map<uint16_t, EndPoints>::iterator it = m_wildcard.find (endPoint->GetLocalPort ());
+      NS_ASSERT (it != m_wildcard.end ());
+      it->second.remove (endPoint);
+      if (it->second.empty ())
+        {
+          m_wildcard.erase (it);
         }
     }
-  return false;
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_portUsers.find (port) != m_portUsers.end ();
 }
 
 bool
@@ -86,8 +174,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -102,8 +189,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -125,8 +211,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -136,7 +221,30 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  // Only the end points sharing the same four-tuple can be duplicates,
+  // and they are all in the same bucket of the index.
+  EndPoints none;
+  EndPoints *bucket = &none;
+  if (localAddress != Ipv4Address::GetAny ()
+      && peerAddress != Ipv4Address::GetAny ()
+      && peerPort != 0)
+    {
+      FourTuple tuple = {localAddress, peerAddress, localPort, peerPort};
+      std::unordered_map<FourTuple, EndPoints, FourTupleHash>::iterator it = m_exact.find (tuple);
+      if (it != m_exact.end ())
+        {
+          bucket = &it->second;
+        }
+    }
+  else
+    {
+      std::unordered_map<uint16_t, EndPoints>::iterator it = m_wildcard.find (localPort);
+      if (it != m_wildcard.end ())
+        {
+          bucket = &it->second;
+        }
+    }
+  for (EndPointsI i = bucket->begin (); i != bucket->end (); i++)
     {
       if ((*i)->GetLocalPort () == localPort &&
           (*i)->GetLocalAddress () == localAddress &&
@@ -150,10 +258,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -161,15 +266,16 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<Ipv4EndPoint *, EndPointsI>::iterator it = m_positions.find (endPoint);
+  if (it == m_positions.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint);
+  m_endPoints.erase (it->second);
+  m_positions.erase (it);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -208,7 +314,46 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+
+  // Collect the end points that can match: the fully specified ones
+  // bound to the destination address (or to the subnet-directed address
+  // of one of the incoming interface addresses), and the wildcard ones
+  // listening on the destination port.
+  EndPoints candidates;
+  std::unordered_map<FourTuple, EndPoints, FourTupleHash>::const_iterator exact;
+  FourTuple tuple = {daddr, saddr, dport, sport};
+  exact = m_exact.find (tuple);
+  if (exact != m_exact.end ())
+    {
+      candidates.insert (candidates.end (), exact->second.begin (), exact->second.end ());
+    }
+  if (!m_exact.empty () && incomingInterface != 0)
+    {
+      std::vector<Ipv4Address> netparts;
+      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+        {
+          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+          tuple.localAddress = addr.GetLocal ().CombineMask (addr.GetMask ());
+          if (tuple.localAddress == daddr
+              || std::find (netparts.begin (), netparts.end (), tuple.localAddress) != netparts.end ())
+            {
+              continue;
+            }
+          netparts.push_back (tuple.localAddress);
+          exact = m_exact.find (tuple);
+          if (exact != m_exact.end ())
+            {
+              candidates.insert (candidates.end (), exact->second.begin (), exact->second.end ());
+            }
+        }
+    }
+  std::unordered_map<uint16_t, EndPoints>::const_iterator wildcard = m_wildcard.find (dport);
+  if (wildcard != m_wildcard.end ())
+    {
+      candidates.insert (candidates.end (), wildcard->second.begin (), wildcard->second.end ());
+    }
+
+  for (EndPointsI i = candidates.begin (); i != candidates.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
 
@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +41,14 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * Besides the list, the endpoints are indexed in hash tables, so that
+ * the lookup cost does not grow with the number of open connections:
+ * endpoints whose four-tuple is fully specified (e.g., established TCP
+ * connections) are found by an exact match on the four-tuple, while
+ * the others (e.g., listening sockets) are kept in per-port buckets.
+ * The index is updated when the address or the peer of an endpoint
+ * is changed.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +175,63 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief Four-tuple of a fully specified end point.
+   */
+  struct FourTuple
+  {
+    Ipv4Address localAddress; //!< local address
+    Ipv4Address peerAddress;  //!< peer address
+    uint16_t localPort;       //!< local port
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \brief Equality operator.
+     * \param other the four-tuple to compare with
+     * \returns true if the four-tuples are equal
+     */
+    bool operator== (const FourTuple &other) const;
+  };
+
+  /**
+   * \brief Hash function for the four-tuples.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \brief Hash a four-tuple.
+     * \param tuple the four-tuple
+     * \returns the hash value
+     */
+    size_t operator() (const FourTuple &tuple) const;
+  };
+
+  /**
+   * \brief Check if an end point is fully specified.
+   * \param endPoint the end point
+   * \returns true if local address, peer address and peer port are all set
+   */
+  static bool IsFullySpecified (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the demux and to the lookup index.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the lookup index.
+   * \param endPoint the end point
+   */
+  void Index (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the lookup index.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -192,6 +258,26 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief Position of each end point in m_endPoints.
+   */
+  std::unordered_map<Ipv4EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief Fully specified end points, by four-tuple.
+   */
+  std::unordered_map<FourTuple, EndPoints, FourTupleHash> m_exact;
+
+  /**
+   * \brief End points not fully specified, by local port.
+   */
+  std::unordered_map<uint16_t, EndPoints> m_wildcard;
+
+  /**
+   * \brief Number of end points using each local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_portUsers;
 };
 
 } // namespace ns3
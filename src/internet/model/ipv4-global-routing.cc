@@ -451,6 +451,13 @@ Ipv4GlobalRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Uni
   *os << std::endl;
 }
 
+bool
+Ipv4GlobalRouting::IsRouteCacheable (void) const
+{
+  // with random ECMP, each packet may take a different route
+  return !m_randomEcmpRouting;
+}
+
 Ptr<Ipv4Route>
 Ipv4GlobalRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
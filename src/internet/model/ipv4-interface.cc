@@ -85,6 +85,7 @@ Ipv4Interface::DoDispose (void)
   m_device = 0;
   m_tc = 0;
   m_cache = 0;
+  m_addressChangeCallback = MakeNullCallback<void> ();
   Object::DoDispose ();
 }
 
@@ -310,6 +311,10 @@ Ipv4Interface::AddAddress (Ipv4InterfaceAddress addr)
 {
   NS_LOG_FUNCTION (this << addr);
   m_ifaddrs.push_back (addr);
+  if (!m_addressChangeCallback.IsNull ())
+    {
+      m_addressChangeCallback ();
+    }
   return true;
 }
 
@@ -353,6 +358,10 @@ Ipv4Interface::RemoveAddress (uint32_t index)
         {
           Ipv4InterfaceAddress addr = *i;
           m_ifaddrs.erase (i);
+          if (!m_addressChangeCallback.IsNull ())
+            {
+              m_addressChangeCallback ();
+            }
           return addr;
         }
       ++tmp;
@@ -380,11 +389,21 @@ Ipv4Interface::RemoveAddress(Ipv4Address address)
         {
           Ipv4InterfaceAddress ifAddr = *it;
           m_ifaddrs.erase(it);
+          if (!m_addressChangeCallback.IsNull ())
+            {
+              m_addressChangeCallback ();
+            }
           return ifAddr;
         }
     }
   return Ipv4InterfaceAddress();
 }
 
-} // namespace ns3
+void
+Ipv4Interface::SetAddressChangeCallback (Callback<void> cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_addressChangeCallback = cb;
+}
 
+} // namespace ns3
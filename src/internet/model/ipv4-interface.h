@@ -25,6 +25,7 @@
 #include <list>
 #include "ns3/ptr.h"
 #include "ns3/object.h"
+#include "ns3/callback.h"
 
 namespace ns3 {
 
@@ -188,6 +189,13 @@ public:
    */
   Ipv4InterfaceAddress RemoveAddress (Ipv4Address address);
 
+  /**
+   * \brief Set the callback invoked when an address is added to or
+   * removed from the interface.
+   * \param cb the callback
+   */
+  void SetAddressChangeCallback (Callback<void> cb);
+
 protected:
   virtual void DoDispose (void);
 private:
@@ -239,6 +247,7 @@ private:
   Ptr<NetDevice> m_device; //!< The associated NetDevice
   Ptr<TrafficControlLayer> m_tc; //!< The associated TrafficControlLayer
   Ptr<ArpCache> m_cache; //!< ARP cache
+  Callback<void> m_addressChangeCallback; //!< address change callback
 };
 
 } // namespace ns3
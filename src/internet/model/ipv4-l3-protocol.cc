@@ -86,6 +86,22 @@ Ipv4L3Protocol::GetTypeId (void)
                    TimeValue (Seconds (1)),
                    MakeTimeAccessor (&Ipv4L3Protocol::m_purge),
                    MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("FastForwarding",
+                   "Forward the unicast packets through a route cache, "
+                   "without the routing protocol lookup, once a route "
+                   "to their destination has been found. Only the routes of "
+                   "the protocols for which Ipv4RoutingProtocol::IsRouteCacheable "
+                   "is true (e.g., static routing) are cached, and the packets "
+                   "carrying a nix-vector always follow the regular path.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4L3Protocol::m_fastForwarding),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FastForwardingTimeout",
+                   "Lifetime of the entries of the fast forwarding route cache. "
+                   "Route changes are taken into account after at most this delay.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&Ipv4L3Protocol::m_fastForwardingTimeout),
+                   MakeTimeChecker (Seconds (0)))
     .AddTraceSource ("Tx",
                      "Send ipv4 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_txTrace),
@@ -130,6 +146,7 @@ Ipv4L3Protocol::GetTypeId (void)
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
+  : m_addressIndexValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -293,6 +310,7 @@ Ipv4L3Protocol::SetRoutingProtocol (Ptr<Ipv4RoutingProtocol> routingProtocol)
   NS_LOG_FUNCTION (this << routingProtocol);
   m_routingProtocol = routingProtocol;
   m_routingProtocol->SetIpv4 (this);
+  m_fastForwardingCache.clear ();
 }
 
 
@@ -319,6 +337,7 @@ Ipv4L3Protocol::DoDispose (void)
     }
   m_interfaces.clear ();
   m_reverseInterfacesContainer.clear ();
+  InvalidateAddressIndex ();
 
   m_sockets.clear ();
   m_node = 0;
@@ -341,6 +360,7 @@ Ipv4L3Protocol::DoDispose (void)
       m_cleanDpd.Cancel ();
     }
   m_dups.clear ();
+  m_fastForwardingCache.clear ();
 
   Object::DoDispose ();
 }
@@ -422,9 +442,41 @@ Ipv4L3Protocol::AddIpv4Interface (Ptr<Ipv4Interface>interface)
   uint32_t index = m_interfaces.size ();
   m_interfaces.push_back (interface);
   m_reverseInterfacesContainer[interface->GetDevice ()] = index;
+  interface->SetAddressChangeCallback (MakeCallback (&Ipv4L3Protocol::InvalidateAddressIndex, this));
+  InvalidateAddressIndex ();
   return index;
 }
 
+void
+Ipv4L3Protocol::InvalidateAddressIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_addressIndexValid = false;
+  m_localAddressIndex.clear ();
+  m_broadcastAddressIndex.clear ();
+}
+
+void
+Ipv4L3Protocol::UpdateAddressIndex (void) const
+{
+  if (m_addressIndexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_interfaces.size (); i++)
+    {
+      for (uint32_t j = 0; j < m_interfaces[i]->GetNAddresses (); j++)
+        {
+          Ipv4InterfaceAddress iaddr = m_interfaces[i]->GetAddress (j);
+          // the lowest interface wins, as with a linear search
+          m_localAddressIndex.insert (std::make_pair (iaddr.GetLocal (), i));
+          m_broadcastAddressIndex.insert (std::make_pair (iaddr.GetBroadcast (), i));
+        }
+    }
+  m_addressIndexValid = true;
+}
+
 Ptr<Ipv4Interface>
 Ipv4L3Protocol::GetInterface (uint32_t index) const
 {
@@ -448,18 +500,11 @@ Ipv4L3Protocol::GetInterfaceForAddress (
   Ipv4Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  int32_t interface = 0;
-  for (Ipv4InterfaceList::const_iterator i = m_interfaces.begin (); 
-       i != m_interfaces.end (); 
-       i++, interface++)
+  UpdateAddressIndex ();
+  AddressIndex::const_iterator it = m_localAddressIndex.find (address);
+  if (it != m_localAddressIndex.end ())
     {
-      for (uint32_t j = 0; j < (*i)->GetNAddresses (); j++)
-        {
-          if ((*i)->GetAddress (j).GetLocal () == address)
-            {
-              return interface;
-            }
-        }
+      return it->second;
     }
 
   return -1;
@@ -543,24 +588,19 @@ Ipv4L3Protocol::IsDestinationAddress (Ipv4Address address, uint32_t iif) const
 
   if (GetWeakEsModel ())  // Check other interfaces
     { 
-      for (uint32_t j = 0; j < GetNInterfaces (); j++)
+      // the incoming interface has been checked above, any match is on
+      // another interface
+      UpdateAddressIndex ();
+      if (m_localAddressIndex.find (address) != m_localAddressIndex.end ())
         {
-          if (j == uint32_t (iif)) continue;
-          for (uint32_t i = 0; i < GetNAddresses (j); i++)
-            {
-              Ipv4InterfaceAddress iaddr = GetAddress (j, i);
-              if (address == iaddr.GetLocal ())
-                {
-                  NS_LOG_LOGIC ("For me (destination " << address << " match) on another interface");
-                  return true;
-                }
-              //  This is a small corner case:  match another interface's broadcast address
-              if (address == iaddr.GetBroadcast ())
-                {
-                  NS_LOG_LOGIC ("For me (interface broadcast address on another interface)");
-                  return true;
-                }
-            }
+          NS_LOG_LOGIC ("For me (destination " << address << " match) on another interface");
+          return true;
+        }
+      //  This is a small corner case:  match another interface's broadcast address
+      if (m_broadcastAddressIndex.find (address) != m_broadcastAddressIndex.end ())
+        {
+          NS_LOG_LOGIC ("For me (interface broadcast address on another interface)");
+          return true;
         }
     }
   return false;
@@ -660,6 +700,11 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
       return;
     }
 
+  if (m_fastForwarding && FastForward (packet, ipHeader, interface))
+    {
+      return;
+    }
+
   NS_ASSERT_MSG (m_routingProtocol != 0, "Need a routing protocol object to process packets");
   if (!m_routingProtocol->RouteInput (packet, ipHeader, device,
                                       MakeCallback (&Ipv4L3Protocol::IpForward, this),
@@ -741,6 +786,10 @@ void
 Ipv4L3Protocol::CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet,
                                     Ptr<Ipv4> ipv4, uint32_t interface)
 {
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
   m_txTrace (packetCopy, ipv4, interface);
@@ -1080,10 +1129,87 @@ Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ip
       packet->AddPacketTag (priorityTag);
     }
 
+  // the packets carrying a nix-vector have to be routed at each hop
+  if (m_fastForwarding && interface >= 0 && !packet->GetNixVector ()
+      && m_routingProtocol->IsRouteCacheable ())
+    {
+      // the cached destinations must be forwarded whatever the input interface
+      bool local = false;
+      for (uint32_t i = 0; i < GetNInterfaces () && !local; i++)
+        {
+          local = IsDestinationAddress (header.GetDestination (), i);
+        }
+      if (!local)
+        {
+          FastForwardingEntry &entry = m_fastForwardingCache[header.GetDestination ()];
+          entry.interface = interface;
+          entry.target = (rtentry->GetGateway ().IsAny () ? header.GetDestination () : rtentry->GetGateway ());
+          entry.expiry = Simulator::Now () + m_fastForwardingTimeout;
+        }
+    }
+
   m_unicastForwardTrace (ipHeader, packet, interface);
   SendRealOut (rtentry, packet, ipHeader);
 }
 
+bool
+Ipv4L3Protocol::FastForward (Ptr<Packet> packet, Ipv4Header &ipHeader, uint32_t iif)
+{
+  NS_LOG_FUNCTION (this << packet << ipHeader << iif);
+
+  if (packet->GetNixVector ())
+    {
+      return false;
+    }
+
+  FastForwardingCache::iterator it = m_fastForwardingCache.find (ipHeader.GetDestination ());
+  if (it == m_fastForwardingCache.end ())
+    {
+      return false;
+    }
+  if (it->second.expiry <= Simulator::Now ())
+    {
+      // expired entries are dropped here, so the cache does not keep them
+      // until the next flush
+      m_fastForwardingCache.erase (it);
+      return false;
+    }
+
+  // TTL expiry, fragmentation and down interfaces are left to the regular path
+  Ptr<Ipv4Interface> outInterface = m_interfaces[it->second.interface];
+  if (ipHeader.GetTtl () <= 1 || !m_interfaces[iif]->IsForwarding () || !outInterface->IsUp ()
+      || packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu ())
+    {
+      return false;
+    }
+
+  NS_LOG_LOGIC ("Fast forwarding to " << it->second.target << " via interface " << it->second.interface);
+  ipHeader.SetTtl (ipHeader.GetTtl () - 1);
+
+  // in case the packet still has a priority tag attached, remove it
+  SocketPriorityTag priorityTag;
+  packet->RemovePacketTag (priorityTag);
+  uint8_t priority = Socket::IpTos2Priority (ipHeader.GetTos ());
+  // add a priority tag if the priority is not null
+  if (priority)
+    {
+      priorityTag.SetPriority (priority);
+      packet->AddPacketTag (priorityTag);
+    }
+
+  m_unicastForwardTrace (ipHeader, packet, it->second.interface);
+  CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), it->second.interface);
+  outInterface->Send (packet, ipHeader, it->second.target);
+  return true;
+}
+
+void
+Ipv4L3Protocol::FlushFastForwardingCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_fastForwardingCache.clear ();
+}
+
 void
 Ipv4L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv4Header const&ip, uint32_t iif)
 {
@@ -1153,6 +1279,7 @@ Ipv4L3Protocol::AddAddress (uint32_t i, Ipv4InterfaceAddress address)
   NS_LOG_FUNCTION (this << i << address);
   Ptr<Ipv4Interface> interface = GetInterface (i);
   bool retVal = interface->AddAddress (address);
+  m_fastForwardingCache.clear ();
   if (m_routingProtocol != 0)
     {
       m_routingProtocol->NotifyAddAddress (i, address);
@@ -1184,6 +1311,7 @@ Ipv4L3Protocol::RemoveAddress (uint32_t i, uint32_t addressIndex)
   Ipv4InterfaceAddress address = interface->RemoveAddress (addressIndex);
   if (address != Ipv4InterfaceAddress ())
     {
+      m_fastForwardingCache.clear ();
       if (m_routingProtocol != 0)
         {
           m_routingProtocol->NotifyRemoveAddress (i, address);
@@ -1207,6 +1335,7 @@ Ipv4L3Protocol::RemoveAddress (uint32_t i, Ipv4Address address)
   Ipv4InterfaceAddress ifAddr = interface->RemoveAddress (address);
   if (ifAddr != Ipv4InterfaceAddress ())
     {
+      m_fastForwardingCache.clear ();
       if (m_routingProtocol != 0)
         {
           m_routingProtocol->NotifyRemoveAddress (i, ifAddr);
@@ -1341,6 +1470,7 @@ Ipv4L3Protocol::SetUp (uint32_t i)
   if (interface->GetDevice ()->GetMtu () >= 68)
     {
       interface->SetUp ();
+      m_fastForwardingCache.clear ();
 
       if (m_routingProtocol != 0)
         {
@@ -1359,6 +1489,7 @@ Ipv4L3Protocol::SetDown (uint32_t ifaceIndex)
   NS_LOG_FUNCTION (this << ifaceIndex);
   Ptr<Ipv4Interface> interface = GetInterface (ifaceIndex);
   interface->SetDown ();
+  m_fastForwardingCache.clear ();
 
   if (m_routingProtocol != 0)
     {
@@ -1381,6 +1512,7 @@ Ipv4L3Protocol::SetForwarding (uint32_t i, bool val)
   NS_LOG_FUNCTION (this << i);
   Ptr<Ipv4Interface> interface = GetInterface (i);
   interface->SetForwarding (val);
+  m_fastForwardingCache.clear ();
 }
 
 Ptr<NetDevice>
@@ -1399,6 +1531,7 @@ Ipv4L3Protocol::SetIpForward (bool forward)
     {
       (*i)->SetForwarding (forward);
     }
+  m_fastForwardingCache.clear ();
 }
 
 bool 
@@ -34,6 +34,7 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/sgi-hashmap.h"
 
 class Ipv4L3ProtocolTestCase;
 
@@ -111,6 +112,16 @@ public:
    */
   void SetNode (Ptr<Node> node);
 
+  /**
+   * \brief Flush the fast forwarding route cache.
+   *
+   * The cache is flushed when the interfaces or their addresses change,
+   * and its entries expire after FastForwardingTimeout. This function
+   * must be called when the routes used by the fast forwarding path are
+   * changed and the change must be taken into account immediately.
+   */
+  void FlushFastForwardingCache (void);
+
   // functions defined in base class Ipv4
 
   void SetRoutingProtocol (Ptr<Ipv4RoutingProtocol> routingProtocol);
@@ -349,6 +360,27 @@ private:
              Ptr<const Packet> p, 
              const Ipv4Header &header);
 
+  /**
+   * \brief Forward a packet through the fast forwarding route cache.
+   * \param packet packet to forward
+   * \param ipHeader IPv4 header of the packet
+   * \param iif input interface packet was received
+   * \return true if the packet has been forwarded, false if it must go
+   * through the routing protocol
+   */
+  bool FastForward (Ptr<Packet> packet, Ipv4Header &ipHeader, uint32_t iif);
+
+  /**
+   * \brief Mark the address indices as out of date, called when an
+   * address is added to or removed from an interface.
+   */
+  void InvalidateAddressIndex (void);
+
+  /**
+   * \brief Rebuild the address indices if they are out of date.
+   */
+  void UpdateAddressIndex (void) const;
+
   /**
    * \brief Forward a multicast packet.
    * \param mrtentry route
@@ -432,8 +464,7 @@ private:
    * \param ipv4 the Ipv4 protocol
    * \param interface the interface index
    *
-   * Note: If the TracedCallback API ever is extended, we could consider
-   * to check for connected functions before adding the header
+   * The copy is not made if no function is connected to the trace.
    */
   void CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
 
@@ -460,6 +491,26 @@ private:
    */
   typedef std::map<L4ListKey_t, Ptr<IpL4Protocol> > L4List_t;
 
+  /**
+   * \brief Entry of the fast forwarding route cache.
+   */
+  struct FastForwardingEntry
+  {
+    uint32_t interface; //!< output interface
+    Ipv4Address target; //!< next hop
+    Time expiry;        //!< expiration time of the entry
+  };
+
+  /**
+   * \brief Container of the fast forwarding route cache entries, by destination.
+   */
+  typedef sgi::hash_map<Ipv4Address, FastForwardingEntry, Ipv4AddressHash> FastForwardingCache;
+
+  /**
+   * \brief Container of the lowest interface index holding an address, by address.
+   */
+  typedef sgi::hash_map<Ipv4Address, uint32_t, Ipv4AddressHash> AddressIndex;
+
   bool m_ipForward;      //!< Forwarding packets (i.e. router mode) state.
   bool m_weakEsModel;    //!< Weak ES model state
   L4List_t m_protocols;  //!< List of transport protocol.
@@ -632,6 +683,14 @@ private:
   Time                m_expire;       //!< duplicate entry expiration delay
   Time                m_purge;        //!< time between purging expired duplicate entries
   EventId             m_cleanDpd;     //!< event to cleanup expired duplicate entries
+
+  bool                m_fastForwarding;        //!< Enable the fast forwarding path
+  Time                m_fastForwardingTimeout; //!< Lifetime of the fast forwarding route cache entries
+  FastForwardingCache m_fastForwardingCache;   //!< Fast forwarding route cache
+
+  mutable AddressIndex m_localAddressIndex;     //!< Interface of each local address
+  mutable AddressIndex m_broadcastAddressIndex; //!< Interface of each subnet-directed broadcast address
+  mutable bool         m_addressIndexValid;     //!< The address indices are up to date
 };
 
 } // Namespace ns3
@@ -85,6 +85,20 @@ Ipv4ListRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit
     }
 }
 
+bool
+Ipv4ListRouting::IsRouteCacheable (void) const
+{
+  for (Ipv4RoutingProtocolList::const_iterator i = m_routingProtocols.begin ();
+       i != m_routingProtocols.end (); i++)
+    {
+      if (!(*i).second->IsRouteCacheable ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 void
 Ipv4ListRouting::DoInitialize (void)
 {
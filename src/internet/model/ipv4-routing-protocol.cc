@@ -36,4 +36,10 @@ TypeId Ipv4RoutingProtocol::GetTypeId (void)
   return tid;
 }
 
+bool
+Ipv4RoutingProtocol::IsRouteCacheable (void) const
+{
+  return false;
+}
+
 } // namespace ns3
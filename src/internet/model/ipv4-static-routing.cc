@@ -742,4 +742,11 @@ Ipv4StaticRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Uni
   *os << std::endl;
 }
 
+bool
+Ipv4StaticRouting::IsRouteCacheable (void) const
+{
+  // the routes only depend on the destination
+  return true;
+}
+
 } // namespace ns3
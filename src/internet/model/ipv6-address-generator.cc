@@ -17,7 +17,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
-#include <list>
+#include <map>
 #include "ns3/abort.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
@@ -28,6 +28,28 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6AddressGenerator");
 
+/**
+ * \brief Add an offset to an address, with the carries.
+ * \param address the address
+ * \param offset the offset, 1 or -1
+ * \return the resulting address, wrapped around
+ */
+static Ipv6Address
+OffsetIpv6Address (const Ipv6Address &address, int offset)
+{
+  uint8_t addr[16];
+  address.GetBytes (addr);
+  for (int j = 15; j >= 0; j--)
+    {
+      addr[j] += offset;
+      if (addr[j] != (offset > 0 ? 0x00 : 0xff))
+        {
+          break;
+        }
+    }
+  return Ipv6Address (addr);
+}
+
 /**
  * \ingroup address
  *
@@ -177,16 +199,15 @@ public:
   NetworkState m_netTable[N_BITS]; //!< the available networks
 
   /**
-   * \brief This class holds the allocated addresses
+   * \brief The blocks of allocated addresses: the highest address of
+   * each block, by lowest address.
+   *
+   * The blocks are disjoint, so the block that may contain an address is
+   * found in logarithmic time.
    */
-  class Entry
-  {
-public:
-    uint8_t addrLow[16];  //!< the lowest allocated address
-    uint8_t addrHigh[16]; //!< the highest allocated address
-  };
+  typedef std::map<Ipv6Address, Ipv6Address> Entries;
 
-  std::list<Entry> m_entries; //!< contained of allocated addresses
+  Entries m_entries; //!< contained of allocated addresses
   Ipv6Address m_base; //!< base address
   bool m_test; //!< test mode (if true)
 };
@@ -466,112 +487,57 @@ Ipv6AddressGeneratorImpl::AddAllocated (const Ipv6Address address)
 {
   NS_LOG_FUNCTION (this << address);
 
-  uint8_t addr[16];
-  address.GetBytes (addr);
-
-  std::list<Entry>::iterator i;
-
-  for (i = m_entries.begin (); i != m_entries.end (); ++i)
+  //
+  // Find the first block above the new address, and the block below it,
+  // which is the only one that can contain the new address.
+  //
+  Entries::iterator next = m_entries.upper_bound (address);
+  Entries::iterator prev = m_entries.end ();
+  if (next != m_entries.begin ())
     {
-      NS_LOG_LOGIC ("examine entry: " << Ipv6Address ((*i).addrLow) <<
-                    " to " << Ipv6Address ((*i).addrHigh));
+      prev = next;
+      --prev;
+      NS_LOG_LOGIC ("examine entry: " << prev->first << " to " << prev->second);
       //
-      // First things first.  Is there an address collision -- that is, does the
-      // new address fall in a previously allocated block of addresses.
+      // First things first.  Is there an address collision -- that is, does
+      // the new address fall in a previously allocated block of addresses.
       //
-      if (!(Ipv6Address (addr) < Ipv6Address ((*i).addrLow))
-          && ((Ipv6Address (addr) < Ipv6Address ((*i).addrHigh))
-              || (Ipv6Address (addr) == Ipv6Address ((*i).addrHigh))))
+      if (!(prev->second < address))
         {
-          NS_LOG_LOGIC ("Ipv6AddressGeneratorImpl::Add(): Address Collision: " << Ipv6Address (addr));
+          NS_LOG_LOGIC ("Ipv6AddressGeneratorImpl::Add(): Address Collision: " << address);
           if (!m_test)
             {
-              NS_FATAL_ERROR ("Ipv6AddressGeneratorImpl::Add(): Address Collision: " << Ipv6Address (addr));
+              NS_FATAL_ERROR ("Ipv6AddressGeneratorImpl::Add(): Address Collision: " << address);
             }
           return false;
         }
       //
-      // If the new address is less than the lowest address in the current
-      // block and can't be merged into to the current block, then insert it
-      // as a new block before the current block.
-      //
-      uint8_t taddr[16];
-      for (uint32_t j = 0; j < 16; j++)
-        {
-          taddr[j] = (*i).addrLow[j];
-        }
-      taddr[15] -= 1;
-      if (Ipv6Address (addr) < Ipv6Address (taddr))
-        {
-          break;
-        }
-      //
-      // If the new address fits at the end of the block, look ahead to the next
-      // block and make sure it's not a collision there.  If we won't overlap,
-      // then just extend the current block by one address.  We expect that
-      // completely filled network ranges will be a fairly rare occurrence,
-      // so we don't worry about collapsing address range blocks.
+      // If the new address fits at the end of the block below, just extend
+      // this block by one address.  We expect that completely filled network
+      // ranges will be a fairly rare occurrence, so we don't worry about
+      // collapsing address range blocks.
       //
-      for (uint32_t j = 0; j < 16; j++)
-        {
-          taddr[j] = (*i).addrLow[j];
-        }
-      taddr[15] += 1;
-      if (Ipv6Address (addr) == Ipv6Address (taddr))
+      if (address == OffsetIpv6Address (prev->second, 1))
         {
-          std::list<Entry>::iterator j = i;
-          ++j;
-
-          if (j != m_entries.end ())
-            {
-              if (Ipv6Address (addr) == Ipv6Address ((*j).addrLow))
-                {
-                  NS_LOG_LOGIC ("Ipv6AddressGeneratorImpl::Add(): "
-                                "Address Collision: " << Ipv6Address (addr));
-                  if (!m_test)
-                    {
-                      NS_FATAL_ERROR ("Ipv6AddressGeneratorImpl::Add(): Address Collision: " << Ipv6Address (addr));
-                    }
-                  return false;
-                }
-            }
-
-          NS_LOG_LOGIC ("New addrHigh = " << Ipv6Address (addr));
-          for (uint32_t j = 0; j < 16; j++)
-            {
-              (*i).addrHigh[j] = addr[j];
-            }
-          return true;
-        }
-      //
-      // If we get here, we know that the next lower block of addresses
-      // couldn't have been extended to include this new address since the
-      // code immediately above would have been executed and that next lower
-      // block extended upward.  So we know it's safe to extend the current
-      // block down to include the new address.
-      //
-      for (uint32_t j = 0; j < 16; j++)
-        {
-          taddr[j] = (*i).addrLow[j];
-        }
-      taddr[15] -= 1;
-      if ((Ipv6Address (addr) == Ipv6Address (taddr)))
-        {
-          NS_LOG_LOGIC ("New addrLow = " << Ipv6Address (addr));
-          for (uint32_t j = 0; j < 16; j++)
-            {
-              (*i).addrLow[j] = addr[j];
-            }
+          NS_LOG_LOGIC ("New addrHigh = " << address);
+          prev->second = address;
           return true;
         }
     }
-
-  Entry entry;
-  for (uint32_t j = 0; j < 16; j++)
+  //
+  // Otherwise, if the new address fits at the beginning of the block above,
+  // extend this block down to include the new address.
+  //
+  if (next != m_entries.end () && address == OffsetIpv6Address (next->first, -1))
     {
-      entry.addrLow[j] = entry.addrHigh[j] = addr[j];
+      NS_LOG_LOGIC ("New addrLow = " << address);
+      Ipv6Address addrHigh = next->second;
+      m_entries.erase (next++);
+      m_entries.insert (next, std::make_pair (address, addrHigh));
+      return true;
     }
-  m_entries.insert (i, entry);
+
+  m_entries.insert (next, std::make_pair (address, address));
   return true;
 }
 
@@ -580,21 +546,14 @@ Ipv6AddressGeneratorImpl::IsAddressAllocated (const Ipv6Address address)
 {
   NS_LOG_FUNCTION (this << address);
 
-  uint8_t addr[16];
-  address.GetBytes (addr);
-
-  std::list<Entry>::iterator i;
-
-  for (i = m_entries.begin (); i != m_entries.end (); ++i)
+  Entries::const_iterator i = m_entries.upper_bound (address);
+  if (i != m_entries.begin ())
     {
-      NS_LOG_LOGIC ("examine entry: " << Ipv6Address ((*i).addrLow) <<
-                    " to " << Ipv6Address ((*i).addrHigh));
-
-      if (!(Ipv6Address (addr) < Ipv6Address ((*i).addrLow))
-          && ((Ipv6Address (addr) < Ipv6Address ((*i).addrHigh))
-              || (Ipv6Address (addr) == Ipv6Address ((*i).addrHigh))))
+      --i;
+      NS_LOG_LOGIC ("examine entry: " << i->first << " to " << i->second);
+      if (!(i->second < address))
         {
-          NS_LOG_LOGIC ("Ipv6AddressGeneratorImpl::IsAddressAllocated(): Address Collision: " << Ipv6Address (addr));
+          NS_LOG_LOGIC ("Ipv6AddressGeneratorImpl::IsAddressAllocated(): Address Collision: " << address);
           return false;
         }
     }
@@ -610,21 +569,31 @@ Ipv6AddressGeneratorImpl::IsNetworkAllocated (const Ipv6Address address, const I
   NS_ABORT_MSG_UNLESS (address == addr.CombinePrefix (prefix),
                        "Ipv6AddressGeneratorImpl::IsNetworkAllocated(): network address and mask don't match " << address << " " << prefix);
 
-  std::list<Entry>::iterator i;
-
-  for (i = m_entries.begin (); i != m_entries.end (); ++i)
+  // the last address of the network
+  uint8_t high[16];
+  uint8_t mask[16];
+  address.GetBytes (high);
+  prefix.GetBytes (mask);
+  for (uint32_t j = 0; j < 16; j++)
     {
-      NS_LOG_LOGIC ("examine entry: " << Ipv6Address ((*i).addrLow) << " to " << Ipv6Address ((*i).addrHigh));
-      Ipv6Address low = Ipv6Address ((*i).addrLow);
-      Ipv6Address high = Ipv6Address ((*i).addrHigh);
+      high[j] |= ~mask[j];
+    }
 
-      if (address == low.CombinePrefix (prefix) || address == high.CombinePrefix (prefix))
+  //
+  // The network is allocated if a block overlaps it: either the last block
+  // starting at or below the network end reaches the network start.
+  //
+  Entries::const_iterator i = m_entries.upper_bound (Ipv6Address (high));
+  if (i != m_entries.begin ())
+    {
+      --i;
+      NS_LOG_LOGIC ("examine entry: " << i->first << " to " << i->second);
+      if (!(i->second < address))
         {
           NS_LOG_LOGIC ("Ipv6AddressGeneratorImpl::IsNetworkAllocated(): Network already allocated: " <<
-                        address << " " << low << "-" << high);
+                        address << " " << i->first << "-" << i->second);
           return false;
         }
-
     }
   return true;
 }
@@ -40,22 +40,102 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_positions.clear ();
+  m_exact.clear ();
+  m_wildcard.clear ();
+  m_portUsers.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+bool Ipv6EndPointDemux::FourTuple::operator== (const FourTuple &other) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  return localAddress == other.localAddress
+         && peerAddress == other.peerAddress
+         && localPort == other.localPort
+         && peerPort == other.peerPort;
+}
+
+size_t Ipv6EndPointDemux::FourTupleHash::operator() (const FourTuple &tuple) const
+{
+  Ipv6AddressHash addressHash;
+  size_t hash = addressHash (tuple.localAddress);
+  hash = hash * 31 + addressHash (tuple.peerAddress);
+  hash = hash * 31 + ((static_cast<size_t> (tuple.localPort) << 16) | tuple.peerPort);
+  return hash;
+}
+
+bool Ipv6EndPointDemux::IsFullySpecified (Ipv6EndPoint *endPoint)
+{
+  return endPoint->GetLocalAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+void Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_positions[endPoint] = m_endPoints.insert (m_endPoints.end (), endPoint);
+  endPoint->m_demux = this;
+  Index (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+}
+
+void Ipv6EndPointDemux::Index (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_portUsers[endPoint->GetLocalPort ()]++;
+  if (IsFullySpecified (endPoint))
     {
-      if ((*i)->GetLocalPort  () == port)
+      FourTuple tuple = {endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                         endPoint->GetLocalPort (), endPoint->GetPeerPort ()};
+      m_exact[tuple].push_back (endPoint);
+    }
+  else
+    {
+      m_wildcard[endPoint->GetLocalPort ()].push_back (endPoint);
+    }
+}
+
+void Ipv6EndPointDemux::Unindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::unordered_map<uint16_t, uint32_t>::iterator users = m_portUsers.find (endPoint->GetLocalPort ());
+  NS_ASSERT (users != m_portUsers.end ());
+  if (--users->second == 0)
+    {
+      m_portUsers.erase (users);
+    }
+  if (IsFullySpecified (endPoint))
+    {
+      FourTuple tuple = {endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                         endPoint->GetLocalPort (), endPoint->GetPeerPort ()};
+      std::unordered_map<FourTuple, EndPoints, FourTupleHash>::iterator it = m_exact.find (tuple);
+      NS_ASSERT (it != m_exact.end ());
+      it->second.remove (endPoint);
+      if (it->second.empty ())
         {
-          return true;
+          m_exact.erase (it);
+        }
+    }
+  else
+    {
+      std::unordered_map<uint16_t, EndPoints>::iterator it = m_wildcard.find (endPoint->GetLocalPort ());
+      NS_ASSERT (it != m_wildcard.end ());
+      it->second.remove (endPoint);
+      if (it->second.empty ())
+        {
+          m_wildcard.erase (it);
         }
     }
-  return false;
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_portUsers.find (port) != m_portUsers.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
@@ -83,8 +163,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -98,8 +177,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -119,8 +197,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv6Ad
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -129,7 +206,30 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  // Only the end points sharing the same four-tuple can be duplicates,
+  // and they are all in the same bucket of the index.
+  EndPoints none;
+  EndPoints *bucket = &none;
+  if (localAddress != Ipv6Address::GetAny ()
+      && peerAddress != Ipv6Address::GetAny ()
+      && peerPort != 0)
+    {
+      FourTuple tuple = {localAddress, peerAddress, localPort, peerPort};
+      std::unordered_map<FourTuple, EndPoints, FourTupleHash>::iterator it = m_exact.find (tuple);
+      if (it != m_exact.end ())
+        {
+          bucket = &it->second;
+        }
+    }
+  else
+    {
+      std::unordered_map<uint16_t, EndPoints>::iterator it = m_wildcard.find (localPort);
+      if (it != m_wildcard.end ())
+        {
+          bucket = &it->second;
+        }
+    }
+  for (EndPointsI i = bucket->begin (); i != bucket->end (); i++)
     {
       if ((*i)->GetLocalPort () == localPort &&
           (*i)->GetLocalAddress () == localAddress &&
@@ -143,25 +243,23 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
+  Insert (endPoint);
   return endPoint;
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<Ipv6EndPoint *, EndPointsI>::iterator it = m_positions.find (endPoint);
+  if (it == m_positions.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint);
+  m_endPoints.erase (it->second);
+  m_positions.erase (it);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -181,7 +279,23 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+
+  /* Only the fully specified end point matching the four-tuple and the
+     wildcard end points listening on the destination port can match. */
+  EndPoints candidates;
+  FourTuple tuple = {daddr, saddr, dport, sport};
+  std::unordered_map<FourTuple, EndPoints, FourTupleHash>::const_iterator exact = m_exact.find (tuple);
+  if (exact != m_exact.end ())
+    {
+      candidates.insert (candidates.end (), exact->second.begin (), exact->second.end ());
+    }
+  std::unordered_map<uint16_t, EndPoints>::const_iterator wildcard = m_wildcard.find (dport);
+  if (wildcard != m_wildcard.end ())
+    {
+      candidates.insert (candidates.end (), wildcard->second.begin (), wildcard->second.end ());
+    }
+
+  for (EndPointsI i = candidates.begin (); i != candidates.end (); i++)
     {
       Ipv6EndPoint* endP = *i;
 
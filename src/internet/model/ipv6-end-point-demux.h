@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +35,10 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are indexed in hash tables: the fully specified ones
+ * by four-tuple, the others by local port.  The index is updated when
+ * the address, the port or the peer of an end point are changed.
  */
 class Ipv6EndPointDemux
 {
@@ -153,6 +158,64 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief Four-tuple of a fully specified end point.
+   */
+  struct FourTuple
+  {
+    Ipv6Address localAddress; //!< local address
+    Ipv6Address peerAddress;  //!< peer address
+    uint16_t localPort;       //!< local port
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \brief Equality operator.
+     * \param other the four-tuple to compare with
+     * \returns true if the four-tuples are equal
+     */
+    bool operator== (const FourTuple &other) const;
+  };
+
+  /**
+   * \brief Hash function for the four-tuples.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \brief Hash a four-tuple.
+     * \param tuple the four-tuple
+     * \returns the hash value
+     */
+    size_t operator() (const FourTuple &tuple) const;
+  };
+
+  /**
+   * \brief Check if an end point is fully specified.
+   * \param endPoint the end point
+   * \returns true if local address, peer address and peer port are all set
+   */
+  static bool IsFullySpecified (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the demux and to the lookup index.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the lookup index.
+   * \param endPoint the end point
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the lookup index.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -178,6 +241,26 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief Position of each end point in m_endPoints.
+   */
+  std::unordered_map<Ipv6EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief Fully specified end points, by four-tuple.
+   */
+  std::unordered_map<FourTuple, EndPoints, FourTupleHash> m_exact;
+
+  /**
+   * \brief End points not fully specified, by local port.
+   */
+  std::unordered_map<uint16_t, EndPoints> m_wildcard;
+
+  /**
+   * \brief Number of end points using each local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_portUsers;
 };
 
 } /* namespace ns3 */
@@ -77,6 +77,7 @@ void Ipv6Interface::DoDispose ()
   m_device = 0;
   m_tc = 0;
   m_ndCache = 0;
+  m_addressChangeCallback = MakeNullCallback<void> ();
   Object::DoDispose ();
 }
 
@@ -176,6 +177,10 @@ void Ipv6Interface::SetDown ()
   NS_LOG_FUNCTION (this);
   m_ifup = false;
   m_addresses.clear ();
+  if (!m_addressChangeCallback.IsNull ())
+    {
+      m_addressChangeCallback ();
+    }
   m_ndCache->Flush ();
 }
 
@@ -209,6 +214,10 @@ bool Ipv6Interface::AddAddress (Ipv6InterfaceAddress iface)
 
       Ipv6Address solicited = Ipv6Address::MakeSolicitedAddress (iface.GetAddress ());
       m_addresses.push_back (std::make_pair (iface, solicited));
+      if (!m_addressChangeCallback.IsNull ())
+        {
+          m_addressChangeCallback ();
+        }
 
       if (!addr.IsAny () || !addr.IsLocalhost ())
         {
@@ -307,6 +316,10 @@ Ipv6InterfaceAddress Ipv6Interface::RemoveAddress (uint32_t index)
         {
           Ipv6InterfaceAddress iface = it->first;
           m_addresses.erase (it);
+          if (!m_addressChangeCallback.IsNull ())
+            {
+              m_addressChangeCallback ();
+            }
           return iface;
         }
 
@@ -334,12 +347,22 @@ Ipv6Interface::RemoveAddress(Ipv6Address address)
         {
           Ipv6InterfaceAddress iface = it->first;
           m_addresses.erase(it);
+          if (!m_addressChangeCallback.IsNull ())
+            {
+              m_addressChangeCallback ();
+            }
           return iface;
         }
     }
   return Ipv6InterfaceAddress();
 }
 
+void Ipv6Interface::SetAddressChangeCallback (Callback<void> cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_addressChangeCallback = cb;
+}
+
 Ipv6InterfaceAddress Ipv6Interface::GetAddressMatchingDestination (Ipv6Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
@@ -24,6 +24,7 @@
 #include <list>
 #include "ns3/ptr.h"
 #include "ns3/object.h"
+#include "ns3/callback.h"
 #include "ipv6-interface-address.h"
 
 namespace ns3
@@ -252,6 +253,13 @@ public:
    */
   Ipv6InterfaceAddress RemoveAddress (Ipv6Address address);
 
+  /**
+   * \brief Set the callback invoked when an address is added to or
+   * removed from the interface.
+   * \param cb the callback
+   */
+  void SetAddressChangeCallback (Callback<void> cb);
+
   /**
    * \brief Update state of an interface address.
    * \param address IPv6 address
@@ -361,6 +369,11 @@ private:
    */
   Ptr<NdiscCache> m_ndCache;
 
+  /**
+   * \brief Callback invoked when an address is added or removed.
+   */
+  Callback<void> m_addressChangeCallback;
+
   /**
    * \brief Current hop limit.
    */
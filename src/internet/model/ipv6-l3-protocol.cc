@@ -23,6 +23,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/vector.h"
 #include "ns3/boolean.h"
+#include "ns3/simulator.h"
 #include "ns3/callback.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object-vector.h"
@@ -91,6 +92,22 @@ TypeId Ipv6L3Protocol::GetTypeId ()
                    BooleanValue (true),
                    MakeBooleanAccessor (&Ipv6L3Protocol::m_strongEndSystemModel),
                    MakeBooleanChecker ())
+    .AddAttribute ("FastForwarding",
+                   "Forward the unicast packets through a route cache, "
+                   "without the routing protocol lookup, once a route "
+                   "to their destination has been found. Only the routes of "
+                   "the protocols for which Ipv6RoutingProtocol::IsRouteCacheable "
+                   "is true (e.g., static routing) are cached, and the packets "
+                   "carrying a nix-vector always follow the regular path.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv6L3Protocol::m_fastForwarding),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FastForwardingTimeout",
+                   "Lifetime of the entries of the fast forwarding route cache. "
+                   "Route changes are taken into account after at most this delay.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&Ipv6L3Protocol::m_fastForwardingTimeout),
+                   MakeTimeChecker (Seconds (0)))
     .AddTraceSource ("Tx",
                      "Send IPv6 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv6L3Protocol::m_txTrace),
@@ -124,7 +141,10 @@ TypeId Ipv6L3Protocol::GetTypeId ()
 }
 
 Ipv6L3Protocol::Ipv6L3Protocol ()
-  : m_nInterfaces (0)
+  : m_nInterfaces (0),
+    m_extensionsDeferred (false),
+    m_deferredExtensionStream (-1),
+    m_addressIndexValid (false)
 {
   NS_LOG_FUNCTION (this);
   m_pmtuCache = CreateObject<Ipv6PmtuCache> ();
@@ -156,6 +176,7 @@ void Ipv6L3Protocol::DoDispose ()
     }
   m_interfaces.clear ();
   m_reverseInterfacesContainer.clear ();
+  InvalidateAddressIndex ();
 
   /* remove raw sockets */
   for (SocketList::iterator it = m_sockets.begin (); it != m_sockets.end (); ++it)
@@ -173,6 +194,8 @@ void Ipv6L3Protocol::DoDispose ()
     }
   m_prefixes.clear ();
 
+  m_fastForwardingCache.clear ();
+
   m_node = 0;
   m_routingProtocol = 0;
   m_pmtuCache = 0;
@@ -184,6 +207,7 @@ void Ipv6L3Protocol::SetRoutingProtocol (Ptr<Ipv6RoutingProtocol> routingProtoco
   NS_LOG_FUNCTION (this << routingProtocol);
   m_routingProtocol = routingProtocol;
   m_routingProtocol->SetIpv6 (this);
+  m_fastForwardingCache.clear ();
 }
 
 Ptr<Ipv6RoutingProtocol> Ipv6L3Protocol::GetRoutingProtocol () const
@@ -211,6 +235,7 @@ uint32_t Ipv6L3Protocol::AddInterface (Ptr<NetDevice> device)
   interface->SetDevice (device);
   interface->SetTrafficControl (tc);
   interface->SetForwarding (m_ipForward);
+  RegisterDeferredExtensionsAndOptions ();
   return AddIpv6Interface (interface);
 }
 
@@ -222,9 +247,36 @@ uint32_t Ipv6L3Protocol::AddIpv6Interface (Ptr<Ipv6Interface> interface)
   m_interfaces.push_back (interface);
   m_reverseInterfacesContainer[interface->GetDevice ()] = index;
   m_nInterfaces++;
+  interface->SetAddressChangeCallback (MakeCallback (&Ipv6L3Protocol::InvalidateAddressIndex, this));
+  InvalidateAddressIndex ();
   return index;
 }
 
+void Ipv6L3Protocol::InvalidateAddressIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  m_addressIndexValid = false;
+  m_addressIndex.clear ();
+}
+
+void Ipv6L3Protocol::UpdateAddressIndex () const
+{
+  if (m_addressIndexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_interfaces.size (); i++)
+    {
+      for (uint32_t j = 0; j < m_interfaces[i]->GetNAddresses (); j++)
+        {
+          // the lowest interface wins, as with a linear search
+          m_addressIndex.insert (std::make_pair (m_interfaces[i]->GetAddress (j).GetAddress (), i));
+        }
+    }
+  m_addressIndexValid = true;
+}
+
 Ptr<Ipv6Interface> Ipv6L3Protocol::GetInterface (uint32_t index) const
 {
   NS_LOG_FUNCTION (this << index);
@@ -245,21 +297,11 @@ uint32_t Ipv6L3Protocol::GetNInterfaces () const
 int32_t Ipv6L3Protocol::GetInterfaceForAddress (Ipv6Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  int32_t index = 0;
-
-  for (Ipv6InterfaceList::const_iterator it = m_interfaces.begin (); it != m_interfaces.end (); it++)
+  UpdateAddressIndex ();
+  AddressIndex::const_iterator it = m_addressIndex.find (address);
+  if (it != m_addressIndex.end ())
     {
-      uint32_t j = 0;
-      uint32_t max = (*it)->GetNAddresses ();
-
-      for (j = 0; j < max; j++)
-        {
-          if ((*it)->GetAddress (j).GetAddress () == address)
-            {
-              return index;
-            }
-        }
-      index++;
+      return it->second;
     }
   return -1;
 }
@@ -381,6 +423,7 @@ bool Ipv6L3Protocol::AddAddress (uint32_t i, Ipv6InterfaceAddress address)
   NS_LOG_FUNCTION (this << i << address);
   Ptr<Ipv6Interface> interface = GetInterface (i);
   bool ret = interface->AddAddress (address);
+  m_fastForwardingCache.clear ();
 
   if (m_routingProtocol != 0)
     {
@@ -411,6 +454,7 @@ bool Ipv6L3Protocol::RemoveAddress (uint32_t i, uint32_t addressIndex)
 
   if (address != Ipv6InterfaceAddress ())
     {
+      m_fastForwardingCache.clear ();
       if (m_routingProtocol != 0)
         {
           m_routingProtocol->NotifyRemoveAddress (i, address);
@@ -434,6 +478,7 @@ Ipv6L3Protocol::RemoveAddress (uint32_t i, Ipv6Address address)
   Ipv6InterfaceAddress ifAddr = interface->RemoveAddress (address);
   if (ifAddr != Ipv6InterfaceAddress ())
   {
+    m_fastForwardingCache.clear ();
     if (m_routingProtocol != 0)
     {
       m_routingProtocol->NotifyRemoveAddress (i, ifAddr);
@@ -498,6 +543,7 @@ void Ipv6L3Protocol::SetUp (uint32_t i)
   if (interface->GetDevice ()->GetMtu () >= 1280)
     {
       interface->SetUp ();
+      m_fastForwardingCache.clear ();
 
       if (m_routingProtocol != 0)
         {
@@ -516,6 +562,7 @@ void Ipv6L3Protocol::SetDown (uint32_t i)
   Ptr<Ipv6Interface> interface = GetInterface (i);
 
   interface->SetDown ();
+  m_fastForwardingCache.clear ();
 
   if (m_routingProtocol != 0)
     {
@@ -574,6 +621,7 @@ void Ipv6L3Protocol::SetForwarding (uint32_t i, bool val)
   NS_LOG_FUNCTION (this << i << val);
   Ptr<Ipv6Interface> interface = GetInterface (i);
   interface->SetForwarding (val);
+  m_fastForwardingCache.clear ();
 }
 
 Ipv6Address Ipv6L3Protocol::SourceAddressSelection (uint32_t interface, Ipv6Address dest)
@@ -624,6 +672,7 @@ void Ipv6L3Protocol::SetIpForward (bool forward)
     {
       (*it)->SetForwarding (forward);
     }
+  m_fastForwardingCache.clear ();
 }
 
 bool Ipv6L3Protocol::GetIpForward () const
@@ -970,6 +1019,11 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
       socket->ForwardUp (packet, hdr, device);
     }
 
+  if (m_fastForwarding && FastForward (packet, hdr, interface))
+    {
+      return;
+    }
+
   Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
   Ptr<Ipv6Extension> ipv6Extension = 0;
   uint8_t nextHeader = hdr.GetNextHeader ();
@@ -1020,30 +1074,24 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
     }
 
 
-  for (uint32_t j = 0; j < GetNInterfaces (); j++)
+  for (uint32_t i = 0; i < GetNAddresses (interface); i++)
     {
-      if (j == interface || !m_strongEndSystemModel)
+      Ipv6InterfaceAddress iaddr = GetAddress (interface, i);
+      Ipv6Address addr = iaddr.GetAddress ();
+      if (addr == hdr.GetDestinationAddress ())
         {
-          for (uint32_t i = 0; i < GetNAddresses (j); i++)
-            {
-              Ipv6InterfaceAddress iaddr = GetAddress (j, i);
-              Ipv6Address addr = iaddr.GetAddress ();
-              if (addr == hdr.GetDestinationAddress ())
-                {
-                  if (j == interface)
-                    {
-                      NS_LOG_LOGIC ("For me (destination " << addr << " match)");
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("For me (destination " << addr << " match) on another interface " << hdr.GetDestinationAddress ());
-                    }
-                  LocalDeliver (packet, hdr, interface);
-                  return;
-                }
-              NS_LOG_LOGIC ("Address " << addr << " not a match");
-            }
+          NS_LOG_LOGIC ("For me (destination " << addr << " match)");
+          LocalDeliver (packet, hdr, interface);
+          return;
         }
+      NS_LOG_LOGIC ("Address " << addr << " not a match");
+    }
+
+  if (!m_strongEndSystemModel && GetInterfaceForAddress (hdr.GetDestinationAddress ()) != -1)
+    {
+      NS_LOG_LOGIC ("For me (destination match) on another interface " << hdr.GetDestinationAddress ());
+      LocalDeliver (packet, hdr, interface);
+      return;
     }
 
   if (!m_routingProtocol->RouteInput (packet, hdr, device,
@@ -1061,6 +1109,10 @@ void
 Ipv6L3Protocol::CallTxTrace (const Ipv6Header & ipHeader, Ptr<Packet> packet,
                                     Ptr<Ipv6> ipv6, uint32_t interface)
 {
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
   m_txTrace (packetCopy, ipv6, interface);
@@ -1120,6 +1172,7 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
           return;
         }
 
+      RegisterDeferredExtensionsAndOptions ();
       Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
 
       // To get specific method GetFragments from Ipv6ExtensionFragmentation
@@ -1266,10 +1319,81 @@ void Ipv6L3Protocol::IpForward (Ptr<const NetDevice> idev, Ptr<Ipv6Route> rtentr
   SocketPriorityTag priorityTag;
   packet->RemovePacketTag (priorityTag);
   int32_t interface = GetInterfaceForDevice (rtentry->GetOutputDevice ());
+
+  // the packets carrying a nix-vector have to be routed at each hop
+  if (m_fastForwarding && interface >= 0 && GetInterfaceForAddress (header.GetDestinationAddress ()) == -1
+      && !packet->GetNixVector () && m_routingProtocol->IsRouteCacheable ())
+    {
+      // the cached destinations must be forwarded whatever the input interface
+      FastForwardingEntry &entry = m_fastForwardingCache[header.GetDestinationAddress ()];
+      entry.interface = interface;
+      entry.target = (rtentry->GetGateway ().IsAny () ? header.GetDestinationAddress () : rtentry->GetGateway ());
+      entry.expiry = Simulator::Now () + m_fastForwardingTimeout;
+    }
+
   m_unicastForwardTrace (ipHeader, packet, interface);
   SendRealOut (rtentry, packet, ipHeader);
 }
 
+bool Ipv6L3Protocol::FastForward (Ptr<Packet> packet, Ipv6Header &ipHeader, uint32_t iif)
+{
+  NS_LOG_FUNCTION (this << packet << ipHeader << iif);
+
+  if (ipHeader.GetNextHeader () == Ipv6Header::IPV6_EXT_HOP_BY_HOP || packet->GetNixVector ())
+    {
+      return false;
+    }
+
+  FastForwardingCache::iterator it = m_fastForwardingCache.find (ipHeader.GetDestinationAddress ());
+  if (it == m_fastForwardingCache.end ())
+    {
+      return false;
+    }
+  if (it->second.expiry <= Simulator::Now ())
+    {
+      // expired entries are dropped here, so the cache does not keep them
+      // until the next flush
+      m_fastForwardingCache.erase (it);
+      return false;
+    }
+
+  // Hop limit expiry, redirects, oversized packets and down interfaces are left to the regular path
+  Ptr<Ipv6Interface> outInterface = m_interfaces[it->second.interface];
+  if (ipHeader.GetHopLimit () <= 1 || ipHeader.GetSourceAddress ().IsLinkLocal ()
+      || !m_interfaces[iif]->IsForwarding () || !outInterface->IsUp ()
+      || (m_sendIcmpv6Redirect && it->second.interface == iif))
+    {
+      return false;
+    }
+  size_t targetMtu = (size_t)(m_pmtuCache->GetPmtu (ipHeader.GetDestinationAddress ()));
+  if (targetMtu == 0)
+    {
+      targetMtu = outInterface->GetDevice ()->GetMtu ();
+    }
+  if (packet->GetSize () > targetMtu + 40)
+    {
+      return false;
+    }
+
+  NS_LOG_LOGIC ("Fast forwarding to " << it->second.target << " via interface " << it->second.interface);
+  ipHeader.SetHopLimit (ipHeader.GetHopLimit () - 1);
+
+  // in case the packet still has a priority tag attached, remove it
+  SocketPriorityTag priorityTag;
+  packet->RemovePacketTag (priorityTag);
+
+  m_unicastForwardTrace (ipHeader, packet, it->second.interface);
+  CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv6> (), it->second.interface);
+  outInterface->Send (packet, ipHeader, it->second.target);
+  return true;
+}
+
+void Ipv6L3Protocol::FlushFastForwardingCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_fastForwardingCache.clear ();
+}
+
 void Ipv6L3Protocol::IpMulticastForward (Ptr<const NetDevice> idev, Ptr<Ipv6MulticastRoute> mrtentry, Ptr<const Packet> p, const Ipv6Header& header)
 {
   NS_LOG_FUNCTION (this << mrtentry << p << header);
@@ -1307,6 +1431,7 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
   NS_LOG_FUNCTION (this << packet << ip << iif);
   Ptr<Packet> p = packet->Copy ();
   Ptr<IpL4Protocol> protocol = 0;
+  RegisterDeferredExtensionsAndOptions ();
   Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
   Ptr<Ipv6Extension> ipv6Extension = 0;
   Ipv6Address src = ip.GetSourceAddress ();
@@ -1498,6 +1623,44 @@ void Ipv6L3Protocol::RegisterOptions ()
   m_node->AggregateObject (ipv6OptionDemux);
 }
 
+void Ipv6L3Protocol::DeferExtensionsAndOptions ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_node == 0 || m_node->GetObject<Ipv6ExtensionDemux> () == 0,
+                 "The IPv6 Extensions are already registered");
+  m_extensionsDeferred = true;
+}
+
+int64_t Ipv6L3Protocol::AssignDeferredExtensionStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  if (!m_extensionsDeferred)
+    {
+      return 0;
+    }
+  // only the fragment extension uses a random variable
+  m_deferredExtensionStream = stream;
+  return 1;
+}
+
+void Ipv6L3Protocol::RegisterDeferredExtensionsAndOptions ()
+{
+  if (m_extensionsDeferred)
+    {
+      NS_LOG_FUNCTION (this);
+      m_extensionsDeferred = false;
+      RegisterExtensions ();
+      RegisterOptions ();
+      if (m_deferredExtensionStream >= 0)
+        {
+          Ptr<Ipv6Extension> fragmentExtension = m_node->GetObject<Ipv6ExtensionDemux> ()->GetExtension (Ipv6ExtensionFragment::EXT_NUMBER);
+          NS_ASSERT (fragmentExtension);
+          fragmentExtension->AssignStreams (m_deferredExtensionStream);
+          m_deferredExtensionStream = -1;
+        }
+    }
+}
+
 void Ipv6L3Protocol::ReportDrop (Ipv6Header ipHeader, Ptr<Packet> p, DropReason dropReason)
 {
   m_dropTrace (ipHeader, p, dropReason, m_node->GetObject<Ipv6> (), 0);
@@ -29,6 +29,8 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-pmtu-cache.h"
+#include "ns3/nstime.h"
+#include "ns3/sgi-hashmap.h"
 
 class Ipv6L3ProtocolTestCase;
 
@@ -105,6 +107,16 @@ public:
    */
   void SetNode (Ptr<Node> node);
 
+  /**
+   * \brief Flush the fast forwarding route cache.
+   *
+   * The cache is flushed when the interfaces or their addresses change,
+   * and its entries expire after FastForwardingTimeout. This function
+   * must be called when the routes used by the fast forwarding path are
+   * changed and the change must be taken into account immediately.
+   */
+  void FlushFastForwardingCache (void);
+
   virtual void Insert (Ptr<IpL4Protocol> protocol);
   virtual void Insert (Ptr<IpL4Protocol> protocol, uint32_t interfaceIndex);
 
@@ -355,6 +367,29 @@ public:
    */
   virtual void RegisterOptions ();
 
+  /**
+   * \brief Defer the registration of the IPv6 Extensions and Options
+   * until the first interface is added.
+   *
+   * A node that never gets an IPv6 interface (other than the loopback)
+   * then never pays for these objects.
+   */
+  void DeferExtensionsAndOptions ();
+
+  /**
+   * \brief Assign a fixed random variable stream number to the IPv6
+   * Extensions whose registration is deferred.
+   *
+   * The stream is recorded and given to the fragment extension when it is
+   * created, so that the stream numbers are the same as with the
+   * Extensions registered upfront.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned, 0 if the Extensions
+   * are not deferred
+   */
+  int64_t AssignDeferredExtensionStreams (int64_t stream);
+
   /**
    * \brief Report a packet drop
    *
@@ -515,8 +550,7 @@ private:
    * \param ipv6 the Ipv6 protocol
    * \param interface the interface index
    *
-   * Note: If the TracedCallback API ever is extended, we could consider
-   * to check for connected functions before adding the header
+   * The copy is not made if no function is connected to the trace.
    */
   void CallTxTrace (const Ipv6Header & ipHeader, Ptr<Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface);
 
@@ -593,6 +627,33 @@ private:
    */
   void IpForward (Ptr<const NetDevice> idev, Ptr<Ipv6Route> rtentry, Ptr<const Packet> p, const Ipv6Header& header);
 
+  /**
+   * \brief Forward a packet through the fast forwarding route cache.
+   * \param packet packet to forward
+   * \param ipHeader IPv6 header of the packet
+   * \param iif input interface packet was received
+   * \return true if the packet has been forwarded, false if it must go
+   * through the routing protocol
+   */
+  bool FastForward (Ptr<Packet> packet, Ipv6Header &ipHeader, uint32_t iif);
+
+  /**
+   * \brief Register the Extensions and Options if their registration
+   * has been deferred.
+   */
+  void RegisterDeferredExtensionsAndOptions ();
+
+  /**
+   * \brief Mark the address index as out of date, called when an address
+   * is added to or removed from an interface.
+   */
+  void InvalidateAddressIndex ();
+
+  /**
+   * \brief Rebuild the address index if it is out of date.
+   */
+  void UpdateAddressIndex () const;
+
   /**
    * \brief Forward a multicast packet.
    * \param idev Pointer to ingress network device
@@ -741,6 +802,63 @@ private:
    */
   bool m_sendIcmpv6Redirect;
 
+  /**
+   * \brief Entry of the fast forwarding route cache.
+   */
+  struct FastForwardingEntry
+  {
+    uint32_t interface; //!< output interface
+    Ipv6Address target; //!< next hop
+    Time expiry;        //!< expiration time of the entry
+  };
+
+  /**
+   * \brief Container of the fast forwarding route cache entries, by destination.
+   */
+  typedef sgi::hash_map<Ipv6Address, FastForwardingEntry, Ipv6AddressHash> FastForwardingCache;
+
+  /**
+   * \brief Container of the lowest interface index holding an address, by address.
+   */
+  typedef sgi::hash_map<Ipv6Address, uint32_t, Ipv6AddressHash> AddressIndex;
+
+  /**
+   * \brief Enable the fast forwarding path.
+   */
+  bool m_fastForwarding;
+
+  /**
+   * \brief Lifetime of the fast forwarding route cache entries.
+   */
+  Time m_fastForwardingTimeout;
+
+  /**
+   * \brief Fast forwarding route cache.
+   */
+  FastForwardingCache m_fastForwardingCache;
+
+  /**
+   * \brief The Extensions and Options are to be registered when the
+   * first interface is added.
+   */
+  bool m_extensionsDeferred;
+
+  /**
+   * \brief The stream of the fragment extension to be registered, or a
+   * negative value for an automatic stream.
+   */
+  int64_t m_deferredExtensionStream;
+
+  /**
+   * \brief Interface of each address.
+   */
+  mutable AddressIndex m_addressIndex;
+
+  /**
+   * \brief The address index is up to date.
+   */
+  mutable bool m_addressIndexValid;
+
   /**
    * \brief IPv6 multicast addresses / interface key.
    */
@@ -226,6 +226,20 @@ Ipv6ListRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit
     }
 }
 
+bool
+Ipv6ListRouting::IsRouteCacheable (void) const
+{
+  for (Ipv6RoutingProtocolList::const_iterator i = m_routingProtocols.begin ();
+       i != m_routingProtocols.end (); i++)
+    {
+      if (!(*i).second->IsRouteCacheable ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 void
 Ipv6ListRouting::SetIpv6 (Ptr<Ipv6> ipv6)
 {
@@ -37,5 +37,11 @@ TypeId Ipv6RoutingProtocol::GetTypeId ()
   return tid;
 }
 
+bool
+Ipv6RoutingProtocol::IsRouteCacheable (void) const
+{
+  return false;
+}
+
 } /* namespace ns3 */
 
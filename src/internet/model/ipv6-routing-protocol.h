@@ -197,6 +197,20 @@ public:
    */
   virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const = 0;
 
+  /**
+   * \brief Whether the forwarding routes can be cached by the IP layer
+   *
+   * With the FastForwarding attribute of Ipv6L3Protocol, the route used
+   * to forward the packets to a destination is reused for the following
+   * packets to that destination, without calling RouteInput.  This is only
+   * correct if RouteInput always returns the same route for a destination,
+   * whatever the packet, and has no side effect.  The default
+   * implementation returns false.
+   *
+   * \return true if the forwarding routes can be cached
+   */
+  virtual bool IsRouteCacheable (void) const;
+
 };
 
 } // namespace ns3
@@ -50,8 +50,10 @@ TypeId NdiscCache::GetTypeId ()
 } 
 
 NdiscCache::NdiscCache ()
+  : m_nudSweeping (false)
 {
   NS_LOG_FUNCTION (this);
+  m_nudTimer.SetFunction (&NdiscCache::HandleNudTimeout, this);
 }
 
 NdiscCache::~NdiscCache ()
@@ -67,6 +69,8 @@ void NdiscCache::DoDispose ()
   m_device = 0;
   m_interface = 0;
   m_icmpv6 = 0;
+  m_nudTimer.Cancel ();
+  m_nudTimer.SetWheel (0);
   Object::DoDispose ();
 }
 
@@ -76,6 +80,15 @@ void NdiscCache::SetDevice (Ptr<NetDevice> device, Ptr<Ipv6Interface> interface,
   m_device = device;
   m_interface = interface;
   m_icmpv6 = icmpv6;
+  if (device->GetNode () != 0)
+    {
+      m_nudTimer.Cancel ();
+      m_nudTimer.SetWheel (device->GetNode ()->GetObject<TimerWheel> ());
+      if (!m_nudQueue.empty ())
+        {
+          m_nudTimer.Schedule (m_nudQueue.begin ()->first - Simulator::Now ());
+        }
+    }
 }
 
 Ptr<Ipv6Interface> NdiscCache::GetInterface () const
@@ -138,15 +151,13 @@ void NdiscCache::Remove (NdiscCache::Entry* entry)
 {
   NS_LOG_FUNCTION (this << entry);
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  CacheI i = m_ndCache.find (entry->m_ipv6Address);
+  if (i != m_ndCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_ndCache.erase (i);
-          entry->ClearWaitingPacket ();
-          delete entry;
-          return;
-        }
+      m_ndCache.erase (i);
+      CancelNud (entry);
+      entry->ClearWaitingPacket ();
+      delete entry;
     }
 }
 
@@ -160,6 +171,69 @@ void NdiscCache::Flush ()
     }
 
   m_ndCache.erase (m_ndCache.begin (), m_ndCache.end ());
+  m_nudQueue.clear ();
+  m_nudTimer.Cancel ();
+}
+
+void NdiscCache::ScheduleNud (Entry *entry, void (Entry::*function) (), Time delay)
+{
+  NS_LOG_FUNCTION (this << entry << delay);
+  CancelNud (entry);
+
+  Time expiry = Simulator::Now () + delay;
+  entry->m_nudFunction = function;
+  entry->m_nudDelay = delay;
+  entry->m_nudRunning = true;
+  // entries expiring at the same time are kept in the order they have been scheduled
+  entry->m_nudPosition = m_nudQueue.insert (m_nudQueue.end (), std::make_pair (expiry, entry));
+
+  // the sweeper is only moved if this entry expires first; while the
+  // expired entries are handled, it is rearmed once they all returned
+  if (m_nudSweeping)
+    {
+      return;
+    }
+  if (!m_nudTimer.IsRunning () || Simulator::Now () + m_nudTimer.GetDelayLeft () > expiry)
+    {
+      m_nudTimer.Cancel ();
+      m_nudTimer.Schedule (delay);
+    }
+}
+
+void NdiscCache::CancelNud (Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  if (entry->m_nudRunning)
+    {
+      m_nudQueue.erase (entry->m_nudPosition);
+      entry->m_nudRunning = false;
+    }
+}
+
+void NdiscCache::HandleNudTimeout ()
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+
+  // an expiring entry may reschedule, cancel or remove any entry, hence the
+  // queue is looked at again after each call
+  m_nudSweeping = true;
+  while (!m_nudQueue.empty () && m_nudQueue.begin ()->first <= now)
+    {
+      Entry *entry = m_nudQueue.begin ()->second;
+      m_nudQueue.erase (m_nudQueue.begin ());
+      entry->m_nudRunning = false;
+      (entry->*(entry->m_nudFunction)) ();
+    }
+  m_nudSweeping = false;
+
+  // the sweeper is set to the earliest remaining entry, whatever has been
+  // rescheduled in between
+  m_nudTimer.Cancel ();
+  if (!m_nudQueue.empty ())
+    {
+      m_nudTimer.Schedule (m_nudQueue.begin ()->first - now);
+    }
 }
 
 void NdiscCache::SetUnresQlen (uint32_t unresQlen)
@@ -229,9 +303,10 @@ NdiscCache::Entry::Entry (NdiscCache* nd)
   : m_ndCache (nd),
     m_waiting (),
     m_router (false),
-    m_nudTimer (Timer::CANCEL_ON_DESTROY),
     m_lastReachabilityConfirmation (Seconds (0.0)),
-    m_nsRetransmit (0)
+    m_nsRetransmit (0),
+    m_nudFunction (0),
+    m_nudRunning (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -418,15 +493,8 @@ Time NdiscCache::Entry::GetLastReachabilityConfirmation () const
 void NdiscCache::Entry::StartReachableTimer ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
   m_lastReachabilityConfirmation = Simulator::Now ();
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionReachableTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetReachableTime ());
-  m_nudTimer.Schedule ();
+  m_ndCache->ScheduleNud (this, &NdiscCache::Entry::FunctionReachableTimeout, m_ndCache->m_icmpv6->GetReachableTime ());
 }
 
 void NdiscCache::Entry::UpdateReachableTimer ()
@@ -436,57 +504,35 @@ void NdiscCache::Entry::UpdateReachableTimer ()
   if (m_state == REACHABLE)
     {
       m_lastReachabilityConfirmation = Simulator::Now ();
-      if (m_nudTimer.IsRunning ())
+      if (m_nudFunction)
         {
-          m_nudTimer.Cancel ();
+          m_ndCache->ScheduleNud (this, m_nudFunction, m_nudDelay);
         }
-      m_nudTimer.Schedule ();
     }
 }
 
 void NdiscCache::Entry::StartProbeTimer ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionProbeTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetRetransmissionTime ());
-  m_nudTimer.Schedule ();
+  m_ndCache->ScheduleNud (this, &NdiscCache::Entry::FunctionProbeTimeout, m_ndCache->m_icmpv6->GetRetransmissionTime ());
 }
 
 void NdiscCache::Entry::StartDelayTimer ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionDelayTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetDelayFirstProbe ());
-  m_nudTimer.Schedule ();
+  m_ndCache->ScheduleNud (this, &NdiscCache::Entry::FunctionDelayTimeout, m_ndCache->m_icmpv6->GetDelayFirstProbe ());
 }
 
 void NdiscCache::Entry::StartRetransmitTimer ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetRetransmissionTime ());
-  m_nudTimer.Schedule ();
+  m_ndCache->ScheduleNud (this, &NdiscCache::Entry::FunctionRetransmitTimeout, m_ndCache->m_icmpv6->GetRetransmissionTime ());
 }
 
 void NdiscCache::Entry::StopNudTimer ()
 {
   NS_LOG_FUNCTION (this);
-  m_nudTimer.Cancel ();
+  m_ndCache->CancelNud (this);
   m_nsRetransmit = 0;
 }
 
@@ -23,13 +23,14 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
 
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/net-device.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/sgi-hashmap.h"
 #include "ns3/output-stream-wrapper.h"
 
@@ -358,6 +359,8 @@ protected:
     NdiscCache* m_ndCache;
 
 private:
+    friend class NdiscCache;
+
     /**
      * \brief The IPv6 address.
      */
@@ -396,11 +399,6 @@ private:
      */
     bool m_router;
 
-    /**
-     * \brief Timer (used for NUD).
-     */
-    Timer m_nudTimer;
-
     /**
      * \brief Last time we see a reachability confirmation.
      */
@@ -410,6 +408,26 @@ private:
      * \brief Number of NS retransmission.
      */
     uint8_t m_nsRetransmit;
+
+    /**
+     * \brief Function called when the NUD timer expires.
+     */
+    void (Entry::*m_nudFunction) ();
+
+    /**
+     * \brief Delay of the NUD timer.
+     */
+    Time m_nudDelay;
+
+    /**
+     * \brief True if the NUD timer is running.
+     */
+    bool m_nudRunning;
+
+    /**
+     * \brief Position of the entry in the NUD queue of the cache, if the NUD timer is running.
+     */
+    std::multimap<Time, Entry *>::iterator m_nudPosition;
   };
 
 protected:
@@ -465,6 +483,43 @@ private:
    */
   Ptr<Icmpv6L4Protocol> m_icmpv6;
 
+  /**
+   * \brief Start the NUD timer of an entry.
+   * \param entry the entry
+   * \param function the function to call when the timer expires
+   * \param delay the delay
+   */
+  void ScheduleNud (Entry *entry, void (Entry::*function) (), Time delay);
+
+  /**
+   * \brief Stop the NUD timer of an entry, if it is running.
+   * \param entry the entry
+   */
+  void CancelNud (Entry *entry);
+
+  /**
+   * \brief Expire the NUD timers of the entries whose delay elapsed,
+   * and rearm the sweeper for the next one.
+   */
+  void HandleNudTimeout ();
+
+  /**
+   * \brief The entries whose NUD timer is running, sorted by expiration time.
+   */
+  std::multimap<Time, Entry *> m_nudQueue;
+
+  /**
+   * \brief The timer expiring the NUD timers of all the entries, set to the
+   * earliest expiration time (kept by the timer wheel of the node, if any).
+   */
+  WheelTimer m_nudTimer;
+
+  /**
+   * \brief True while HandleNudTimeout calls the expired entries, which
+   * defers the rearming of m_nudTimer to the end of the sweep.
+   */
+  bool m_nudSweeping;
+
   /**
    * \brief Max number of packet stored in m_waiting.
    */
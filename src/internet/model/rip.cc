@@ -19,6 +19,7 @@
  */
 
 #include <iomanip>
+#include <algorithm>
 #include "rip.h"
 #include "ns3/log.h"
 #include "ns3/abort.h"
@@ -45,7 +46,7 @@ NS_LOG_COMPONENT_DEFINE ("Rip");
 NS_OBJECT_ENSURE_REGISTERED (Rip);
 
 Rip::Rip ()
-  : m_ipv4 (0), m_splitHorizonStrategy (Rip::POISON_REVERSE), m_initialized (false)
+  : m_routesVersion (0), m_ipv4 (0), m_splitHorizonStrategy (Rip::POISON_REVERSE), m_initialized (false)
 {
   m_rng = CreateObject<UniformRandomVariable> ();
 }
@@ -312,6 +313,8 @@ void Rip::NotifyInterfaceUp (uint32_t i)
           AddNetworkRouteTo (networkAddress, networkMask, i);
         }
     }
+  // the routes advertised on the interface depend on its addresses
+  m_routesVersion++;
 
   if (!m_initialized)
     {
@@ -383,9 +386,10 @@ void Rip::NotifyInterfaceDown (uint32_t interface)
     {
       if (it->first->GetInterface () == interface)
         {
-          InvalidateRoute (it->first);
+          InvalidateRoute (it);
         }
     }
+  m_routesVersion++;
 
   for (SocketListI iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++ )
     {
@@ -426,6 +430,7 @@ void Rip::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
     {
       AddNetworkRouteTo (networkAddress, networkMask, interface);
     }
+  m_routesVersion++;
 
   SendTriggeredRouteUpdate ();
 }
@@ -456,9 +461,10 @@ void Rip::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkMask () == networkMask)
         {
-          InvalidateRoute (it->first);
+          InvalidateRoute (it);
         }
     }
+  m_routesVersion++;
 
   if (m_interfaceExclusions.find (interface) == m_interfaceExclusions.end ())
     {
@@ -474,6 +480,7 @@ void Rip::SetIpv4 (Ptr<Ipv4> ipv4)
   NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
   uint32_t i = 0;
   m_ipv4 = ipv4;
+  m_timerWheel = ipv4->GetObject<TimerWheel> ();
 
   for (i = 0; i < m_ipv4->GetNInterfaces (); i++)
     {
@@ -553,8 +560,15 @@ void Rip::DoDispose ()
   for (RoutesI j = m_routes.begin ();  j != m_routes.end (); j = m_routes.erase (j))
     {
       delete j->first;
+      delete j->second;
     }
   m_routes.clear ();
+  m_routeIndex.clear ();
+  m_deleteTimersEvent.Cancel ();
+  DeleteTimers ();
+  m_timerWheel = 0;
+  m_changedRoutes.clear ();
+  m_updateCache.clear ();
 
   m_nextTriggeredUpdate.Cancel ();
   m_nextUnsolicitedUpdate.Cancel ();
@@ -659,7 +673,8 @@ void Rip::AddNetworkRouteTo (Ipv4Address network, Ipv4Mask networkPrefix, Ipv4Ad
   route->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
   route->SetRouteChanged (true);
 
-  m_routes.push_back (std::make_pair (route, EventId ()));
+  InsertRoute (m_routes.end (), route);
+  NotifyRouteChanged (route);
 }
 
 void Rip::AddNetworkRouteTo (Ipv4Address network, Ipv4Mask networkPrefix, uint32_t interface)
@@ -671,45 +686,115 @@ void Rip::AddNetworkRouteTo (Ipv4Address network, Ipv4Mask networkPrefix, uint32
   route->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
   route->SetRouteChanged (true);
 
-  m_routes.push_back (std::make_pair (route, EventId ()));
+  InsertRoute (m_routes.end (), route);
+  NotifyRouteChanged (route);
 }
 
-void Rip::InvalidateRoute (RipRoutingTableEntry *route)
+Rip::RoutesI Rip::InsertRoute (RoutesI position, RipRoutingTableEntry *route)
 {
   NS_LOG_FUNCTION (this << *route);
 
-  for (RoutesI it = m_routes.begin (); it != m_routes.end (); it++)
+  WheelTimer *timer = new WheelTimer ();
+  timer->SetWheel (m_timerWheel);
+  timer->SetFunction (&Rip::HandleRouteTimer, this);
+  RoutesI it = m_routes.insert (position, std::make_pair (route, timer));
+  m_routeIndex.insert (std::make_pair (route->GetDestNetwork (), it));
+  return it;
+}
+
+void Rip::NotifyRouteChanged (RipRoutingTableEntry *route)
+{
+  m_routesVersion++;
+  if (route->IsRouteChanged ())
     {
-      if (it->first == route)
-        {
-          route->SetRouteStatus (RipRoutingTableEntry::RIP_INVALID);
-          route->SetRouteMetric (m_linkDown);
-          route->SetRouteChanged (true);
-          if (it->second.IsRunning ())
-            {
-              it->second.Cancel ();
-            }
-          it->second = Simulator::Schedule (m_garbageCollectionDelay, &Rip::DeleteRoute, this, route);
-          return;
-        }
+      m_changedRoutes.push_back (route);
+    }
+}
+
+void Rip::SetRouteTimer (RoutesI it, Time delay, bool garbageCollection)
+{
+  it->second->Cancel ();
+  it->second->SetArguments (it, garbageCollection);
+  it->second->Schedule (delay);
+}
+
+void Rip::CancelRouteTimer (RoutesI it)
+{
+  it->second->Cancel ();
+}
+
+Time Rip::GetRouteTimerDelayLeft (RoutesI it) const
+{
+  return it->second->GetDelayLeft ();
+}
+
+void Rip::HandleRouteTimer (RoutesI it, bool garbageCollection)
+{
+  NS_LOG_FUNCTION (this << *it->first << garbageCollection);
+
+  if (garbageCollection)
+    {
+      DeleteRoute (it);
+    }
+  else
+    {
+      InvalidateRoute (it);
     }
-  NS_ABORT_MSG ("RIP::InvalidateRoute - cannot find the route to update");
 }
 
-void Rip::DeleteRoute (RipRoutingTableEntry *route)
+void Rip::InvalidateRoute (RoutesI it)
 {
+  RipRoutingTableEntry *route = it->first;
   NS_LOG_FUNCTION (this << *route);
 
-  for (RoutesI it = m_routes.begin (); it != m_routes.end (); it++)
+  route->SetRouteStatus (RipRoutingTableEntry::RIP_INVALID);
+  route->SetRouteMetric (m_linkDown);
+  route->SetRouteChanged (true);
+  NotifyRouteChanged (route);
+  SetRouteTimer (it, m_garbageCollectionDelay, true);
+}
+
+void Rip::DeleteRoute (RoutesI it)
+{
+  RipRoutingTableEntry *route = it->first;
+  NS_LOG_FUNCTION (this << *route);
+
+  // the timer may be the one invoking this function, hence it is only
+  // stopped here and deleted once the current event returned
+  it->second->Cancel ();
+  m_deletedTimers.push_back (it->second);
+  if (!m_deleteTimersEvent.IsRunning ())
+    {
+      m_deleteTimersEvent = Simulator::ScheduleNow (&Rip::DeleteTimers, this);
+    }
+  std::pair<RouteIndex::iterator, RouteIndex::iterator> range = m_routeIndex.equal_range (route->GetDestNetwork ());
+  for (RouteIndex::iterator iter = range.first; iter != range.second; iter++)
     {
-      if (it->first == route)
+      if (iter->second == it)
         {
-          delete route;
-          m_routes.erase (it);
-          return;
+          m_routeIndex.erase (iter);
+          break;
         }
     }
-  NS_ABORT_MSG ("RIP::DeleteRoute - cannot find the route to delete");
+  if (route->IsRouteChanged ())
+    {
+      m_changedRoutes.erase (std::remove (m_changedRoutes.begin (), m_changedRoutes.end (), route), m_changedRoutes.end ());
+    }
+  m_routesVersion++;
+
+  delete route;
+  m_routes.erase (it);
+}
+
+void Rip::DeleteTimers ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (std::vector<WheelTimer *>::iterator it = m_deletedTimers.begin (); it != m_deletedTimers.end (); it++)
+    {
+      delete *it;
+    }
+  m_deletedTimers.clear ();
 }
 
 
@@ -991,69 +1076,65 @@ void Rip::HandleResponses (RipHeader hdr, Ipv4Address senderAddress, uint32_t in
           rteMetric = m_linkDown;
         }
 
-      RoutesI it;
       bool found = false;
-      for (it = m_routes.begin (); it != m_routes.end (); it++)
+      std::pair<RouteIndex::iterator, RouteIndex::iterator> range = m_routeIndex.equal_range (rteAddr);
+      for (RouteIndex::iterator idx = range.first; idx != range.second; idx++)
         {
-          if (it->first->GetDestNetwork () == rteAddr &&
-              it->first->GetDestNetworkMask () == rtePrefixMask)
+          RoutesI it = idx->second;
+          if (it->first->GetDestNetworkMask () == rtePrefixMask)
             {
               found = true;
               if (rteMetric < it->first->GetRouteMetric ())
                 {
                   if (senderAddress != it->first->GetGateway ())
                     {
-                      RipRoutingTableEntry* route = new RipRoutingTableEntry (rteAddr, rtePrefixMask, senderAddress, incomingInterface);
-                      delete it->first;
-                      it->first = route;
+                      // the entry is replaced in place, its timer and its index stay valid
+                      *it->first = RipRoutingTableEntry (rteAddr, rtePrefixMask, senderAddress, incomingInterface);
                     }
                   it->first->SetRouteMetric (rteMetric);
                   it->first->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
                   it->first->SetRouteTag (iter->GetRouteTag ());
                   it->first->SetRouteChanged (true);
-                  it->second.Cancel ();
-                  it->second = Simulator::Schedule (m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
+                  NotifyRouteChanged (it->first);
+                  SetRouteTimer (it, m_timeoutDelay, false);
                   changed = true;
                 }
               else if (rteMetric == it->first->GetRouteMetric ())
                 {
                   if (senderAddress == it->first->GetGateway ())
                     {
-                      it->second.Cancel ();
-                      it->second = Simulator::Schedule (m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
+                      SetRouteTimer (it, m_timeoutDelay, false);
                     }
                   else
                     {
-                      if (Simulator::GetDelayLeft (it->second) < m_timeoutDelay/2)
+                      if (GetRouteTimerDelayLeft (it) < m_timeoutDelay/2)
                         {
-                          RipRoutingTableEntry* route = new RipRoutingTableEntry (rteAddr, rtePrefixMask, senderAddress, incomingInterface);
-                          route->SetRouteMetric (rteMetric);
-                          route->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
-                          route->SetRouteTag (iter->GetRouteTag ());
-                          route->SetRouteChanged (true);
-                          delete it->first;
-                          it->first = route;
-                          it->second.Cancel ();
-                          it->second = Simulator::Schedule (m_timeoutDelay, &Rip::InvalidateRoute, this, route);
+                          *it->first = RipRoutingTableEntry (rteAddr, rtePrefixMask, senderAddress, incomingInterface);
+                          it->first->SetRouteMetric (rteMetric);
+                          it->first->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
+                          it->first->SetRouteTag (iter->GetRouteTag ());
+                          it->first->SetRouteChanged (true);
+                          NotifyRouteChanged (it->first);
+                          SetRouteTimer (it, m_timeoutDelay, false);
                           changed = true;
                         }
                     }
                 }
               else if (rteMetric > it->first->GetRouteMetric () && senderAddress == it->first->GetGateway ())
                 {
-                  it->second.Cancel ();
+                  CancelRouteTimer (it);
                   if (rteMetric < m_linkDown)
                     {
                       it->first->SetRouteMetric (rteMetric);
                       it->first->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
                       it->first->SetRouteTag (iter->GetRouteTag ());
                       it->first->SetRouteChanged (true);
-                      it->second.Cancel ();
-                      it->second = Simulator::Schedule (m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
+                      NotifyRouteChanged (it->first);
+                      SetRouteTimer (it, m_timeoutDelay, false);
                     }
                   else
                     {
-                      InvalidateRoute (it->first);
+                      InvalidateRoute (it);
                     }
                   changed = true;
                 }
@@ -1067,9 +1148,9 @@ void Rip::HandleResponses (RipHeader hdr, Ipv4Address senderAddress, uint32_t in
           route->SetRouteMetric (rteMetric);
           route->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
           route->SetRouteChanged (true);
-          m_routes.push_front (std::make_pair (route, EventId ()));
-          EventId invalidateEvent = Simulator::Schedule (m_timeoutDelay, &Rip::InvalidateRoute, this, route);
-          (m_routes.begin ())->second = invalidateEvent;
+          RoutesI it = InsertRoute (m_routes.begin (), route);
+          NotifyRouteChanged (route);
+          SetRouteTimer (it, m_timeoutDelay, false);
           changed = true;
         }
     }
@@ -1084,6 +1165,26 @@ void Rip::DoSendRouteUpdate (bool periodic)
 {
   NS_LOG_FUNCTION (this << (periodic ? " periodic" : " triggered"));
 
+  // a triggered update only carries the routes changed since the last update
+  std::vector<RipRoutingTableEntry *> changedRoutes;
+  if (!periodic)
+    {
+      for (std::vector<RipRoutingTableEntry *>::iterator rtIter = m_changedRoutes.begin (); rtIter != m_changedRoutes.end (); rtIter++)
+        {
+          if ((*rtIter)->IsRouteChanged ())
+            {
+              changedRoutes.push_back (*rtIter);
+              (*rtIter)->SetRouteChanged (false);
+            }
+        }
+      m_changedRoutes.clear ();
+      if (changedRoutes.empty ())
+        {
+          NS_LOG_LOGIC ("No route changed, skipping the triggered update");
+          return;
+        }
+    }
+
   for (SocketListI iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++ )
     {
       uint32_t interface = iter->second;
@@ -1093,81 +1194,121 @@ void Rip::DoSendRouteUpdate (bool periodic)
           uint16_t mtu = m_ipv4->GetMtu (interface);
           uint16_t maxRte = (mtu - Ipv4Header ().GetSerializedSize () - UdpHeader ().GetSerializedSize () - RipHeader ().GetSerializedSize ()) / RipRte ().GetSerializedSize ();
 
-          Ptr<Packet> p = Create<Packet> ();
-          SocketIpTtlTag tag;
-          tag.SetTtl (1);
-          p->AddPacketTag (tag);
-
           RipHeader hdr;
           hdr.SetCommand (RipHeader::RESPONSE);
 
-          for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
+          std::vector<Ptr<Packet> > triggeredPackets;
+          std::vector<Ptr<Packet> > *packets = &triggeredPackets;
+          if (periodic)
             {
-              bool splitHorizoning = (rtIter->first->GetInterface () == interface);
-              Ipv4InterfaceAddress rtDestAddr = Ipv4InterfaceAddress(rtIter->first->GetDestNetwork (), rtIter->first->GetDestNetworkMask ());
-
-              NS_LOG_DEBUG ("Processing RT " << rtDestAddr << " " << int(rtIter->first->IsRouteChanged ()));
-
-              bool isGlobal = (rtDestAddr.GetScope () == Ipv4InterfaceAddress::GLOBAL);
-              bool isDefaultRoute = ((rtIter->first->GetDestNetwork () == Ipv4Address::GetAny ()) &&
-                  (rtIter->first->GetDestNetworkMask () == Ipv4Mask::GetZero ()) &&
-                  (rtIter->first->GetInterface () != interface));
-
-              bool sameNetwork = false;
-              for (uint32_t index = 0; index < m_ipv4->GetNAddresses (interface); index++)
+              // the periodic update is serialized again only if the routes changed
+              UpdateCache &cache = m_updateCache[interface];
+              if (cache.packets.empty () || cache.version != m_routesVersion || cache.maxRte != maxRte)
                 {
-                  Ipv4InterfaceAddress addr = m_ipv4->GetAddress (interface, index);
-                  if (addr.GetLocal ().CombineMask (addr.GetMask ()) == rtIter->first->GetDestNetwork ())
+                  cache.version = m_routesVersion;
+                  cache.maxRte = maxRte;
+                  cache.packets.clear ();
+                  for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
                     {
-                      sameNetwork = true;
+                      AddUpdateRte (rtIter->first, interface, maxRte, hdr, cache.packets);
                     }
+                  FlushUpdateRtes (hdr, cache.packets);
                 }
-
-              if ((isGlobal || isDefaultRoute) &&
-                  (periodic || rtIter->first->IsRouteChanged ()) &&
-                  !sameNetwork)
+              else
                 {
-                  RipRte rte;
-                  rte.SetPrefix (rtIter->first->GetDestNetwork ());
-                  rte.SetSubnetMask (rtIter->first->GetDestNetworkMask ());
-                  if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
-                    {
-                      rte.SetRouteMetric (m_linkDown);
-                    }
-                  else
-                    {
-                      rte.SetRouteMetric (rtIter->first->GetRouteMetric ());
-                    }
-                  rte.SetRouteTag (rtIter->first->GetRouteTag ());
-                  if (m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning)
-                    {
-                      hdr.AddRte (rte);
-                    }
-                  else if (m_splitHorizonStrategy != SPLIT_HORIZON)
-                    {
-                      hdr.AddRte (rte);
-                    }
+                  NS_LOG_LOGIC ("Routes unchanged, reusing the periodic update for interface " << interface);
                 }
-              if (hdr.GetRteNumber () == maxRte)
+              packets = &cache.packets;
+            }
+          else
+            {
+              for (std::vector<RipRoutingTableEntry *>::iterator rtIter = changedRoutes.begin (); rtIter != changedRoutes.end (); rtIter++)
                 {
-                  p->AddHeader (hdr);
-                  NS_LOG_DEBUG ("SendTo: " << *p);
-                  iter->first->SendTo (p, 0, InetSocketAddress (RIP_ALL_NODE, RIP_PORT));
-                  p->RemoveHeader (hdr);
-                  hdr.ClearRtes ();
+                  AddUpdateRte (*rtIter, interface, maxRte, hdr, triggeredPackets);
                 }
+              FlushUpdateRtes (hdr, triggeredPackets);
             }
-          if (hdr.GetRteNumber () > 0)
+
+          for (std::vector<Ptr<Packet> >::const_iterator pIter = packets->begin (); pIter != packets->end (); pIter++)
             {
-              p->AddHeader (hdr);
-              NS_LOG_DEBUG ("SendTo: " << *p);
-              iter->first->SendTo (p, 0, InetSocketAddress (RIP_ALL_NODE, RIP_PORT));
+              NS_LOG_DEBUG ("SendTo: " << **pIter);
+              iter->first->SendTo ((*pIter)->Copy (), 0, InetSocketAddress (RIP_ALL_NODE, RIP_PORT));
             }
         }
     }
-  for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
+
+  if (periodic)
+    {
+      for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
+        {
+          rtIter->first->SetRouteChanged (false);
+        }
+      m_changedRoutes.clear ();
+    }
+}
+
+void Rip::AddUpdateRte (RipRoutingTableEntry *route, uint32_t interface, uint16_t maxRte, RipHeader &hdr, std::vector<Ptr<Packet> > &packets) const
+{
+  bool splitHorizoning = (route->GetInterface () == interface);
+  Ipv4InterfaceAddress rtDestAddr = Ipv4InterfaceAddress(route->GetDestNetwork (), route->GetDestNetworkMask ());
+
+  NS_LOG_DEBUG ("Processing RT " << rtDestAddr << " " << int(route->IsRouteChanged ()));
+
+  bool isGlobal = (rtDestAddr.GetScope () == Ipv4InterfaceAddress::GLOBAL);
+  bool isDefaultRoute = ((route->GetDestNetwork () == Ipv4Address::GetAny ()) &&
+      (route->GetDestNetworkMask () == Ipv4Mask::GetZero ()) &&
+      (route->GetInterface () != interface));
+
+  bool sameNetwork = false;
+  for (uint32_t index = 0; index < m_ipv4->GetNAddresses (interface); index++)
+    {
+      Ipv4InterfaceAddress addr = m_ipv4->GetAddress (interface, index);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == route->GetDestNetwork ())
+        {
+          sameNetwork = true;
+        }
+    }
+
+  if ((isGlobal || isDefaultRoute) && !sameNetwork)
     {
-      rtIter->first->SetRouteChanged (false);
+      RipRte rte;
+      rte.SetPrefix (route->GetDestNetwork ());
+      rte.SetSubnetMask (route->GetDestNetworkMask ());
+      if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
+        {
+          rte.SetRouteMetric (m_linkDown);
+        }
+      else
+        {
+          rte.SetRouteMetric (route->GetRouteMetric ());
+        }
+      rte.SetRouteTag (route->GetRouteTag ());
+      if (m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning)
+        {
+          hdr.AddRte (rte);
+        }
+      else if (m_splitHorizonStrategy != SPLIT_HORIZON)
+        {
+          hdr.AddRte (rte);
+        }
+    }
+  if (hdr.GetRteNumber () == maxRte)
+    {
+      FlushUpdateRtes (hdr, packets);
+    }
+}
+
+void Rip::FlushUpdateRtes (RipHeader &hdr, std::vector<Ptr<Packet> > &packets) const
+{
+  if (hdr.GetRteNumber () > 0)
+    {
+      Ptr<Packet> p = Create<Packet> ();
+      SocketIpTtlTag tag;
+      tag.SetTtl (1);
+      p->AddPacketTag (tag);
+      p->AddHeader (hdr);
+      packets.push_back (p);
+      hdr.ClearRtes ();
     }
 }
 
@@ -22,6 +22,9 @@
 #define RIP_H
 
 #include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-interface.h"
@@ -29,6 +32,7 @@
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/rip-header.h"
 
 namespace ns3 {
@@ -264,14 +268,27 @@ protected:
   void DoInitialize ();
 
 private:
-  /// Container for the network routes - pair RipRoutingTableEntry *, EventId (update event)
-  typedef std::list<std::pair <RipRoutingTableEntry *, EventId> > Routes;
+  /// Container for the network routes - pair RipRoutingTableEntry *, route timer (timeout or garbage collection)
+  typedef std::list<std::pair <RipRoutingTableEntry *, WheelTimer *> > Routes;
 
   /// Const Iterator for container for the network routes
-  typedef std::list<std::pair <RipRoutingTableEntry *, EventId> >::const_iterator RoutesCI;
+  typedef Routes::const_iterator RoutesCI;
 
   /// Iterator for container for the network routes
-  typedef std::list<std::pair <RipRoutingTableEntry *, EventId> >::iterator RoutesI;
+  typedef Routes::iterator RoutesI;
+
+  /// Index of the network routes by destination network
+  typedef std::unordered_multimap<Ipv4Address, RoutesI, Ipv4AddressHash> RouteIndex;
+
+  /**
+   * \brief Serialized periodic update for an interface.
+   */
+  struct UpdateCache
+  {
+    uint64_t version; //!< version of the routing table the packets were built from
+    uint16_t maxRte; //!< max number of RTEs per packet the packets were built with
+    std::vector<Ptr<Packet> > packets; //!< the update packets
+  };
 
 
   /**
@@ -359,19 +376,93 @@ private:
    */
   void SendUnsolicitedRouteUpdate (void);
 
+  /**
+   * \brief Add the RTE of a route to an update, if the route is to be advertised on the interface.
+   *
+   * A packet is appended to the update packets when the header is full.
+   *
+   * \param route the route
+   * \param interface the interface the update is sent on
+   * \param maxRte max number of RTEs per packet
+   * \param hdr the header being filled
+   * \param packets the update packets
+   */
+  void AddUpdateRte (RipRoutingTableEntry *route, uint32_t interface, uint16_t maxRte, RipHeader &hdr, std::vector<Ptr<Packet> > &packets) const;
+
+  /**
+   * \brief Append a packet with the header RTEs (if any) to the update packets.
+   * \param hdr the header, cleared on return
+   * \param packets the update packets
+   */
+  void FlushUpdateRtes (RipHeader &hdr, std::vector<Ptr<Packet> > &packets) const;
+
+  /**
+   * \brief Add a route to the routing table.
+   * \param position the position of the route in the table
+   * \param route the route
+   * \return an iterator to the route
+   */
+  RoutesI InsertRoute (RoutesI position, RipRoutingTableEntry *route);
+
+  /**
+   * \brief Record a change of a route, to be announced by the next update.
+   * \param route the route
+   */
+  void NotifyRouteChanged (RipRoutingTableEntry *route);
+
+  /**
+   * \brief Set the timeout or the garbage collection timer of a route.
+   * \param it the route
+   * \param delay the timer delay
+   * \param garbageCollection true to delete the route on expiration, false to invalidate it
+   */
+  void SetRouteTimer (RoutesI it, Time delay, bool garbageCollection);
+
+  /**
+   * \brief Cancel the timer of a route.
+   * \param it the route
+   */
+  void CancelRouteTimer (RoutesI it);
+
+  /**
+   * \brief Get the time left before the timer of a route expires.
+   * \param it the route
+   * \return the time left, zero if the route has no timer
+   */
+  Time GetRouteTimerDelayLeft (RoutesI it) const;
+
+  /**
+   * \brief Handle the expiration of the timer of a route.
+   * \param it the route
+   * \param garbageCollection true to delete the route, false to invalidate it
+   */
+  void HandleRouteTimer (RoutesI it, bool garbageCollection);
+
   /**
    * \brief Invalidate a route.
-   * \param route the route to be removed
+   * \param it the route to be invalidated
    */
-  void InvalidateRoute (RipRoutingTableEntry *route);
+  void InvalidateRoute (RoutesI it);
 
   /**
    * \brief Delete a route.
-   * \param route the route to be removed
+   * \param it the route to be removed
+   */
+  void DeleteRoute (RoutesI it);
+
+  /**
+   * \brief Delete the timers of the routes deleted during the last event.
    */
-  void DeleteRoute (RipRoutingTableEntry *route);
+  void DeleteTimers ();
 
   Routes m_routes; //!<  the forwarding table for network.
+  RouteIndex m_routeIndex; //!< the routes indexed by destination network
+  Ptr<TimerWheel> m_timerWheel; //!< the timer wheel of the node, if any
+  std::vector<WheelTimer *> m_deletedTimers; //!< timers of the deleted routes, freed by DeleteTimers
+  EventId m_deleteTimersEvent; //!< event freeing the timers of the deleted routes
+  std::vector<RipRoutingTableEntry *> m_changedRoutes; //!< routes changed since the last update (may contain duplicates)
+  uint64_t m_routesVersion; //!< incremented on every change of the advertised routes
+  std::map<uint32_t, UpdateCache> m_updateCache; //!< periodic update packets for each interface
   Ptr<Ipv4> m_ipv4; //!< IPv4 reference
   Time m_startupDelay; //!< Random delay before protocol startup.
   Time m_minTriggeredUpdateDelay; //!< Min cooldown delay after a Triggered Update.
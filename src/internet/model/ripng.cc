@@ -19,6 +19,7 @@
  */
 
 #include <iomanip>
+#include <algorithm>
 #include "ripng.h"
 #include "ns3/log.h"
 #include "ns3/abort.h"
@@ -45,7 +46,7 @@ NS_LOG_COMPONENT_DEFINE ("RipNg");
 NS_OBJECT_ENSURE_REGISTERED (RipNg);
 
 RipNg::RipNg ()
-  : m_ipv6 (0), m_splitHorizonStrategy (RipNg::POISON_REVERSE), m_initialized (false)
+  : m_routesVersion (0), m_ipv6 (0), m_splitHorizonStrategy (RipNg::POISON_REVERSE), m_initialized (false)
 {
   m_rng = CreateObject<UniformRandomVariable> ();
 }
@@ -351,7 +352,7 @@ void RipNg::NotifyInterfaceDown (uint32_t interface)
     {
       if (it->first->GetInterface () == interface)
         {
-          InvalidateRoute (it->first);
+          InvalidateRoute (it);
         }
     }
 
@@ -424,7 +425,7 @@ void RipNg::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAddress addres
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkPrefix () == networkMask)
         {
-          InvalidateRoute (it->first);
+          InvalidateRoute (it);
         }
     }
 
@@ -454,6 +455,7 @@ void RipNg::SetIpv6 (Ptr<Ipv6> ipv6)
   NS_ASSERT (m_ipv6 == 0 && ipv6 != 0);
   uint32_t i = 0;
   m_ipv6 = ipv6;
+  m_timerWheel = ipv6->GetObject<TimerWheel> ();
 
   for (i = 0; i < m_ipv6->GetNInterfaces (); i++)
     {
@@ -532,8 +534,15 @@ void RipNg::DoDispose ()
   for (RoutesI j = m_routes.begin ();  j != m_routes.end (); j = m_routes.erase (j))
     {
       delete j->first;
+      delete j->second;
     }
   m_routes.clear ();
+  m_routeIndex.clear ();
+  m_deleteTimersEvent.Cancel ();
+  DeleteTimers ();
+  m_timerWheel = 0;
+  m_changedRoutes.clear ();
+  m_updateCache.clear ();
 
   m_nextTriggeredUpdate.Cancel ();
   m_nextUnsolicitedUpdate.Cancel ();
@@ -647,7 +656,8 @@ void RipNg::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ip
   route->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_VALID);
   route->SetRouteChanged (true);
 
-  m_routes.push_back (std::make_pair (route, EventId ()));
+  InsertRoute (m_routes.end (), route);
+  NotifyRouteChanged (route);
 }
 
 void RipNg::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t interface)
@@ -659,45 +669,115 @@ void RipNg::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, ui
   route->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_VALID);
   route->SetRouteChanged (true);
 
-  m_routes.push_back (std::make_pair (route, EventId ()));
+  InsertRoute (m_routes.end (), route);
+  NotifyRouteChanged (route);
 }
 
-void RipNg::InvalidateRoute (RipNgRoutingTableEntry *route)
+RipNg::RoutesI RipNg::InsertRoute (RoutesI position, RipNgRoutingTableEntry *route)
 {
   NS_LOG_FUNCTION (this << *route);
 
-  for (RoutesI it = m_routes.begin (); it != m_routes.end (); it++)
+  WheelTimer *timer = new WheelTimer ();
+  timer->SetWheel (m_timerWheel);
+  timer->SetFunction (&RipNg::HandleRouteTimer, this);
+  RoutesI it = m_routes.insert (position, std::make_pair (route, timer));
+  m_routeIndex.insert (std::make_pair (route->GetDestNetwork (), it));
+  return it;
+}
+
+void RipNg::NotifyRouteChanged (RipNgRoutingTableEntry *route)
+{
+  m_routesVersion++;
+  if (route->IsRouteChanged ())
     {
-      if (it->first == route)
-        {
-          route->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_INVALID);
-          route->SetRouteMetric (m_linkDown);
-          route->SetRouteChanged (true);
-          if (it->second.IsRunning ())
-            {
-              it->second.Cancel ();
-            }
-          it->second = Simulator::Schedule (m_garbageCollectionDelay, &RipNg::DeleteRoute, this, route);
-          return;
-        }
+      m_changedRoutes.push_back (route);
+    }
+}
+
+void RipNg::SetRouteTimer (RoutesI it, Time delay, bool garbageCollection)
+{
+  it->second->Cancel ();
+  it->second->SetArguments (it, garbageCollection);
+  it->second->Schedule (delay);
+}
+
+void RipNg::CancelRouteTimer (RoutesI it)
+{
+  it->second->Cancel ();
+}
+
+Time RipNg::GetRouteTimerDelayLeft (RoutesI it) const
+{
+  return it->second->GetDelayLeft ();
+}
+
+void RipNg::HandleRouteTimer (RoutesI it, bool garbageCollection)
+{
+  NS_LOG_FUNCTION (this << *it->first << garbageCollection);
+
+  if (garbageCollection)
+    {
+      DeleteRoute (it);
+    }
+  else
+    {
+      InvalidateRoute (it);
     }
-  NS_ABORT_MSG ("Ripng::InvalidateRoute - cannot find the route to update");
 }
 
-void RipNg::DeleteRoute (RipNgRoutingTableEntry *route)
+void RipNg::InvalidateRoute (RoutesI it)
 {
+  RipNgRoutingTableEntry *route = it->first;
   NS_LOG_FUNCTION (this << *route);
 
-  for (RoutesI it = m_routes.begin (); it != m_routes.end (); it++)
+  route->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_INVALID);
+  route->SetRouteMetric (m_linkDown);
+  route->SetRouteChanged (true);
+  NotifyRouteChanged (route);
+  SetRouteTimer (it, m_garbageCollectionDelay, true);
+}
+
+void RipNg::DeleteRoute (RoutesI it)
+{
+  RipNgRoutingTableEntry *route = it->first;
+  NS_LOG_FUNCTION (this << *route);
+
+  // the timer may be the one invoking this function, hence it is only
+  // stopped here and deleted once the current event returned
+  it->second->Cancel ();
+  m_deletedTimers.push_back (it->second);
+  if (!m_deleteTimersEvent.IsRunning ())
     {
-      if (it->first == route)
+      m_deleteTimersEvent = Simulator::ScheduleNow (&RipNg::DeleteTimers, this);
+    }
+  std::pair<RouteIndex::iterator, RouteIndex::iterator> range = m_routeIndex.equal_range (route->GetDestNetwork ());
+  for (RouteIndex::iterator iter = range.first; iter != range.second; iter++)
+    {
+      if (iter->second == it)
         {
-          delete route;
-          m_routes.erase (it);
-          return;
+          m_routeIndex.erase (iter);
+          break;
         }
     }
-  NS_ABORT_MSG ("Ripng::DeleteRoute - cannot find the route to delete");
+  if (route->IsRouteChanged ())
+    {
+      m_changedRoutes.erase (std::remove (m_changedRoutes.begin (), m_changedRoutes.end (), route), m_changedRoutes.end ());
+    }
+  m_routesVersion++;
+
+  delete route;
+  m_routes.erase (it);
+}
+
+void RipNg::DeleteTimers ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (std::vector<WheelTimer *>::iterator it = m_deletedTimers.begin (); it != m_deletedTimers.end (); it++)
+    {
+      delete *it;
+    }
+  m_deletedTimers.clear ();
 }
 
 
@@ -987,69 +1067,65 @@ void RipNg::HandleResponses (RipNgHeader hdr, Ipv6Address senderAddress, uint32_
         {
           rteMetric = m_linkDown;
         }
-      RoutesI it;
       bool found = false;
-      for (it = m_routes.begin (); it != m_routes.end (); it++)
+      std::pair<RouteIndex::iterator, RouteIndex::iterator> range = m_routeIndex.equal_range (rteAddr);
+      for (RouteIndex::iterator idx = range.first; idx != range.second; idx++)
         {
-          if (it->first->GetDestNetwork () == rteAddr &&
-              it->first->GetDestNetworkPrefix () == rtePrefix)
+          RoutesI it = idx->second;
+          if (it->first->GetDestNetworkPrefix () == rtePrefix)
             {
               found = true;
               if (rteMetric < it->first->GetRouteMetric ())
                 {
                   if (senderAddress != it->first->GetGateway ())
                     {
-                      RipNgRoutingTableEntry* route = new RipNgRoutingTableEntry (rteAddr, rtePrefix, senderAddress, incomingInterface, Ipv6Address::GetAny ());
-                      delete it->first;
-                      it->first = route;
+                      // the entry is replaced in place, its timer and its index stay valid
+                      *it->first = RipNgRoutingTableEntry (rteAddr, rtePrefix, senderAddress, incomingInterface, Ipv6Address::GetAny ());
                     }
                   it->first->SetRouteMetric (rteMetric);
                   it->first->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_VALID);
                   it->first->SetRouteTag (iter->GetRouteTag ());
                   it->first->SetRouteChanged (true);
-                  it->second.Cancel ();
-                  it->second = Simulator::Schedule (m_timeoutDelay, &RipNg::InvalidateRoute, this, it->first);
+                  NotifyRouteChanged (it->first);
+                  SetRouteTimer (it, m_timeoutDelay, false);
                   changed = true;
                 }
               else if (rteMetric == it->first->GetRouteMetric ())
                 {
                   if (senderAddress == it->first->GetGateway ())
                     {
-                      it->second.Cancel ();
-                      it->second = Simulator::Schedule (m_timeoutDelay, &RipNg::InvalidateRoute, this, it->first);
+                      SetRouteTimer (it, m_timeoutDelay, false);
                     }
                   else
                     {
-                      if (Simulator::GetDelayLeft (it->second) < m_timeoutDelay/2)
+                      if (GetRouteTimerDelayLeft (it) < m_timeoutDelay/2)
                         {
-                          RipNgRoutingTableEntry* route = new RipNgRoutingTableEntry (rteAddr, rtePrefix, senderAddress, incomingInterface, Ipv6Address::GetAny ());
-                          route->SetRouteMetric (rteMetric);
-                          route->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_VALID);
-                          route->SetRouteTag (iter->GetRouteTag ());
-                          route->SetRouteChanged (true);
-                          delete it->first;
-                          it->first = route;
-                          it->second.Cancel ();
-                          it->second = Simulator::Schedule (m_timeoutDelay, &RipNg::InvalidateRoute, this, route);
+                          *it->first = RipNgRoutingTableEntry (rteAddr, rtePrefix, senderAddress, incomingInterface, Ipv6Address::GetAny ());
+                          it->first->SetRouteMetric (rteMetric);
+                          it->first->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_VALID);
+                          it->first->SetRouteTag (iter->GetRouteTag ());
+                          it->first->SetRouteChanged (true);
+                          NotifyRouteChanged (it->first);
+                          SetRouteTimer (it, m_timeoutDelay, false);
                           changed = true;
                         }
                     }
                 }
               else if (rteMetric > it->first->GetRouteMetric () && senderAddress == it->first->GetGateway ())
                 {
-                  it->second.Cancel ();
+                  CancelRouteTimer (it);
                   if (rteMetric < m_linkDown)
                     {
                       it->first->SetRouteMetric (rteMetric);
                       it->first->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_VALID);
                       it->first->SetRouteTag (iter->GetRouteTag ());
                       it->first->SetRouteChanged (true);
-                      it->second.Cancel ();
-                      it->second = Simulator::Schedule (m_timeoutDelay, &RipNg::InvalidateRoute, this, it->first);
+                      NotifyRouteChanged (it->first);
+                      SetRouteTimer (it, m_timeoutDelay, false);
                     }
                   else
                     {
-                      InvalidateRoute (it->first);
+                      InvalidateRoute (it);
                     }
                   changed = true;
                 }
@@ -1063,9 +1139,9 @@ void RipNg::HandleResponses (RipNgHeader hdr, Ipv6Address senderAddress, uint32_
           route->SetRouteMetric (rteMetric);
           route->SetRouteStatus (RipNgRoutingTableEntry::RIPNG_VALID);
           route->SetRouteChanged (true);
-          m_routes.push_front (std::make_pair (route, EventId ()));
-          EventId invalidateEvent = Simulator::Schedule (m_timeoutDelay, &RipNg::InvalidateRoute, this, route);
-          (m_routes.begin ())->second = invalidateEvent;
+          RoutesI it = InsertRoute (m_routes.begin (), route);
+          NotifyRouteChanged (route);
+          SetRouteTimer (it, m_timeoutDelay, false);
           changed = true;
         }
     }
@@ -1080,6 +1156,26 @@ void RipNg::DoSendRouteUpdate (bool periodic)
 {
   NS_LOG_FUNCTION (this << (periodic ? " periodic" : " triggered"));
 
+  // a triggered update only carries the routes changed since the last update
+  std::vector<RipNgRoutingTableEntry *> changedRoutes;
+  if (!periodic)
+    {
+      for (std::vector<RipNgRoutingTableEntry *>::iterator rtIter = m_changedRoutes.begin (); rtIter != m_changedRoutes.end (); rtIter++)
+        {
+          if ((*rtIter)->IsRouteChanged ())
+            {
+              changedRoutes.push_back (*rtIter);
+              (*rtIter)->SetRouteChanged (false);
+            }
+        }
+      m_changedRoutes.clear ();
+      if (changedRoutes.empty ())
+        {
+          NS_LOG_LOGIC ("No route changed, skipping the triggered update");
+          return;
+        }
+    }
+
   for (SocketListI iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++ )
     {
       uint32_t interface = iter->second;
@@ -1089,70 +1185,111 @@ void RipNg::DoSendRouteUpdate (bool periodic)
           uint16_t mtu = m_ipv6->GetMtu (interface);
           uint16_t maxRte = (mtu - Ipv6Header ().GetSerializedSize () - UdpHeader ().GetSerializedSize () - RipNgHeader ().GetSerializedSize ()) / RipNgRte ().GetSerializedSize ();
 
-          Ptr<Packet> p = Create<Packet> ();
-          SocketIpv6HopLimitTag tag;
-          tag.SetHopLimit (255);
-          p->AddPacketTag (tag);
-
           RipNgHeader hdr;
           hdr.SetCommand (RipNgHeader::RESPONSE);
 
-          for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
+          std::vector<Ptr<Packet> > triggeredPackets;
+          std::vector<Ptr<Packet> > *packets = &triggeredPackets;
+          if (periodic)
             {
-              bool splitHorizoning = (rtIter->first->GetInterface () == interface);
-              Ipv6InterfaceAddress rtDestAddr = Ipv6InterfaceAddress(rtIter->first->GetDestNetwork (), rtIter->first->GetDestNetworkPrefix ());
-
-              NS_LOG_DEBUG ("Processing RT " << rtDestAddr << " " << int(rtIter->first->IsRouteChanged ()));
-
-              bool isGlobal = (rtDestAddr.GetScope () == Ipv6InterfaceAddress::GLOBAL);
-              bool isDefaultRoute = ((rtIter->first->GetDestNetwork () == Ipv6Address::GetAny ()) &&
-                  (rtIter->first->GetDestNetworkPrefix () == Ipv6Prefix::GetZero ()) &&
-                  (rtIter->first->GetInterface () != interface));
-
-              if ((isGlobal || isDefaultRoute) &&
-                  (periodic || rtIter->first->IsRouteChanged ()))
+              // the periodic update is serialized again only if the routes changed
+              UpdateCache &cache = m_updateCache[interface];
+              if (cache.packets.empty () || cache.version != m_routesVersion || cache.maxRte != maxRte)
                 {
-                  RipNgRte rte;
-                  rte.SetPrefix (rtIter->first->GetDestNetwork ());
-                  rte.SetPrefixLen (rtIter->first->GetDestNetworkPrefix ().GetPrefixLength ());
-                  if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
-                    {
-                      rte.SetRouteMetric (m_linkDown);
-                    }
-                  else
-                    {
-                      rte.SetRouteMetric (rtIter->first->GetRouteMetric ());
-                    }
-                  rte.SetRouteTag (rtIter->first->GetRouteTag ());
-                  if (m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning)
+                  cache.version = m_routesVersion;
+                  cache.maxRte = maxRte;
+                  cache.packets.clear ();
+                  for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
                     {
-                      hdr.AddRte (rte);
-                    }
-                  else if (m_splitHorizonStrategy != SPLIT_HORIZON)
-                    {
-                      hdr.AddRte (rte);
+                      AddUpdateRte (rtIter->first, interface, maxRte, hdr, cache.packets);
                     }
+                  FlushUpdateRtes (hdr, cache.packets);
                 }
-              if (hdr.GetRteNumber () == maxRte)
+              else
                 {
-                  p->AddHeader (hdr);
-                  NS_LOG_DEBUG ("SendTo: " << *p);
-                  iter->first->SendTo (p, 0, Inet6SocketAddress (RIPNG_ALL_NODE, RIPNG_PORT));
-                  p->RemoveHeader (hdr);
-                  hdr.ClearRtes ();
+                  NS_LOG_LOGIC ("Routes unchanged, reusing the periodic update for interface " << interface);
+                }
+              packets = &cache.packets;
+            }
+          else
+            {
+              for (std::vector<RipNgRoutingTableEntry *>::iterator rtIter = changedRoutes.begin (); rtIter != changedRoutes.end (); rtIter++)
+                {
+                  AddUpdateRte (*rtIter, interface, maxRte, hdr, triggeredPackets);
                 }
+              FlushUpdateRtes (hdr, triggeredPackets);
             }
-          if (hdr.GetRteNumber () > 0)
+
+          for (std::vector<Ptr<Packet> >::const_iterator pIter = packets->begin (); pIter != packets->end (); pIter++)
             {
-              p->AddHeader (hdr);
-              NS_LOG_DEBUG ("SendTo: " << *p);
-              iter->first->SendTo (p, 0, Inet6SocketAddress (RIPNG_ALL_NODE, RIPNG_PORT));
+              NS_LOG_DEBUG ("SendTo: " << **pIter);
+              iter->first->SendTo ((*pIter)->Copy (), 0, Inet6SocketAddress (RIPNG_ALL_NODE, RIPNG_PORT));
             }
         }
     }
-  for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
+
+  if (periodic)
+    {
+      for (RoutesI rtIter = m_routes.begin (); rtIter != m_routes.end (); rtIter++)
+        {
+          rtIter->first->SetRouteChanged (false);
+        }
+      m_changedRoutes.clear ();
+    }
+}
+
+void RipNg::AddUpdateRte (RipNgRoutingTableEntry *route, uint32_t interface, uint16_t maxRte, RipNgHeader &hdr, std::vector<Ptr<Packet> > &packets) const
+{
+  bool splitHorizoning = (route->GetInterface () == interface);
+  Ipv6InterfaceAddress rtDestAddr = Ipv6InterfaceAddress(route->GetDestNetwork (), route->GetDestNetworkPrefix ());
+
+  NS_LOG_DEBUG ("Processing RT " << rtDestAddr << " " << int(route->IsRouteChanged ()));
+
+  bool isGlobal = (rtDestAddr.GetScope () == Ipv6InterfaceAddress::GLOBAL);
+  bool isDefaultRoute = ((route->GetDestNetwork () == Ipv6Address::GetAny ()) &&
+      (route->GetDestNetworkPrefix () == Ipv6Prefix::GetZero ()) &&
+      (route->GetInterface () != interface));
+
+  if (isGlobal || isDefaultRoute)
+    {
+      RipNgRte rte;
+      rte.SetPrefix (route->GetDestNetwork ());
+      rte.SetPrefixLen (route->GetDestNetworkPrefix ().GetPrefixLength ());
+      if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
+        {
+          rte.SetRouteMetric (m_linkDown);
+        }
+      else
+        {
+          rte.SetRouteMetric (route->GetRouteMetric ());
+        }
+      rte.SetRouteTag (route->GetRouteTag ());
+      if (m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning)
+        {
+          hdr.AddRte (rte);
+        }
+      else if (m_splitHorizonStrategy != SPLIT_HORIZON)
+        {
+          hdr.AddRte (rte);
+        }
+    }
+  if (hdr.GetRteNumber () == maxRte)
+    {
+      FlushUpdateRtes (hdr, packets);
+    }
+}
+
+void RipNg::FlushUpdateRtes (RipNgHeader &hdr, std::vector<Ptr<Packet> > &packets) const
+{
+  if (hdr.GetRteNumber () > 0)
     {
-      rtIter->first->SetRouteChanged (false);
+      Ptr<Packet> p = Create<Packet> ();
+      SocketIpv6HopLimitTag tag;
+      tag.SetHopLimit (255);
+      p->AddPacketTag (tag);
+      p->AddHeader (hdr);
+      packets.push_back (p);
+      hdr.ClearRtes ();
     }
 }
 
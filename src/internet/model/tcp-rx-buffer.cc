@@ -155,8 +155,14 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet. Stored blocks never overlap, so
+  // only the last block starting at or before headSeq and the blocks
+  // starting within the incoming packet need to be checked.
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -194,7 +200,7 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
     }
   // Insert packet into buffer
   NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
+  i = m_data.insert (i, std::make_pair (headSeq, p));
 
   if (headSeq > m_nextRxSeq)
     {
@@ -205,18 +211,17 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (i = m_data.begin (); i != m_data.end (); ++i)
+  if (headSeq == m_nextRxSeq)
     {
-      if (i->first < m_nextRxSeq)
+      // The new block fills the hole at the head: walk the blocks that
+      // became contiguous, without touching the in-order data before it
+      SequenceNumber32 nextRxSeq = m_nextRxSeq;
+      for (; i != m_data.end () && i->first == nextRxSeq; ++i)
         {
-          continue;
+          nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
+          m_availBytes += i->second->GetSize ();
         }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+      m_nextRxSeq = nextRxSeq;
       ClearSackList (m_nextRxSeq);
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -369,17 +374,18 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return nullptr;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
-  Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
+  Ptr<Packet> outPkt; // The packet that contains all the data to return
   BufIterator i;
   while (extractSize)
     { // Check the buffered data for delivery
       i = m_data.begin ();
       NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
       // Check if we send the whole pkt or just a partial
+      Ptr<Packet> chunk;
       uint32_t pktSize = i->second->GetSize ();
       if (pktSize <= extractSize)
         { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
+          chunk = i->second;
           m_data.erase (i);
           m_size -= pktSize;
           m_availBytes -= pktSize;
@@ -387,15 +393,28 @@ TcpRxBuffer::Extract (uint32_t maxSize)
         }
       else
         { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
+          chunk = i->second->CreateFragment (0, extractSize);
+          SequenceNumber32 restSeq = i->first + SequenceNumber32 (extractSize);
+          Ptr<Packet> rest = i->second->CreateFragment (extractSize, pktSize - extractSize);
           m_data.erase (i);
+          m_data.insert (m_data.begin (), std::make_pair (restSeq, rest));
           m_size -= extractSize;
           m_availBytes -= extractSize;
           extractSize = 0;
         }
+      // The blocks are owned by the buffer, so the first one is handed over
+      // as is, and the following ones are appended to it.
+      if (outPkt == nullptr)
+        {
+          outPkt = chunk;
+          outPkt->RemoveAllPacketTags ();
+        }
+      else
+        {
+          outPkt->AddAtEnd (chunk);
+        }
     }
-  if (outPkt->GetSize () == 0)
+  if (outPkt == nullptr || outPkt->GetSize () == 0)
     {
       NS_LOG_LOGIC ("Nothing extracted.");
       return nullptr;
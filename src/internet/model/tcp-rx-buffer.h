@@ -53,6 +53,12 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * The data is stored as non-overlapping blocks, indexed by their first
+ * sequence number, so that adding a segment only looks at the blocks it
+ * overlaps. Contiguous blocks are not merged when they are received: they
+ * are joined only when the application extracts them, and a block that
+ * satisfies a request by itself is returned without copies.
+ *
  * SACK list
  * ---------
  *
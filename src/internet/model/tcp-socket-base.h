@@ -27,7 +27,7 @@
 #include "ns3/tcp-socket.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv6-header.h"
-#include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/sequence-number.h"
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
@@ -253,6 +253,10 @@ public:
 
   /**
    * \brief Set the associated node.
+   *
+   * If a TimerWheel is aggregated to the node, the retransmission,
+   * delayed ACK, persist and pacing timers are kept by it.
+   *
    * \param node the node
    */
   virtual void SetNode (Ptr<Node> node);
@@ -829,6 +833,12 @@ protected:
    */
   void CancelAllTimers (void);
 
+  /**
+   * \brief Set the wheel keeping the timers of the socket
+   * \param wheel the wheel, or null to use simulator events
+   */
+  void SetTimerWheel (Ptr<TimerWheel> wheel);
+
   /**
    * \brief Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
    */
@@ -1200,10 +1210,11 @@ protected:
 
 protected:
   // Counters and events
-  EventId           m_retxEvent     {}; //!< Retransmission event
+  WheelTimer        m_retxEvent     {}; //!< Retransmission event
+  bool              m_retxEmptyPacket {false}; //!< True if the retransmission event resends a SYN or FIN rather than calling ReTxTimeout
   EventId           m_lastAckEvent  {}; //!< Last ACK timeout event
-  EventId           m_delAckEvent   {}; //!< Delayed ACK timeout event
-  EventId           m_persistEvent  {}; //!< Persist event: Send 1 byte to probe for a non-zero Rx window
+  WheelTimer        m_delAckEvent   {}; //!< Delayed ACK timeout event
+  WheelTimer        m_persistEvent  {}; //!< Persist event: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent {}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
 
   // ACK management
@@ -1298,7 +1309,7 @@ protected:
                  Ptr<const TcpSocketBase> > m_rxTrace; //!< Trace of received packets
 
   // Pacing related variable
-  Timer m_pacingTimer {Timer::CANCEL_ON_DESTROY}; //!< Pacing Event
+  WheelTimer m_pacingTimer {}; //!< Pacing Event
 
   // Parameters related to Explicit Congestion Notification
   TracedValue<SequenceNumber32> m_ecnEchoSeq {0};      //!< Sequence number of the last received ECN Echo
@@ -58,7 +58,8 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n)
+  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n),
+    m_lostHint (n)
 {
   m_rWndCallback = MakeNullCallback<uint32_t> ();
 }
@@ -162,6 +163,9 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
   // if you change the head with data already sent, something bad will happen
   NS_ASSERT (m_sentList.size () == 0);
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_sentIndex.clear ();
+  m_sentIndexValid = true;
+  m_lostHint = seq;
 }
 
 bool
@@ -284,8 +288,12 @@ TcpTxBuffer::GetNewSegment (uint32_t numBytes)
   NS_ASSERT (it != m_appList.end ());
 
   m_appList.erase (it);
-  m_sentList.insert (m_sentList.end (), item);
+  PacketList::const_iterator sent = m_sentList.insert (m_sentList.end (), item);
   m_sentSize += item->m_packet->GetSize ();
+  if (m_sentIndexValid)
+    {
+      m_sentIndex.emplace_hint (m_sentIndex.end (), item->m_startSeq, sent);
+    }
 
   return item;
 }
@@ -298,40 +306,47 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
   NS_ASSERT (numBytes <= m_sentSize);
   NS_ASSERT (m_sentList.size () >= 1);
 
-  auto it = m_sentList.begin ();
+  PacketList::const_iterator it = FindSentItem (seq);
+  NS_ASSERT (it != m_sentList.end ());
   bool listEdited = false;
   uint32_t s = numBytes;
 
   // Avoid to merge different packet for this retransmission if flags are
   // different.
-  for (; it != m_sentList.end(); ++it)
+  if ((*it)->m_startSeq == seq)
     {
-      if ((*it)->m_startSeq == seq)
+      auto next = it;
+      next++;
+      if (next != m_sentList.end ())
         {
-          auto next = it;
-          next++;
-          if (next != m_sentList.end ())
+          // Next is not sacked... there is the possibility to merge
+          if (! (*next)->m_sacked)
             {
-              // Next is not sacked... there is the possibility to merge
-              if (! (*next)->m_sacked)
-                {
-                  s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
-                }
-              else
-                {
-                  // Next is sacked... better to retransmit only the first segment
-                  s = std::min(s, (*it)->m_packet->GetSize ());
-                }
+              s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
             }
           else
             {
+              // Next is sacked... better to retransmit only the first segment
               s = std::min(s, (*it)->m_packet->GetSize ());
             }
-          break;
+        }
+      else
+        {
+          s = std::min(s, (*it)->m_packet->GetSize ());
         }
     }
 
-  TcpTxItem *item = GetPacketFromList (m_sentList, m_firstByteSeq, s, seq, &listEdited);
+  // Start the search from the item containing seq, instead of the head.
+  // Erasing the empty range [it, it] does not modify the list: it is the
+  // constant time way to get a mutable iterator from the const_iterator
+  // stored in the index.
+  SequenceNumber32 startingSeq = (*it)->m_startSeq;
+  TcpTxItem *item = GetPacketFromList (m_sentList, m_sentList.erase (it, it),
+                                       startingSeq, s, seq, &listEdited);
+  if (listEdited)
+    {
+      m_sentIndexValid = false;
+    }
 
   if (! item->m_retrans)
     {
@@ -364,6 +379,35 @@ TcpTxBuffer::FindHighestSacked () const
   return ret;
 }
 
+void
+TcpTxBuffer::IndexSentList (void) const
+{
+  if (m_sentIndexValid)
+    {
+      return;
+    }
+
+  NS_LOG_FUNCTION (this);
+  m_sentIndex.clear ();
+  for (auto it = m_sentList.begin (); it != m_sentList.end (); ++it)
+    {
+      m_sentIndex.emplace_hint (m_sentIndex.end (), (*it)->m_startSeq, it);
+    }
+  m_sentIndexValid = true;
+}
+
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItem (const SequenceNumber32 &seq) const
+{
+  IndexSentList ();
+  SentIndex::const_iterator it = m_sentIndex.upper_bound (seq);
+  if (it == m_sentIndex.begin ())
+    {
+      return m_sentList.end ();
+    }
+  --it;
+  return it->second;
+}
 
 void
 TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
@@ -389,6 +433,15 @@ TcpTxItem*
 TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listStartFrom,
                                 uint32_t numBytes, const SequenceNumber32 &seq,
                                 bool *listEdited) const
+{
+  return GetPacketFromList (list, list.begin (), listStartFrom, numBytes, seq, listEdited);
+}
+
+TcpTxItem*
+TcpTxBuffer::GetPacketFromList (PacketList &list, PacketList::iterator start,
+                                const SequenceNumber32 &listStartFrom,
+                                uint32_t numBytes, const SequenceNumber32 &seq,
+                                bool *listEdited) const
 {
   NS_LOG_FUNCTION (this << numBytes << seq);
 
@@ -422,7 +475,7 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
   Ptr<Packet> currentPacket = nullptr;
   TcpTxItem *currentItem = nullptr;
   TcpTxItem *outItem = nullptr;
-  PacketList::iterator it = list.begin ();
+  PacketList::iterator it = start;
   SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
   while (it != list.end ())
@@ -459,13 +512,17 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
               SplitItems (firstPart, currentItem, seq - beginOfCurrentPacket);
 
               // insert firstPart before currentItem
-              list.insert (it, firstPart);
+              PacketList::iterator first = list.insert (it, firstPart);
+              if (it == start)
+                {
+                  start = first;
+                }
               if (listEdited)
                 {
                   *listEdited = true;
                 }
 
-              return GetPacketFromList (list, listStartFrom, numBytes, seq, listEdited);
+              return GetPacketFromList (list, start, listStartFrom, numBytes, seq, listEdited);
             }
           else
             {
@@ -514,7 +571,7 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
                       *listEdited = true;
                     }
 
-                  return GetPacketFromList (list, listStartFrom, numBytes, seq, listEdited);
+                  return GetPacketFromList (list, start, listStartFrom, numBytes, seq, listEdited);
                 }
             }
           else if (numBytes < currentPacket->GetSize ())
@@ -563,7 +620,7 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
               *listEdited = true;
             }
 
-          return GetPacketFromList (list, listStartFrom, numBytes, seq, listEdited);
+          return GetPacketFromList (list, start, listStartFrom, numBytes, seq, listEdited);
         }
     }
 
@@ -684,6 +741,11 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
 
           RemoveFromCounts (item, pktSize);
 
+          if (m_sentIndexValid)
+            {
+              NS_ASSERT (m_sentIndex.begin ()->first == item->m_startSeq);
+              m_sentIndex.erase (m_sentIndex.begin ());
+            }
           i = m_sentList.erase (i);
           NS_LOG_INFO ("Removed " << *item << " lost: " << m_lostOut <<
                        " retrans: " << m_retrans << " sacked: " << m_sackedOut <<
@@ -703,6 +765,11 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
           NS_LOG_INFO (*item);
           // PacketTags are preserved when fragmenting
           item->m_packet = item->m_packet->CreateFragment (offset, pktSize);
+          if (m_sentIndexValid)
+            {
+              m_sentIndex.erase (m_sentIndex.begin ());
+              m_sentIndex.emplace_hint (m_sentIndex.begin (), item->m_startSeq + offset, i);
+            }
           item->m_startSeq += offset;
           m_size -= offset;
           m_sentSize -= offset;
@@ -765,17 +832,24 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
 
   uint32_t bytesSacked = 0;
 
+  IndexSentList ();
   for (auto option_it = list.begin (); option_it != list.end (); ++option_it)
     {
-      PacketList::iterator item_it = m_sentList.begin ();
-      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
       if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
           NS_LOG_INFO ("Not updating scoreboard, the option block is outside the sent list");
           return bytesSacked;
         }
 
+      // Items starting before the block can not be sacked by it: skip them
+      SentIndex::const_iterator index_it = m_sentIndex.lower_bound ((*option_it).first);
+      if (index_it == m_sentIndex.end ())
+        {
+          continue;
+        }
+      PacketList::const_iterator item_it = index_it->second;
+      SequenceNumber32 beginOfCurrentPacket = index_it->first;
+
       while (item_it != m_sentList.end ())
         {
           uint32_t pktSize = (*item_it)->m_packet->GetSize ();
@@ -858,6 +932,9 @@ TcpTxBuffer::UpdateLostCount ()
   NS_LOG_FUNCTION (this);
   uint32_t sacked = 0;
   SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
+  // Only the hint left by the previous updates can be trusted: the items
+  // before the hint set by this walk are yet to be marked
+  SequenceNumber32 lostHint = m_lostHint;
   if (m_highestSack.first == m_sentList.end ())
     {
       NS_LOG_INFO ("Status before the update: " << *this <<
@@ -872,9 +949,20 @@ TcpTxBuffer::UpdateLostCount ()
   for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
     {
       TcpTxItem *item = *it;
+      if (sacked >= m_dupAckThresh && item->m_startSeq < lostHint)
+        {
+          // Everything from here to the head is already lost or sacked
+          break;
+        }
+
       if (item->m_sacked)
         {
           sacked++;
+          if (sacked == m_dupAckThresh
+              && m_lostHint < item->m_startSeq + item->m_packet->GetSize ())
+            {
+              m_lostHint = item->m_startSeq + item->m_packet->GetSize ();
+            }
         }
 
       if (sacked >= m_dupAckThresh)
@@ -906,7 +994,6 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
 {
   NS_LOG_FUNCTION (this << seq);
 
-  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
   PacketList::const_iterator it;
 
   if (seq >= m_highestSack.second)
@@ -914,27 +1001,27 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
       return false;
     }
 
-  // In theory, using a map and hints when inserting elements can improve
-  // performance
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // Start from the first item beginning at or after seq
+  IndexSentList ();
+  SentIndex::const_iterator index_it = m_sentIndex.lower_bound (seq);
+  if (index_it == m_sentIndex.end ())
     {
-      // Search for the right iterator before calling IsLost()
-      if (beginOfCurrentPacket >= seq)
-        {
-          if ((*it)->m_lost == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
-              return true;
-            }
+      return false;
+    }
 
-          if ((*it)->m_sacked == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
-              return false;
-            }
+  for (it = index_it->second; it != m_sentList.end (); ++it)
+    {
+      if ((*it)->m_lost == true)
+        {
+          NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
+          return true;
         }
 
-      beginOfCurrentPacket += (*it)->m_packet->GetSize ();
+      if ((*it)->m_sacked == true)
+        {
+          NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
+          return false;
+        }
     }
 
   return false;
@@ -964,7 +1051,10 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, SequenceNumber32 *seqHigh, bool isR
   bool isSeqPerRule3Valid = false;
   SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
 
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // Without lost segments, rule (1) can not be satisfied, and the walk is
+  // needed only to find the candidate for rule (3).
+  it = (m_lostOut > 0 || isRecovery) ? m_sentList.begin () : m_sentList.end ();
+  for (; it != m_sentList.end (); ++it)
     {
       item = *it;
 
@@ -1201,6 +1291,7 @@ TcpTxBuffer::ResetRenoSack ()
     }
 
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_lostHint = m_firstByteSeq;
 }
 
 void
@@ -1230,6 +1321,9 @@ TcpTxBuffer::ResetSentList ()
   m_retrans = 0;
   m_sackedOut = 0;
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_sentIndex.clear ();
+  m_sentIndexValid = true;
+  m_lostHint = m_firstByteSeq;
 }
 
 void
@@ -1240,6 +1334,10 @@ TcpTxBuffer::ResetLastSegmentSent ()
     {
       TcpTxItem *item = m_sentList.back ();
 
+      if (m_sentIndexValid)
+        {
+          m_sentIndex.erase (--m_sentIndex.end ());
+        }
       m_sentList.pop_back ();
       m_sentSize -= item->m_packet->GetSize ();
       if (item->m_retrans)
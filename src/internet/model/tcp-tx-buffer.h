@@ -22,6 +22,9 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
+#include <list>
+#include <map>
+
 #include "ns3/object.h"
 #include "ns3/traced-value.h"
 #include "ns3/sequence-number.h"
@@ -393,6 +396,29 @@ private:
 
   typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
+  /**
+   * \brief Index of the sent list: items by their starting sequence number
+   */
+  typedef std::map<SequenceNumber32, PacketList::const_iterator> SentIndex;
+
+  /**
+   * \brief Build the index of the sent list, if it is not valid.
+   *
+   * The index is kept up to date when items are appended to the sent list
+   * or removed from its head, which are the operations done for each
+   * segment. When the list is edited in the middle (fragmentation or merge
+   * for a retransmission), the index is invalidated and it is rebuilt
+   * the next time it is needed.
+   */
+  void IndexSentList (void) const;
+
+  /**
+   * \brief Find the item of the sent list which contains a sequence number
+   * \param seq the sequence number
+   * \return an iterator to the item, or the end of the sent list
+   */
+  PacketList::const_iterator FindSentItem (const SequenceNumber32 &seq) const;
+
   /**
    * \brief Update the lost count
    *
@@ -408,8 +434,8 @@ private:
    * The {New}Reno cases, for now, are managed in TcpSocketBase through the
    * call to MarkHeadAsLost.
    * This function is, therefore, called after a SACK option has been received,
-   * and updates the lost count. It can be probably optimized by not walking
-   * the entire list, but a subset.
+   * and updates the lost count. The walk stops at m_lostHint, as the
+   * items before it are already marked as lost (or sacked).
    *
    */
   void UpdateLostCount ();
@@ -544,6 +570,27 @@ private:
                                 uint32_t numBytes, const SequenceNumber32 &requestedSeq,
                                 bool *listEdited = nullptr) const;
 
+  /**
+   * \brief Get a block (which is returned as Packet) from a list, starting
+   * the search from an item inside the list
+   *
+   * Same as the other GetPacketFromList, but the items before start are
+   * not considered (nor edited). The requested block must begin inside
+   * or after the start item.
+   *
+   * \param list List to extract block from
+   * \param start Item of the list to start the search from
+   * \param startingSeq Starting sequence of the start item
+   * \param numBytes Bytes to extract, starting from requestedSeq
+   * \param requestedSeq Requested sequence
+   * \param listEdited output parameter which indicates if the list has been edited
+   * \return the item that contains the right packet
+   */
+  TcpTxItem* GetPacketFromList (PacketList &list, PacketList::iterator start,
+                                const SequenceNumber32 &startingSeq,
+                                uint32_t numBytes, const SequenceNumber32 &requestedSeq,
+                                bool *listEdited) const;
+
   /**
    * \brief Merge two TcpTxItem
    *
@@ -583,6 +630,8 @@ private:
 
   PacketList m_appList;  //!< Buffer for application data
   PacketList m_sentList; //!< Buffer for sent (but not acked) data
+  mutable SentIndex m_sentIndex;      //!< Sent list items by starting sequence
+  mutable bool m_sentIndexValid {true}; //!< True if m_sentIndex matches m_sentList
   uint32_t m_maxBuffer;  //!< Max number of data bytes in buffer (SND.WND)
   uint32_t m_size;       //!< Size of all data in this buffer
   uint32_t m_sentSize;   //!< Size of sent (and not discarded) segments
@@ -595,6 +644,12 @@ private:
   uint32_t m_sackedOut {0}; //!< Number of sacked bytes
   uint32_t m_retrans   {0}; //!< Number of retransmitted bytes
 
+  /**
+   * All the items of the sent list starting before this sequence are
+   * either lost or sacked; UpdateLostCount does not walk them again.
+   */
+  SequenceNumber32 m_lostHint;
+
   uint32_t m_dupAckThresh {0}; //!< Duplicate Ack threshold from TcpSocketBase
   uint32_t m_segmentSize {0}; //!< Segment size from TcpSocketBase
   bool     m_renoSack {false}; //!< Indicates if AddRenoSack was called
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EndPointDemuxTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux lookup Test
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Lookup a single end point.
+   * \param demux the demux
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \returns the end point found, or 0
+   */
+  Ipv4EndPoint *LookupOne (Ipv4EndPointDemux &demux,
+                           Ipv4Address daddr, uint16_t dport,
+                           Ipv4Address saddr, uint16_t sport);
+
+  Ptr<Ipv4Interface> m_interface; //!< Incoming interface
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookup")
+{
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::LookupOne (Ipv4EndPointDemux &demux,
+                                      Ipv4Address daddr, uint16_t dport,
+                                      Ipv4Address saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, m_interface);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  m_interface = CreateObject<Ipv4Interface> ();
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address peer ("10.0.0.2");
+  Ipv4EndPointDemux demux;
+
+  Ipv4EndPoint *listen = demux.Allocate (0, Ipv4Address::GetAny (), 80);
+  NS_TEST_ASSERT_MSG_NE (listen, 0, "Listening end point not allocated");
+  Ipv4EndPoint *conn = demux.Allocate (0, local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (conn, 0, "Connected end point not allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 80, peer, 1000), 0, "Duplicated end point allocated");
+
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1000), conn, "Exact match not preferred");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1001), listen, "Wildcard match not found");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 81, peer, 1000), 0, "Unexpected match");
+
+  // Changing the peer of an end point must move it in the index
+  Ipv4EndPoint *client = demux.Allocate (local);
+  NS_TEST_ASSERT_MSG_NE (client, 0, "Ephemeral end point not allocated");
+  uint16_t port = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), true, "Ephemeral port not in use");
+  client->SetPeer (peer, 5000);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, port, peer, 5000), client, "Connected end point not found");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, port, peer, 5001), 0, "Unexpected match");
+
+  Ipv4EndPoint *other = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (other, 0, "Ephemeral end point not allocated");
+  NS_TEST_EXPECT_MSG_NE (other->GetLocalPort (), port, "Ephemeral port allocated twice");
+
+  demux.DeAllocate (conn);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1000), listen, "Removed end point still found");
+  demux.DeAllocate (listen);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "Port still in use");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 2, "Wrong number of end points");
+
+  m_interface = 0;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv6EndPointDemux lookup Test
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Lookup a single end point.
+   * \param demux the demux
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \returns the end point found, or 0
+   */
+  Ipv6EndPoint *LookupOne (Ipv6EndPointDemux &demux,
+                           Ipv6Address daddr, uint16_t dport,
+                           Ipv6Address saddr, uint16_t sport);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Ipv6EndPointDemux lookup")
+{
+}
+
+Ipv6EndPoint *
+Ipv6EndPointDemuxTestCase::LookupOne (Ipv6EndPointDemux &demux,
+                                      Ipv6Address daddr, uint16_t dport,
+                                      Ipv6Address saddr, uint16_t sport)
+{
+  Ipv6EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, 0);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6Address local ("2001:1::1");
+  Ipv6Address peer ("2001:1::2");
+  Ipv6EndPointDemux demux;
+
+  Ipv6EndPoint *listen = demux.Allocate (0, Ipv6Address::GetAny (), 80);
+  NS_TEST_ASSERT_MSG_NE (listen, 0, "Listening end point not allocated");
+  Ipv6EndPoint *conn = demux.Allocate (0, local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (conn, 0, "Connected end point not allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 80, peer, 1000), 0, "Duplicated end point allocated");
+
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1000), conn, "Exact match not preferred");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1001), listen, "Wildcard match not found");
+
+  // Changing the port and the peer of an end point must move it in the index
+  Ipv6EndPoint *client = demux.Allocate (local);
+  NS_TEST_ASSERT_MSG_NE (client, 0, "Ephemeral end point not allocated");
+  uint16_t port = client->GetLocalPort ();
+  client->SetLocalPort (8080);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "Old port still in use");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (8080), true, "New port not in use");
+  client->SetPeer (peer, 5000);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 8080, peer, 5000), client, "Connected end point not found");
+
+  demux.DeAllocate (conn);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1000), listen, "Removed end point still found");
+  demux.DeAllocate (listen);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "Port still in use");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 1, "Wrong number of end points");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-routing-protocol.h"
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/packet-socket-factory.h"
+#include "ns3/ipv6-extension-demux.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief InternetStackHelper::InstallBulk test: the nodes get the same
+ * stacks as with Install, and the IPv6 extensions are created with the
+ * first IPv6 interface.
+ */
+class InternetStackHelperBulkTest : public TestCase
+{
+public:
+  InternetStackHelperBulkTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a packet.
+   * \param socket the sending socket
+   * \param to the destination
+   */
+  void SendData (Ptr<Socket> socket, Address to);
+  /**
+   * \brief Receive a packet.
+   * \param socket the receiving socket
+   */
+  void ReceivePkt (Ptr<Socket> socket);
+
+  uint32_t m_received; //!< the number of received packets
+};
+
+InternetStackHelperBulkTest::InternetStackHelperBulkTest ()
+  : TestCase ("InternetStackHelper::InstallBulk builds working stacks"),
+    m_received (0)
+{
+}
+
+void
+InternetStackHelperBulkTest::SendData (Ptr<Socket> socket, Address to)
+{
+  socket->SendTo (Create<Packet> (123), 0, to);
+}
+
+void
+InternetStackHelperBulkTest::ReceivePkt (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_received++;
+    }
+}
+
+void
+InternetStackHelperBulkTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  InternetStackHelper internet;
+  internet.SetIpv4ArpJitter (false);
+  internet.InstallBulk (nodes);
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<ArpL3Protocol> (), 0, "Missing ARP");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<Ipv4L3Protocol> (), 0, "Missing IPv4");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<Icmpv4L4Protocol> (), 0, "Missing ICMPv4");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<Ipv6L3Protocol> (), 0, "Missing IPv6");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<Icmpv6L4Protocol> (), 0, "Missing ICMPv6");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<TrafficControlLayer> (), 0, "Missing traffic control");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<UdpL4Protocol> (), 0, "Missing UDP");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<TcpL4Protocol> (), 0, "Missing TCP");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<PacketSocketFactory> (), 0, "Missing packet sockets");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<Ipv4> ()->GetRoutingProtocol (), 0, "Missing IPv4 routing");
+      NS_TEST_EXPECT_MSG_NE (node->GetObject<Ipv6> ()->GetRoutingProtocol (), 0, "Missing IPv6 routing");
+      NS_TEST_EXPECT_MSG_EQ (node->GetObject<Ipv6ExtensionDemux> (), 0, "IPv6 extensions not deferred");
+    }
+
+  // the jitter attribute is given to each ARP, with its own random variable
+  PointerValue jitter0;
+  PointerValue jitter1;
+  nodes.Get (0)->GetObject<ArpL3Protocol> ()->GetAttribute ("RequestJitter", jitter0);
+  nodes.Get (1)->GetObject<ArpL3Protocol> ()->GetAttribute ("RequestJitter", jitter1);
+  NS_TEST_EXPECT_MSG_NE (jitter0.Get<ConstantRandomVariable> (), 0, "ARP jitter not set");
+  NS_TEST_EXPECT_MSG_NE (jitter0.Get<RandomVariableStream> (), jitter1.Get<RandomVariableStream> (),
+                         "ARP jitter random variables shared");
+
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  Ipv4AddressHelper ipv4Helper;
+  ipv4Helper.SetBase ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4Helper.Assign (devices);
+  Ipv6AddressHelper ipv6Helper;
+  ipv6Helper.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6Helper.Assign (devices);
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_NE (nodes.Get (i)->GetObject<Ipv6ExtensionDemux> (), 0, "IPv6 extensions not registered");
+    }
+
+  Ptr<Socket> rxSocket = nodes.Get (2)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  NS_TEST_EXPECT_MSG_EQ (rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234)), 0, "trivial");
+  rxSocket->SetRecvCallback (MakeCallback (&InternetStackHelperBulkTest::ReceivePkt, this));
+  Ptr<Socket> rxSocket6 = nodes.Get (2)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  NS_TEST_EXPECT_MSG_EQ (rxSocket6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234)), 0, "trivial");
+  rxSocket6->SetRecvCallback (MakeCallback (&InternetStackHelperBulkTest::ReceivePkt, this));
+
+  Ptr<Socket> txSocket = nodes.Get (0)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  Ptr<Socket> txSocket6 = nodes.Get (0)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  Simulator::Schedule (Seconds (1), &InternetStackHelperBulkTest::SendData, this, txSocket,
+                       InetSocketAddress (ipv4Interfaces.GetAddress (2), 1234));
+  Simulator::Schedule (Seconds (2), &InternetStackHelperBulkTest::SendData, this, txSocket6,
+                       Inet6SocketAddress (ipv6Interfaces.GetAddress (2, 1), 1234));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2, "Packets not received");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief InternetStackHelper::AssignStreams test: the stacks installed by
+ * InstallBulk, whose IPv6 extensions are not created yet, get the same
+ * streams as the stacks installed by Install.
+ */
+class InternetStackHelperStreamsTest : public TestCase
+{
+public:
+  InternetStackHelperStreamsTest ();
+  virtual void DoRun (void);
+};
+
+InternetStackHelperStreamsTest::InternetStackHelperStreamsTest ()
+  : TestCase ("InternetStackHelper::AssignStreams after InstallBulk")
+{
+}
+
+void
+InternetStackHelperStreamsTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  NodeContainer bulkNodes;
+  bulkNodes.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  internet.InstallBulk (bulkNodes);
+
+  int64_t streams = internet.AssignStreams (nodes, 100);
+  int64_t bulkStreams = internet.AssignStreams (bulkNodes, 100);
+  NS_TEST_EXPECT_MSG_EQ (bulkStreams, streams, "Different number of streams after InstallBulk");
+
+  // the streams of the second node are not shifted
+  PointerValue jitter;
+  PointerValue bulkJitter;
+  nodes.Get (1)->GetObject<ArpL3Protocol> ()->GetAttribute ("RequestJitter", jitter);
+  bulkNodes.Get (1)->GetObject<ArpL3Protocol> ()->GetAttribute ("RequestJitter", bulkJitter);
+  NS_TEST_EXPECT_MSG_EQ (bulkJitter.Get<RandomVariableStream> ()->GetStream (),
+                         jitter.Get<RandomVariableStream> ()->GetStream (),
+                         "ARP jitter streams shifted after InstallBulk");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief InternetStackHelper TestSuite
+ */
+class InternetStackHelperTestSuite : public TestSuite
+{
+public:
+  InternetStackHelperTestSuite ();
+};
+
+InternetStackHelperTestSuite::InternetStackHelperTestSuite ()
+  : TestSuite ("internet-stack-helper", UNIT)
+{
+  AddTestCase (new InternetStackHelperBulkTest, TestCase::QUICK);
+  AddTestCase (new InternetStackHelperStreamsTest, TestCase::QUICK);
+}
+
+static InternetStackHelperTestSuite g_internetStackHelperTestSuite; //!< Static variable for test initialization
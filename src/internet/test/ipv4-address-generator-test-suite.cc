@@ -331,6 +331,71 @@ AddressCollisionTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (added, false, "404");
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 allocated address blocks Test
+ */
+class AddressBlocksTestCase : public TestCase
+{
+public:
+  AddressBlocksTestCase ();
+private:
+  void DoRun (void);
+  void DoTeardown (void);
+};
+
+AddressBlocksTestCase::AddressBlocksTestCase ()
+  : TestCase ("Make sure that the allocated address blocks are looked up correctly.")
+{
+}
+
+void
+AddressBlocksTestCase::DoTeardown (void)
+{
+  Ipv4AddressGenerator::Reset ();
+  Simulator::Destroy ();
+}
+void
+AddressBlocksTestCase::DoRun (void)
+{
+  // two addresses per /30 network, as with point-to-point links
+  for (uint32_t net = 0; net < 100000; net++)
+    {
+      Ipv4AddressGenerator::AddAllocated (Ipv4Address ((10 << 24) + net * 4 + 1));
+      Ipv4AddressGenerator::AddAllocated (Ipv4Address ((10 << 24) + net * 4 + 2));
+    }
+  // a block crossing a /24 boundary, grown at both ends
+  for (uint32_t addr = 0x0b000080; addr < 0x0b000180; addr++)
+    {
+      Ipv4AddressGenerator::AddAllocated (Ipv4Address (addr));
+    }
+  Ipv4AddressGenerator::AddAllocated ("11.0.0.127");
+  Ipv4AddressGenerator::AddAllocated ("11.0.1.128");
+
+  // IsAddressAllocated and IsNetworkAllocated return false on a hit
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("10.0.0.1"), false, "10.0.0.1 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("10.0.0.3"), true, "10.0.0.3 not allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("10.6.26.126"), false, "10.6.26.126 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("10.6.26.132"), true, "10.6.26.132 not allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("11.0.0.126"), true, "11.0.0.126 not allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("11.0.0.255"), false, "11.0.0.255 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("11.0.1.128"), false, "11.0.1.128 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsAddressAllocated ("11.0.1.129"), true, "11.0.1.129 not allocated");
+
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsNetworkAllocated ("10.0.0.0", "255.255.255.252"), false, "10.0.0.0/30 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsNetworkAllocated ("10.6.26.128", "255.255.255.252"), true, "10.6.26.128/30 not allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsNetworkAllocated ("11.0.0.192", "255.255.255.192"), false, "11.0.0.192/26 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsNetworkAllocated ("11.0.0.64", "255.255.255.192"), false, "11.0.0.64/26 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::IsNetworkAllocated ("11.0.0.0", "255.255.255.192"), true, "11.0.0.0/26 not allocated");
+
+  Ipv4AddressGenerator::TestMode ();
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::AddAllocated ("10.1.0.2"), false, "collision");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::AddAllocated ("11.0.1.0"), false, "collision");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4AddressGenerator::AddAllocated ("10.1.0.3"), true, "no collision");
+}
+
 
 /**
  * \ingroup internet-test
@@ -353,6 +418,7 @@ Ipv4AddressGeneratorTestSuite::Ipv4AddressGeneratorTestSuite ()
   AddTestCase (new NetworkAndAddressTestCase (), TestCase::QUICK);
   AddTestCase (new ExampleAddressGeneratorTestCase (), TestCase::QUICK);
   AddTestCase (new AddressCollisionTestCase (), TestCase::QUICK);
+  AddTestCase (new AddressBlocksTestCase (), TestCase::QUICK);
 }
 
 static Ipv4AddressGeneratorTestSuite g_ipv4AddressGeneratorTestSuite; //!< Static variable for test initialization
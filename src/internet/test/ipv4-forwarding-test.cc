@@ -36,10 +36,13 @@
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-routing-helper.h"
 
 #include "ns3/traffic-control-layer.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/ipv4-address-helper.h"
 
 #include <string>
 #include <limits>
@@ -217,6 +220,136 @@ Ipv4ForwardingTest::DoRun (void)
 
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 fast forwarding Test
+ *
+ * The forwarding node keeps forwarding through its route cache after the
+ * route has been removed, until the cache is flushed.
+ */
+class Ipv4FastForwardingTest : public TestCase
+{
+  Ptr<Packet> m_receivedPacket; //!< Received packet
+
+  /**
+   * \brief Send data.
+   * \param socket The sending socket.
+   * \param to Destination address.
+   */
+  void DoSendData (Ptr<Socket> socket, Ipv4Address to);
+  /**
+   * \brief Send data.
+   * \param socket The sending socket.
+   * \param to Destination address.
+   */
+  void SendData (Ptr<Socket> socket, Ipv4Address to);
+
+public:
+  virtual void DoRun (void);
+  Ipv4FastForwardingTest ();
+
+  /**
+   * \brief Receive data.
+   * \param socket The receiving socket.
+   */
+  void ReceivePkt (Ptr<Socket> socket);
+};
+
+Ipv4FastForwardingTest::Ipv4FastForwardingTest ()
+  : TestCase ("IPv4 fast forwarding")
+{
+}
+
+void Ipv4FastForwardingTest::ReceivePkt (Ptr<Socket> socket)
+{
+  m_receivedPacket = socket->Recv (std::numeric_limits<uint32_t>::max (), 0);
+}
+
+void
+Ipv4FastForwardingTest::DoSendData (Ptr<Socket> socket, Ipv4Address to)
+{
+  NS_TEST_EXPECT_MSG_EQ (socket->SendTo (Create<Packet> (123), 0, InetSocketAddress (to, 1234)),
+                         123, "100");
+}
+
+void
+Ipv4FastForwardingTest::SendData (Ptr<Socket> socket, Ipv4Address to)
+{
+  m_receivedPacket = Create<Packet> ();
+  Simulator::ScheduleWithContext (socket->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv4FastForwardingTest::DoSendData, this, socket, to);
+  Simulator::Run ();
+}
+
+void
+Ipv4FastForwardingTest::DoRun (void)
+{
+  Ptr<Node> rxNode = CreateObject<Node> ();
+  Ptr<Node> fwNode = CreateObject<Node> ();
+  Ptr<Node> txNode = CreateObject<Node> ();
+
+  SimpleNetDeviceHelper simple;
+  simple.SetNetDevicePointToPointMode (true);
+  NetDeviceContainer net1 = simple.Install (NodeContainer (rxNode, fwNode));
+  NetDeviceContainer net2 = simple.Install (NodeContainer (fwNode, txNode));
+
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.Install (NodeContainer (rxNode, fwNode, txNode));
+
+  Ptr<Ipv4L3Protocol> fwIpv4 = fwNode->GetObject<Ipv4L3Protocol> ();
+  fwIpv4->SetAttribute ("FastForwarding", BooleanValue (true));
+  fwIpv4->SetAttribute ("FastForwardingTimeout", TimeValue (Seconds (100)));
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer iic1 = address.Assign (net1);
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer iic2 = address.Assign (net2);
+
+  Ptr<Ipv4StaticRouting> txRouting = Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (txNode->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  txRouting->SetDefaultRoute (iic2.GetAddress (0), iic2.Get (1).second);
+
+  Ptr<Socket> rxSocket = rxNode->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  NS_TEST_EXPECT_MSG_EQ (rxSocket->Bind (InetSocketAddress (iic1.GetAddress (0), 1234)), 0, "trivial");
+  rxSocket->SetIpRecvTtl (true);
+  rxSocket->SetRecvCallback (MakeCallback (&Ipv4FastForwardingTest::ReceivePkt, this));
+
+  Ptr<Socket> txSocket = txNode->GetObject<UdpSocketFactory> ()->CreateSocket ();
+
+  // the first packet goes through the routing protocol
+  SendData (txSocket, iic1.GetAddress (0));
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "IPv4 forwarding");
+  SocketIpTtlTag ttlTag;
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->PeekPacketTag (ttlTag), true, "Missing TTL");
+  NS_TEST_EXPECT_MSG_EQ (int (ttlTag.GetTtl ()), 63, "TTL not decremented");
+
+  // remove the route to the receiver: the cached route is still used
+  Ptr<Ipv4StaticRouting> fwRouting = Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (fwIpv4->GetRoutingProtocol ());
+  for (uint32_t i = 0; i < fwRouting->GetNRoutes (); i++)
+    {
+      if (fwRouting->GetRoute (i).GetDest () == Ipv4Address ("10.0.0.0"))
+        {
+          fwRouting->RemoveRoute (i);
+          break;
+        }
+    }
+  SendData (txSocket, iic1.GetAddress (0));
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "IPv4 fast forwarding");
+  ttlTag.SetTtl (0);
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->PeekPacketTag (ttlTag), true, "Missing TTL");
+  NS_TEST_EXPECT_MSG_EQ (int (ttlTag.GetTtl ()), 63, "TTL not decremented by the fast path");
+
+  // once the cache is flushed, the route removal is taken into account
+  fwIpv4->FlushFastForwardingCache ();
+  SendData (txSocket, iic1.GetAddress (0));
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 0, "IPv4 route cache not flushed");
+
+  Simulator::Destroy ();
+}
+
 
 /**
  * \ingroup internet-test
@@ -235,6 +368,7 @@ Ipv4ForwardingTestSuite::Ipv4ForwardingTestSuite ()
   : TestSuite ("ipv4-forwarding", UNIT)
 {
   AddTestCase (new Ipv4ForwardingTest, TestCase::QUICK);
+  AddTestCase (new Ipv4FastForwardingTest, TestCase::QUICK);
 }
 
 static Ipv4ForwardingTestSuite g_ipv4forwardingTestSuite; //!< Static variable for test initialization
@@ -681,6 +681,147 @@ Ipv4RipSplitHorizonStrategyTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 RIP route expiration Test
+ *
+ * A route is kept as long as the neighbor advertises it, and it is
+ * invalidated when the neighbor stops advertising it.
+ */
+class Ipv4RipRouteExpiryTest : public TestCase
+{
+  std::vector<bool> m_routeFound; //!< Route found at each check.
+  bool m_timerWheel; //!< Use the node timer wheel for the route timers.
+
+public:
+  virtual void DoRun (void);
+  /**
+   * \brief Constructor.
+   * \param timerWheel Use the node timer wheel for the route timers.
+   */
+  Ipv4RipRouteExpiryTest (bool timerWheel);
+
+  /**
+   * \brief Check if a node has a route to a destination.
+   * \param node The node.
+   * \param destination The destination.
+   */
+  void CheckRoute (Ptr<Node> node, Ipv4Address destination);
+
+  /**
+   * \brief Stop the RIP updates on an interface.
+   * \param node The node.
+   * \param interface The interface.
+   */
+  void ExcludeInterface (Ptr<Node> node, uint32_t interface);
+};
+
+Ipv4RipRouteExpiryTest::Ipv4RipRouteExpiryTest (bool timerWheel)
+  : TestCase (timerWheel ? "RIP route expiration (timer wheel)" : "RIP route expiration"),
+    m_timerWheel (timerWheel)
+{
+}
+
+void
+Ipv4RipRouteExpiryTest::CheckRoute (Ptr<Node> node, Ipv4Address destination)
+{
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  Ipv4Header header;
+  header.SetDestination (destination);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), header, 0, sockerr);
+  m_routeFound.push_back (route != 0);
+}
+
+void
+Ipv4RipRouteExpiryTest::ExcludeInterface (Ptr<Node> node, uint32_t interface)
+{
+  Ptr<Rip> rip = DynamicCast<Rip> (node->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  NS_TEST_ASSERT_MSG_NE (rip, 0, "RIP not found");
+  std::set<uint32_t> exclusions;
+  exclusions.insert (interface);
+  rip->SetInterfaceExclusions (exclusions);
+}
+
+void
+Ipv4RipRouteExpiryTest::DoRun (void)
+{
+  Ptr<Node> fakeNode = CreateObject<Node> ();
+  Ptr<Node> routerA = CreateObject<Node> ();
+  Ptr<Node> routerB = CreateObject<Node> ();
+
+  RipHelper ripRouting;
+  ripRouting.Set ("UnsolicitedRoutingUpdate", TimeValue (Seconds (4)));
+  ripRouting.Set ("TimeoutDelay", TimeValue (Seconds (20)));
+  ripRouting.Set ("GarbageCollectionDelay", TimeValue (Seconds (10)));
+
+  InternetStackHelper internetRouters;
+  internetRouters.SetRoutingHelper (ripRouting);
+  internetRouters.SetTimerWheel (m_timerWheel);
+  internetRouters.Install (NodeContainer (routerA, routerB));
+
+  InternetStackHelper internetNodes;
+  internetNodes.Install (fakeNode);
+
+  // fake node - router B - router A
+  Ptr<SimpleNetDevice> fakeDev = CreateObject<SimpleNetDevice> ();
+  fakeDev->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  fakeNode->AddDevice (fakeDev);
+  Ptr<SimpleNetDevice> silentDevRouterB = CreateObject<SimpleNetDevice> ();
+  silentDevRouterB->SetAddress (Mac48Address ("00:00:00:00:00:02"));
+  routerB->AddDevice (silentDevRouterB);
+  Ptr<SimpleNetDevice> fwDevRouterB = CreateObject<SimpleNetDevice> ();
+  fwDevRouterB->SetAddress (Mac48Address ("00:00:00:00:00:03"));
+  routerB->AddDevice (fwDevRouterB);
+  Ptr<SimpleNetDevice> fwDevRouterA = CreateObject<SimpleNetDevice> ();
+  fwDevRouterA->SetAddress (Mac48Address ("00:00:00:00:00:04"));
+  routerA->AddDevice (fwDevRouterA);
+
+  Ptr<SimpleChannel> channel0 = CreateObject<SimpleChannel> ();
+  fakeDev->SetChannel (channel0);
+  silentDevRouterB->SetChannel (channel0);
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  fwDevRouterB->SetChannel (channel1);
+  fwDevRouterA->SetChannel (channel1);
+
+  NetDeviceContainer net0;
+  net0.Add (fakeDev);
+  net0.Add (silentDevRouterB);
+  NetDeviceContainer net1;
+  net1.Add (fwDevRouterB);
+  net1.Add (fwDevRouterA);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase (Ipv4Address ("10.0.1.0"), Ipv4Mask ("255.255.255.0"));
+  ipv4.Assign (net0);
+  ipv4.SetBase (Ipv4Address ("192.168.0.0"), Ipv4Mask ("255.255.255.0"));
+  Ipv4InterfaceContainer iic1 = ipv4.Assign (net1);
+
+  // learned route, refreshed by the updates of router B well after its first timeout
+  Simulator::Schedule (Seconds (10), &Ipv4RipRouteExpiryTest::CheckRoute, this, routerA, Ipv4Address ("10.0.1.1"));
+  Simulator::Schedule (Seconds (40), &Ipv4RipRouteExpiryTest::CheckRoute, this, routerA, Ipv4Address ("10.0.1.1"));
+  // router B goes silent: the route times out
+  Simulator::Schedule (Seconds (41), &Ipv4RipRouteExpiryTest::ExcludeInterface, this, routerB, iic1.Get (0).second);
+  Simulator::Schedule (Seconds (50), &Ipv4RipRouteExpiryTest::CheckRoute, this, routerA, Ipv4Address ("10.0.1.1"));
+  Simulator::Schedule (Seconds (70), &Ipv4RipRouteExpiryTest::CheckRoute, this, routerA, Ipv4Address ("10.0.1.1"));
+
+  Simulator::Stop (Seconds (100));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_routeFound.size (), 4, "Missing route checks");
+  if (m_routeFound.size () == 4)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_routeFound[0], true, "RIP route not learned");
+      NS_TEST_EXPECT_MSG_EQ (m_routeFound[1], true, "RIP route not refreshed");
+      NS_TEST_EXPECT_MSG_EQ (m_routeFound[2], true, "RIP route expired too early");
+      NS_TEST_EXPECT_MSG_EQ (m_routeFound[3], false, "RIP route not expired");
+    }
+
+  Simulator::Destroy ();
+}
+
 
 /**
  * \ingroup internet-test
@@ -698,6 +839,8 @@ public:
     AddTestCase (new Ipv4RipSplitHorizonStrategyTest (Rip::POISON_REVERSE), TestCase::QUICK);
     AddTestCase (new Ipv4RipSplitHorizonStrategyTest (Rip::SPLIT_HORIZON), TestCase::QUICK);
     AddTestCase (new Ipv4RipSplitHorizonStrategyTest (Rip::NO_SPLIT_HORIZON), TestCase::QUICK);
+    AddTestCase (new Ipv4RipRouteExpiryTest (false), TestCase::QUICK);
+    AddTestCase (new Ipv4RipRouteExpiryTest (true), TestCase::QUICK);
   }
 };
 
@@ -131,6 +131,29 @@ Ipv4L3ProtocolTestCase::DoRun (void)
   num = interface->GetNAddresses ();
   NS_TEST_ASSERT_MSG_EQ (num, 1, "Should find 1 addresses??");
 
+  /* The address lookup follows the changes of the interface addresses */
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetInterfaceForAddress ("192.168.0.1"), 0, "Address not found??");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetInterfaceForAddress ("10.30.0.1"), -1, "Removed address found??");
+  interface->AddAddress (ifaceAddr3);
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetInterfaceForAddress ("10.30.0.1"), 0, "Added address not found??");
+  ipv4->RemoveAddress (index, Ipv4Address ("192.168.0.1"));
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetInterfaceForAddress ("192.168.0.1"), -1, "Removed address found??");
+
+  Ptr<Ipv4Interface> interface2 = CreateObject<Ipv4Interface> ();
+  Ptr<LoopbackNetDevice> device2 = CreateObject<LoopbackNetDevice> ();
+  node->AddDevice (device2);
+  interface2->SetDevice (device2);
+  interface2->SetNode (node);
+  uint32_t index2 = ipv4->AddIpv4Interface (interface2);
+  interface2->SetUp ();
+  ipv4->AddAddress (index2, Ipv4InterfaceAddress ("192.168.0.1", "255.255.255.0"));
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetInterfaceForAddress ("192.168.0.1"), static_cast<int32_t> (index2), "Address not found on the second interface??");
+  ipv4->AddAddress (index, Ipv4InterfaceAddress ("192.168.0.1", "255.255.255.0"));
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetInterfaceForAddress ("192.168.0.1"), static_cast<int32_t> (index), "The lowest interface should be found??");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->IsDestinationAddress ("10.30.0.1", index2), true, "Address on another interface not local??");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->IsDestinationAddress ("10.30.0.255", index2), true, "Broadcast on another interface not local??");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->IsDestinationAddress ("10.30.0.2", index2), false, "Foreign address local??");
+
   Simulator::Destroy ();
 }
 
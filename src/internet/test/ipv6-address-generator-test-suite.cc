@@ -302,6 +302,73 @@ AddressCollision6TestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (added, false, "address should not get allocated");
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv6 allocated address blocks Test
+ */
+class AddressBlocks6TestCase : public TestCase
+{
+public:
+  AddressBlocks6TestCase ();
+private:
+  void DoRun (void);
+  void DoTeardown (void);
+};
+
+AddressBlocks6TestCase::AddressBlocks6TestCase ()
+  : TestCase ("Make sure that the allocated address blocks are looked up correctly.")
+{
+}
+
+void
+AddressBlocks6TestCase::DoTeardown (void)
+{
+  Ipv6AddressGenerator::Reset ();
+  Simulator::Destroy ();
+}
+void
+AddressBlocks6TestCase::DoRun (void)
+{
+  // many networks with two addresses each
+  Ipv6AddressGenerator::Init (Ipv6Address ("2001:db8::"), Ipv6Prefix (64), Ipv6Address ("::1"));
+  for (uint32_t net = 0; net < 10000; net++)
+    {
+      Ipv6AddressGenerator::NextAddress (Ipv6Prefix (64));
+      Ipv6AddressGenerator::NextAddress (Ipv6Prefix (64));
+      Ipv6AddressGenerator::NextNetwork (Ipv6Prefix (64));
+    }
+  // a block crossing a byte boundary, grown at both ends
+  for (uint32_t i = 0x80; i < 0x180; i++)
+    {
+      uint8_t buf[16] = {0x20, 0x01, 0x0d, 0xb9};
+      buf[14] = i >> 8;
+      buf[15] = i & 0xff;
+      Ipv6AddressGenerator::AddAllocated (Ipv6Address (buf));
+    }
+  Ipv6AddressGenerator::AddAllocated ("2001:db9::7f");
+  Ipv6AddressGenerator::AddAllocated ("2001:db9::180");
+
+  // IsAddressAllocated and IsNetworkAllocated return false on a hit
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsAddressAllocated ("2001:db8::1"), false, "2001:db8::1 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsAddressAllocated ("2001:db8:0:1::2"), false, "2001:db8:0:1::2 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsAddressAllocated ("2001:db8:0:1::3"), true, "2001:db8:0:1::3 not allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsAddressAllocated ("2001:db9::7e"), true, "2001:db9::7e not allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsAddressAllocated ("2001:db9::ff"), false, "2001:db9::ff allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsAddressAllocated ("2001:db9::100"), false, "2001:db9::100 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsAddressAllocated ("2001:db9::181"), true, "2001:db9::181 not allocated");
+
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsNetworkAllocated ("2001:db8:0:2::", Ipv6Prefix (64)), false, "2001:db8:0:2::/64 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsNetworkAllocated ("2001:db9::100", Ipv6Prefix (120)), false, "2001:db9::100/120 allocated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::IsNetworkAllocated ("2001:db9:0:1::", Ipv6Prefix (64)), true, "2001:db9:0:1::/64 not allocated");
+
+  Ipv6AddressGenerator::TestMode ();
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::AddAllocated ("2001:db9::120"), false, "collision");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::AddAllocated ("2001:db8:0:5::1"), false, "collision");
+  NS_TEST_EXPECT_MSG_EQ (Ipv6AddressGenerator::AddAllocated ("2001:db8:0:5::3"), true, "no collision");
+}
+
 
 /**
  * \ingroup internet-test
@@ -320,6 +387,7 @@ public:
     AddTestCase (new NetworkAndAddress6TestCase (), TestCase::QUICK);
     AddTestCase (new ExampleAddress6GeneratorTestCase (), TestCase::QUICK);
     AddTestCase (new AddressCollision6TestCase (), TestCase::QUICK);
+    AddTestCase (new AddressBlocks6TestCase (), TestCase::QUICK);
   }
 };
 
@@ -36,6 +36,7 @@
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6-routing-table-entry.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-routing-helper.h"
@@ -209,6 +210,141 @@ Ipv6ForwardingTest::DoRun (void)
 
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv6 fast forwarding Test
+ *
+ * The forwarding node keeps forwarding through its route cache after the
+ * route has been removed, until the cache is flushed.
+ */
+class Ipv6FastForwardingTest : public TestCase
+{
+  Ptr<Packet> m_receivedPacket;   //!< Received packet.
+
+  /**
+   * \brief Send data.
+   * \param socket The sending socket.
+   * \param to Destination address.
+   */
+  void DoSendData (Ptr<Socket> socket, Ipv6Address to);
+  /**
+   * \brief Send data.
+   * \param socket The sending socket.
+   * \param to Destination address.
+   */
+  void SendData (Ptr<Socket> socket, Ipv6Address to);
+
+public:
+  virtual void DoRun (void);
+  Ipv6FastForwardingTest ();
+
+  /**
+   * \brief Receive data.
+   * \param socket The receiving socket.
+   */
+  void ReceivePkt (Ptr<Socket> socket);
+};
+
+Ipv6FastForwardingTest::Ipv6FastForwardingTest ()
+  : TestCase ("IPv6 fast forwarding")
+{
+}
+
+void Ipv6FastForwardingTest::ReceivePkt (Ptr<Socket> socket)
+{
+  m_receivedPacket = socket->Recv (std::numeric_limits<uint32_t>::max (), 0);
+}
+
+void
+Ipv6FastForwardingTest::DoSendData (Ptr<Socket> socket, Ipv6Address to)
+{
+  NS_TEST_EXPECT_MSG_EQ (socket->SendTo (Create<Packet> (123), 0, Inet6SocketAddress (to, 1234)),
+                         123, "100");
+}
+
+void
+Ipv6FastForwardingTest::SendData (Ptr<Socket> socket, Ipv6Address to)
+{
+  m_receivedPacket = Create<Packet> ();
+  Simulator::ScheduleWithContext (socket->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv6FastForwardingTest::DoSendData, this, socket, to);
+  Simulator::Run ();
+}
+
+void
+Ipv6FastForwardingTest::DoRun (void)
+{
+  Ptr<Node> rxNode = CreateObject<Node> ();
+  Ptr<Node> fwNode = CreateObject<Node> ();
+  Ptr<Node> txNode = CreateObject<Node> ();
+
+  SimpleNetDeviceHelper helperChannel;
+  helperChannel.SetNetDevicePointToPointMode (true);
+  NetDeviceContainer net1 = helperChannel.Install (NodeContainer (rxNode, fwNode));
+  NetDeviceContainer net2 = helperChannel.Install (NodeContainer (fwNode, txNode));
+
+  InternetStackHelper internetv6;
+  internetv6.SetIpv4StackInstall (false);
+  internetv6.Install (NodeContainer (rxNode, fwNode, txNode));
+
+  txNode->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+  fwNode->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+  rxNode->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+
+  Ptr<Ipv6L3Protocol> fwIpv6 = fwNode->GetObject<Ipv6L3Protocol> ();
+  fwIpv6->SetAttribute ("FastForwarding", BooleanValue (true));
+  fwIpv6->SetAttribute ("FastForwardingTimeout", TimeValue (Seconds (100)));
+
+  Ipv6AddressHelper ipv6helper;
+  ipv6helper.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer iic1 = ipv6helper.Assign (net1);
+  iic1.SetForwarding (1, true);
+  ipv6helper.SetBase (Ipv6Address ("2001:2::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer iic2 = ipv6helper.Assign (net2);
+  iic2.SetForwarding (0, true);
+
+  Ptr<Ipv6StaticRouting> txRouting = Ipv6RoutingHelper::GetRouting <Ipv6StaticRouting> (txNode->GetObject<Ipv6> ()->GetRoutingProtocol ());
+  txRouting->SetDefaultRoute (iic2.GetAddress (0, 1), iic2.GetInterfaceIndex (1));
+
+  Ptr<Socket> rxSocket = rxNode->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  NS_TEST_EXPECT_MSG_EQ (rxSocket->Bind (Inet6SocketAddress (iic1.GetAddress (0, 1), 1234)), 0, "trivial");
+  rxSocket->SetIpv6RecvHopLimit (true);
+  rxSocket->SetRecvCallback (MakeCallback (&Ipv6FastForwardingTest::ReceivePkt, this));
+
+  Ptr<Socket> txSocket = txNode->GetObject<UdpSocketFactory> ()->CreateSocket ();
+
+  // the first packet goes through the routing protocol
+  SendData (txSocket, iic1.GetAddress (0, 1));
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "IPv6 forwarding");
+  SocketIpv6HopLimitTag hopLimitTag;
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->PeekPacketTag (hopLimitTag), true, "Missing hop limit");
+  NS_TEST_EXPECT_MSG_EQ (int (hopLimitTag.GetHopLimit ()), 63, "Hop limit not decremented");
+
+  // remove the route to the receiver: the cached route is still used
+  Ptr<Ipv6StaticRouting> fwRouting = Ipv6RoutingHelper::GetRouting <Ipv6StaticRouting> (fwIpv6->GetRoutingProtocol ());
+  for (uint32_t i = fwRouting->GetNRoutes (); i > 0; i--)
+    {
+      if (fwRouting->GetRoute (i - 1).GetDest () == Ipv6Address ("2001:1::"))
+        {
+          fwRouting->RemoveRoute (i - 1);
+        }
+    }
+  SendData (txSocket, iic1.GetAddress (0, 1));
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "IPv6 fast forwarding");
+  hopLimitTag.SetHopLimit (0);
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->PeekPacketTag (hopLimitTag), true, "Missing hop limit");
+  NS_TEST_EXPECT_MSG_EQ (int (hopLimitTag.GetHopLimit ()), 63, "Hop limit not decremented by the fast path");
+
+  // once the cache is flushed, the route removal is taken into account
+  fwIpv6->FlushFastForwardingCache ();
+  SendData (txSocket, iic1.GetAddress (0, 1));
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 0, "IPv6 route cache not flushed");
+
+  Simulator::Destroy ();
+}
+
 
 /**
  * \ingroup internet-test
@@ -222,6 +358,7 @@ public:
   Ipv6ForwardingTestSuite () : TestSuite ("ipv6-forwarding", UNIT)
   {
     AddTestCase (new Ipv6ForwardingTest, TestCase::QUICK);
+    AddTestCase (new Ipv6FastForwardingTest, TestCase::QUICK);
   }
 };
 
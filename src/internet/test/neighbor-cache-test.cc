@@ -0,0 +1,278 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ndisc-cache.h"
+#include "ns3/socket-factory.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief NeighborCacheHelper test: the caches are populated with
+ * permanent entries and no address resolution takes place.
+ */
+class NeighborCacheTest : public TestCase
+{
+public:
+  NeighborCacheTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a packet.
+   * \param socket the sending socket
+   * \param to the destination
+   */
+  void SendData (Ptr<Socket> socket, Address to);
+  /**
+   * \brief Receive a packet.
+   * \param socket the receiving socket
+   */
+  void ReceivePkt (Ptr<Socket> socket);
+
+  std::vector<Time> m_receiveTimes; //!< the reception times
+};
+
+NeighborCacheTest::NeighborCacheTest ()
+  : TestCase ("NeighborCacheHelper populates the ARP and NDISC caches")
+{
+}
+
+void
+NeighborCacheTest::SendData (Ptr<Socket> socket, Address to)
+{
+  socket->SendTo (Create<Packet> (123), 0, to);
+}
+
+void
+NeighborCacheTest::ReceivePkt (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_receiveTimes.push_back (Simulator::Now ());
+    }
+}
+
+void
+NeighborCacheTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper ipv4Helper;
+  ipv4Helper.SetBase ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4Helper.Assign (devices);
+  Ipv6AddressHelper ipv6Helper;
+  ipv6Helper.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6Helper.Assign (devices);
+
+  NeighborCacheHelper neighborCache;
+  neighborCache.PopulateNeighborCache ();
+
+  // each interface knows the addresses of the two others
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4L3Protocol> ipv4 = nodes.Get (i)->GetObject<Ipv4L3Protocol> ();
+      Ptr<ArpCache> arpCache = ipv4->GetInterface (ipv4->GetInterfaceForDevice (devices.Get (i)))->GetArpCache ();
+      Ptr<Ipv6L3Protocol> ipv6 = nodes.Get (i)->GetObject<Ipv6L3Protocol> ();
+      Ptr<Ipv6Interface> ipv6Interface = ipv6->GetInterface (ipv6->GetInterfaceForDevice (devices.Get (i)));
+      Ptr<NdiscCache> ndiscCache = ipv6Interface->GetNdiscCache ();
+
+      for (uint32_t j = 0; j < nodes.GetN (); j++)
+        {
+          ArpCache::Entry *arpEntry = arpCache->Lookup (ipv4Interfaces.GetAddress (j));
+          NdiscCache::Entry *ndiscEntry = ndiscCache->Lookup (ipv6Interfaces.GetAddress (j, 1));
+          NdiscCache::Entry *linkLocalEntry = ndiscCache->Lookup (ipv6Interfaces.GetAddress (j, 0));
+          if (i == j)
+            {
+              NS_TEST_EXPECT_MSG_EQ ((arpEntry == 0), true, "No ARP entry for the own address");
+              NS_TEST_EXPECT_MSG_EQ ((ndiscEntry == 0), true, "No NDISC entry for the own address");
+              continue;
+            }
+          NS_TEST_EXPECT_MSG_NE (arpEntry, 0, "Missing ARP entry");
+          NS_TEST_EXPECT_MSG_NE (ndiscEntry, 0, "Missing NDISC entry");
+          NS_TEST_EXPECT_MSG_NE (linkLocalEntry, 0, "Missing NDISC entry for the link-local address");
+          if (arpEntry == 0 || ndiscEntry == 0 || linkLocalEntry == 0)
+            {
+              continue;
+            }
+          NS_TEST_EXPECT_MSG_EQ (arpEntry->IsPermanent (), true, "ARP entry not permanent");
+          NS_TEST_EXPECT_MSG_EQ (arpEntry->GetMacAddress (), devices.Get (j)->GetAddress (), "Wrong ARP entry");
+          NS_TEST_EXPECT_MSG_EQ (ndiscEntry->IsPermanent (), true, "NDISC entry not permanent");
+          NS_TEST_EXPECT_MSG_EQ (ndiscEntry->GetMacAddress (), devices.Get (j)->GetAddress (), "Wrong NDISC entry");
+          NS_TEST_EXPECT_MSG_EQ (linkLocalEntry->IsPermanent (), true, "NDISC entry not permanent");
+        }
+    }
+
+  // without address resolution, a packet takes a single channel delay
+  Ptr<Socket> rxSocket = nodes.Get (2)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  NS_TEST_EXPECT_MSG_EQ (rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234)), 0, "trivial");
+  rxSocket->SetRecvCallback (MakeCallback (&NeighborCacheTest::ReceivePkt, this));
+  Ptr<Socket> rxSocket6 = nodes.Get (2)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  NS_TEST_EXPECT_MSG_EQ (rxSocket6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234)), 0, "trivial");
+  rxSocket6->SetRecvCallback (MakeCallback (&NeighborCacheTest::ReceivePkt, this));
+
+  Ptr<Socket> txSocket = nodes.Get (0)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  Ptr<Socket> txSocket6 = nodes.Get (0)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  Simulator::Schedule (Seconds (3), &NeighborCacheTest::SendData, this, txSocket,
+                       InetSocketAddress (ipv4Interfaces.GetAddress (2), 1234));
+  Simulator::Schedule (Seconds (4), &NeighborCacheTest::SendData, this, txSocket6,
+                       Inet6SocketAddress (ipv6Interfaces.GetAddress (2, 1), 1234));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receiveTimes.size (), 2, "Packets not received");
+  if (m_receiveTimes.size () == 2)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_receiveTimes[0], Seconds (3) + MilliSeconds (1), "IPv4 address resolution took place");
+      NS_TEST_EXPECT_MSG_EQ (m_receiveTimes[1], Seconds (4) + MilliSeconds (1), "IPv6 address resolution took place");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief NDISC NUD timers: an entry moving from DELAY to PROBE while
+ * another one is still in DELAY must not delay the expiry of the latter.
+ */
+class NdiscNudTimerTest : public TestCase
+{
+public:
+  NdiscNudTimerTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Add a STALE entry to the cache and start its DELAY timer.
+   * \param cache the NDISC cache
+   * \param to the address of the entry
+   */
+  void StartDelay (Ptr<NdiscCache> cache, Ipv6Address to);
+  /**
+   * \brief Check that an entry is in PROBE state.
+   * \param cache the NDISC cache
+   * \param to the address of the entry
+   */
+  void CheckProbe (Ptr<NdiscCache> cache, Ipv6Address to);
+};
+
+NdiscNudTimerTest::NdiscNudTimerTest ()
+  : TestCase ("NDISC NUD timers of interleaved entries expire on time")
+{
+}
+
+void
+NdiscNudTimerTest::StartDelay (Ptr<NdiscCache> cache, Ipv6Address to)
+{
+  NdiscCache::Entry *entry = cache->Add (to);
+  entry->MarkStale (Mac48Address::Allocate ());
+  entry->MarkDelay ();
+  entry->StartDelayTimer ();
+}
+
+void
+NdiscNudTimerTest::CheckProbe (Ptr<NdiscCache> cache, Ipv6Address to)
+{
+  NdiscCache::Entry *entry = cache->Lookup (to);
+  NS_TEST_ASSERT_MSG_NE (entry, 0, "Missing NDISC entry " << to);
+  NS_TEST_EXPECT_MSG_EQ (entry->IsProbe (), true, "NDISC entry " << to << " not in PROBE state at " << Simulator::Now ().As (Time::S));
+}
+
+void
+NdiscNudTimerTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.SetIpv4StackInstall (false);
+  internet.Install (nodes);
+
+  Ipv6AddressHelper ipv6Helper;
+  ipv6Helper.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  ipv6Helper.Assign (devices);
+
+  Ptr<Ipv6L3Protocol> ipv6 = nodes.Get (0)->GetObject<Ipv6L3Protocol> ();
+  Ptr<NdiscCache> cache = ipv6->GetInterface (ipv6->GetInterfaceForDevice (devices.Get (0)))->GetNdiscCache ();
+
+  // with the default timers, the first entry leaves DELAY at 6 s and sends
+  // its next probe at 7 s, while the second one leaves DELAY at 6.5 s
+  Ipv6Address first ("2001:1::a");
+  Ipv6Address second ("2001:1::b");
+  Simulator::Schedule (Seconds (1), &NdiscNudTimerTest::StartDelay, this, cache, first);
+  Simulator::Schedule (Seconds (1.5), &NdiscNudTimerTest::StartDelay, this, cache, second);
+  Simulator::Schedule (Seconds (6.75), &NdiscNudTimerTest::CheckProbe, this, cache, first);
+  Simulator::Schedule (Seconds (6.75), &NdiscNudTimerTest::CheckProbe, this, cache, second);
+
+  Simulator::Stop (Seconds (8));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief NeighborCacheHelper TestSuite
+ */
+class NeighborCacheTestSuite : public TestSuite
+{
+public:
+  NeighborCacheTestSuite ();
+};
+
+NeighborCacheTestSuite::NeighborCacheTestSuite ()
+  : TestSuite ("neighbor-cache", UNIT)
+{
+  AddTestCase (new NeighborCacheTest, TestCase::QUICK);
+  AddTestCase (new NdiscNudTimerTest, TestCase::QUICK);
+}
+
+static NeighborCacheTestSuite g_neighborCacheTestSuite; //!< Static variable for test initialization
@@ -429,7 +429,12 @@ TcpDctcpCongestedRouter::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize,
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpDctcpCongestedRouter::ReTxTimeout, this);
+      if (m_retxEmptyPacket)
+        {
+          m_retxEvent.SetFunction (&TcpDctcpCongestedRouter::ReTxTimeout, this);
+          m_retxEmptyPacket = false;
+        }
+      m_retxEvent.Schedule (m_rto);
     }
 
   m_txTrace (p, header, this);
@@ -811,7 +811,7 @@ TcpGeneralTest::GetRWnd (SocketWho who)
     }
 }
 
-EventId
+const WheelTimer &
 TcpGeneralTest::GetPersistentEvent (SocketWho who)
 {
   if (who == SENDER)
@@ -1253,7 +1253,10 @@ TcpSocketSmallAcks::SendEmptyPacket (uint8_t flags)
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketSmallAcks::SendEmptyPacket, this, flags);
+      m_retxEvent.SetFunction (&TcpSocketSmallAcks::SendEmptyPacket, this);
+      m_retxEvent.SetArguments (flags);
+      m_retxEmptyPacket = true;
+      m_retxEvent.Schedule (m_rto);
     }
 
   // send another ACK if bytes remain
@@ -15,6 +15,8 @@
  *
  */
 
+#include <vector>
+
 #include "ns3/test.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
@@ -44,6 +46,21 @@ private:
    * \brief Test the SACK list update.
    */
   void TestUpdateSACKList ();
+  /**
+   * \brief Test the overlap handling and the extraction of the data.
+   */
+  void TestOverlapAndExtract ();
+  /**
+   * \brief Test that retransmitted data does not alter the buffered bytes.
+   */
+  void TestRetransmittedData ();
+  /**
+   * \brief Create a packet whose bytes are derived from their sequence number
+   * \param seq the sequence number of the first byte
+   * \param size the size of the packet
+   * \returns the packet
+   */
+  static Ptr<Packet> CreatePayload (uint32_t seq, uint32_t size);
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase ()
@@ -55,6 +72,19 @@ void
 TcpRxBufferTestCase::DoRun ()
 {
   TestUpdateSACKList ();
+  TestOverlapAndExtract ();
+  TestRetransmittedData ();
+}
+
+Ptr<Packet>
+TcpRxBufferTestCase::CreatePayload (uint32_t seq, uint32_t size)
+{
+  std::vector<uint8_t> buffer (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      buffer[i] = static_cast<uint8_t> (seq + i);
+    }
+  return Create<Packet> (buffer.data (), size);
 }
 
 void
@@ -338,6 +368,114 @@ TcpRxBufferTestCase::TestUpdateSACKList ()
                          "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestOverlapAndExtract ()
+{
+  TcpRxBuffer rxBuf;
+  TcpHeader h;
+  rxBuf.SetNextRxSequence (SequenceNumber32 (1));
+  rxBuf.SetMaxBufferSize (10000);
+
+  // Out of order blocks [201;301) [401;501) [601;701)
+  for (uint32_t seq = 201; seq < 700; seq += 200)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (seq));
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (Create<Packet> (100), h), true,
+                             "Block not added");
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 300, "Buffer size differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 0, "Data available while it should not");
+
+  // A segment fully contained in a stored block is discarded
+  h.SetSequenceNumber (SequenceNumber32 (221));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (Create<Packet> (50), h), false,
+                         "Duplicated data added");
+
+  // A segment covering [151;651) replaces the blocks embedded in it,
+  // and is trimmed at the head of the last block: [151;601) [601;701)
+  h.SetSequenceNumber (SequenceNumber32 (151));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (Create<Packet> (500), h), true,
+                         "Block not added");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 550, "Buffer size differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (1),
+                         "Sequence number differs from expected");
+
+  // Filling the head makes everything contiguous
+  h.SetSequenceNumber (SequenceNumber32 (1));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (Create<Packet> (200), h), true,
+                         "Block not added");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (701),
+                         "Sequence number differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 700, "Available data differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackListSize (), 0, "SACK list should be empty");
+
+  // Extraction within a block, across blocks, and up to the end
+  Ptr<Packet> p = rxBuf.Extract (150);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 150, "Extracted size differs from expected");
+  p = rxBuf.Extract (400);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 400, "Extracted size differs from expected");
+  p = rxBuf.Extract (1000);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 150, "Extracted size differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0, "Buffer should be empty");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Extract (1000), 0, "Data extracted from an empty buffer");
+}
+
+void
+TcpRxBufferTestCase::TestRetransmittedData ()
+{
+  TcpRxBuffer rxBuf;
+  TcpHeader h;
+  rxBuf.SetNextRxSequence (SequenceNumber32 (1));
+  rxBuf.SetMaxBufferSize (10000);
+
+  // In order blocks [1;101) [101;201) [201;301), not read yet
+  for (uint32_t seq = 1; seq < 300; seq += 100)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (seq));
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreatePayload (seq, 100), h), true,
+                             "Block not added");
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 300, "Available data differs from expected");
+
+  // A retransmission of data waiting to be read is discarded
+  h.SetSequenceNumber (SequenceNumber32 (101));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreatePayload (101, 100), h), false,
+                         "Duplicated data added");
+
+  // Out of order block [401;501), then a segment [251;451) overlapping
+  // both the in order data and the out of order block
+  h.SetSequenceNumber (SequenceNumber32 (401));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreatePayload (401, 100), h), true,
+                         "Block not added");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackListSize (), 1, "SACK list should contain one block");
+  h.SetSequenceNumber (SequenceNumber32 (251));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreatePayload (251, 200), h), true,
+                         "Block not added");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 500, "Buffer size differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 500, "Available data differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (501),
+                         "Sequence number differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackListSize (), 0, "SACK list should be empty");
+
+  // The extracted bytes are the ones of the first copy of each sequence
+  // number, whatever the blocks they were stored in
+  uint32_t seq = 1;
+  uint32_t sizes[] = {50, 150, 300};
+  for (uint32_t k = 0; k < 3; k++)
+    {
+      Ptr<Packet> p = rxBuf.Extract (sizes[k]);
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), sizes[k], "Extracted size differs from expected");
+      std::vector<uint8_t> buffer (p->GetSize ());
+      p->CopyData (buffer.data (), p->GetSize ());
+      for (uint32_t i = 0; i < buffer.size (); i++, seq++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (buffer[i]), seq % 256,
+                                 "Unexpected byte at sequence number " << seq);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0, "Buffer should be empty");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown ()
 {
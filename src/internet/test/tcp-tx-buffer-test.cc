@@ -354,6 +354,89 @@ TcpTxBufferTestCase::TestNewBlock ()
 void
 TcpTxBufferTestCase::TestTransmittedBlock ()
 {
+  Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer> ();
+  txBuf->SetRWndCallback (MakeCallback (&TcpTxBufferTestCase::GetRWnd, this));
+  txBuf->SetHeadSequence (SequenceNumber32 (1));
+  txBuf->SetSegmentSize (100);
+  txBuf->SetDupAckThresh (3);
+
+  // ten segments of 100 bytes, from 1 to 1001
+  txBuf->Add (Create<Packet> (1000));
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      txBuf->CopyFromSequence (100, SequenceNumber32 (i * 100 + 1));
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 1000,
+                         "TxBuf miscalculates size of in flight segments");
+
+  // is exactly the same as previous
+  TcpTxItem *item = txBuf->CopyFromSequence (100, SequenceNumber32 (401));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 100,
+                         "Returned packet has different size than requested");
+  NS_TEST_ASSERT_MSG_EQ (item->IsRetrans (), true, "Item is not a retransmission");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetRetransmitsCount (), 100,
+                         "TxBuf miscalculates the retransmitted bytes");
+
+  // starts over the boundary, but ends earlier
+  item = txBuf->CopyFromSequence (50, SequenceNumber32 (501));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 50,
+                         "Returned packet has different size than requested");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetRetransmitsCount (), 150,
+                         "TxBuf miscalculates the retransmitted bytes");
+
+  // starts over the boundary, but ends after
+  item = txBuf->CopyFromSequence (150, SequenceNumber32 (601));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 150,
+                         "Returned packet has different size than requested");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetRetransmitsCount (), 300,
+                         "TxBuf miscalculates the retransmitted bytes");
+
+  // starts inside a packet, ends right
+  item = txBuf->CopyFromSequence (50, SequenceNumber32 (851));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 50,
+                         "Returned packet has different size than requested");
+
+  // starts inside a packet, ends earlier in the same packet
+  item = txBuf->CopyFromSequence (20, SequenceNumber32 (911));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 20,
+                         "Returned packet has different size than requested");
+
+  // starts inside a packet, ends in another packet, which was already
+  // retransmitted: the two parts are merged
+  item = txBuf->CopyFromSequence (100, SequenceNumber32 (351));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 100,
+                         "Returned packet has different size than requested");
+
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetRetransmitsCount (), 370,
+                         "TxBuf miscalculates the retransmitted bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 1370,
+                         "TxBuf miscalculates size of in flight segments");
+
+  // the segments split above are found by the SACK processing
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+  sack->AddSackBlock (TcpOptionSack::SackBlock (SequenceNumber32 (851), SequenceNumber32 (1001)));
+  txBuf->Update (sack->GetSackList ());
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSacked (), 150, "TxBuf miscalculates the sacked bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsLost (SequenceNumber32 (801)), true,
+                         "Lost is false, but it's not");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsLost (SequenceNumber32 (851)), false,
+                         "Lost is true, but it's not");
+
+  // acknowledge up to the middle of a split segment, then retransmit what follows
+  txBuf->DiscardUpTo (SequenceNumber32 (526));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->HeadSequence (), SequenceNumber32 (526),
+                         "Unexpected head of the buffer");
+  item = txBuf->CopyFromSequence (25, SequenceNumber32 (526));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 25,
+                         "Returned packet has different size than requested");
+  item = txBuf->CopyFromSequence (100, SequenceNumber32 (801));
+  NS_TEST_ASSERT_MSG_EQ (item->GetSeqSize (), 50,
+                         "A retransmission should not include sacked data");
+
+  txBuf->DiscardUpTo (SequenceNumber32 (1001));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->Size (), 0, "Data inside the buffer");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 0,
+                         "TxBuf miscalculates size of in flight segments");
 }
 
 void
@@ -188,9 +188,15 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      // compute the chunk in place, in the storage of the previous chunk
+      m_interf = *m_allSignals;
+      m_interf -= *m_rxSignal;
+      m_interf += *m_noise;
+      SpectrumValue &interf = m_interf;
+
+      m_sinr = *m_rxSignal;
+      m_sinr /= interf;
+      SpectrumValue &sinr = m_sinr;
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
@@ -143,6 +143,9 @@ protected:
 
   Ptr<const SpectrumValue> m_noise {nullptr}; ///< the noise value
 
+  SpectrumValue m_interf; ///< the interference plus noise of the last chunk, reused across chunks
+  SpectrumValue m_sinr;   ///< the SINR of the last chunk, reused across chunks
+
   Time m_lastChangeTime {Seconds(0)}; /**< the time of the last change in
                                        * m_TotalPower
                                        */
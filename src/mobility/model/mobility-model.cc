@@ -53,6 +53,7 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_courseChangeCount (0)
 {
 }
 
@@ -91,9 +92,16 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
   return (GetVelocity () - other->GetVelocity ()).GetLength ();
 }
 
+uint32_t
+MobilityModel::GetCourseChangeCount (void) const
+{
+  return m_courseChangeCount;
+}
+
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  m_courseChangeCount++;
   m_courseChangeTrace (this);
 }
 
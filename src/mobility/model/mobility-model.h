@@ -69,6 +69,12 @@ public:
    * \return the relative speed between the two objects. Unit is meters/s.
    */
   double GetRelativeSpeed (Ptr<const MobilityModel> other) const;
+  /**
+   * \return the number of course changes notified so far, which allows to
+   * tell whether the values computed from the position of a static object
+   * are still valid without listening to the course changes.
+   */
+  uint32_t GetCourseChangeCount (void) const;
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model. Return the number of streams (possibly zero) that
@@ -129,6 +135,8 @@ private:
    */
   ns3::TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  mutable uint32_t m_courseChangeCount; //!< the number of course changes notified
+
 };
 
 } // namespace ns3
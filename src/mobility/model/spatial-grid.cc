@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spatial-grid.h"
+#include "mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialGrid");
+
+SpatialGrid::SpatialGrid (double cellSize)
+  : m_cellSize (cellSize),
+    m_nMoving (0),
+    m_maxSpeed (0)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT (cellSize > 0);
+}
+
+SpatialGrid::~SpatialGrid ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+uint32_t
+SpatialGrid::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  uint32_t item = m_items.size ();
+  m_items.push_back ({mobility, 0, 0});
+  if (mobility == 0)
+    {
+      m_unlocated.push_back (item);
+      return item;
+    }
+  std::vector<uint32_t> &modelItems = m_models[PeekPointer (mobility)];
+  if (modelItems.empty ())
+    {
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&SpatialGrid::CourseChange, this));
+    }
+  modelItems.push_back (item);
+  Bin (item);
+  m_cells[m_items[item].cell].push_back (item);
+  return item;
+}
+
+uint32_t
+SpatialGrid::GetN (void) const
+{
+  return m_items.size ();
+}
+
+double
+SpatialGrid::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+void
+SpatialGrid::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (const auto &model : m_models)
+    {
+      m_items[model.second.front ()].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                                              MakeCallback (&SpatialGrid::CourseChange, this));
+    }
+  m_models.clear ();
+  m_cells.clear ();
+  m_items.clear ();
+  m_unlocated.clear ();
+  m_nMoving = 0;
+  m_maxSpeed = 0;
+}
+
+uint64_t
+SpatialGrid::GetCellKey (int32_t x, int32_t y)
+{
+  return (static_cast<uint64_t> (static_cast<uint32_t> (x)) << 32) | static_cast<uint32_t> (y);
+}
+
+int32_t
+SpatialGrid::GetCellCoordinate (double coordinate) const
+{
+  double cell = std::floor (coordinate / m_cellSize);
+  cell = std::max (cell, static_cast<double> (std::numeric_limits<int32_t>::min ()));
+  cell = std::min (cell, static_cast<double> (std::numeric_limits<int32_t>::max ()));
+  return static_cast<int32_t> (cell);
+}
+
+void
+SpatialGrid::Bin (uint32_t item)
+{
+  Item &it = m_items[item];
+  Vector position = it.mobility->GetPosition ();
+  it.cell = GetCellKey (GetCellCoordinate (position.x), GetCellCoordinate (position.y));
+  if (it.speed > 0)
+    {
+      m_nMoving--;
+    }
+  Vector velocity = it.mobility->GetVelocity ();
+  it.speed = velocity.GetLength ();
+  if (it.speed > 0)
+    {
+      if (m_nMoving == 0)
+        {
+          // the distance travelled by the moving items is counted from now
+          m_lastRefresh = Simulator::Now ();
+          m_maxSpeed = 0;
+        }
+      m_nMoving++;
+      m_maxSpeed = std::max (m_maxSpeed, it.speed);
+    }
+}
+
+void
+SpatialGrid::CourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  auto modelIt = m_models.find (PeekPointer (mobility));
+  NS_ASSERT (modelIt != m_models.end ());
+  for (uint32_t item : modelIt->second)
+    {
+      uint64_t oldCell = m_items[item].cell;
+      Bin (item);
+      if (m_items[item].cell != oldCell)
+        {
+          std::vector<uint32_t> &cell = m_cells[oldCell];
+          auto it = std::find (cell.begin (), cell.end (), item);
+          NS_ASSERT (it != cell.end ());
+          *it = cell.back ();
+          cell.pop_back ();
+          if (cell.empty ())
+            {
+              m_cells.erase (oldCell);
+            }
+          m_cells[m_items[item].cell].push_back (item);
+        }
+    }
+}
+
+void
+SpatialGrid::Refresh (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_maxSpeed = 0;
+  m_lastRefresh = Simulator::Now ();
+  std::vector<uint32_t> moving;
+  for (uint32_t item = 0; item < m_items.size (); item++)
+    {
+      if (m_items[item].speed > 0)
+        {
+          moving.push_back (item);
+        }
+    }
+  // a model may have several items
+  for (uint32_t item : moving)
+    {
+      if (m_models[PeekPointer (m_items[item].mobility)].front () == item)
+        {
+          CourseChange (m_items[item].mobility);
+        }
+    }
+}
+
+void
+SpatialGrid::GetNeighbors (const Vector &position, double range, std::vector<uint32_t> &items)
+{
+  NS_LOG_FUNCTION (this << position << range);
+  items.clear ();
+  double margin = 0;
+  if (m_nMoving > 0)
+    {
+      margin = m_maxSpeed * (Simulator::Now () - m_lastRefresh).GetSeconds ();
+      if (margin > m_cellSize / 2)
+        {
+          Refresh ();
+          margin = 0;
+        }
+    }
+  double reach = range + margin;
+  int32_t minX = GetCellCoordinate (position.x - reach);
+  int32_t maxX = GetCellCoordinate (position.x + reach);
+  int32_t minY = GetCellCoordinate (position.y - reach);
+  int32_t maxY = GetCellCoordinate (position.y + reach);
+  auto isNeighbor = [&] (uint32_t item)
+    {
+      return CalculateDistance (m_items[item].mobility->GetPosition (), position) <= range;
+    };
+  if ((static_cast<double> (maxX) - minX + 1) * (static_cast<double> (maxY) - minY + 1) > m_cells.size ())
+    {
+      // the range spans more cells than there are occupied ones
+      for (const auto &cell : m_cells)
+        {
+          std::copy_if (cell.second.begin (), cell.second.end (), std::back_inserter (items), isNeighbor);
+        }
+    }
+  else
+    {
+      for (int32_t x = minX; x <= maxX; x++)
+        {
+          for (int32_t y = minY; y <= maxY; y++)
+            {
+              auto cellIt = m_cells.find (GetCellKey (x, y));
+              if (cellIt != m_cells.end ())
+                {
+                  std::copy_if (cellIt->second.begin (), cellIt->second.end (), std::back_inserter (items), isNeighbor);
+                }
+            }
+        }
+    }
+  items.insert (items.end (), m_unlocated.begin (), m_unlocated.end ());
+  std::sort (items.begin (), items.end ());
+}
+
+} // namespace ns3
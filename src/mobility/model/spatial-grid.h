@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include <vector>
+#include <unordered_map>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Index the positions of mobility models on a uniform grid.
+ *
+ * The items of the grid are identified by the order in which they were
+ * added, and are binned, by their x and y coordinates, in square cells.
+ * GetNeighbors then only looks at the cells around a position to find
+ * the items within a given range of it, instead of at all the items.
+ *
+ * An item is moved to its new cell when its mobility model notifies a
+ * course change. Between two course changes, the mobility models are
+ * assumed to move at a constant velocity: the items with a non-zero
+ * velocity are looked for in a range enlarged by the distance they
+ * may have travelled since they were binned, and are binned again once
+ * this distance exceeds half a cell. Models whose speed changes without
+ * a course change notification (e.g., ConstantAccelerationMobilityModel)
+ * are not supported.
+ *
+ * Items without a mobility model are the neighbors of any position.
+ */
+class SpatialGrid : public SimpleRefCount<SpatialGrid>
+{
+public:
+  /**
+   * \param cellSize the size of the side of the cells (m)
+   */
+  SpatialGrid (double cellSize);
+  ~SpatialGrid ();
+
+  // Delete copy constructor and assignment operator to avoid misuse
+  SpatialGrid (const SpatialGrid &) = delete;
+  SpatialGrid & operator= (const SpatialGrid &) = delete;
+
+  /**
+   * \brief Add an item.
+   * \param mobility the mobility model of the item (possibly null)
+   * \return the index of the item
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+
+  /**
+   * \return the number of items
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \return the size of the side of the cells (m)
+   */
+  double GetCellSize (void) const;
+
+  /**
+   * \brief Remove all the items.
+   */
+  void Clear (void);
+
+  /**
+   * \brief Get the items within a range of a position.
+   *
+   * The distance between the position and the current position of the items
+   * is computed in three dimensions.
+   *
+   * \param position the position
+   * \param range the range (m)
+   * \param items the indexes of the items within range, and of the items
+   *        without mobility model, in increasing order
+   */
+  void GetNeighbors (const Vector &position, double range, std::vector<uint32_t> &items);
+
+private:
+  /**
+   * \brief Notification of a course change of a mobility model.
+   * \param mobility the mobility model
+   */
+  void CourseChange (Ptr<const MobilityModel> mobility);
+
+  /**
+   * \brief Put an item in the cell of the current position of its mobility model.
+   * \param item the index of the item
+   */
+  void Bin (uint32_t item);
+
+  /**
+   * \brief Bin again the moving items, if they may have left their cell.
+   */
+  void Refresh (void);
+
+  /**
+   * \param x the x coordinate
+   * \param y the y coordinate
+   * \return the key of the cell
+   */
+  static uint64_t GetCellKey (int32_t x, int32_t y);
+
+  /**
+   * \param coordinate the coordinate (m)
+   * \return the cell coordinate
+   */
+  int32_t GetCellCoordinate (double coordinate) const;
+
+  /// An item of the grid
+  struct Item
+  {
+    Ptr<MobilityModel> mobility;   //!< the mobility model
+    uint64_t cell;                 //!< the key of the cell of the item
+    double speed;                  //!< the speed of the item when binned (m/s)
+  };
+
+  double m_cellSize;                           //!< the size of the cells (m)
+  std::vector<Item> m_items;                   //!< the items
+  std::vector<uint32_t> m_unlocated;           //!< the items without mobility model
+  std::unordered_map<uint64_t, std::vector<uint32_t> > m_cells; //!< the items of each cell
+  std::unordered_map<const MobilityModel *, std::vector<uint32_t> > m_models; //!< the items of each mobility model
+  uint32_t m_nMoving;                          //!< the number of items with a non-zero speed
+  double m_maxSpeed;                           //!< the largest speed since the last refresh (m/s)
+  Time m_lastRefresh;                          //!< the time of the last refresh
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_GRID_H */
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/rectangle.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/spatial-grid.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Compare the neighbors found by a SpatialGrid with the ones found by
+ * looking at all the mobility models, while the models move.
+ */
+class SpatialGridNeighborsTest : public TestCase
+{
+public:
+  SpatialGridNeighborsTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Check the neighbors of a random position.
+   */
+  void CheckNeighbors (void);
+
+  Ptr<SpatialGrid> m_grid;                       //!< the grid
+  std::vector<Ptr<MobilityModel> > m_mobilities; //!< the mobility model of each item
+  Ptr<UniformRandomVariable> m_random;           //!< the query positions and ranges
+  uint32_t m_nChecks;                            //!< the number of queries checked
+  uint32_t m_nNeighbors;                         //!< the total number of neighbors found
+};
+
+SpatialGridNeighborsTest::SpatialGridNeighborsTest ()
+  : TestCase ("SpatialGrid finds the neighbors of moving mobility models"),
+    m_nChecks (0),
+    m_nNeighbors (0)
+{
+}
+
+void
+SpatialGridNeighborsTest::CheckNeighbors (void)
+{
+  Vector position (m_random->GetValue (0, 1000), m_random->GetValue (0, 1000), 0);
+  double range = m_random->GetValue (10, 300);
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 0; i < m_mobilities.size (); i++)
+    {
+      if (m_mobilities[i] == 0 || CalculateDistance (m_mobilities[i]->GetPosition (), position) <= range)
+        {
+          expected.push_back (i);
+        }
+    }
+  std::vector<uint32_t> neighbors;
+  m_grid->GetNeighbors (position, range, neighbors);
+  NS_TEST_EXPECT_MSG_EQ (neighbors.size (), expected.size (), "Wrong number of neighbors at " << Simulator::Now ().As (Time::S));
+  NS_TEST_EXPECT_MSG_EQ ((neighbors == expected), true, "Wrong neighbors at " << Simulator::Now ().As (Time::S));
+  m_nChecks++;
+  m_nNeighbors += neighbors.size ();
+}
+
+void
+SpatialGridNeighborsTest::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  m_grid = Create<SpatialGrid> (100);
+  for (uint32_t i = 0; i < 600; i++)
+    {
+      Ptr<MobilityModel> mobility;
+      Vector position (m_random->GetValue (0, 1000), m_random->GetValue (0, 1000), m_random->GetValue (0, 10));
+      switch (i % 3)
+        {
+        case 0:
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+          break;
+        case 1:
+          {
+            Ptr<RandomWalk2dMobilityModel> walk = CreateObject<RandomWalk2dMobilityModel> ();
+            walk->SetAttribute ("Bounds", RectangleValue (Rectangle (0, 1000, 0, 1000)));
+            walk->SetAttribute ("Mode", EnumValue (RandomWalk2dMobilityModel::MODE_TIME));
+            walk->SetAttribute ("Time", TimeValue (Seconds (3)));
+            walk->SetAttribute ("Speed", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=40.0]"));
+            walk->AssignStreams (i);
+            mobility = walk;
+          }
+          break;
+        default:
+          {
+            Ptr<ConstantVelocityMobilityModel> constantVelocity = CreateObject<ConstantVelocityMobilityModel> ();
+            constantVelocity->SetVelocity (Vector (m_random->GetValue (-5, 5), m_random->GetValue (-5, 5), 0));
+            mobility = constantVelocity;
+          }
+          break;
+        }
+      mobility->SetPosition (position);
+      mobility->Initialize ();
+      m_mobilities.push_back (mobility);
+      NS_TEST_EXPECT_MSG_EQ (m_grid->Add (mobility), i, "Wrong item index");
+      if (i % 100 == 0)
+        {
+          // a mobility model shared by several items, and items without mobility model
+          m_mobilities.push_back (mobility);
+          m_grid->Add (mobility);
+          m_mobilities.push_back (0);
+          m_grid->Add (0);
+          i += 2;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_grid->GetN (), m_mobilities.size (), "Wrong number of items");
+
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Simulator::Schedule (MilliSeconds (50 * i + 7), &SpatialGridNeighborsTest::CheckNeighbors, this);
+    }
+  // the random walks never stop
+  Simulator::Stop (Seconds (101));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_nChecks, 2000, "Neighbors not checked");
+  NS_TEST_EXPECT_MSG_GT (m_nNeighbors, 20 * m_nChecks, "Too few neighbors for a meaningful test");
+
+  m_grid = 0;
+  m_mobilities.clear ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief SpatialGrid Test Suite
+ */
+static struct SpatialGridTestSuite : public TestSuite
+{
+  SpatialGridTestSuite () : TestSuite ("spatial-grid", UNIT)
+  {
+    AddTestCase (new SpatialGridNeighborsTest (), TestCase::QUICK);
+  }
+} g_spatialGridTestSuite; ///< the test suite
@@ -146,4 +146,79 @@ QueueDiscItem::Hash (uint32_t perturbation) const
   return 0;
 }
 
+/// Maximum number of destroyed items kept in a free list
+static const std::size_t QUEUE_DISC_ITEM_FREE_LIST_MAX = 1000;
+
+std::vector<QueueDiscItem::FreeList> *QueueDiscItem::g_freeLists = 0;
+bool QueueDiscItem::g_freeListsDestroyed = false;
+struct QueueDiscItem::LocalStaticDestructor QueueDiscItem::g_localStaticDestructor;
+
+QueueDiscItem::LocalStaticDestructor::~LocalStaticDestructor (void)
+{
+  if (g_freeLists != 0)
+    {
+      for (auto &list : *g_freeLists)
+        {
+          for (auto block : list.blocks)
+            {
+              ::operator delete (block);
+            }
+        }
+      delete g_freeLists;
+      g_freeLists = 0;
+    }
+  // items destroyed from now on release their memory
+  g_freeListsDestroyed = true;
+}
+
+void *
+QueueDiscItem::operator new (std::size_t size)
+{
+  if (g_freeLists != 0)
+    {
+      for (auto &list : *g_freeLists)
+        {
+          if (list.size == size && !list.blocks.empty ())
+            {
+              void *block = list.blocks.back ();
+              list.blocks.pop_back ();
+              return block;
+            }
+        }
+    }
+  return ::operator new (size);
+}
+
+void
+QueueDiscItem::operator delete (void *p, std::size_t size)
+{
+  if (g_freeListsDestroyed)
+    {
+      ::operator delete (p);
+      return;
+    }
+  if (g_freeLists == 0)
+    {
+      g_freeLists = new std::vector<FreeList> ();
+    }
+  for (auto &list : *g_freeLists)
+    {
+      if (list.size == size)
+        {
+          if (list.blocks.size () < QUEUE_DISC_ITEM_FREE_LIST_MAX)
+            {
+              list.blocks.push_back (p);
+            }
+          else
+            {
+              ::operator delete (p);
+            }
+          return;
+        }
+    }
+  g_freeLists->push_back (FreeList ());
+  g_freeLists->back ().size = size;
+  g_freeLists->back ().blocks.push_back (p);
+}
+
 } // namespace ns3
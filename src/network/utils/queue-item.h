@@ -24,6 +24,8 @@
 #include "ns3/simple-ref-count.h"
 #include <ns3/address.h>
 #include "ns3/nstime.h"
+#include <cstddef>
+#include <vector>
 
 namespace ns3 {
 
@@ -144,6 +146,10 @@ std::ostream& operator<< (std::ostream& os, const QueueItem &item);
  * disc. It is derived from QueueItem (which only consists of a Ptr<Packet>)
  * to additionally store the destination MAC address, the
  * L3 protocol number and the transmission queue index,
+ *
+ * An item is created for every packet sent through the traffic control layer,
+ * hence the memory of the destroyed items is not released but kept in free
+ * lists, one per item size, from which the new items are allocated.
  */
 class QueueDiscItem : public QueueItem {
 public:
@@ -226,7 +232,41 @@ public:
    */
   virtual uint32_t Hash (uint32_t perturbation = 0) const;
 
+  /**
+   * \brief Allocate the memory of an item, reusing the memory of a destroyed
+   * item of the same size if possible
+   * \param size the size of the item
+   * \return the memory of the item
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * \brief Keep the memory of a destroyed item for later reuse
+   * \param p the memory of the item
+   * \param size the size of the item
+   */
+  static void operator delete (void *p, std::size_t size);
+
 private:
+  /// The memory of the destroyed items of a given size
+  struct FreeList
+  {
+    std::size_t size;             //!< the size of the items
+    std::vector<void *> blocks;   //!< the memory of the destroyed items
+  };
+  /// Local static destructor structure
+  struct LocalStaticDestructor
+  {
+    /**
+     * \brief Release the memory kept in the free lists
+     */
+    ~LocalStaticDestructor ();
+  };
+
+  static std::vector<FreeList> *g_freeLists;  //!< Free lists, created on demand
+  static bool g_freeListsDestroyed;           //!< True once the free lists have been destroyed
+  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+
+
   /**
    * \brief Default constructor
    *
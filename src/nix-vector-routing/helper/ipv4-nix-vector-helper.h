@@ -66,6 +66,18 @@ public:
   */
   virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
 
+  /**
+   * \brief Compute ahead of time the nix-vector routes between all the
+   * pairs of nodes.
+   *
+   * This is meant to be called once the topology and the addresses are
+   * set up, before the simulation starts.  The searches are spread over
+   * the given number of threads.
+   *
+   * \param nThreads number of worker threads
+   */
+  static void PrecomputeAllPairs (uint32_t nThreads = 1);
+
 private:
   /**
    * \brief Assignment operator declared private and not implemented to disallow
@@ -18,12 +18,12 @@
  * Authors: Josh Pelkey <jpelkey@gatech.edu>
  */
 
-#include <queue>
 #include <iomanip>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/names.h"
+#include "ns3/simulator.h"
 #include "ns3/ipv4-list-routing.h"
 
 #include "ipv4-nix-vector-routing.h"
@@ -34,7 +34,9 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4NixVectorRouting");
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting);
 
-bool Ipv4NixVectorRouting::g_isCacheDirty = false;
+NixVectorTopology Ipv4NixVectorRouting::g_topology (NixVectorTopology::IPV4);
+std::map<Ipv4Address, uint32_t> Ipv4NixVectorRouting::g_nodeByAddress;
+bool Ipv4NixVectorRouting::g_clearStoreScheduled = false;
 
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
@@ -51,6 +53,13 @@ Ipv4NixVectorRouting::Ipv4NixVectorRouting ()
   : m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  // the shared store outlives the individual routers, even those which are
+  // never disposed, and lasts until the end of the simulation
+  if (!g_clearStoreScheduled)
+    {
+      Simulator::ScheduleDestroy (&Ipv4NixVectorRouting::ClearStore);
+      g_clearStoreScheduled = true;
+    }
 }
 
 Ipv4NixVectorRouting::~Ipv4NixVectorRouting ()
@@ -80,6 +89,15 @@ Ipv4NixVectorRouting::DoDispose ()
 }
 
 
+void
+Ipv4NixVectorRouting::ClearStore (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_topology.Clear ();
+  g_nodeByAddress.clear ();
+  g_clearStoreScheduled = false;
+}
+
 void
 Ipv4NixVectorRouting::SetNode (Ptr<Node> node)
 {
@@ -92,6 +110,8 @@ void
 Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
+  g_topology.Clear ();
+  g_nodeByAddress.clear ();
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -107,6 +127,17 @@ Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
     }
 }
 
+void
+Ipv4NixVectorRouting::PrecomputeAllPairs (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (nThreads);
+  if (g_topology.HasPendingChanges ())
+    {
+      ProcessTopologyChanges ();
+    }
+  g_topology.PrecomputeAllPairs (nThreads);
+}
+
 void
 Ipv4NixVectorRouting::FlushNixCache (void) const
 {
@@ -126,9 +157,7 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  Ptr<NixVector> nixVector = Create<NixVector> ();
-
-  // not in cache, must build the nix vector
+  // not in cache, must get the nix vector
   // First, we have to figure out the nodes 
   // associated with these IPs
   Ptr<Node> destNode = GetNodeByIp (dest);
@@ -146,24 +175,25 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
       NS_LOG_DEBUG ("Do not process packets to self");
       return 0;
     }
+
+  // otherwise proceed as normal and get the nix vector
+  // from the shared store, unless a specific output
+  // interface must be used
+  Ptr<NixVector> nixVector;
+  if (oif)
+    {
+      nixVector = g_topology.BuildNixVector (source->GetId (), destNode->GetId (), oif);
+    }
   else
     {
-      // otherwise proceed as normal 
-      // and build the nix vector
-      std::vector< Ptr<Node> > parentVector;
-
-      BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif);
+      nixVector = g_topology.GetNixVector (source->GetId (), destNode->GetId ());
+    }
 
-      if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
-        {
-          return nixVector;
-        }
-      else
-        {
-          NS_LOG_ERROR ("No routing path exists");
-          return 0;
-        }
+  if (!nixVector)
+    {
+      NS_LOG_ERROR ("No routing path exists");
     }
+  return nixVector;
 }
 
 Ptr<NixVector>
@@ -229,145 +259,41 @@ Ipv4NixVectorRouting::BuildNixVectorLocal (Ptr<NixVector> nixVector)
   return false;
 }
 
-bool
-Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
-{
+Ptr<Node>
+Ipv4NixVectorRouting::GetNodeByIp (Ipv4Address dest)
+{ 
   NS_LOG_FUNCTION_NOARGS ();
 
-  if (source == dest)
-    {
-      return true;
-    }
-
-  if (parentVector.at (dest) == 0)
-    {
-      return false;
-    }
-
-  Ptr<Node> parentNode = parentVector.at (dest);
-
-  uint32_t numberOfDevices = parentNode->GetNDevices ();
-  uint32_t destId = 0;
-  uint32_t totalNeighbors = 0;
-
-  // scan through the net devices on the parent node
-  // and then look at the nodes adjacent to them
-  for (uint32_t i = 0; i < numberOfDevices; i++)
+  if (g_nodeByAddress.empty ())
     {
-      // Get a net device from the node
-      // as well as the channel, and figure
-      // out the adjacent net devices
-      Ptr<NetDevice> localNetDevice = parentNode->GetDevice (i);
-      if (localNetDevice->IsBridge ())
+      // the first node owning an address wins
+      NS_LOG_LOGIC ("Building the address index");
+      NodeList::Iterator listEnd = NodeList::End ();
+      for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
         {
-          continue;
-        }
-      Ptr<Channel> channel = localNetDevice->GetChannel ();
-      if (channel == 0)
-        {
-          continue;
-        }
-
-      // this function takes in the local net dev, and channel, and
-      // writes to the netDeviceContainer the adjacent net devs
-      NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-      // Finally we can get the adjacent nodes
-      // and scan through them.  If we find the 
-      // node that matches "dest" then we can add 
-      // the index  to the nix vector.
-      // the index corresponds to the neighbor index
-      uint32_t offset = 0;
-      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-        {
-          Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-          if (remoteNode->GetId () == dest)
+          Ptr<Ipv4> ipv4 = (*i)->GetObject<Ipv4> ();
+          if (!ipv4)
             {
-              destId = totalNeighbors + offset;
+              continue;
             }
-          offset += 1;
-        }
-
-      totalNeighbors += netDeviceContainer.GetN ();
-    }
-  NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
-                               << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode->GetId ());
-  nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
-
-  // recurse through parent vector, grabbing the path 
-  // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
-  return true;
-}
-
-void
-Ipv4NixVectorRouting::GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  for (std::size_t i = 0; i < channel->GetNDevices (); i++)
-    {
-      Ptr<NetDevice> remoteDevice = channel->GetDevice (i);
-      if (remoteDevice != netDevice)
-        {
-          Ptr<BridgeNetDevice> bd = NetDeviceIsBridged (remoteDevice);
-          // we have a bridged device, we need to add all 
-          // bridged devices
-          if (bd)
+          for (uint32_t j = 0; j < ipv4->GetNInterfaces (); j++)
             {
-              NS_LOG_LOGIC ("Looking through bridge ports of bridge net device " << bd);
-              for (uint32_t j = 0; j < bd->GetNBridgePorts (); ++j)
+              for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
                 {
-                  Ptr<NetDevice> ndBridged = bd->GetBridgePort (j);
-                  if (ndBridged == remoteDevice)
-                    {
-                      NS_LOG_LOGIC ("That bridge port is me, don't walk backward");
-                      continue;
-                    }
-                  Ptr<Channel> chBridged = ndBridged->GetChannel ();
-                  if (chBridged == 0)
-                    {
-                      continue;
-                    }
-                  GetAdjacentNetDevices (ndBridged, chBridged, netDeviceContainer);
+                  g_nodeByAddress.insert (std::make_pair (ipv4->GetAddress (j, k).GetLocal (), (*i)->GetId ()));
                 }
             }
-          else
-            {
-              netDeviceContainer.Add (channel->GetDevice (i));
-            }
-        }
-    }
-}
-
-Ptr<Node>
-Ipv4NixVectorRouting::GetNodeByIp (Ipv4Address dest)
-{ 
-  NS_LOG_FUNCTION_NOARGS ();
-
-  NodeContainer allNodes = NodeContainer::GetGlobal ();
-  Ptr<Node> destNode;
-
-  for (NodeContainer::Iterator i = allNodes.Begin (); i != allNodes.End (); ++i)
-    {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-      if (ipv4->GetInterfaceForAddress (dest) != -1)
-        {
-          destNode = node;
-          break;
         }
     }
 
-  if (!destNode)
+  std::map<Ipv4Address, uint32_t>::const_iterator it = g_nodeByAddress.find (dest);
+  if (it == g_nodeByAddress.end ())
     {
       NS_LOG_ERROR ("Couldn't find dest node given the IP" << dest);
       return 0;
     }
 
-  return destNode;
+  return NodeList::GetNode (it->second);
 }
 
 uint32_t
@@ -393,7 +319,7 @@ Ipv4NixVectorRouting::FindTotalNeighbors (void)
       // this function takes in the local net dev, and channel, and
       // writes to the netDeviceContainer the adjacent net devs
       NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+      NixVectorTopology::GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
 
       totalNeighbors += netDeviceContainer.GetN ();
     }
@@ -401,46 +327,6 @@ Ipv4NixVectorRouting::FindTotalNeighbors (void)
   return totalNeighbors;
 }
 
-Ptr<BridgeNetDevice>
-Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd) const
-{
-  NS_LOG_FUNCTION (nd);
-
-  Ptr<Node> node = nd->GetNode ();
-  uint32_t nDevices = node->GetNDevices ();
-
-  //
-  // There is no bit on a net device that says it is being bridged, so we have
-  // to look for bridges on the node to which the device is attached.  If we
-  // find a bridge, we need to look through its bridge ports (the devices it
-  // bridges) to see if we find the device in question.
-  //
-  for (uint32_t i = 0; i < nDevices; ++i)
-    {
-      Ptr<NetDevice> ndTest = node->GetDevice (i);
-      NS_LOG_LOGIC ("Examine device " << i << " " << ndTest);
-
-      if (ndTest->IsBridge ())
-        {
-          NS_LOG_LOGIC ("device " << i << " is a bridge net device");
-          Ptr<BridgeNetDevice> bnd = ndTest->GetObject<BridgeNetDevice> ();
-          NS_ABORT_MSG_UNLESS (bnd, "Ipv4NixVectorRouting::NetDeviceIsBridged (): GetObject for <BridgeNetDevice> failed");
-
-          for (uint32_t j = 0; j < bnd->GetNBridgePorts (); ++j)
-            {
-              NS_LOG_LOGIC ("Examine bridge port " << j << " " << bnd->GetBridgePort (j));
-              if (bnd->GetBridgePort (j) == nd)
-                {
-                  NS_LOG_LOGIC ("Net device " << nd << " is bridged by " << bnd);
-                  return bnd;
-                }
-            }
-        }
-    }
-  NS_LOG_LOGIC ("Net device " << nd << " is not bridged");
-  return 0;
-}
-
 uint32_t
 Ipv4NixVectorRouting::FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp)
 {
@@ -465,7 +351,7 @@ Ipv4NixVectorRouting::FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address
       // this function takes in the local net dev, and channel, and
       // writes to the netDeviceContainer the adjacent net devs
       NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+      NixVectorTopology::GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
 
       // check how many neighbors we have
       if (nodeIndex < (totalNeighbors + netDeviceContainer.GetN ()))
@@ -752,177 +638,74 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::
 void
 Ipv4NixVectorRouting::NotifyInterfaceUp (uint32_t i)
 {
-  g_isCacheDirty = true;
+  NotifyTopologyChange ();
 }
 void
 Ipv4NixVectorRouting::NotifyInterfaceDown (uint32_t i)
 {
-  g_isCacheDirty = true;
+  NotifyTopologyChange ();
 }
 void
 Ipv4NixVectorRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  NotifyTopologyChange ();
 }
 void
 Ipv4NixVectorRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  NotifyTopologyChange ();
 }
 
-bool
-Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source, 
-                           Ptr<Node> dest, std::vector< Ptr<Node> > & parentVector,
-                           Ptr<NetDevice> oif)
+void
+Ipv4NixVectorRouting::NotifyTopologyChange (void) const
 {
-  NS_LOG_FUNCTION_NOARGS ();
-
-  NS_LOG_LOGIC ("Going from Node " << source->GetId () << " to Node " << dest->GetId ());
-  std::queue< Ptr<Node> > greyNodeList;  // discovered nodes with unexplored children
-
-  // reset the parent vector
-  parentVector.assign (numberOfNodes, 0); // initialize to 0
-
-  // Add the source node to the queue, set its parent to itself 
-  greyNodeList.push (source);
-  parentVector.at (source->GetId ()) = source;
-
-  // BFS loop
-  while (greyNodeList.size () != 0)
+  if (m_node)
     {
-      Ptr<Node> currNode = greyNodeList.front ();
-      Ptr<Ipv4> ipv4 = currNode->GetObject<Ipv4> ();
- 
-      if (currNode == dest) 
-        {
-          NS_LOG_LOGIC ("Made it to Node " << currNode->GetId ());
-          return true;
-        }
+      g_topology.NotifyChange (m_node->GetId ());
+    }
+  else
+    {
+      g_topology.NotifyGlobalChange ();
+    }
+}
 
-      // if this is the first iteration of the loop and a 
-      // specific output interface was given, make sure 
-      // we go this way
-      if (currNode == source && oif)
-        {
-          // make sure that we can go this way
-          if (ipv4)
-            {
-              uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (oif);
-              if (!(ipv4->IsUp (interfaceIndex)))
-                {
-                  NS_LOG_LOGIC ("Ipv4Interface is down");
-                  return false;
-                }
-            }
-          if (!(oif->IsLinkUp ()))
-            {
-              NS_LOG_LOGIC ("Link is down.");
-              return false;
-            }
-          Ptr<Channel> channel = oif->GetChannel ();
-          if (channel == 0)
-            { 
-              return false;
-            }
+void 
+Ipv4NixVectorRouting::CheckCacheStateAndFlush (void) const
+{
+  if (g_topology.HasPendingChanges ())
+    {
+      ProcessTopologyChanges ();
+    }
+}
 
-          // this function takes in the local net dev, and channel, and
-          // writes to the netDeviceContainer the adjacent net devs
-          NetDeviceContainer netDeviceContainer;
-          GetAdjacentNetDevices (oif, channel, netDeviceContainer);
+void
+Ipv4NixVectorRouting::ProcessTopologyChanges (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
 
-          // Finally we can get the adjacent nodes
-          // and scan through them.  We push them
-          // to the greyNode queue, if they aren't 
-          // already there.
-          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-            {
-              Ptr<Node> remoteNode = (*iter)->GetNode ();
+  g_nodeByAddress.clear ();
 
-              // check to see if this node has been pushed before
-              // by checking to see if it has a parent
-              // if it doesn't (null or 0), then set its parent and 
-              // push to the queue
-              if (parentVector.at (remoteNode->GetId ()) == 0)
-                {
-                  parentVector.at (remoteNode->GetId ()) = currNode;
-                  greyNodeList.push (remoteNode);
-                }
-            }
-        }
-      else
+  std::vector<uint32_t> affectedNodes;
+  bool partial = g_topology.Invalidate (affectedNodes);
+  if (!partial)
+    {
+      affectedNodes.clear ();
+      for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
         {
-          // Iterate over the current node's adjacent vertices
-          // and push them into the queue
-          for (uint32_t i = 0; i < (currNode->GetNDevices ()); i++)
-            {
-              // Get a net device from the node
-              // as well as the channel, and figure
-              // out the adjacent net device
-              Ptr<NetDevice> localNetDevice = currNode->GetDevice (i);
-
-              // make sure that we can go this way
-              if (ipv4)
-                {
-                  uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (currNode->GetDevice (i));
-                  if (!(ipv4->IsUp (interfaceIndex)))
-                    {
-                      NS_LOG_LOGIC ("Ipv4Interface is down");
-                      continue;
-                    }
-                }
-              if (!(localNetDevice->IsLinkUp ()))
-                {
-                  NS_LOG_LOGIC ("Link is down.");
-                  continue;
-                }
-              Ptr<Channel> channel = localNetDevice->GetChannel ();
-              if (channel == 0)
-                { 
-                  continue;
-                }
-
-              // this function takes in the local net dev, and channel, and
-              // writes to the netDeviceContainer the adjacent net devs
-              NetDeviceContainer netDeviceContainer;
-              GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-              // Finally we can get the adjacent nodes
-              // and scan through them.  We push them
-              // to the greyNode queue, if they aren't 
-              // already there.
-              for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-                {
-                  Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-                  // check to see if this node has been pushed before
-                  // by checking to see if it has a parent
-                  // if it doesn't (null or 0), then set its parent and 
-                  // push to the queue
-                  if (parentVector.at (remoteNode->GetId ()) == 0)
-                    {
-                      parentVector.at (remoteNode->GetId ()) = currNode;
-                      greyNodeList.push (remoteNode);
-                    }
-                }
-            }
+          affectedNodes.push_back (i);
         }
-
-      // Pop off the head grey node.  We have all its children.
-      // It is now black.
-      greyNodeList.pop ();
     }
 
-  // Didn't find the dest...
-  return false;
-}
-
-void 
-Ipv4NixVectorRouting::CheckCacheStateAndFlush (void) const
-{
-  if (g_isCacheDirty)
+  for (std::vector<uint32_t>::const_iterator i = affectedNodes.begin (); i != affectedNodes.end (); ++i)
     {
-      FlushGlobalNixRoutingCache ();
-      g_isCacheDirty = false;
+      Ptr<Ipv4NixVectorRouting> rp = NodeList::GetNode (*i)->GetObject<Ipv4NixVectorRouting> ();
+      if (!rp)
+        {
+          continue;
+        }
+      NS_LOG_LOGIC ("Flushing Nix caches of node " << *i);
+      rp->FlushNixCache ();
+      rp->FlushIpv4RouteCache ();
     }
 }
 
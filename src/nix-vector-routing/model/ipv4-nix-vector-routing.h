@@ -32,6 +32,7 @@
 #include "ns3/nix-vector.h"
 #include "ns3/bridge-net-device.h"
 #include "ns3/nstime.h"
+#include "nix-vector-topology.h"
 
 namespace ns3 {
 
@@ -88,6 +89,18 @@ public:
    */
   void FlushGlobalNixRoutingCache (void) const;
 
+  /**
+   * @brief Compute ahead of time the routes between all the pairs of nodes
+   *
+   * The BFS trees of all the nodes are computed and stored in the
+   * nix-vector store shared by all the Ipv4NixVectorRouting instances,
+   * so that no search is needed when a new destination is first used.
+   * The searches are spread over nThreads worker threads.
+   *
+   * @param nThreads number of worker threads
+   */
+  static void PrecomputeAllPairs (uint32_t nThreads = 1);
+
 private:
 
   /**
@@ -111,8 +124,8 @@ private:
 
   /**
    * Takes in the source node and dest IP and calls GetNodeByIp,
-   * BFS, accounting for any output interface specified, and finally
-   * BuildNixVector to return the built nix-vector
+   * then gets the nix-vector from the shared store, or builds it
+   * if a specific output interface is given
    *
    * \param source Source node
    * \param dest Destination node address
@@ -136,32 +149,13 @@ private:
   Ptr<Ipv4Route> GetIpv4RouteInCache (Ipv4Address address);
 
   /**
-   * Given a net-device returns all the adjacent net-devices,
-   * essentially getting the neighbors on that channel
-   * \param [in] netDevice the NetDevice attached to the channel.
-   * \param [in] channel the channel to check
-   * \param [out] netDeviceContainer the NetDeviceContainer of the NetDevices in the channel.
-   */
-  void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer);
-
-  /**
-   * Iterates through the node list and finds the one
-   * corresponding to the given Ipv4Address
+   * Finds the node corresponding to the given Ipv4Address,
+   * through an index of all the addresses in the simulation
    * \param dest destination node IP
    * \return The node with the specified IP.
    */
   Ptr<Node> GetNodeByIp (Ipv4Address dest);
 
-  /**
-   * Recurses the parent vector, created by BFS and actually builds the nixvector
-   * \param [in] parentVector Parent vector for retracing routes
-   * \param [in] source Source Node index
-   * \param [in] dest Destination Node index
-   * \param [out] nixVector the NixVector to be used for routing
-   * \returns true on success, false otherwise.
-   */
-  bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
-
   /**
    * Special variation of BuildNixVector for when a node is sending to itself
    * \param [out] nixVector the NixVector to be used for routing
@@ -176,13 +170,6 @@ private:
    */
   uint32_t FindTotalNeighbors (void);
 
-  /**
-   * Determine if the NetDevice is bridged
-   * \param nd the NetDevice to check
-   * \returns the bridging NetDevice (or null if the NetDevice is not bridged)
-   */
-  Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd) const;
-
 
   /**
    * Nix index is with respect to the neighbors.  The net-device index must be
@@ -193,21 +180,6 @@ private:
    */
   uint32_t FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp);
 
-  /**
-   * \brief Breadth first search algorithm.
-   * \param [in] numberOfNodes total number of nodes
-   * \param [in] source Source Node
-   * \param [in] dest Destination Node
-   * \param [out] parentVector Parent vector for retracing routes
-   * \param [in] oif specific output interface to use from source node, if not null
-   * \returns false if dest not found, true o.w.
-   */
-  bool BFS (uint32_t numberOfNodes,
-            Ptr<Node> source,
-            Ptr<Node> dest,
-            std::vector< Ptr<Node> > & parentVector,
-            Ptr<NetDevice> oif);
-
   void DoDispose (void);
 
   /* From Ipv4RoutingProtocol */
@@ -228,10 +200,34 @@ private:
   void CheckCacheStateAndFlush (void) const;
 
   /**
-   * Flag to mark when caches are dirty and need to be flushed.  
-   * Used for lazy cleanup of caches when there are many topology changes.
+   * Records a run-time topology change on this node
+   */
+  void NotifyTopologyChange (void) const;
+
+  /**
+   * Processes the recorded topology changes, flushing the caches
+   * of the nodes in the affected components only.
+   */
+  static void ProcessTopologyChanges (void);
+
+  /**
+   * Topology snapshot and nix-vector store shared by all nodes.
+   * Changes are recorded there and processed lazily, which allows
+   * cheap cleanup of caches when there are many topology changes.
+   */
+  static NixVectorTopology g_topology;
+
+  /** Index of the node owning each address, built lazily */
+  static std::map<Ipv4Address, uint32_t> g_nodeByAddress;
+
+  /** Whether ClearStore is scheduled to run with Simulator::Destroy */
+  static bool g_clearStoreScheduled;
+
+  /**
+   * Clears the shared store, when the simulation is destroyed and the node
+   * ids are about to be reused
    */
-  static bool g_isCacheDirty;
+  static void ClearStore (void);
 
   /** Cache stores nix-vectors based on destination ip */
   mutable NixMap_t m_nixCache;
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 The Georgia Institute of Technology 
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Josh Pelkey <jpelkey@gatech.edu>
+ */
+
+#ifndef IPV6_NIX_VECTOR_ROUTING_H
+#define IPV6_NIX_VECTOR_ROUTING_H
+
+#include <map>
+
+#include "ns3/channel.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv6-routing-protocol.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/nix-vector.h"
+#include "ns3/bridge-net-device.h"
+#include "ns3/nstime.h"
+#include "nix-vector-topology.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup nix-vector-routing
+ * Map of Ipv6Address to NixVector
+ */
+typedef std::map<Ipv6Address, Ptr<NixVector> > Ipv6NixMap_t;
+/**
+ * \ingroup nix-vector-routing
+ * Map of Ipv6Address to Ipv6Route
+ */
+typedef std::map<Ipv6Address, Ptr<Ipv6Route> > Ipv6RouteMap_t;
+
+/**
+ * \ingroup nix-vector-routing
+ * Nix-vector routing protocol for IPv6
+ *
+ * The nix-vectors are shared with Ipv4NixVectorRouting only in their
+ * format: the IPv6 instances have their own topology snapshot and store,
+ * built from the state of the IPv6 interfaces.
+ */
+class Ipv6NixVectorRouting : public Ipv6RoutingProtocol
+{
+public:
+  Ipv6NixVectorRouting ();
+  ~Ipv6NixVectorRouting ();
+  /**
+   * @brief The Interface ID of the Global Router interface.
+   * @return The Interface ID
+   * @see Object::GetObject ()
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * @brief Set the Node pointer of the node for which this
+   * routing protocol is to be placed
+   *
+   * @param node Node pointer
+   */
+  void SetNode (Ptr<Node> node);
+
+  /**
+   * @brief Called when run-time link topology change occurs
+   * which iterates through the node list and flushes any
+   * nix vector caches
+   *
+   * \internal
+   * \c const is used here due to need to potentially flush the cache
+   * in const methods such as PrintRoutingTable.  Caches are stored in
+   * mutable variables and flushed in const methods.
+   */
+  void FlushGlobalNixRoutingCache (void) const;
+
+  /**
+   * @brief Compute ahead of time the routes between all the pairs of nodes
+   *
+   * The BFS trees of all the nodes are computed and stored in the
+   * nix-vector store shared by all the Ipv6NixVectorRouting instances,
+   * so that no search is needed when a new destination is first used.
+   * The searches are spread over nThreads worker threads.
+   *
+   * @param nThreads number of worker threads
+   */
+  static void PrecomputeAllPairs (uint32_t nThreads = 1);
+
+private:
+
+  /**
+   * Flushes the cache which stores nix-vector based on
+   * destination IP
+   */
+  void FlushNixCache (void) const;
+
+  /**
+   * Flushes the cache which stores the Ipv6 route
+   * based on the destination IP
+   */
+  void FlushIpv6RouteCache (void) const;
+
+  /**
+   * Takes in the source node and dest IP and calls GetNodeByIp,
+   * then gets the nix-vector from the shared store, or builds it
+   * if a specific output interface is given
+   *
+   * \param source Source node
+   * \param dest Destination node address
+   * \param oif Preferred output interface
+   * \returns The NixVector to be used in routing.
+   */
+  Ptr<NixVector> GetNixVector (Ptr<Node> source, Ipv6Address dest, Ptr<NetDevice> oif);
+
+  /**
+   * Checks the cache based on dest IP for the nix-vector
+   * \param address Address to check
+   * \returns The NixVector to be used in routing.
+   */
+  Ptr<NixVector> GetNixVectorInCache (Ipv6Address address);
+
+  /**
+   * Checks the cache based on dest IP for the Ipv6Route
+   * \param address Address to check
+   * \returns The cached route.
+   */
+  Ptr<Ipv6Route> GetIpv6RouteInCache (Ipv6Address address);
+
+  /**
+   * Finds the node corresponding to the given Ipv6Address,
+   * through an index of all the addresses in the simulation
+   * \param dest destination node IP
+   * \return The node with the specified IP.
+   */
+  Ptr<Node> GetNodeByIp (Ipv6Address dest);
+
+  /**
+   * Simple iterates through the nodes net-devices and determines
+   * how many neighbors it has
+   * \returns the number of neighbors.
+   */
+  uint32_t FindTotalNeighbors (void);
+
+
+  /**
+   * Nix index is with respect to the neighbors.  The net-device index must be
+   * derived from this
+   * \param [in] nodeIndex Nix Node index
+   * \param [out] gatewayIp link-local IP address of the gateway
+   * \returns the index of the NetDevice in the node.
+   */
+  uint32_t FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv6Address & gatewayIp);
+
+  void DoDispose (void);
+
+  /* From Ipv6RoutingProtocol */
+  virtual Ptr<Ipv6Route> RouteOutput (Ptr<Packet> p, const Ipv6Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv6Header &header, Ptr<const NetDevice> idev,
+                           UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                           LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv6InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAddress address);
+  virtual void NotifyAddRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse = Ipv6Address::GetZero ());
+  virtual void NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse = Ipv6Address::GetZero ());
+  virtual void SetIpv6 (Ptr<Ipv6> ipv6);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+ 
+  /**
+   * Flushes routing caches if required.
+   */
+  void CheckCacheStateAndFlush (void) const;
+
+  /**
+   * Records a run-time topology change on this node
+   */
+  void NotifyTopologyChange (void) const;
+
+  /**
+   * Processes the recorded topology changes, flushing the caches
+   * of the nodes in the affected components only.
+   */
+  static void ProcessTopologyChanges (void);
+
+  /**
+   * Topology snapshot and nix-vector store shared by all nodes.
+   * Changes are recorded there and processed lazily, which allows
+   * cheap cleanup of caches when there are many topology changes.
+   */
+  static NixVectorTopology g_topology;
+
+  /** Index of the node owning each address, built lazily */
+  static std::map<Ipv6Address, uint32_t> g_nodeByAddress;
+
+  /** Whether ClearStore is scheduled to run with Simulator::Destroy */
+  static bool g_clearStoreScheduled;
+
+  /**
+   * Clears the shared store, when the simulation is destroyed and the node
+   * ids are about to be reused
+   */
+  static void ClearStore (void);
+
+  /** Cache stores nix-vectors based on destination ip */
+  mutable Ipv6NixMap_t m_nixCache;
+
+  /** Cache stores Ipv6Routes based on destination ip */
+  mutable Ipv6RouteMap_t m_ipv6RouteCache;
+
+  Ptr<Ipv6> m_ipv6; //!< IPv6 object
+  Ptr<Node> m_node; //!< Node object
+
+  /** Total neighbors used for nix-vector to determine number of bits */
+  uint32_t m_totalNeighbors;
+};
+} // namespace ns3
+
+#endif /* IPV6_NIX_VECTOR_ROUTING_H */
@@ -0,0 +1,580 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
+
+#include "nix-vector-topology.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NixVectorTopology");
+
+const uint32_t NixVectorTopology::UNREACHED;
+
+NixVectorTopology::NixVectorTopology (Family family)
+  : m_family (family),
+    m_graphValid (false),
+    m_globalChange (false),
+    m_nTrees (0)
+{
+  NS_LOG_FUNCTION (this << family);
+}
+
+NixVectorTopology::~NixVectorTopology ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+NixVectorTopology::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_graphValid = false;
+  m_globalChange = false;
+  m_changedNodes.clear ();
+  m_graph.clear ();
+  m_component.clear ();
+  m_trees.clear ();
+  m_nTrees = 0;
+}
+
+void
+NixVectorTopology::NotifyChange (uint32_t nodeId)
+{
+  NS_LOG_FUNCTION (this << nodeId);
+  m_changedNodes.insert (nodeId);
+}
+
+void
+NixVectorTopology::NotifyGlobalChange (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_globalChange = true;
+}
+
+bool
+NixVectorTopology::HasPendingChanges (void) const
+{
+  return m_globalChange || !m_changedNodes.empty ();
+}
+
+bool
+NixVectorTopology::Invalidate (std::vector<uint32_t> &affectedNodes)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_graphValid || m_globalChange || m_graph.size () != NodeList::GetNNodes ())
+    {
+      NS_LOG_LOGIC ("Dropping the whole nix-vector store");
+      Clear ();
+      return false;
+    }
+
+  // Collect the components of the changed nodes, and those of their
+  // current neighbors: a link that just came up may join two components
+  std::set<uint32_t> components;
+  for (std::set<uint32_t>::const_iterator it = m_changedNodes.begin (); it != m_changedNodes.end (); ++it)
+    {
+      if (*it >= m_graph.size ())
+        {
+          Clear ();
+          return false;
+        }
+      components.insert (m_component[*it]);
+
+      Ptr<Node> node = NodeList::GetNode (*it);
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              uint32_t remoteId = (*iter)->GetNode ()->GetId ();
+              if (remoteId >= m_graph.size ())
+                {
+                  Clear ();
+                  return false;
+                }
+              components.insert (m_component[remoteId]);
+            }
+        }
+    }
+  m_changedNodes.clear ();
+
+  for (uint32_t i = 0; i < m_graph.size (); i++)
+    {
+      if (components.find (m_component[i]) != components.end ())
+        {
+          affectedNodes.push_back (i);
+          if (!m_trees[i].parent.empty ())
+            {
+              m_nTrees--;
+            }
+          m_trees[i] = SourceTree ();
+        }
+    }
+  NS_LOG_LOGIC ("Invalidated " << affectedNodes.size () << " nodes in " << components.size () << " components");
+
+  BuildGraph ();
+  return true;
+}
+
+Ptr<NixVector>
+NixVectorTopology::GetNixVector (uint32_t source, uint32_t dest)
+{
+  NS_LOG_FUNCTION (this << source << dest);
+
+  CheckGraph ();
+  if (source >= m_graph.size () || dest >= m_graph.size ())
+    {
+      return 0;
+    }
+
+  SourceTree &tree = m_trees[source];
+  if (tree.parent.empty ())
+    {
+      NS_LOG_LOGIC ("No BFS tree for node " << source << ", build it");
+      Bfs (source, UNREACHED, tree.parent);
+      m_nTrees++;
+    }
+
+  std::map<uint32_t, Ptr<NixVector> >::const_iterator it = tree.nixes.find (dest);
+  if (it != tree.nixes.end ())
+    {
+      return it->second;
+    }
+
+  Ptr<NixVector> nixVector = Retrace (tree.parent, source, dest);
+  tree.nixes.insert (std::make_pair (dest, nixVector));
+  return nixVector;
+}
+
+Ptr<NixVector>
+NixVectorTopology::BuildNixVector (uint32_t source, uint32_t dest, Ptr<NetDevice> oif)
+{
+  NS_LOG_FUNCTION (this << source << dest << oif);
+
+  CheckGraph ();
+  if (source >= m_graph.size () || dest >= m_graph.size ())
+    {
+      return 0;
+    }
+
+  std::vector<uint32_t> parent;
+  Bfs (source, oif->GetIfIndex (), parent);
+  return Retrace (parent, source, dest);
+}
+
+void
+NixVectorTopology::PrecomputeAllPairs (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+
+  CheckGraph ();
+  uint32_t nNodes = m_graph.size ();
+  if (nThreads == 0)
+    {
+      nThreads = 1;
+    }
+  if (nThreads > nNodes)
+    {
+      nThreads = nNodes;
+    }
+
+  // The workers only read the snapshot and write their own slots of
+  // the output vector, so they need no locking.
+  std::vector<std::vector<uint32_t> > parents (nNodes);
+  std::vector<Worker> workers (nThreads);
+  for (uint32_t t = 0; t < nThreads; t++)
+    {
+      workers[t].topology = this;
+      workers[t].first = t;
+      workers[t].stride = nThreads;
+      workers[t].parents = &parents;
+    }
+
+#ifdef HAVE_PTHREAD_H
+  if (nThreads > 1)
+    {
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&Worker::Run, &workers[t])));
+          threads[t]->Start ();
+        }
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          threads[t]->Join ();
+        }
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+    {
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          workers[t].Run ();
+        }
+    }
+
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      if (!parents[i].empty ())
+        {
+          m_trees[i].parent.swap (parents[i]);
+          m_nTrees++;
+        }
+    }
+  NS_LOG_LOGIC ("Stored BFS trees for " << m_nTrees << " nodes");
+}
+
+uint32_t
+NixVectorTopology::GetNTrees (void) const
+{
+  return m_nTrees;
+}
+
+void
+NixVectorTopology::Worker::Run (void)
+{
+  uint32_t nNodes = topology->m_graph.size ();
+  for (uint32_t source = first; source < nNodes; source += stride)
+    {
+      if (topology->m_trees[source].parent.empty ())
+        {
+          topology->Bfs (source, UNREACHED, (*parents)[source]);
+        }
+    }
+}
+
+void
+NixVectorTopology::CheckGraph (void)
+{
+  if (!m_graphValid || m_graph.size () != NodeList::GetNNodes ())
+    {
+      std::set<uint32_t> changedNodes;
+      changedNodes.swap (m_changedNodes);
+      bool globalChange = m_globalChange;
+      Clear ();
+      BuildGraph ();
+      // keep the pending changes for the routing protocol caches
+      m_changedNodes.swap (changedNodes);
+      m_globalChange = globalChange;
+    }
+}
+
+void
+NixVectorTopology::BuildGraph (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t nNodes = NodeList::GetNNodes ();
+  m_graph.assign (nNodes, Adjacency ());
+  m_trees.resize (nNodes);
+
+  for (uint32_t id = 0; id < nNodes; id++)
+    {
+      Ptr<Node> node = NodeList::GetNode (id);
+      Adjacency &adjacency = m_graph[id];
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+
+          Link link;
+          link.device = i;
+          link.usable = IsUsable (node, localNetDevice);
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              link.neighbors.push_back ((*iter)->GetNode ()->GetId ());
+            }
+
+          // nix indexes skip the bridge devices
+          if (!localNetDevice->IsBridge ())
+            {
+              adjacency.nixNeighbors.insert (adjacency.nixNeighbors.end (),
+                                             link.neighbors.begin (), link.neighbors.end ());
+            }
+          adjacency.links.push_back (link);
+        }
+    }
+
+  BuildComponents ();
+  m_graphValid = true;
+}
+
+void
+NixVectorTopology::BuildComponents (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // union-find over all the links, whatever their state
+  uint32_t nNodes = m_graph.size ();
+  m_component.resize (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      m_component[i] = i;
+    }
+
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      const std::vector<Link> &links = m_graph[i].links;
+      for (std::vector<Link>::const_iterator l = links.begin (); l != links.end (); ++l)
+        {
+          for (std::vector<uint32_t>::const_iterator n = l->neighbors.begin (); n != l->neighbors.end (); ++n)
+            {
+              uint32_t a = i;
+              while (m_component[a] != a)
+                {
+                  m_component[a] = m_component[m_component[a]];
+                  a = m_component[a];
+                }
+              uint32_t b = *n;
+              while (m_component[b] != b)
+                {
+                  m_component[b] = m_component[m_component[b]];
+                  b = m_component[b];
+                }
+              if (a != b)
+                {
+                  m_component[std::max (a, b)] = std::min (a, b);
+                }
+            }
+        }
+    }
+
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      m_component[i] = m_component[m_component[i]];
+    }
+}
+
+void
+NixVectorTopology::Bfs (uint32_t source, uint32_t oifDevice, std::vector<uint32_t> &parent) const
+{
+  // no logging here, this runs in the worker threads
+
+  // discovered nodes with unexplored children are the ones
+  // between head and the end of the queue
+  std::vector<uint32_t> greyNodes;
+  parent.assign (m_graph.size (), UNREACHED);
+
+  greyNodes.push_back (source);
+  parent[source] = source;
+
+  for (std::size_t head = 0; head < greyNodes.size (); head++)
+    {
+      uint32_t currNode = greyNodes[head];
+      const std::vector<Link> &links = m_graph[currNode].links;
+      for (std::vector<Link>::const_iterator l = links.begin (); l != links.end (); ++l)
+        {
+          // if a specific output interface was given,
+          // make sure we go this way
+          if (currNode == source && oifDevice != UNREACHED && l->device != oifDevice)
+            {
+              continue;
+            }
+          if (!l->usable)
+            {
+              continue;
+            }
+          for (std::vector<uint32_t>::const_iterator n = l->neighbors.begin (); n != l->neighbors.end (); ++n)
+            {
+              if (parent[*n] == UNREACHED)
+                {
+                  parent[*n] = currNode;
+                  greyNodes.push_back (*n);
+                }
+            }
+        }
+    }
+}
+
+Ptr<NixVector>
+NixVectorTopology::Retrace (const std::vector<uint32_t> &parent, uint32_t source, uint32_t dest) const
+{
+  NS_LOG_FUNCTION (this << source << dest);
+
+  if (parent[dest] == UNREACHED)
+    {
+      return 0;
+    }
+
+  // walk back from the destination, adding the hops
+  // in the same order as the recursive construction
+  Ptr<NixVector> nixVector = Create<NixVector> ();
+  uint32_t currNode = dest;
+  while (currNode != source)
+    {
+      uint32_t parentNode = parent[currNode];
+      const std::vector<uint32_t> &neighbors = m_graph[parentNode].nixNeighbors;
+      uint32_t destId = 0;
+      for (uint32_t i = 0; i < neighbors.size (); i++)
+        {
+          if (neighbors[i] == currNode)
+            {
+              destId = i;
+            }
+        }
+      NS_LOG_LOGIC ("Adding Nix: " << destId << " with "
+                                   << nixVector->BitCount (neighbors.size ()) << " bits, for node " << parentNode);
+      nixVector->AddNeighborIndex (destId, nixVector->BitCount (neighbors.size ()));
+      currNode = parentNode;
+    }
+  return nixVector;
+}
+
+bool
+NixVectorTopology::IsUsable (Ptr<Node> node, Ptr<NetDevice> device) const
+{
+  if (m_family == IPV4)
+    {
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      if (ipv4)
+        {
+          int32_t interfaceIndex = ipv4->GetInterfaceForDevice (device);
+          if (interfaceIndex == -1 || !ipv4->IsUp (interfaceIndex))
+            {
+              NS_LOG_LOGIC ("Ipv4Interface is down");
+              return false;
+            }
+        }
+    }
+  else
+    {
+      Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+      if (ipv6)
+        {
+          int32_t interfaceIndex = ipv6->GetInterfaceForDevice (device);
+          if (interfaceIndex == -1 || !ipv6->IsUp (interfaceIndex))
+            {
+              NS_LOG_LOGIC ("Ipv6Interface is down");
+              return false;
+            }
+        }
+    }
+  if (!device->IsLinkUp ())
+    {
+      NS_LOG_LOGIC ("Link is down.");
+      return false;
+    }
+  return true;
+}
+
+void
+NixVectorTopology::GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  for (std::size_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<NetDevice> remoteDevice = channel->GetDevice (i);
+      if (remoteDevice != netDevice)
+        {
+          Ptr<BridgeNetDevice> bd = NetDeviceIsBridged (remoteDevice);
+          // we have a bridged device, we need to add all
+          // bridged devices
+          if (bd)
+            {
+              NS_LOG_LOGIC ("Looking through bridge ports of bridge net device " << bd);
+              for (uint32_t j = 0; j < bd->GetNBridgePorts (); ++j)
+                {
+                  Ptr<NetDevice> ndBridged = bd->GetBridgePort (j);
+                  if (ndBridged == remoteDevice)
+                    {
+                      NS_LOG_LOGIC ("That bridge port is me, don't walk backward");
+                      continue;
+                    }
+                  Ptr<Channel> chBridged = ndBridged->GetChannel ();
+                  if (chBridged == 0)
+                    {
+                      continue;
+                    }
+                  GetAdjacentNetDevices (ndBridged, chBridged, netDeviceContainer);
+                }
+            }
+          else
+            {
+              netDeviceContainer.Add (channel->GetDevice (i));
+            }
+        }
+    }
+}
+
+Ptr<BridgeNetDevice>
+NixVectorTopology::NetDeviceIsBridged (Ptr<NetDevice> nd)
+{
+  NS_LOG_FUNCTION (nd);
+
+  Ptr<Node> node = nd->GetNode ();
+  uint32_t nDevices = node->GetNDevices ();
+
+  //
+  // There is no bit on a net device that says it is being bridged, so we have
+  // to look for bridges on the node to which the device is attached.  If we
+  // find a bridge, we need to look through its bridge ports (the devices it
+  // bridges) to see if we find the device in question.
+  //
+  for (uint32_t i = 0; i < nDevices; ++i)
+    {
+      Ptr<NetDevice> ndTest = node->GetDevice (i);
+      NS_LOG_LOGIC ("Examine device " << i << " " << ndTest);
+
+      if (ndTest->IsBridge ())
+        {
+          NS_LOG_LOGIC ("device " << i << " is a bridge net device");
+          Ptr<BridgeNetDevice> bnd = ndTest->GetObject<BridgeNetDevice> ();
+          NS_ABORT_MSG_UNLESS (bnd, "NixVectorTopology::NetDeviceIsBridged (): GetObject for <BridgeNetDevice> failed");
+
+          for (uint32_t j = 0; j < bnd->GetNBridgePorts (); ++j)
+            {
+              NS_LOG_LOGIC ("Examine bridge port " << j << " " << bnd->GetBridgePort (j));
+              if (bnd->GetBridgePort (j) == nd)
+                {
+                  NS_LOG_LOGIC ("Net device " << nd << " is bridged by " << bnd);
+                  return bnd;
+                }
+            }
+        }
+    }
+  NS_LOG_LOGIC ("Net device " << nd << " is not bridged");
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NIX_VECTOR_TOPOLOGY_H
+#define NIX_VECTOR_TOPOLOGY_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "ns3/ptr.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/net-device-container.h"
+#include "ns3/nix-vector.h"
+#include "ns3/bridge-net-device.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup nix-vector-routing
+ *
+ * \brief Shared topology graph and nix-vector store used by the
+ * IPv4 and IPv6 nix-vector routing protocols.
+ *
+ * The topology of all the nodes in the simulation is captured once in
+ * a compact adjacency snapshot indexed by node id.  Breadth first
+ * searches run on the snapshot instead of walking the NetDevice and
+ * Channel objects, and the resulting BFS trees are kept per source node.
+ * A tree costs one node id per destination, and is the compressed form
+ * of all the nix-vectors from that source: the NixVector for a given
+ * (source, destination) pair is only materialized the first time it
+ * is requested, and is then shared by all the users of the store.
+ *
+ * Topology changes are recorded per node and processed lazily.  Only the
+ * trees and caches of the nodes belonging to the connected components
+ * touched by the change are invalidated; the rest of the store survives.
+ *
+ * The trees for all the sources can be computed ahead of time with
+ * PrecomputeAllPairs, which spreads the searches over several threads
+ * when threading support is available.
+ */
+class NixVectorTopology
+{
+public:
+  /**
+   * Address family whose interface state is checked while building
+   * the snapshot.
+   */
+  enum Family
+  {
+    IPV4,
+    IPV6
+  };
+
+  /**
+   * \brief Constructor
+   * \param family address family of the routing protocol using the store
+   */
+  NixVectorTopology (Family family);
+  ~NixVectorTopology ();
+
+  /**
+   * \brief Forget the snapshot, all the BFS trees and all the nix-vectors.
+   */
+  void Clear (void);
+
+  /**
+   * \brief Record a run-time change (interface or address) on a node.
+   *
+   * Nothing is invalidated until the next call to Invalidate.
+   *
+   * \param nodeId the id of the node on which the change happened
+   */
+  void NotifyChange (uint32_t nodeId);
+
+  /**
+   * \brief Record a run-time change that can not be bound to a node.
+   *
+   * The whole store is dropped on the next call to Invalidate.
+   */
+  void NotifyGlobalChange (void);
+
+  /**
+   * \returns true if there are recorded changes not processed yet
+   */
+  bool HasPendingChanges (void) const;
+
+  /**
+   * \brief Process the recorded changes.
+   *
+   * The BFS trees of all the nodes in the connected components touched
+   * by the changes are dropped, and the snapshot is rebuilt.
+   *
+   * \param [out] affectedNodes ids of the nodes whose state was dropped
+   * \returns false if everything must be considered stale (e.g., the
+   * snapshot was never built or the number of nodes changed), in which
+   * case the store has been cleared and affectedNodes is not filled.
+   */
+  bool Invalidate (std::vector<uint32_t> &affectedNodes);
+
+  /**
+   * \brief Get the (shared) nix-vector from source to dest.
+   *
+   * The returned NixVector is owned by the store and must not be modified.
+   *
+   * \param source the source node id
+   * \param dest the destination node id
+   * \returns the nix-vector, or null if there is no path
+   */
+  Ptr<NixVector> GetNixVector (uint32_t source, uint32_t dest);
+
+  /**
+   * \brief Build a new nix-vector from source to dest, forcing the first
+   * hop through the given device of the source node.
+   *
+   * The result is not stored.
+   *
+   * \param source the source node id
+   * \param dest the destination node id
+   * \param oif the output device on the source node
+   * \returns the nix-vector, or null if there is no path
+   */
+  Ptr<NixVector> BuildNixVector (uint32_t source, uint32_t dest, Ptr<NetDevice> oif);
+
+  /**
+   * \brief Compute the BFS trees of all the source nodes.
+   *
+   * \param nThreads number of worker threads; searches run in the calling
+   * thread if this is 1 or if threading support is not available.
+   */
+  void PrecomputeAllPairs (uint32_t nThreads);
+
+  /**
+   * \returns the number of source nodes for which a BFS tree is stored
+   */
+  uint32_t GetNTrees (void) const;
+
+  /**
+   * Given a net-device returns all the adjacent net-devices,
+   * essentially getting the neighbors on that channel
+   * \param [in] netDevice the NetDevice attached to the channel.
+   * \param [in] channel the channel to check
+   * \param [out] netDeviceContainer the NetDeviceContainer of the NetDevices in the channel.
+   */
+  static void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer);
+
+  /**
+   * Determine if the NetDevice is bridged
+   * \param nd the NetDevice to check
+   * \returns the bridging NetDevice (or null if the NetDevice is not bridged)
+   */
+  static Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd);
+
+private:
+  /// Marker for nodes not reached by a BFS
+  static const uint32_t UNREACHED = 0xffffffff;
+
+  /// Outgoing adjacencies through one NetDevice
+  struct Link
+  {
+    uint32_t device;                 //!< index of the device on the node
+    bool usable;                     //!< device up and usable for routing
+    std::vector<uint32_t> neighbors; //!< adjacent node ids, in discovery order
+  };
+
+  /// Adjacency information of a node
+  struct Adjacency
+  {
+    std::vector<Link> links;             //!< links, in device order
+    std::vector<uint32_t> nixNeighbors;  //!< neighbor ids, in nix index order
+  };
+
+  /// BFS tree rooted at a source node, and the nix-vectors built from it
+  struct SourceTree
+  {
+    std::vector<uint32_t> parent;                //!< parent of each node, UNREACHED if none
+    std::map<uint32_t, Ptr<NixVector> > nixes;   //!< materialized nix-vectors by dest id
+  };
+
+  /**
+   * \brief Worker computing the BFS trees of a strided subset of sources.
+   */
+  struct Worker
+  {
+    const NixVectorTopology *topology; //!< the topology being searched
+    uint32_t first;                    //!< first source id
+    uint32_t stride;                   //!< distance between source ids
+    std::vector<std::vector<uint32_t> > *parents; //!< output trees, by source id
+    /**
+     * \brief Run the searches
+     */
+    void Run (void);
+  };
+
+  /**
+   * \brief Build the adjacency snapshot of all the nodes.
+   */
+  void BuildGraph (void);
+
+  /**
+   * \brief Compute the connected component of each node, ignoring
+   * the interface state.
+   */
+  void BuildComponents (void);
+
+  /**
+   * \brief Breadth first search on the snapshot.
+   * \param [in] source the source node id
+   * \param [in] oifDevice device index on source forced as first hop, or UNREACHED
+   * \param [out] parent the parent vector
+   */
+  void Bfs (uint32_t source, uint32_t oifDevice, std::vector<uint32_t> &parent) const;
+
+  /**
+   * \brief Retrace a parent vector to build a nix-vector.
+   * \param parent the parent vector
+   * \param source the source node id
+   * \param dest the destination node id
+   * \returns the nix-vector, or null if dest is not reachable
+   */
+  Ptr<NixVector> Retrace (const std::vector<uint32_t> &parent, uint32_t source, uint32_t dest) const;
+
+  /**
+   * \brief Check whether a device can be used by the routing protocol.
+   * \param node the node
+   * \param device the device
+   * \returns true if the device is up for the address family in use
+   */
+  bool IsUsable (Ptr<Node> node, Ptr<NetDevice> device) const;
+
+  /**
+   * \brief Ensure the snapshot is available.
+   */
+  void CheckGraph (void);
+
+  Family m_family;                      //!< address family
+  bool m_graphValid;                    //!< true if m_graph reflects the topology
+  bool m_globalChange;                  //!< true if the whole store must be dropped
+  std::set<uint32_t> m_changedNodes;    //!< nodes with pending changes
+  std::vector<Adjacency> m_graph;       //!< adjacency snapshot, by node id
+  std::vector<uint32_t> m_component;    //!< connected component id, by node id
+  std::vector<SourceTree> m_trees;      //!< BFS trees, by source node id
+  uint32_t m_nTrees;                    //!< number of non-empty trees
+};
+
+} // namespace ns3
+
+#endif /* NIX_VECTOR_TOPOLOGY_H */
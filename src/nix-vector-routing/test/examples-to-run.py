@@ -9,6 +9,7 @@
 # See test.py for more information.
 cpp_examples = [
     ("nix-simple", "True", "True"),
+    ("nix-simple-v6", "True", "True"),
     ("nms-p2p-nix", "False", "True"), # Takes too long to run
 ]
 
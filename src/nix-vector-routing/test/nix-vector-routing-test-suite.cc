@@ -0,0 +1,657 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/nix-vector.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/boolean.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv6-routing-protocol.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/ipv6-nix-vector-helper.h"
+#include "ns3/ipv4-nix-vector-routing.h"
+#include "ns3/ipv6-nix-vector-routing.h"
+#include "ns3/nix-vector-topology.h"
+
+using namespace ns3;
+
+// All the test cases use the same network, made of two components:
+//
+//          n1                 10.1.1.0 n0-n1    10.1.3.0 n1-n3
+//        /    \               10.1.2.0 n0-n2    10.1.4.0 n2-n3
+//      n0      n3             10.1.5.0 n4-n5
+//        \    /
+//          n2           n4 ------ n5
+//
+// The BFS visits the devices in order, hence n0 reaches n3 through n1
+// as long as the n1-n3 link is up.
+
+/**
+ * \ingroup nix-vector-routing
+ * \defgroup nix-vector-routing-test Nix-vector routing module tests
+ */
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The test network, with one device container per link
+ */
+struct NixTestNetwork
+{
+  /**
+   * Creates the nodes and the links
+   * \param stack the Internet stack helper, with the routing helper set
+   */
+  NixTestNetwork (const InternetStackHelper &stack);
+
+  NodeContainer nodes; //!< the nodes
+  NetDeviceContainer d01; //!< devices of the n0-n1 link
+  NetDeviceContainer d02; //!< devices of the n0-n2 link
+  NetDeviceContainer d13; //!< devices of the n1-n3 link
+  NetDeviceContainer d23; //!< devices of the n2-n3 link
+  NetDeviceContainer d45; //!< devices of the n4-n5 link
+};
+
+NixTestNetwork::NixTestNetwork (const InternetStackHelper &stack)
+{
+  nodes.Create (6);
+  stack.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  d01 = simple.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  d02 = simple.Install (NodeContainer (nodes.Get (0), nodes.Get (2)));
+  d13 = simple.Install (NodeContainer (nodes.Get (1), nodes.Get (3)));
+  d23 = simple.Install (NodeContainer (nodes.Get (2), nodes.Get (3)));
+  d45 = simple.Install (NodeContainer (nodes.Get (4), nodes.Get (5)));
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * Builds an IPv4 network routed by nix-vector routing
+ */
+struct Ipv4NixTestNetwork : public NixTestNetwork
+{
+  Ipv4NixTestNetwork ();
+
+  /**
+   * Asks the routing protocol of a node for a route
+   * \param node the source node index
+   * \param dest the destination address
+   * \return the route, or 0 if there is none
+   */
+  Ptr<Ipv4Route> Route (uint32_t node, Ipv4Address dest);
+
+  /**
+   * Brings an interface up or down
+   * \param device the device of the interface
+   * \param up whether to bring the interface up
+   */
+  void SetUp (Ptr<NetDevice> device, bool up);
+
+  Ipv4InterfaceContainer i01; //!< interfaces of the n0-n1 link
+  Ipv4InterfaceContainer i02; //!< interfaces of the n0-n2 link
+  Ipv4InterfaceContainer i13; //!< interfaces of the n1-n3 link
+  Ipv4InterfaceContainer i23; //!< interfaces of the n2-n3 link
+  Ipv4InterfaceContainer i45; //!< interfaces of the n4-n5 link
+
+private:
+  /**
+   * \return an Internet stack helper installing IPv4 nix-vector routing
+   */
+  static InternetStackHelper Stack (void);
+};
+
+InternetStackHelper
+Ipv4NixTestNetwork::Stack (void)
+{
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetIpv6StackInstall (false);
+  stack.SetRoutingHelper (nixRouting);
+  return stack;
+}
+
+Ipv4NixTestNetwork::Ipv4NixTestNetwork ()
+  : NixTestNetwork (Stack ())
+{
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  i01 = address.Assign (d01);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  i02 = address.Assign (d02);
+  address.SetBase ("10.1.3.0", "255.255.255.0");
+  i13 = address.Assign (d13);
+  address.SetBase ("10.1.4.0", "255.255.255.0");
+  i23 = address.Assign (d23);
+  address.SetBase ("10.1.5.0", "255.255.255.0");
+  i45 = address.Assign (d45);
+}
+
+Ptr<Ipv4Route>
+Ipv4NixTestNetwork::Route (uint32_t node, Ipv4Address dest)
+{
+  Ptr<Ipv4> ipv4 = nodes.Get (node)->GetObject<Ipv4> ();
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  return ipv4->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), header, 0, sockerr);
+}
+
+void
+Ipv4NixTestNetwork::SetUp (Ptr<NetDevice> device, bool up)
+{
+  Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+  int32_t interface = ipv4->GetInterfaceForDevice (device);
+  if (up)
+    {
+      ipv4->SetUp (interface);
+    }
+  else
+    {
+      ipv4->SetDown (interface);
+    }
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief Checks the BFS trees computed ahead of time, and the partial
+ * invalidation of the nix-vector store after a topology change.
+ */
+class NixVectorTopologyTestCase : public TestCase
+{
+public:
+  NixVectorTopologyTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param nixVector a nix-vector
+   * \return the textual representation of the nix-vector
+   */
+  static std::string ToString (Ptr<NixVector> nixVector);
+};
+
+NixVectorTopologyTestCase::NixVectorTopologyTestCase ()
+  : TestCase ("Precomputation and partial invalidation of the nix-vector store")
+{
+}
+
+std::string
+NixVectorTopologyTestCase::ToString (Ptr<NixVector> nixVector)
+{
+  std::ostringstream oss;
+  oss << *nixVector;
+  return oss.str ();
+}
+
+void
+NixVectorTopologyTestCase::DoRun (void)
+{
+  Ipv4NixTestNetwork net;
+
+  NixVectorTopology onDemand (NixVectorTopology::IPV4);
+  NixVectorTopology precomputed (NixVectorTopology::IPV4);
+  precomputed.PrecomputeAllPairs (2);
+  NS_TEST_ASSERT_MSG_EQ (precomputed.GetNTrees (), 6, "A tree should be stored for every node");
+
+  for (uint32_t source = 0; source < 6; source++)
+    {
+      for (uint32_t dest = 0; dest < 6; dest++)
+        {
+          Ptr<NixVector> expected = onDemand.GetNixVector (source, dest);
+          Ptr<NixVector> actual = precomputed.GetNixVector (source, dest);
+          bool reachable = (source < 4) == (dest < 4);
+          NS_TEST_ASSERT_MSG_EQ ((expected != 0), reachable, "Unexpected reachability of " << dest << " from " << source);
+          NS_TEST_ASSERT_MSG_EQ ((actual != 0), reachable, "Unexpected reachability of " << dest << " from " << source);
+          if (expected && actual)
+            {
+              NS_TEST_EXPECT_MSG_EQ (ToString (actual), ToString (expected),
+                                     "Precomputed nix-vector from " << source << " to " << dest);
+            }
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (onDemand.GetNTrees (), 6, "A tree should be stored for every source");
+
+  std::string viaN1 = ToString (precomputed.GetNixVector (0, 3));
+  std::string n4ToN5 = ToString (precomputed.GetNixVector (4, 5));
+
+  // n1 loses its link to n3: only the component of n1 is affected
+  net.SetUp (net.d13.Get (0), false);
+  precomputed.NotifyChange (1);
+  NS_TEST_ASSERT_MSG_EQ (precomputed.HasPendingChanges (), true, "The change should be pending");
+  std::vector<uint32_t> affectedNodes;
+  bool partial = precomputed.Invalidate (affectedNodes);
+  NS_TEST_ASSERT_MSG_EQ (partial, true, "The invalidation should be partial");
+  NS_TEST_ASSERT_MSG_EQ (precomputed.HasPendingChanges (), false, "The change should have been processed");
+  std::sort (affectedNodes.begin (), affectedNodes.end ());
+  NS_TEST_ASSERT_MSG_EQ (affectedNodes.size (), 4, "Only the nodes n0 to n3 should be affected");
+  for (uint32_t i = 0; i < affectedNodes.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (affectedNodes[i], i, "Unexpected affected node");
+    }
+  NS_TEST_EXPECT_MSG_EQ (precomputed.GetNTrees (), 2, "The trees of n4 and n5 should be kept");
+
+  NS_TEST_ASSERT_MSG_NE (precomputed.GetNixVector (0, 3), 0, "n3 should still be reachable through n2");
+  NS_TEST_EXPECT_MSG_NE (ToString (precomputed.GetNixVector (0, 3)), viaN1, "The route to n3 should have changed");
+  NS_TEST_EXPECT_MSG_EQ (ToString (precomputed.GetNixVector (4, 5)), n4ToN5, "The route to n5 should not change");
+
+  // the link comes back up: the previous route is used again
+  net.SetUp (net.d13.Get (0), true);
+  precomputed.NotifyChange (1);
+  affectedNodes.clear ();
+  partial = precomputed.Invalidate (affectedNodes);
+  NS_TEST_ASSERT_MSG_EQ (partial, true, "The invalidation should be partial");
+  NS_TEST_EXPECT_MSG_EQ (ToString (precomputed.GetNixVector (0, 3)), viaN1, "The route to n3 should go through n1 again");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief Checks the IPv4 routes after interface changes, including when a
+ * router is disposed while the changes are pending.
+ */
+class Ipv4NixVectorRoutingTestCase : public TestCase
+{
+public:
+  Ipv4NixVectorRoutingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4NixVectorRoutingTestCase::Ipv4NixVectorRoutingTestCase ()
+  : TestCase ("IPv4 nix-vector routes after interface changes")
+{
+}
+
+void
+Ipv4NixVectorRoutingTestCase::DoRun (void)
+{
+  Ipv4NixTestNetwork net;
+  Ipv4NixVectorHelper::PrecomputeAllPairs (2);
+
+  Ptr<Ipv4Route> route = net.Route (0, net.i13.GetAddress (1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d01.Get (0), "n3 should be reached through n1");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), net.i01.GetAddress (1), "n3 should be reached through n1");
+  route = net.Route (4, net.i45.GetAddress (1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n5 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d45.Get (0), "Unexpected route to n5");
+  NS_TEST_EXPECT_MSG_EQ (net.Route (0, net.i45.GetAddress (1)), 0, "n5 should not be reachable from n0");
+
+  // n1 loses its link to n3, then a router that is not used by any node
+  // is disposed before the change is processed
+  net.SetUp (net.d13.Get (0), false);
+  CreateObject<Ipv4NixVectorRouting> ()->Dispose ();
+
+  route = net.Route (0, net.i13.GetAddress (1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should still be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d02.Get (0), "n3 should be reached through n2");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), net.i02.GetAddress (1), "n3 should be reached through n2");
+  route = net.Route (4, net.i45.GetAddress (1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n5 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d45.Get (0), "Unexpected route to n5");
+
+  net.SetUp (net.d13.Get (0), true);
+  route = net.Route (0, net.i13.GetAddress (1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d01.Get (0), "n3 should be reached through n1 again");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief Checks that the IPv4 store does not outlive the simulation, even
+ * if a router is never disposed.
+ *
+ * The second simulation has as many nodes as the first one, and gives the
+ * address of n3 to a node reached through another neighbor of n0:
+ *
+ *  n4 -- n0 -- n2 -- n3
+ */
+class Ipv4NixVectorStoreTestCase : public TestCase
+{
+public:
+  Ipv4NixVectorStoreTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4NixVectorStoreTestCase::Ipv4NixVectorStoreTestCase ()
+  : TestCase ("IPv4 nix-vector store cleared by Simulator::Destroy")
+{
+}
+
+void
+Ipv4NixVectorStoreTestCase::DoRun (void)
+{
+  // a router which is neither used by any node nor disposed
+  Ptr<Ipv4NixVectorRouting> router = CreateObject<Ipv4NixVectorRouting> ();
+
+  {
+    Ipv4NixTestNetwork net;
+    Ptr<Ipv4Route> route = net.Route (0, net.i23.GetAddress (1));
+    NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should be reachable");
+    NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), net.i01.GetAddress (1), "n3 should be reached through n1");
+  }
+  Simulator::Destroy ();
+
+  NodeContainer nodes;
+  nodes.Create (6);
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetIpv6StackInstall (false);
+  stack.SetRoutingHelper (nixRouting);
+  stack.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (simple.Install (NodeContainer (nodes.Get (0), nodes.Get (4))));
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer i02 = address.Assign (simple.Install (NodeContainer (nodes.Get (0), nodes.Get (2))));
+  address.SetBase ("10.1.4.0", "255.255.255.0");
+  Ipv4InterfaceContainer i23 = address.Assign (simple.Install (NodeContainer (nodes.Get (2), nodes.Get (3))));
+
+  Ipv4Header header;
+  header.SetDestination (i23.GetAddress (1));
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = nodes.Get (0)->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), header, 0, sockerr);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), i02.GetAddress (1), "n3 should be reached through n2");
+
+  router->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief Checks the IPv6 routes after interface changes.
+ */
+class Ipv6NixVectorRoutingTestCase : public TestCase
+{
+public:
+  Ipv6NixVectorRoutingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Asks the routing protocol of a node for a route
+   * \param node the source node
+   * \param dest the destination address
+   * \return the route, or 0 if there is none
+   */
+  static Ptr<Ipv6Route> Route (Ptr<Node> node, Ipv6Address dest);
+
+  /**
+   * Brings an interface up or down
+   * \param device the device of the interface
+   * \param up whether to bring the interface up
+   */
+  static void SetUp (Ptr<NetDevice> device, bool up);
+};
+
+Ipv6NixVectorRoutingTestCase::Ipv6NixVectorRoutingTestCase ()
+  : TestCase ("IPv6 nix-vector routes after interface changes")
+{
+}
+
+Ptr<Ipv6Route>
+Ipv6NixVectorRoutingTestCase::Route (Ptr<Node> node, Ipv6Address dest)
+{
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+  Ipv6Header header;
+  header.SetDestinationAddress (dest);
+  Socket::SocketErrno sockerr;
+  return ipv6->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), header, 0, sockerr);
+}
+
+void
+Ipv6NixVectorRoutingTestCase::SetUp (Ptr<NetDevice> device, bool up)
+{
+  Ptr<Ipv6> ipv6 = device->GetNode ()->GetObject<Ipv6> ();
+  int32_t interface = ipv6->GetInterfaceForDevice (device);
+  if (up)
+    {
+      ipv6->SetUp (interface);
+    }
+  else
+    {
+      ipv6->SetDown (interface);
+    }
+}
+
+void
+Ipv6NixVectorRoutingTestCase::DoRun (void)
+{
+  Ipv6NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetIpv4StackInstall (false);
+  stack.SetRoutingHelper (nixRouting);
+  NixTestNetwork net (stack);
+
+  Ipv6AddressHelper address;
+  address.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  address.Assign (net.d01);
+  address.SetBase (Ipv6Address ("2001:2::"), Ipv6Prefix (64));
+  address.Assign (net.d02);
+  address.SetBase (Ipv6Address ("2001:3::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer i13 = address.Assign (net.d13);
+  address.SetBase (Ipv6Address ("2001:4::"), Ipv6Prefix (64));
+  address.Assign (net.d23);
+  address.SetBase (Ipv6Address ("2001:5::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer i45 = address.Assign (net.d45);
+
+  Ipv6NixVectorHelper::PrecomputeAllPairs (2);
+
+  Ptr<Node> n0 = net.nodes.Get (0);
+  Ptr<Node> n4 = net.nodes.Get (4);
+  Ptr<Ipv6Route> route = Route (n0, i13.GetAddress (1, 1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d01.Get (0), "n3 should be reached through n1");
+  route = Route (n4, i45.GetAddress (1, 1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n5 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d45.Get (0), "Unexpected route to n5");
+  NS_TEST_EXPECT_MSG_EQ (Route (n0, i45.GetAddress (1, 1)), 0, "n5 should not be reachable from n0");
+
+  SetUp (net.d13.Get (0), false);
+  CreateObject<Ipv6NixVectorRouting> ()->Dispose ();
+
+  route = Route (n0, i13.GetAddress (1, 1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should still be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d02.Get (0), "n3 should be reached through n2");
+  route = Route (n4, i45.GetAddress (1, 1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n5 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d45.Get (0), "Unexpected route to n5");
+
+  SetUp (net.d13.Get (0), true);
+  route = Route (n0, i13.GetAddress (1, 1));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "n3 should be reachable");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), net.d01.Get (0), "n3 should be reached through n1 again");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief Checks that the packets routed by nix-vector routing reach their
+ * destination when a router has the IPv4 fast forwarding enabled.
+ *
+ * The packets cross two routers, which have other neighbors, and only r1
+ * has the fast forwarding enabled.  Had r1 not consumed its part of the
+ * nix-vector, r2 would read the wrong neighbor index: r1 reaches r2 through
+ * its third neighbor, which is r1 for r2.
+ *
+ *      x1        x2
+ *      |         |
+ *  n0 -- r1 -- r2 -- n3
+ */
+class Ipv4NixVectorFastForwardingTestCase : public TestCase
+{
+public:
+  Ipv4NixVectorFastForwardingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Sends a packet
+   * \param socket the socket to send the packet with
+   */
+  void SendPacket (Ptr<Socket> socket);
+
+  /**
+   * Receives the packets from a socket
+   * \param socket the socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  uint32_t m_received; //!< the number of packets received by n3
+};
+
+Ipv4NixVectorFastForwardingTestCase::Ipv4NixVectorFastForwardingTestCase ()
+  : TestCase ("IPv4 nix-vector routing through a fast forwarding router"),
+    m_received (0)
+{
+}
+
+void
+Ipv4NixVectorFastForwardingTestCase::SendPacket (Ptr<Socket> socket)
+{
+  socket->Send (Create<Packet> (100));
+}
+
+void
+Ipv4NixVectorFastForwardingTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_received++;
+    }
+}
+
+void
+Ipv4NixVectorFastForwardingTestCase::DoRun (void)
+{
+  // n0, r1, r2, n3, x1, x2
+  NodeContainer nodes;
+  nodes.Create (6);
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetIpv6StackInstall (false);
+  stack.SetRoutingHelper (nixRouting);
+  stack.Install (nodes);
+  nodes.Get (1)->GetObject<Ipv4L3Protocol> ()->SetAttribute ("FastForwarding", BooleanValue (true));
+
+  SimpleNetDeviceHelper simple;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (simple.Install (NodeContainer (nodes.Get (1), nodes.Get (4))));
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  address.Assign (simple.Install (NodeContainer (nodes.Get (0), nodes.Get (1))));
+  address.SetBase ("10.1.3.0", "255.255.255.0");
+  Ipv4InterfaceContainer i23 = address.Assign (simple.Install (NodeContainer (nodes.Get (2), nodes.Get (3))));
+  address.SetBase ("10.1.4.0", "255.255.255.0");
+  NetDeviceContainer d25 = simple.Install (NodeContainer (nodes.Get (2), nodes.Get (5)));
+  address.Assign (d25);
+  address.SetBase ("10.1.5.0", "255.255.255.0");
+  address.Assign (simple.Install (NodeContainer (nodes.Get (1), nodes.Get (2))));
+
+  Ptr<Socket> rxSocket = Socket::CreateSocket (nodes.Get (3), UdpSocketFactory::GetTypeId ());
+  rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+  rxSocket->SetRecvCallback (MakeCallback (&Ipv4NixVectorFastForwardingTestCase::Receive, this));
+
+  Ptr<Socket> txSocket = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  txSocket->Connect (InetSocketAddress (i23.GetAddress (1), 1234));
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::Schedule (MilliSeconds (100 * (i + 1)), &Ipv4NixVectorFastForwardingTestCase::SendPacket,
+                           this, txSocket);
+    }
+
+  // flap the r2-x2 link, which flushes the nix-vector routing caches but
+  // leaves the interfaces of r1, and then its route cache, untouched
+  Ptr<Ipv4> ipv4 = nodes.Get (2)->GetObject<Ipv4> ();
+  int32_t interface = ipv4->GetInterfaceForDevice (d25.Get (0));
+  Simulator::Schedule (MilliSeconds (250), &Ipv4::SetDown, ipv4, interface);
+  Simulator::Schedule (MilliSeconds (260), &Ipv4::SetUp, ipv4, interface);
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 5, "All the packets should reach n3");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief Nix-vector routing TestSuite
+ */
+class NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  NixVectorRoutingTestSuite ();
+};
+
+NixVectorRoutingTestSuite::NixVectorRoutingTestSuite ()
+  : TestSuite ("nix-vector-routing", UNIT)
+{
+  AddTestCase (new NixVectorTopologyTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4NixVectorRoutingTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4NixVectorStoreTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv6NixVectorRoutingTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4NixVectorFastForwardingTestCase, TestCase::QUICK);
+}
+
+static NixVectorRoutingTestSuite nixVectorRoutingTestSuite; //!< Static variable for test initialization
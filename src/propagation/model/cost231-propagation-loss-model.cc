@@ -174,6 +174,12 @@ Cost231PropagationLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel
   return txPowerDbm + GetLoss (a, b);
 }
 
+bool
+Cost231PropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 Cost231PropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -102,6 +102,12 @@ ItuR1411LosPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return (txPowerDbm - GetLoss (a, b));
 }
 
+bool
+ItuR1411LosPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 ItuR1411LosPropagationLossModel::DoAssignStreams (int64_t stream)
 {
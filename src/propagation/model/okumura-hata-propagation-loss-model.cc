@@ -152,6 +152,12 @@ OkumuraHataPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return (txPowerDbm - GetLoss (a, b));
 }
 
+bool
+OkumuraHataPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 OkumuraHataPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -44,12 +44,22 @@ PropagationLossModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::PropagationLossModel")
     .SetParent<Object> ()
     .SetGroupName ("Propagation")
+    .AddAttribute ("CacheLoss",
+                   "If true, the loss of the deterministic models at the "
+                   "beginning of the chain starting at this model is cached "
+                   "for each pair of static mobility models, until one of "
+                   "them changes course. Only meaningful for the first model "
+                   "of a chain.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PropagationLossModel::m_cacheLoss),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 PropagationLossModel::PropagationLossModel ()
-  : m_next (0)
+  : m_next (0),
+    m_cacheLoss (false)
 {
 }
 
@@ -57,6 +67,13 @@ PropagationLossModel::~PropagationLossModel ()
 {
 }
 
+void
+PropagationLossModel::DoDispose (void)
+{
+  m_gainCache.clear ();
+  Object::DoDispose ();
+}
+
 void
 PropagationLossModel::SetNext (Ptr<PropagationLossModel> next)
 {
@@ -74,6 +91,20 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
                                    Ptr<MobilityModel> a,
                                    Ptr<MobilityModel> b) const
 {
+  if (m_cacheLoss && DoIsDeterministic ())
+    {
+      const PropagationLossModel *end = PeekPointer (m_next);
+      while (end != 0 && end->DoIsDeterministic ())
+        {
+          end = PeekPointer (end->m_next);
+        }
+      double rxPowerDbm = txPowerDbm + GetCachedGain (a, b, end);
+      if (end != 0)
+        {
+          rxPowerDbm = end->CalcRxPower (rxPowerDbm, a, b);
+        }
+      return rxPowerDbm;
+    }
   double self = DoCalcRxPower (txPowerDbm, a, b);
   if (m_next != 0)
     {
@@ -82,6 +113,45 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+double
+PropagationLossModel::GetCachedGain (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                                     const PropagationLossModel *end) const
+{
+  std::pair<const MobilityModel *, const MobilityModel *> key (PeekPointer (a), PeekPointer (b));
+  auto gainIt = m_gainCache.find (key);
+  if (gainIt != m_gainCache.end ()
+      && gainIt->second.courseChangesA == a->GetCourseChangeCount ()
+      && gainIt->second.courseChangesB == b->GetCourseChangeCount ())
+    {
+      // both models were static, and did not change course since
+      return gainIt->second.gainDb;
+    }
+  double gainDb = 0;
+  for (const PropagationLossModel *model = this; model != end; model = PeekPointer (model->m_next))
+    {
+      gainDb = model->DoCalcRxPower (gainDb, a, b);
+    }
+  // the positions of moving models change without course change notification
+  if (a->GetVelocity ().GetLength () == 0 && b->GetVelocity ().GetLength () == 0)
+    {
+      // the cache holds the mobility models so that their addresses are not reused
+      m_gainCache[key] = {gainDb, a, b, a->GetCourseChangeCount (), b->GetCourseChangeCount ()};
+    }
+  return gainDb;
+}
+
+bool
+PropagationLossModel::IsDeterministic (void) const
+{
+  return DoIsDeterministic ();
+}
+
+bool
+PropagationLossModel::DoIsDeterministic (void) const
+{
+  return false;
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -271,6 +341,12 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
+bool
+FriisPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -445,6 +521,12 @@ TwoRayGroundPropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+bool
+TwoRayGroundPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 TwoRayGroundPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -534,6 +616,12 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+bool
+LogDistancePropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -636,6 +724,12 @@ ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - pathLossDb;
 }
 
+bool
+ThreeLogDistancePropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 ThreeLogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
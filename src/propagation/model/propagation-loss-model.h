@@ -28,6 +28,7 @@
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -45,6 +46,14 @@ class MobilityModel;
  *
  * Calculate the receive power (dbm) from a transmit power (dbm)
  * and a mobility model for the source and destination positions.
+ *
+ * If the CacheLoss attribute of the first model of a chain is set, the
+ * loss of the deterministic models at the beginning of the chain (see
+ * IsDeterministic) is cached for each pair of mobility models, as long as
+ * both are static, and is only computed again once one of them changed
+ * course. The models of the chain following the first non-deterministic one
+ * are still evaluated on top of the cached loss. The attributes of the
+ * cached models must then not be changed once signals were propagated.
  */
 class PropagationLossModel : public Object
 {
@@ -106,6 +115,17 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \return true if the loss of this model (but not of the models chained
+   * to it) only depends on the positions of the two mobility models, i.e.,
+   * if the reception power is the transmission power minus a loss that is
+   * not random and does not change over time.
+   */
+  bool IsDeterministic (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
 private:
   /**
    * \brief Copy constructor
@@ -140,7 +160,54 @@ private:
    */
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
 
+  /**
+   * Subclasses whose loss only depends on the positions of the mobility
+   * models return true; the loss of the other ones is never cached.
+   *
+   * \return true if the loss of this model is deterministic
+   */
+  virtual bool DoIsDeterministic (void) const;
+
+  /**
+   * Returns the loss of the deterministic models at the beginning of the
+   * chain, from the cache if both mobility models are static.
+   *
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \param end the first non-deterministic model of the chain (possibly null)
+   * \returns the reception power for a transmission power of 0 dBm
+   */
+  double GetCachedGain (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                        const PropagationLossModel *end) const;
+
+  /// The gain of a pair of mobility models
+  struct CachedGain
+  {
+    double gainDb;            //!< the gain of the deterministic models (dB)
+    Ptr<MobilityModel> a;     //!< the mobility model of the source
+    Ptr<MobilityModel> b;     //!< the mobility model of the destination
+    uint32_t courseChangesA;  //!< the number of course changes of the source
+    uint32_t courseChangesB;  //!< the number of course changes of the destination
+  };
+
+  /// Hash of a pair of mobility models
+  struct MobilityPairHash
+  {
+    /**
+     * \param pair the source and destination mobility models
+     * \return the hash of the pair
+     */
+    std::size_t operator() (const std::pair<const MobilityModel *, const MobilityModel *> &pair) const
+    {
+      std::hash<const MobilityModel *> hash;
+      return hash (pair.first) ^ (hash (pair.second) * 31);
+    }
+  };
+
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
+  bool m_cacheLoss;                 //!< whether the deterministic losses are cached
+  /// the gains of the deterministic models, by pair of mobility models
+  mutable std::unordered_map<std::pair<const MobilityModel *, const MobilityModel *>, CachedGain, MobilityPairHash> m_gainCache;
 };
 
 /**
@@ -322,6 +389,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsDeterministic (void) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -442,6 +510,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsDeterministic (void) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -530,6 +599,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsDeterministic (void) const;
 
   /**
    *  Creates a default reference loss model
@@ -613,6 +683,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsDeterministic (void) const;
 
   double m_distance0; //!< Beginning of the first (near) distance field
   double m_distance1; //!< Beginning of the second (middle) distance field.
@@ -23,6 +23,8 @@
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/boolean.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -436,6 +438,94 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class PropagationLossCacheTestCase : public TestCase
+{
+public:
+  PropagationLossCacheTestCase ();
+  virtual ~PropagationLossCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a chain of a deterministic model, a random one and another
+   * deterministic one.
+   *
+   * \param cache whether the deterministic losses are cached
+   * \returns the first model of the chain
+   */
+  Ptr<ThreeLogDistancePropagationLossModel> CreateChain (bool cache);
+};
+
+PropagationLossCacheTestCase::PropagationLossCacheTestCase ()
+  : TestCase ("Test the cache of the deterministic propagation losses")
+{
+}
+
+PropagationLossCacheTestCase::~PropagationLossCacheTestCase ()
+{
+}
+
+Ptr<ThreeLogDistancePropagationLossModel>
+PropagationLossCacheTestCase::CreateChain (bool cache)
+{
+  Ptr<ThreeLogDistancePropagationLossModel> threeLog = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  threeLog->SetAttribute ("CacheLoss", BooleanValue (cache));
+  Ptr<NakagamiPropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  logDistance->SetAttribute ("Exponent", DoubleValue (0.5));
+  threeLog->SetNext (nakagami);
+  nakagami->SetNext (logDistance);
+  threeLog->AssignStreams (1);
+  return threeLog;
+}
+
+void
+PropagationLossCacheTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (80, 0, 0));
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (0, 300, 0));
+  moving->SetVelocity (Vector (10, 0, 0));
+  Ptr<MobilityModel> c = moving;
+
+  Ptr<ThreeLogDistancePropagationLossModel> cached = CreateChain (true);
+  Ptr<ThreeLogDistancePropagationLossModel> uncached = CreateChain (false);
+  NS_TEST_EXPECT_MSG_EQ (cached->IsDeterministic (), true, "ThreeLogDistance not deterministic");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetNext ()->IsDeterministic (), false, "Nakagami deterministic");
+
+  // the fading is still applied on top of the cached losses
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      double txPowerDbm = 10 + i % 7;
+      Ptr<MobilityModel> rx = (i % 2 == 0 ? b : c);
+      NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (txPowerDbm, a, rx), uncached->CalcRxPower (txPowerDbm, a, rx),
+                                 1e-9, "Wrong cached loss");
+    }
+
+  // a change of the model only applies to the static pairs after a course change
+  cached->SetNext (0);
+  uncached->SetNext (0);
+  double staticRxPowerDbm = cached->CalcRxPower (0, a, b);
+  double movingRxPowerDbm = cached->CalcRxPower (0, a, c);
+  cached->SetAttribute ("ReferenceLoss", DoubleValue (56.6777));
+  uncached->SetAttribute ("ReferenceLoss", DoubleValue (56.6777));
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (0, a, b), staticRxPowerDbm, 1e-9, "Loss not cached");
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (0, a, c), movingRxPowerDbm - 10, 1e-9, "Loss of a moving model cached");
+  b->SetPosition (Vector (90, 0, 0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (0, a, b), uncached->CalcRxPower (0, a, b), 1e-9,
+                             "Cached loss not invalidated by a course change");
+  NS_TEST_EXPECT_MSG_LT (cached->CalcRxPower (0, a, b), staticRxPowerDbm - 10, "Position change not accounted for");
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->CalcRxPower (0, b, a), uncached->CalcRxPower (0, b, a), 1e-9,
+                             "Wrong loss in the reverse direction");
+
+  cached->Dispose ();
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +540,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationLossCacheTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
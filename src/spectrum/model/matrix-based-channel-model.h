@@ -23,6 +23,8 @@
 #define MATRIX_BASED_CHANNEL_H
 
 #include <complex.h>
+#include <complex>
+#include <vector>
 #include <ns3/object.h>
 #include <ns3/nstime.h>
 #include <ns3/vector.h>
@@ -52,7 +54,93 @@ public:
   typedef std::vector<DoubleVector> Double2DVector; //!< type definition for matrices of doubles
   typedef std::vector<Double2DVector> Double3DVector; //!< type definition for 3D matrices of doubles
   typedef std::vector<ThreeGppAntennaArrayModel::ComplexVector> Complex2DVector; //!< type definition for complex matrices
-  typedef std::vector<Complex2DVector> Complex3DVector; //!< type definition for complex 3D matrices
+
+  /**
+   * A complex 3D matrix stored in a single contiguous buffer. Element
+   * (row, col, page) is stored at ((row * numCols) + col) * numPages + page,
+   * i.e., the pages of an element are adjacent.
+   */
+  class Complex3DVector
+  {
+  public:
+    /**
+     * Create an empty matrix
+     */
+    Complex3DVector ()
+      : m_numRows (0),
+        m_numCols (0),
+        m_numPages (0)
+    {
+    }
+
+    /**
+     * Create a matrix whose elements are all zero
+     * \param numRows the number of rows
+     * \param numCols the number of columns
+     * \param numPages the number of pages
+     */
+    Complex3DVector (size_t numRows, size_t numCols, size_t numPages)
+      : m_numRows (numRows),
+        m_numCols (numCols),
+        m_numPages (numPages),
+        m_values (numRows * numCols * numPages)
+    {
+    }
+
+    /**
+     * \param row the row index
+     * \param col the column index
+     * \param page the page index
+     * \return a reference to the element
+     */
+    std::complex<double>& operator() (size_t row, size_t col, size_t page)
+    {
+      NS_ASSERT (row < m_numRows && col < m_numCols && page < m_numPages);
+      return m_values[(row * m_numCols + col) * m_numPages + page];
+    }
+
+    /**
+     * \param row the row index
+     * \param col the column index
+     * \param page the page index
+     * \return a const reference to the element
+     */
+    const std::complex<double>& operator() (size_t row, size_t col, size_t page) const
+    {
+      NS_ASSERT (row < m_numRows && col < m_numCols && page < m_numPages);
+      return m_values[(row * m_numCols + col) * m_numPages + page];
+    }
+
+    /**
+     * \return the number of rows
+     */
+    size_t GetNumRows (void) const
+    {
+      return m_numRows;
+    }
+
+    /**
+     * \return the number of columns
+     */
+    size_t GetNumCols (void) const
+    {
+      return m_numCols;
+    }
+
+    /**
+     * \return the number of pages
+     */
+    size_t GetNumPages (void) const
+    {
+      return m_numPages;
+    }
+
+  private:
+    size_t m_numRows;  //!< the number of rows
+    size_t m_numCols;  //!< the number of columns
+    size_t m_numPages; //!< the number of pages
+    std::vector<std::complex<double> > m_values; //!< the elements
+  };
 
 
   /**
@@ -60,7 +148,7 @@ public:
    */
   struct ChannelMatrix : public SimpleRefCount<ChannelMatrix>
   {
-    Complex3DVector    m_channel; //!< channel matrix H[u][s][n].
+    Complex3DVector    m_channel; //!< channel matrix H (u, s, n).
     DoubleVector       m_delay; //!< cluster delay in nanoseconds.
     Double2DVector     m_angle; //!< cluster angle angle[direction][n], where direction = 0(AOA), 1(ZOA), 2(AOD), 3(ZOD) in degree.
     Time               m_generatedTime; //!< generation time
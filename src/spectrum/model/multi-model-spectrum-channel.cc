@@ -128,6 +128,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       if (phyIt != rxInfoIterator->second.m_rxPhys.end ())
         {
           rxInfoIterator->second.m_rxPhys.erase (phyIt);
+          rxInfoIterator->second.m_rxGrid = 0;
           --m_numDevices;
           break; // there should be at most one entry
         }       
@@ -168,6 +169,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
     {
       // spectrum model is already known, just add the device to the corresponding list
       rxInfoIterator->second.m_rxPhys.push_back (phy);
+      rxInfoIterator->second.m_rxGrid = 0;
     }
 }
 
@@ -235,7 +237,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
-  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
     {
@@ -260,10 +262,28 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
-      for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhys.end ();
-           ++rxPhyIterator)
+      // with a limited range, only look at the receivers near the transmitter
+      const std::vector<Ptr<SpectrumPhy> > &rxPhys = rxInfoIterator->second.m_rxPhys;
+      bool culled = (m_maxRange > 0 && txMobility);
+      std::size_t nReceivers = rxPhys.size ();
+      if (culled)
+        {
+          Ptr<SpatialGrid> &rxGrid = rxInfoIterator->second.m_rxGrid;
+          if (rxGrid == 0)
+            {
+              rxGrid = Create<SpatialGrid> (m_maxRange);
+              for (const auto &phy : rxPhys)
+                {
+                  rxGrid->Add (phy->GetMobility ());
+                }
+            }
+          rxGrid->GetNeighbors (txMobility->GetPosition (), m_maxRange, m_neighbors);
+          nReceivers = m_neighbors.size ();
+        }
+
+      for (std::size_t n = 0; n < nReceivers; n++)
         {
+          auto rxPhyIterator = rxPhys.begin () + (culled ? m_neighbors[n] : n);
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
                          "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
@@ -27,6 +27,7 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/spatial-grid.h>
 #include <map>
 #include <set>
 
@@ -81,6 +82,7 @@ public:
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;  //!< Rx Spectrum model.
   std::vector<Ptr<SpectrumPhy> > m_rxPhys;     //!< Container of the Rx Spectrum phy objects.
+  Ptr<SpatialGrid> m_rxGrid;                   //!< Positions of the Rx Spectrum phy objects, if the range is limited.
 };
 
 /**
@@ -169,6 +171,11 @@ private:
    */
   std::size_t m_numDevices;
 
+  /**
+   * Indexes of the receiving SpectrumPhy instances within range of the transmitter.
+   */
+  std::vector<uint32_t> m_neighbors;
+
 };
 
 
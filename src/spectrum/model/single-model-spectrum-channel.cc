@@ -54,6 +54,7 @@ SingleModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_grid = 0;
   m_spectrumModel = 0;
   SpectrumChannel::DoDispose ();
 }
@@ -76,6 +77,7 @@ SingleModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  m_grid = 0;
 }
 
 
@@ -106,10 +108,26 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
-  for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
-       rxPhyIterator != m_phyList.end ();
-       ++rxPhyIterator)
+  // with a limited range, only look at the receivers near the transmitter
+  bool culled = (m_maxRange > 0 && senderMobility);
+  std::size_t nReceivers = m_phyList.size ();
+  if (culled)
     {
+      if (m_grid == 0)
+        {
+          m_grid = Create<SpatialGrid> (m_maxRange);
+          for (const auto &phy : m_phyList)
+            {
+              m_grid->Add (phy->GetMobility ());
+            }
+        }
+      m_grid->GetNeighbors (senderMobility->GetPosition (), m_maxRange, m_neighbors);
+      nReceivers = m_neighbors.size ();
+    }
+
+  for (std::size_t n = 0; n < nReceivers; n++)
+    {
+      PhyList::const_iterator rxPhyIterator = m_phyList.begin () + (culled ? m_neighbors[n] : n);
       if ((*rxPhyIterator) != txParams->txPhy)
         {
           Time delay  = MicroSeconds (0);
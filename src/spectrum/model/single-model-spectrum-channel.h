@@ -25,6 +25,7 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/traced-callback.h>
+#include <ns3/spatial-grid.h>
 
 namespace ns3 {
 
@@ -77,6 +78,16 @@ private:
    */
   PhyList m_phyList;
 
+  /**
+   * Positions of the SpectrumPhy instances, if the range is limited.
+   */
+  Ptr<SpatialGrid> m_grid;
+
+  /**
+   * Indexes of the SpectrumPhy instances within range of the transmitter.
+   */
+  std::vector<uint32_t> m_neighbors;
+
   /**
    * SpectrumModel that this channel instance is supporting.
    */
@@ -32,6 +32,7 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SpectrumChannel);
 
 SpectrumChannel::SpectrumChannel ()
+  : m_maxRange (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -70,6 +71,18 @@ SpectrumChannel::GetTypeId (void)
                    MakeDoubleAccessor (&SpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
 
+    .AddAttribute ("MaxRange",
+                   "The distance (m) beyond which transmissions are not "
+                   "passed to the receiving PHYs. The receivers within range "
+                   "are then found with a uniform grid over their positions "
+                   "instead of by considering all the receivers, and the "
+                   "Gain and PathLoss traces are not fired for the receivers "
+                   "out of range. Receivers without mobility model are always "
+                   "considered in range. Zero means an unlimited range.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+
     .AddAttribute ("PropagationLossModel",
                    "A pointer to the propagation loss model attached to this channel.",
                    PointerValue (0),
@@ -183,6 +183,14 @@ protected:
    */
   double m_maxLossDb;
 
+  /**
+   * Maximum range [m].
+   *
+   * Any device farther than this distance is considered out of range,
+   * zero meaning an unlimited range.
+   */
+  double m_maxRange;
+
   /**
    * Single-frequency propagation loss model to be used with this channel.
    */
@@ -403,16 +403,34 @@ Integral (const SpectrumValue& arg)
   return i;
 }
 
+double
+Integral (const SpectrumValue& lhs, const SpectrumValue& rhs)
+{
+  NS_ASSERT (lhs.m_spectrumModel == rhs.m_spectrumModel);
+  double i = 0;
+  Values::const_iterator it1 = lhs.ConstValuesBegin ();
+  Values::const_iterator it2 = rhs.ConstValuesBegin ();
+  Bands::const_iterator bit = lhs.ConstBandsBegin ();
+  while (it1 != lhs.ConstValuesEnd ())
+    {
+      NS_ASSERT (it2 != rhs.ConstValuesEnd ());
+      NS_ASSERT (bit != lhs.ConstBandsEnd ());
+      i += ((*it1) * (*it2)) * (bit->fh - bit->fl);
+      ++it1;
+      ++it2;
+      ++bit;
+    }
+  NS_ASSERT (bit == lhs.ConstBandsEnd ());
+  return i;
+}
+
 
 
 Ptr<SpectrumValue>
 SpectrumValue::Copy () const
 {
-  Ptr<SpectrumValue> p = Create<SpectrumValue> (m_spectrumModel);
-  *p = *this;
-  return p;
-
-  //  return Copy<SpectrumValue> (*this)
+  // copy-construct the values, rather than allocating them twice
+  return Create<SpectrumValue> (*this);
 }
 
 
@@ -661,6 +679,24 @@ SpectrumValue::operator/= (double rhs)
 }
 
 
+SpectrumValue&
+SpectrumValue::AddScaled (const SpectrumValue& rhs, double factor)
+{
+  Values::iterator it1 = m_values.begin ();
+  Values::const_iterator it2 = rhs.m_values.begin ();
+
+  NS_ASSERT (m_spectrumModel == rhs.m_spectrumModel);
+
+  while (it1 != m_values.end ())
+    {
+      NS_ASSERT ( it2 != rhs.m_values.end ());
+      *it1 += (*it2) * factor;
+      ++it1;
+      ++it2;
+    }
+  return *this;
+}
+
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
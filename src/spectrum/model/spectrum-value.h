@@ -420,6 +420,18 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add the Right Hand Side of the operator multiplied by a factor to
+   * *this, component by component. This is equivalent to
+   * *this += rhs * factor, without building the temporary product.
+   *
+   * @param rhs Right Hand Side of the operator
+   * @param factor the factor
+   *
+   * @return a reference to the updated SpectrumValue
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& rhs, double factor);
+
 
 
   /**
@@ -508,6 +520,17 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   * Equivalent to Integral (lhs * rhs), without building the temporary
+   * product, e.g., to filter a power spectral density by a spectral mask.
+   *
+   * @param lhs Left Hand Side of the product
+   * @param rhs Right Hand Side of the product
+   *
+   * @return the value of the integral \f$\int_F g(f) h(f) df  \f$
+   */
+  friend double Integral (const SpectrumValue&  lhs, const SpectrumValue&  rhs);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -630,6 +653,7 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+double Integral (const SpectrumValue& lhs, const SpectrumValue& rhs);
 
 
 } // namespace ns3
@@ -21,13 +21,21 @@
  */
 
 #include "three-gpp-channel-model.h"
+#include "ns3/core-config.h"
 #include "ns3/log.h"
 #include "ns3/three-gpp-antenna-array-model.h"
 #include "ns3/node.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/rng-stream.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
 #include <algorithm>
+#include <array>
 #include <random>
 #include "ns3/log.h"
 #include <ns3/simulator.h>
@@ -161,6 +169,9 @@ static const double sqrtC_office_NLOS[6][6] = {
 };
 
 ThreeGppChannelModel::ThreeGppChannelModel ()
+  : m_linkStream (-1),
+    m_linkStreamIndex (0),
+    m_linkStreamValid (false)
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = CreateObject<UniformRandomVariable> ();
@@ -179,6 +190,7 @@ void
 ThreeGppChannelModel::DoDispose ()
 {
   m_channelMap.clear ();
+  m_bankLinks.clear ();
   m_channelConditionModel->Dispose ();
   m_channelConditionModel = nullptr;
 }
@@ -235,6 +247,21 @@ ThreeGppChannelModel::GetTypeId (void)
                    DoubleValue (1),
                    MakeDoubleAccessor (&ThreeGppChannelModel::m_blockerSpeed),
                    MakeDoubleChecker<double> ())
+    // attributes for the channel bank
+    .AddAttribute ("PrecomputeChannels",
+                   "If true, the channels of all the links whose update period "
+                   "has expired are generated together, each link drawing its "
+                   "random values from a substream of its own",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppChannelModel::m_precompute),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "The number of threads generating the channels when "
+                   "PrecomputeChannels is true. The realizations do not depend "
+                   "on this number.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1))
     ;
   return tid;
 }
@@ -755,7 +782,6 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   // retrieve the channel condition
   Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (aMob, bMob);
   bool los = (condition->GetLosCondition () == ChannelCondition::LosConditionValue::LOS);
-  bool o2i = false; // TODO include the o2i condition in the channel condition model
 
   // Check if the channel is present in the map and return it, otherwise
   // generate a new channel
@@ -781,41 +807,262 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   // generate a new realization
   if (notFound || update)
     {
-      // channel matrix not found or has to be updated, generate a new one
-      Angles txAngle (bMob->GetPosition (), aMob->GetPosition ());
-      Angles rxAngle (aMob->GetPosition (), bMob->GetPosition ());
-
-      double x = aMob->GetPosition ().x - bMob->GetPosition ().x;
-      double y = aMob->GetPosition ().y - bMob->GetPosition ().y;
-      double distance2D = sqrt (x * x + y * y);
-
-      // NOTE we assume hUT = min (height(a), height(b)) and
-      // hBS = max (height (a), height (b))
-      double hUt = std::min (aMob->GetPosition ().z, bMob->GetPosition ().z);
-      double hBs = std::max (aMob->GetPosition ().z, bMob->GetPosition ().z);
-
-      // TODO this is not currently used, it is needed for the computation of the
-      // additional blockage in case of spatial consistent update
-      // I do not know who is the UT, I can use the relative distance between
-      // tx and rx instead
-      Vector locUt = Vector (0.0, 0.0, 0.0);
-
-      channelMatrix = GetNewChannel (locUt, los, o2i, aAntenna, bAntenna, rxAngle, txAngle, distance2D, hBs, hUt);
-      channelMatrix->m_nodeIds = std::make_pair (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
-
-      // store or replace the channel matrix in the channel map
-      m_channelMap[channelId] = channelMatrix;
-  }
+      if (m_precompute)
+        {
+          BankLink &link = m_bankLinks[channelId];
+          if (link.m_random == 0)
+            {
+              link.m_random = CreateLinkRandomStream (channelId);
+            }
+          // the new realization follows the direction of this request
+          link.m_aMob = aMob;
+          link.m_bMob = bMob;
+          link.m_aAntenna = aAntenna;
+          link.m_bAntenna = bAntenna;
+          GenerateBankChannels (channelId, los);
+          channelMatrix = m_channelMap[channelId];
+        }
+      else
+        {
+          ChannelRandomStream random (m_uniformRv, m_normalRv);
+          ChannelGeneration generation = PrepareGeneration (aMob, bMob, aAntenna, bAntenna, los, &random);
+          Generate (generation);
+          channelMatrix = generation.m_channelMatrix;
+
+          // store or replace the channel matrix in the channel map
+          m_channelMap[channelId] = channelMatrix;
+        }
+    }
 
   return channelMatrix;
 }
 
+ThreeGppChannelModel::ChannelGeneration
+ThreeGppChannelModel::PrepareGeneration (Ptr<const MobilityModel> aMob,
+                                         Ptr<const MobilityModel> bMob,
+                                         Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                         Ptr<const ThreeGppAntennaArrayModel> bAntenna,
+                                         bool los, ChannelRandomStream *random) const
+{
+  NS_LOG_FUNCTION (this);
+
+  ChannelGeneration generation;
+  generation.m_aId = aMob->GetObject<Node> ()->GetId ();
+  generation.m_bId = bMob->GetObject<Node> ()->GetId ();
+  generation.m_channelId = GetKey (std::min (generation.m_aId, generation.m_bId),
+                                   std::max (generation.m_aId, generation.m_bId));
+  generation.m_los = los;
+  generation.m_o2i = false; // TODO include the o2i condition in the channel condition model
+
+  generation.m_txAngle = Angles (bMob->GetPosition (), aMob->GetPosition ());
+  generation.m_rxAngle = Angles (aMob->GetPosition (), bMob->GetPosition ());
+
+  double x = aMob->GetPosition ().x - bMob->GetPosition ().x;
+  double y = aMob->GetPosition ().y - bMob->GetPosition ().y;
+  generation.m_distance2D = sqrt (x * x + y * y);
+
+  // NOTE we assume hUT = min (height(a), height(b)) and
+  // hBS = max (height (a), height (b))
+  generation.m_hUt = std::min (aMob->GetPosition ().z, bMob->GetPosition ().z);
+  generation.m_hBs = std::max (aMob->GetPosition ().z, bMob->GetPosition ().z);
+
+  generation.m_aAntenna = aAntenna;
+  generation.m_bAntenna = bAntenna;
+  generation.m_random = random;
+  return generation;
+}
+
+void
+ThreeGppChannelModel::Generate (ChannelGeneration &generation) const
+{
+  // TODO this is not currently used, it is needed for the computation of the
+  // additional blockage in case of spatial consistent update
+  // I do not know who is the UT, I can use the relative distance between
+  // tx and rx instead
+  Vector locUt = Vector (0.0, 0.0, 0.0);
+
+  generation.m_channelMatrix = GetNewChannel (locUt, generation.m_los, generation.m_o2i,
+                                              generation.m_aAntenna, generation.m_bAntenna,
+                                              generation.m_rxAngle, generation.m_txAngle,
+                                              generation.m_distance2D, generation.m_hBs, generation.m_hUt,
+                                              *generation.m_random);
+  generation.m_channelMatrix->m_nodeIds = std::make_pair (generation.m_aId, generation.m_bId);
+}
+
+void
+ThreeGppChannelModel::Worker::Run (void)
+{
+  for (uint32_t i = m_first; i < m_generations->size (); i += m_stride)
+    {
+      m_model->Generate ((*m_generations)[i]);
+    }
+}
+
+void
+ThreeGppChannelModel::GenerateBankChannels (uint32_t channelId, bool los)
+{
+  NS_LOG_FUNCTION (this << channelId << los);
+
+  // The inputs of the generations are prepared here, in the simulation
+  // thread, since they need the mobility and the channel condition models.
+  // The links are visited in the order of their keys, so that the channel
+  // condition model is called in a deterministic order.
+  std::vector<ChannelGeneration> generations;
+  for (const auto &bankLink : m_bankLinks)
+    {
+      bool linkLos = los;
+      if (bankLink.first != channelId)
+        {
+          auto channelIt = m_channelMap.find (bankLink.first);
+          NS_ASSERT (channelIt != m_channelMap.end ());
+          // only the update period matters here, a change of the LOS
+          // condition is detected when the link is requested
+          if (!ChannelMatrixNeedsUpdate (channelIt->second, channelIt->second->m_los))
+            {
+              continue;
+            }
+          Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (bankLink.second.m_aMob, bankLink.second.m_bMob);
+          linkLos = (condition->GetLosCondition () == ChannelCondition::LosConditionValue::LOS);
+        }
+      generations.push_back (PrepareGeneration (bankLink.second.m_aMob, bankLink.second.m_bMob,
+                                                bankLink.second.m_aAntenna, bankLink.second.m_bAntenna,
+                                                linkLos, PeekPointer (bankLink.second.m_random)));
+    }
+
+  // The workers only read the model and the inputs, and each of them writes
+  // its own generations with the random values of their own links, so they
+  // need no locking and the results do not depend on the number of threads.
+  uint32_t nThreads = std::min<uint32_t> (m_numThreads, generations.size ());
+  std::vector<Worker> workers (nThreads);
+  for (uint32_t t = 0; t < nThreads; t++)
+    {
+      workers[t].m_model = this;
+      workers[t].m_first = t;
+      workers[t].m_stride = nThreads;
+      workers[t].m_generations = &generations;
+    }
+
+#ifdef HAVE_PTHREAD_H
+  if (nThreads > 1)
+    {
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&Worker::Run, &workers[t])));
+          threads[t]->Start ();
+        }
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          threads[t]->Join ();
+        }
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+    {
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          workers[t].Run ();
+        }
+    }
+
+  for (auto &generation : generations)
+    {
+      m_channelMap[generation.m_channelId] = generation.m_channelMatrix;
+    }
+  NS_LOG_DEBUG ("Generated the channels of " << generations.size () << " links out of " << m_bankLinks.size ());
+}
+
+Ptr<ThreeGppChannelModel::ChannelRandomStream>
+ThreeGppChannelModel::CreateLinkRandomStream (uint32_t channelId)
+{
+  NS_LOG_FUNCTION (this << channelId);
+
+  if (!m_linkStreamValid)
+    {
+      // same stream numbering as RandomVariableStream::SetStream
+      if (m_linkStream == -1)
+        {
+          m_linkStreamIndex = RngSeedManager::GetNextStreamIndex ();
+        }
+      else
+        {
+          m_linkStreamIndex = ((1ULL) << 63) + m_linkStream;
+        }
+      m_linkStreamValid = true;
+    }
+  // Each link gets the substreams of its own run. With 2^51 substreams per
+  // stream, this leaves room for 2^32 keys of 2^16 runs.
+  uint64_t run = RngSeedManager::GetRun ();
+  NS_ABORT_MSG_IF (run >= (1ULL << 16), "The channel bank supports run numbers below 65536");
+  return Create<ChannelRandomStream> (m_linkStreamIndex, (static_cast<uint64_t> (channelId) << 16) + run);
+}
+
+ThreeGppChannelModel::ChannelRandomStream::ChannelRandomStream (Ptr<UniformRandomVariable> uniformRv, Ptr<NormalRandomVariable> normalRv)
+  : m_uniformRv (uniformRv),
+    m_normalRv (normalRv),
+    m_rng (0),
+    m_nextNormalValid (false),
+    m_nextNormal (0)
+{
+}
+
+ThreeGppChannelModel::ChannelRandomStream::ChannelRandomStream (uint64_t stream, uint64_t substream)
+  : m_rng (new RngStream (RngSeedManager::GetSeed (), stream, substream)),
+    m_nextNormalValid (false),
+    m_nextNormal (0)
+{
+}
+
+ThreeGppChannelModel::ChannelRandomStream::~ChannelRandomStream ()
+{
+  delete m_rng;
+}
+
+double
+ThreeGppChannelModel::ChannelRandomStream::GetUniform (double min, double max)
+{
+  if (m_rng == 0)
+    {
+      return m_uniformRv->GetValue (min, max);
+    }
+  return min + m_rng->RandU01 () * (max - min);
+}
+
+double
+ThreeGppChannelModel::ChannelRandomStream::GetNormal (void)
+{
+  if (m_rng == 0)
+    {
+      return m_normalRv->GetValue ();
+    }
+  if (m_nextNormalValid)
+    {
+      m_nextNormalValid = false;
+      return m_nextNormal;
+    }
+  // same polar method as NormalRandomVariable
+  while (true)
+    {
+      double v1 = 2 * m_rng->RandU01 () - 1;
+      double v2 = 2 * m_rng->RandU01 () - 1;
+      double w = v1 * v1 + v2 * v2;
+      if (w > 0 && w <= 1.0)
+        {
+          double y = std::sqrt ((-2 * std::log (w)) / w);
+          m_nextNormal = v2 * y;
+          m_nextNormalValid = true;
+          return v1 * y;
+        }
+    }
+}
+
 Ptr<ThreeGppChannelModel::ThreeGppChannelMatrix>
 ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
-                                     Ptr<const ThreeGppAntennaArrayModel> sAntenna,
-                                     Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                     const Ptr<const ThreeGppAntennaArrayModel> &sAntenna,
+                                     const Ptr<const ThreeGppAntennaArrayModel> &uAntenna,
                                      Angles &uAngle, Angles &sAngle,
-                                     double dis2D, double hBS, double hUT) const
+                                     double dis2D, double hBS, double hUT,
+                                     ChannelRandomStream &random) const
 {
   NS_LOG_FUNCTION (this);
 
@@ -851,7 +1098,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   //Generate paramNum independent LSPs.
   for (uint8_t iter = 0; iter < paramNum; iter++)
     {
-      LSPsIndep.push_back (m_normalRv->GetValue ());
+      LSPsIndep.push_back (random.GetNormal ());
     }
   for (uint8_t row = 0; row < paramNum; row++)
     {
@@ -899,7 +1146,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   double minTau = 100.0;
   for (uint8_t cIndex = 0; cIndex < numOfCluster; cIndex++)
     {
-      double tau = -1*table3gpp->m_rTau*DS*log (m_uniformRv->GetValue (0,1)); //(7.5-1)
+      double tau = -1*table3gpp->m_rTau*DS*log (random.GetUniform (0,1)); //(7.5-1)
       if (minTau > tau)
         {
           minTau = tau;
@@ -922,7 +1169,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   for (uint8_t cIndex = 0; cIndex < numOfCluster; cIndex++)
     {
       double power = exp (-1 * clusterDelay[cIndex] * (table3gpp->m_rTau - 1) / table3gpp->m_rTau / DS) *
-        pow (10,-1 * m_normalRv->GetValue () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
+        pow (10,-1 * random.GetNormal () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
       powerSum += power;
       clusterPower.push_back (power);
     }
@@ -1099,21 +1346,21 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   for (uint8_t cIndex = 0; cIndex < numReducedCluster; cIndex++)
     {
       int Xn = 1;
-      if (m_uniformRv->GetValue (0,1) < 0.5)
+      if (random.GetUniform (0,1) < 0.5)
         {
           Xn = -1;
         }
-      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (m_normalRv->GetValue () * ASA / 7) + uAngle.phi * 180 / M_PI;        //(7.5-11)
-      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (m_normalRv->GetValue () * ASD / 7) + sAngle.phi * 180 / M_PI;
+      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (random.GetNormal () * ASA / 7) + uAngle.phi * 180 / M_PI;        //(7.5-11)
+      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (random.GetNormal () * ASD / 7) + sAngle.phi * 180 / M_PI;
       if (o2i)
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + 90;            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (random.GetNormal () * ZSA / 7) + 90;            //(7.5-16)
         }
       else
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + uAngle.theta * 180 / M_PI;            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (random.GetNormal () * ZSA / 7) + uAngle.theta * 180 / M_PI;            //(7.5-16)
         }
-      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (m_normalRv->GetValue () * ZSD / 7) + sAngle.theta * 180 / M_PI + table3gpp->m_offsetZOD;        //(7.5-19)
+      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (random.GetNormal () * ZSD / 7) + sAngle.theta * 180 / M_PI + table3gpp->m_offsetZOD;        //(7.5-19)
 
     }
 
@@ -1275,7 +1522,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   DoubleVector attenuation_dB;
   if (m_blockage)
     {
-      attenuation_dB = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa);
+      attenuation_dB = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa, random);
       for (uint8_t cInd = 0; cInd < numReducedCluster; cInd++)
         {
           clusterPower[cInd] = clusterPower[cInd] / pow (10,attenuation_dB[cInd] / 10);
@@ -1309,11 +1556,11 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
           double uXprLinear = pow (10, table3gpp->m_uXpr / 10); // convert to linear
           double sigXprLinear = pow (10, table3gpp->m_sigXpr / 10); // convert to linear
 
-          temp.push_back (std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
+          temp.push_back (std::pow (10, (random.GetNormal () * sigXprLinear + uXprLinear) / 10));
           DoubleVector temp3; // used to store the PHI valuse
           for (uint8_t pInd = 0; pInd < 4; pInd++)
             {
-              temp3.push_back (m_uniformRv->GetValue (-1 * M_PI, M_PI));
+              temp3.push_back (random.GetUniform (-1 * M_PI, M_PI));
             }
           temp2.push_back (temp3);
         }
@@ -1325,7 +1572,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   //Step 11: Generate channel coefficients for each cluster n and each receiver
   // and transmitter element pair u,s.
 
-  Complex3DVector H_NLOS; // channel coefficients H_NLOS [u][s][n],
+  // channel coefficients H (u, s, n),
   // where u and s are receive and transmit antenna element, n is cluster index.
   uint64_t uSize = uAntenna->GetNumberOfElements ();
   uint64_t sSize = sAntenna->GetNumberOfElements ();
@@ -1352,63 +1599,133 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
   NS_LOG_INFO ("1st strongest cluster:" << (int)cluster1st << ", 2nd strongest cluster:" << (int)cluster2nd);
 
-  Complex3DVector H_usn;  //channel coffecient H_usn[u][s][n];
+  Complex3DVector H_usn;  //channel coffecient H_usn (u, s, n);
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
   // the total cluster will be numReducedCLuster + 4.
+  // The sub-clusters of the strongest cluster with the lowest index come
+  // first, followed by the ones of the other strongest cluster.
+  uint8_t numSubClusterPages = (cluster1st == cluster2nd ? 2 : 4);
+  H_usn = Complex3DVector (uSize, sSize, numReducedCluster + numSubClusterPages);
+  uint8_t firstStrongCluster = std::min (cluster1st, cluster2nd);
+
+  // Everything but the phase shifts due to the location of the elements
+  // depends only on the ray, hence it is computed once per ray. The phase
+  // shifts depend on either the u or the s element, hence they are computed
+  // once per element and ray, and the channel coefficient of each element
+  // pair is a sum of their products. The operations are performed in the
+  // same order as if all the terms were computed for each element pair.
+  uint16_t numRays = numReducedCluster * raysPerCluster;
+  ThreeGppAntennaArrayModel::ComplexVector rayPolarization (numRays); // the polarization term of ray m of cluster n, at n * raysPerCluster + m
+  std::vector<std::array<double, 3> > rayRxDirection (numRays); // the components of the direction of arrival of each ray
+  std::vector<std::array<double, 3> > rayTxDirection (numRays); // the components of the direction of departure of each ray
+  for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
+    {
+      for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+        {
+          uint16_t ray = nIndex * raysPerCluster + mIndex;
+          const DoubleVector &initialPhase = clusterPhase[nIndex][mIndex];
+          double k = crossPolarizationPowerRatios[nIndex][mIndex];
+
+          double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+          std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoa_radian[nIndex][mIndex], rayZoa_radian[nIndex][mIndex]));
+          std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAod_radian[nIndex][mIndex], rayZod_radian[nIndex][mIndex]));
+
+          rayPolarization[ray] = exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
+            +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
+            +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
+            +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi;
+
+          rayRxDirection[ray][0] = sin (rayZoa_radian[nIndex][mIndex]) * cos (rayAoa_radian[nIndex][mIndex]);
+          rayRxDirection[ray][1] = sin (rayZoa_radian[nIndex][mIndex]) * sin (rayAoa_radian[nIndex][mIndex]);
+          rayRxDirection[ray][2] = cos (rayZoa_radian[nIndex][mIndex]);
+          rayTxDirection[ray][0] = sin (rayZod_radian[nIndex][mIndex]) * cos (rayAod_radian[nIndex][mIndex]);
+          rayTxDirection[ray][1] = sin (rayZod_radian[nIndex][mIndex]) * sin (rayAod_radian[nIndex][mIndex]);
+          rayTxDirection[ray][2] = cos (rayZod_radian[nIndex][mIndex]);
+        }
+    }
 
-  H_usn.resize (uSize);
+  // rxPhase[u * numRays + ray] and txPhase[s * numRays + ray]
+  //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+  ThreeGppAntennaArrayModel::ComplexVector rxPhase (uSize * numRays);
+  ThreeGppAntennaArrayModel::ComplexVector txPhase (sSize * numRays);
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      H_usn[uIndex].resize (sSize);
+      Vector uLoc = uAntenna->GetElementLocation (uIndex);
+      for (uint16_t ray = 0; ray < numRays; ray++)
+        {
+          double rxPhaseDiff = 2 * M_PI * (rayRxDirection[ray][0] * uLoc.x
+                                           + rayRxDirection[ray][1] * uLoc.y
+                                           + rayRxDirection[ray][2] * uLoc.z);
+          rxPhase[uIndex * numRays + ray] = exp (std::complex<double> (0, rxPhaseDiff));
+        }
+    }
+  for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+      Vector sLoc = sAntenna->GetElementLocation (sIndex);
+      for (uint16_t ray = 0; ray < numRays; ray++)
+        {
+          double txPhaseDiff = 2 * M_PI * (rayTxDirection[ray][0] * sLoc.x
+                                           + rayTxDirection[ray][1] * sLoc.y
+                                           + rayTxDirection[ray][2] * sLoc.z);
+          txPhase[sIndex * numRays + ray] = exp (std::complex<double> (0, txPhaseDiff));
+        }
+    }
+  // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center anngle of each cluster.
+
+  // the LOS ray (7.5-29) && (7.5-30)
+  std::complex<double> losPolarization;
+  ThreeGppAntennaArrayModel::ComplexVector losRxPhase, losTxPhase;
+  if (los)
+    {
+      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.phi, uAngle.theta));
+      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.phi, sAngle.theta));
+
+      double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
+
+      losPolarization = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
+        * exp (std::complex<double> (0, - 2 * M_PI * dis3D / lambda));
+
+      for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+        {
+          Vector uLoc = uAntenna->GetElementLocation (uIndex);
+          double rxPhaseDiff = 2 * M_PI * (sin (uAngle.theta) * cos (uAngle.phi) * uLoc.x
+                                           + sin (uAngle.theta) * sin (uAngle.phi) * uLoc.y
+                                           + cos (uAngle.theta) * uLoc.z);
+          losRxPhase.push_back (exp (std::complex<double> (0, rxPhaseDiff)));
+        }
       for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-          H_usn[uIndex][sIndex].resize (numReducedCluster);
+          Vector sLoc = sAntenna->GetElementLocation (sIndex);
+          double txPhaseDiff = 2 * M_PI * (sin (sAngle.theta) * cos (sAngle.phi) * sLoc.x
+                                           + sin (sAngle.theta) * sin (sAngle.phi) * sLoc.y
+                                           + cos (sAngle.theta) * sLoc.z);
+          losTxPhase.push_back (exp (std::complex<double> (0, txPhaseDiff)));
         }
     }
 
   // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      Vector uLoc = uAntenna->GetElementLocation (uIndex);
+      const std::complex<double> *uRxPhase = &rxPhase[uIndex * numRays];
 
       for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-
-          Vector sLoc = sAntenna->GetElementLocation (sIndex);
+          const std::complex<double> *sTxPhase = &txPhase[sIndex * numRays];
 
           for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
             {
+              uint16_t firstRay = nIndex * raysPerCluster;
               //Compute the N-2 weakest cluster, only vertical polarization. (7.5-22)
               if (nIndex != cluster1st && nIndex != cluster2nd)
                 {
                   std::complex<double> rays (0,0);
-                  for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+                  for (uint16_t ray = firstRay; ray < firstRay + raysPerCluster; ray++)
                     {
-                      DoubleVector initialPhase = clusterPhase[nIndex][mIndex];
-                      double k = crossPolarizationPowerRatios[nIndex][mIndex];
-                      //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoa_radian[nIndex][mIndex]) * cos (rayAoa_radian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoa_radian[nIndex][mIndex]) * sin (rayAoa_radian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoa_radian[nIndex][mIndex]) * uLoc.z);
-
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZod_radian[nIndex][mIndex]) * cos (rayAod_radian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZod_radian[nIndex][mIndex]) * sin (rayAod_radian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZod_radian[nIndex][mIndex]) * sLoc.z);
-                      // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center anngle of each cluster.
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoa_radian[nIndex][mIndex], rayZoa_radian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAod_radian[nIndex][mIndex], rayZod_radian[nIndex][mIndex]));
-
-                      rays += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                               +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                               +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                               +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * exp (std::complex<double> (0, rxPhaseDiff))
-                        * exp (std::complex<double> (0, txPhaseDiff));
+                      rays += rayPolarization[ray] * uRxPhase[ray] * sTxPhase[ray];
                     }
                   rays *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = rays;
+                  H_usn (uIndex, sIndex, nIndex) = rays;
                 }
               else  //(7.5-28)
                 {
@@ -1416,24 +1733,10 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
                   std::complex<double> raysSub2 (0,0);
                   std::complex<double> raysSub3 (0,0);
 
+                  //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
                   for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
                     {
-                      double k = crossPolarizationPowerRatios[nIndex][mIndex];
-
-                      //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
-
-                      DoubleVector initialPhase = clusterPhase[nIndex][mIndex];
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoa_radian[nIndex][mIndex]) * cos (rayAoa_radian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoa_radian[nIndex][mIndex]) * sin (rayAoa_radian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoa_radian[nIndex][mIndex]) * uLoc.z);
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZod_radian[nIndex][mIndex]) * cos (rayAod_radian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZod_radian[nIndex][mIndex]) * sin (rayAod_radian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZod_radian[nIndex][mIndex]) * sLoc.z);
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoa_radian[nIndex][mIndex], rayZoa_radian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAod_radian[nIndex][mIndex], rayZod_radian[nIndex][mIndex]));
-
+                      uint16_t ray = firstRay + mIndex;
                       switch (mIndex)
                         {
                         case 9:
@@ -1442,71 +1745,39 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
                         case 12:
                         case 17:
                         case 18:
-                          raysSub2 += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                       +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                            * exp (std::complex<double> (0, rxPhaseDiff))
-                            * exp (std::complex<double> (0, txPhaseDiff));
+                          raysSub2 += rayPolarization[ray] * uRxPhase[ray] * sTxPhase[ray];
                           break;
                         case 13:
                         case 14:
                         case 15:
                         case 16:
-                          raysSub3 += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                       +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                            * exp (std::complex<double> (0, rxPhaseDiff))
-                            * exp (std::complex<double> (0, txPhaseDiff));
+                          raysSub3 += rayPolarization[ray] * uRxPhase[ray] * sTxPhase[ray];
                           break;
                         default:                        //case 1,2,3,4,5,6,7,8,19,20
-                          raysSub1 += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                       +exp (std::complex<double> (0, initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                       +exp (std::complex<double> (0, initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                            * exp (std::complex<double> (0, rxPhaseDiff))
-                            * exp (std::complex<double> (0, txPhaseDiff));
+                          raysSub1 += rayPolarization[ray] * uRxPhase[ray] * sTxPhase[ray];
                           break;
                         }
                     }
                   raysSub1 *= sqrt (clusterPower[nIndex] / raysPerCluster);
                   raysSub2 *= sqrt (clusterPower[nIndex] / raysPerCluster);
                   raysSub3 *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = raysSub1;
-                  H_usn[uIndex][sIndex].push_back (raysSub2);
-                  H_usn[uIndex][sIndex].push_back (raysSub3);
-
+                  uint8_t subClusterPage = numReducedCluster + (nIndex == firstStrongCluster ? 0 : 2);
+                  H_usn (uIndex, sIndex, nIndex) = raysSub1;
+                  H_usn (uIndex, sIndex, subClusterPage) = raysSub2;
+                  H_usn (uIndex, sIndex, subClusterPage + 1) = raysSub3;
                 }
             }
           if (los) //(7.5-29) && (7.5-30)
             {
-              std::complex<double> ray (0,0);
-              double rxPhaseDiff = 2 * M_PI * (sin (uAngle.theta) * cos (uAngle.phi) * uLoc.x
-                                               + sin (uAngle.theta) * sin (uAngle.phi) * uLoc.y
-                                               + cos (uAngle.theta) * uLoc.z);
-              double txPhaseDiff = 2 * M_PI * (sin (sAngle.theta) * cos (sAngle.phi) * sLoc.x
-                                               + sin (sAngle.theta) * sin (sAngle.phi) * sLoc.y
-                                               + cos (sAngle.theta) * sLoc.z);
-
-              double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.phi, uAngle.theta));
-              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.phi, sAngle.theta));
-
-              double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
-
-              ray = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
-                  * exp (std::complex<double> (0, - 2 * M_PI * dis3D / lambda))
-                  * exp (std::complex<double> (0, rxPhaseDiff))
-                  * exp (std::complex<double> (0, txPhaseDiff));
+              std::complex<double> ray = losPolarization * losRxPhase[uIndex] * losTxPhase[sIndex];
 
               double K_linear = pow (10,K_factor / 10);
               // the LOS path should be attenuated if blockage is enabled.
-              H_usn[uIndex][sIndex][0] = sqrt (1 / (K_linear + 1)) * H_usn[uIndex][sIndex][0] + sqrt (K_linear / (1 + K_linear)) * ray / pow (10,attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = H_usn[uIndex][sIndex].size ();
+              H_usn (uIndex, sIndex, 0) = sqrt (1 / (K_linear + 1)) * H_usn (uIndex, sIndex, 0) + sqrt (K_linear / (1 + K_linear)) * ray / pow (10,attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
+              double tempSize = H_usn.GetNumPages ();
               for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
                 {
-                  H_usn[uIndex][sIndex][nIndex] *= sqrt (1 / (K_linear + 1)); //(7.5-30) for tau = tau2...taunN
+                  H_usn (uIndex, sIndex, nIndex) *= sqrt (1 / (K_linear + 1)); //(7.5-30) for tau = tau2...taunN
                 }
 
             }
@@ -1572,7 +1843,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
     }
 
-  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.size () << "][" << H_usn[0].size () << "][" << H_usn[0][0].size () << "]");
+  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.GetNumRows () << "][" << H_usn.GetNumCols () << "][" << H_usn.GetNumPages () << "]");
 
   channelParams->m_channel = H_usn;
   channelParams->m_delay = clusterDelay;
@@ -1589,7 +1860,8 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 MatrixBasedChannelModel::DoubleVector
 ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::ThreeGppChannelMatrix> params,
                                                  const DoubleVector &clusterAOA,
-                                                 const DoubleVector &clusterZOA) const
+                                                 const DoubleVector &clusterZOA,
+                                                 ChannelRandomStream &random) const
 {
   NS_LOG_FUNCTION (this);
 
@@ -1627,17 +1899,17 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
         {
           //draw value from table 7.6.4.1-2 Blocking region parameters
           DoubleVector table;
-          table.push_back (m_normalRv->GetValue ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
+          table.push_back (random.GetNormal ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
           if (m_scenario == "InH-OfficeMixed" || m_scenario == "InH-OfficeOpen")
             {
-              table.push_back (m_uniformRv->GetValue (15, 45)); //x_k
+              table.push_back (random.GetUniform (15, 45)); //x_k
               table.push_back (90);  //Theta_k
-              table.push_back (m_uniformRv->GetValue (5, 15)); //y_k
+              table.push_back (random.GetUniform (5, 15)); //y_k
               table.push_back (2);  //r
             }
           else
             {
-              table.push_back (m_uniformRv->GetValue (5, 15)); //x_k
+              table.push_back (random.GetUniform (5, 15)); //x_k
               table.push_back (90);  //Theta_k
               table.push_back (5);  //y_k
               table.push_back (10);  //r
@@ -1700,7 +1972,7 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
 
               //Generate a new correlated normal RV with the following formula
               params->m_nonSelfBlocking[blockInd][PHI_INDEX] =
-                R * params->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * m_normalRv->GetValue ();
+                R * params->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * random.GetNormal ();
             }
         }
 
@@ -1812,6 +2084,12 @@ ThreeGppChannelModel::AssignStreams (int64_t stream)
   NS_LOG_FUNCTION (this << stream);
   m_normalRv->SetStream (stream);
   m_uniformRv->SetStream (stream + 1);
+  if (m_precompute)
+    {
+      m_linkStream = stream + 2;
+      m_linkStreamValid = false;
+      return 3;
+    }
   return 2;
 }
 
@@ -29,12 +29,14 @@
 #include <ns3/random-variable-stream.h>
 #include <ns3/boolean.h>
 #include <unordered_map>
+#include <map>
 #include <ns3/channel-condition-model.h>
 #include <ns3/matrix-based-channel-model.h>
 
 namespace ns3 {
 
 class MobilityModel;
+class RngStream;
 
 /**
  * \ingroup spectrum
@@ -43,6 +45,14 @@ class MobilityModel;
  * The class implements the channel matrix generation procedure
  * described in 3GPP TR 38.901.
  *
+ * When the attribute PrecomputeChannels is true, the model keeps a bank of
+ * the links it has been asked about. When a channel has to be updated, the
+ * channels of all the links whose update period has expired are generated
+ * at once, spread over NumThreads threads when threading support is
+ * available. Each link then draws its random values from a substream of its
+ * own, so that the realizations do not depend on the number of threads nor
+ * on the order in which the links are requested.
+ *
  * \see GetChannel
  */
 class ThreeGppChannelModel : public MatrixBasedChannelModel
@@ -187,6 +197,105 @@ private:
     double m_sqrtC[7][7];
   };
 
+  /**
+   * The source of the random values used to generate a channel realization:
+   * either the random variables of the model, or a stream owned by a single
+   * link.
+   */
+  class ChannelRandomStream : public SimpleRefCount<ChannelRandomStream>
+  {
+  public:
+    /**
+     * Draw the values from the given random variables
+     * \param uniformRv the uniform random variable
+     * \param normalRv the normal random variable
+     */
+    ChannelRandomStream (Ptr<UniformRandomVariable> uniformRv, Ptr<NormalRandomVariable> normalRv);
+
+    /**
+     * Draw the values from a stream of their own
+     * \param stream the index of the stream
+     * \param substream the index of the substream
+     */
+    ChannelRandomStream (uint64_t stream, uint64_t substream);
+
+    ~ChannelRandomStream ();
+
+    /**
+     * \param min the lower bound
+     * \param max the upper bound
+     * \return a value drawn uniformly in [min, max)
+     */
+    double GetUniform (double min, double max);
+
+    /**
+     * \return a value drawn from the standard normal distribution
+     */
+    double GetNormal (void);
+
+  private:
+    /// Not copyable, the stream is owned
+    ChannelRandomStream (const ChannelRandomStream &) = delete;
+    /// Not copyable, the stream is owned
+    ChannelRandomStream & operator= (const ChannelRandomStream &) = delete;
+
+    Ptr<UniformRandomVariable> m_uniformRv; //!< the uniform random variable, if shared
+    Ptr<NormalRandomVariable> m_normalRv; //!< the normal random variable, if shared
+    RngStream *m_rng; //!< the owned stream, if not shared
+    bool m_nextNormalValid; //!< whether m_nextNormal holds a value
+    double m_nextNormal; //!< the second value of the last pair of normal values
+  };
+
+  /**
+   * A link kept in the channel bank
+   */
+  struct BankLink
+  {
+    Ptr<const MobilityModel> m_aMob; //!< mobility model of the a device
+    Ptr<const MobilityModel> m_bMob; //!< mobility model of the b device
+    Ptr<const ThreeGppAntennaArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const ThreeGppAntennaArrayModel> m_bAntenna; //!< antenna of the b device
+    Ptr<ChannelRandomStream> m_random; //!< the random values of the link
+  };
+
+  /**
+   * The inputs and the output of the generation of a channel realization.
+   * The inputs are prepared in the simulation thread, so that the generation
+   * itself can run in any thread.
+   */
+  struct ChannelGeneration
+  {
+    uint32_t m_channelId; //!< the channel key
+    uint32_t m_aId; //!< the id of the a node
+    uint32_t m_bId; //!< the id of the b node
+    bool m_los; //!< the LOS condition
+    bool m_o2i; //!< the O2I condition
+    Angles m_txAngle; //!< the angle towards the a device, seen from the b device
+    Angles m_rxAngle; //!< the angle towards the b device, seen from the a device
+    double m_distance2D; //!< the 2D distance between the devices
+    double m_hBs; //!< the height of the BS
+    double m_hUt; //!< the height of the UT
+    Ptr<const ThreeGppAntennaArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const ThreeGppAntennaArrayModel> m_bAntenna; //!< antenna of the b device
+    ChannelRandomStream *m_random; //!< the random values to use
+    Ptr<ThreeGppChannelMatrix> m_channelMatrix; //!< the generated realization
+  };
+
+  /**
+   * Worker generating a strided subset of the channel realizations
+   */
+  struct Worker
+  {
+    const ThreeGppChannelModel *m_model; //!< the channel model
+    uint32_t m_first; //!< index of the first generation
+    uint32_t m_stride; //!< distance between the generations
+    std::vector<ChannelGeneration> *m_generations; //!< the generations
+    /**
+     * Run the generations
+     */
+    void Run (void);
+  };
+
   /**
    * Get the parameters needed to apply the channel generation procedure
    * \param los the LOS/NLOS condition
@@ -200,7 +309,8 @@ private:
 
   /**
    * Compute the channel matrix between two devices using the procedure
-   * described in 3GPP TR 38.901
+   * described in 3GPP TR 38.901. This method only reads the state of the
+   * model, it can run outside the simulation thread.
    * \param locUT the location of the UT
    * \param los the LOS/NLOS condition
    * \param o2i whether if it is an outdoor to indoor transmission
@@ -211,24 +321,67 @@ private:
    * \param dis2D the 2D distance between tx and rx
    * \param hBS the height of the BS
    * \param hUT the height of the UT
+   * \param random the random values to use
    * \return the channel realization
    */
   Ptr<ThreeGppChannelMatrix> GetNewChannel (Vector locUT, bool los, bool o2i,
-                                            Ptr<const ThreeGppAntennaArrayModel> sAntenna,
-                                            Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                            const Ptr<const ThreeGppAntennaArrayModel> &sAntenna,
+                                            const Ptr<const ThreeGppAntennaArrayModel> &uAntenna,
                                             Angles &uAngle, Angles &sAngle,
-                                            double dis2D, double hBS, double hUT) const;
+                                            double dis2D, double hBS, double hUT,
+                                            ChannelRandomStream &random) const;
 
   /**
    * Applies the blockage model A described in 3GPP TR 38.901
    * \param params the channel matrix
    * \param clusterAOA vector containing the azimuth angle of arrival for each cluster
    * \param clusterZOA vector containing the zenith angle of arrival for each cluster
+   * \param random the random values to use
    * \return vector containing the power attenuation for each cluster
    */
   DoubleVector CalcAttenuationOfBlockage (Ptr<ThreeGppChannelMatrix> params,
                                           const DoubleVector &clusterAOA,
-                                          const DoubleVector &clusterZOA) const;
+                                          const DoubleVector &clusterZOA,
+                                          ChannelRandomStream &random) const;
+
+  /**
+   * Prepare the generation of the channel realization of a link
+   * \param aMob mobility model of the a device
+   * \param bMob mobility model of the b device
+   * \param aAntenna antenna of the a device
+   * \param bAntenna antenna of the b device
+   * \param los the LOS condition
+   * \param random the random values to use
+   * \return the inputs of the generation
+   */
+  ChannelGeneration PrepareGeneration (Ptr<const MobilityModel> aMob,
+                                       Ptr<const MobilityModel> bMob,
+                                       Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                       Ptr<const ThreeGppAntennaArrayModel> bAntenna,
+                                       bool los, ChannelRandomStream *random) const;
+
+  /**
+   * Generate a channel realization. This method only reads the state of
+   * the model, it can run outside the simulation thread.
+   * \param generation the inputs, updated with the generated realization
+   */
+  void Generate (ChannelGeneration &generation) const;
+
+  /**
+   * Generate the channel realization of a link of the bank, together with
+   * the ones of all the other links whose update period has expired, and
+   * store them in m_channelMap
+   * \param channelId the key of the link
+   * \param los the current LOS condition of the link
+   */
+  void GenerateBankChannels (uint32_t channelId, bool los);
+
+  /**
+   * Get the substream of the random values of a link of the bank
+   * \param channelId the key of the link
+   * \return the random values of the link
+   */
+  Ptr<ChannelRandomStream> CreateLinkRandomStream (uint32_t channelId);
 
   /**
    * Check if the channel matrix has to be updated
@@ -246,6 +399,14 @@ private:
   Ptr<UniformRandomVariable> m_uniformRv; //!< uniform random variable
   Ptr<NormalRandomVariable> m_normalRv; //!< normal random variable
 
+  // parameters for the channel bank
+  bool m_precompute; //!< whether the channels are generated by the bank
+  uint32_t m_numThreads; //!< the number of threads generating the channels of the bank
+  std::map<uint32_t, BankLink> m_bankLinks; //!< the links of the bank, by channel key
+  int64_t m_linkStream; //!< the stream assigned to the links of the bank, -1 if automatic
+  uint64_t m_linkStreamIndex; //!< the index of the stream of the links of the bank
+  bool m_linkStreamValid; //!< whether m_linkStreamIndex was set
+
   // parameters for the blockage model
   bool m_blockage; //!< enables the blockage model A
   uint16_t m_numNonSelfBlocking; //!< number of non-self-blocking regions
@@ -30,6 +30,7 @@
 #include "ns3/string.h"
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
+#include <algorithm>
 #include <map>
 
 namespace ns3 {
@@ -113,6 +114,31 @@ ThreeGppSpectrumPropagationLossModel::GetChannelModelAttribute (const std::strin
   m_channelModel->GetAttribute (name, value);
 }
 
+/**
+ * Computes y[i] += a * x[i] for i = 0, ..., n - 1, i.e., the complex
+ * counterpart of the BLAS axpy kernel. The complex products are written out
+ * on the interleaved real and imaginary parts, in the same order as
+ * std::complex does, so that the loop can be vectorized by the compiler
+ * while returning the same values as the scalar code.
+ * \param n the number of elements
+ * \param a the scale factor
+ * \param x the elements to scale
+ * \param y the elements to update
+ */
+static void
+ComplexAxpy (size_t n, std::complex<double> a, const std::complex<double> *x, std::complex<double> *y)
+{
+  const double ar = a.real ();
+  const double ai = a.imag ();
+  const double *xd = reinterpret_cast<const double *> (x);
+  double *yd = reinterpret_cast<double *> (y);
+  for (size_t i = 0; i < 2 * n; i += 2)
+    {
+      yd[i] += ar * xd[i] - ai * xd[i + 1];
+      yd[i + 1] += ar * xd[i + 1] + ai * xd[i];
+    }
+}
+
 ThreeGppAntennaArrayModel::ComplexVector
 ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
                                                     const ThreeGppAntennaArrayModel::ComplexVector &sW,
@@ -126,147 +152,169 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   NS_LOG_DEBUG ("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
   //store the long term part to reduce computation load
   //only the small scale fading needs to be updated if the large scale parameters and antenna weights remain unchanged.
-  ThreeGppAntennaArrayModel::ComplexVector longTerm;
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
+  size_t numCluster = params->m_channel.GetNumPages ();
+  ThreeGppAntennaArrayModel::ComplexVector longTerm (numCluster);
+  if (numCluster == 0)
+    {
+      return longTerm;
+    }
 
-  for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+  // the coefficients of all the clusters of an element pair are contiguous,
+  // hence the products are computed for all the clusters at once
+  ThreeGppAntennaArrayModel::ComplexVector rxSum (numCluster);
+  for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
     {
-      std::complex<double> txSum (0,0);
-      for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
+      std::fill (rxSum.begin (), rxSum.end (), std::complex<double> (0, 0));
+      for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
         {
-          std::complex<double> rxSum (0,0);
-          for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
-            {
-              rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
-            }
-          txSum = txSum + sW[sIndex] * rxSum;
+          ComplexAxpy (numCluster, uW[uIndex], &params->m_channel (uIndex, sIndex, 0), rxSum.data ());
         }
-      longTerm.push_back (txSum);
+      ComplexAxpy (numCluster, sW[sIndex], rxSum.data (), longTerm.data ());
     }
   return longTerm;
 }
 
 Ptr<SpectrumValue>
-ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                                           ThreeGppAntennaArrayModel::ComplexVector longTerm,
+ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> psd,
+                                                           Ptr<LongTerm> longTerm,
                                                            Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
                                                            const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
+  //channel (rx, tx, cluster)
+  size_t numCluster = params->m_channel.GetNumPages ();
+  size_t numBands = psd->GetSpectrumModel ()->GetNumBands ();
 
-  //channel[rx][tx][cluster]
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
+  // the direction of each cluster only depends on the channel matrix
+  if (longTerm->m_uDirection.size () != numCluster)
+    {
+      longTerm->m_sDirection.clear ();
+      longTerm->m_uDirection.clear ();
+      for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+          //cluster angle angle[direction][n],where, direction = 0(aoa), 1(zoa).
+          double zoa = params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180;
+          double aoa = params->m_angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180;
+          double zod = params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180;
+          double aod = params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180;
+          longTerm->m_uDirection.push_back (Vector (sin (zoa) * cos (aoa), sin (zoa) * sin (aoa), cos (zoa)));
+          longTerm->m_sDirection.push_back (Vector (sin (zod) * cos (aod), sin (zod) * sin (aod), cos (zod)));
+        }
+    }
+
+  // the phase shift due to the delay of each cluster only depends on the
+  // channel matrix and on the center frequencies of the bands
+  if (longTerm->m_delayModelUid != psd->GetSpectrumModelUid ())
+    {
+      longTerm->m_delayPhasors.resize (numCluster * numBands);
+      for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+          auto sbit = psd->ConstBandsBegin (); // band iterator
+          for (size_t bIndex = 0; bIndex < numBands; bIndex++, sbit++)
+            {
+              double fsb = (*sbit).fc; // center frequency of the sub-band
+              double delay = -2 * M_PI * fsb * (params->m_delay[cIndex]);
+              longTerm->m_delayPhasors[cIndex * numBands + bIndex] = exp (std::complex<double> (0, delay));
+            }
+        }
+      longTerm->m_delayModelUid = psd->GetSpectrumModelUid ();
+    }
 
-  // compute the doppler term
+  // compute the doppler term and apply it to the long term component
   // NOTE the update of Doppler is simplified by only taking the center angle of
   // each cluster in to consideration.
   double slotTime = Simulator::Now ().GetSeconds ();
-  ThreeGppAntennaArrayModel::ComplexVector doppler;
-  for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+  double frequency = GetFrequency ();
+  ThreeGppAntennaArrayModel::ComplexVector clusterGain;
+  clusterGain.reserve (numCluster);
+  for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
-      //cluster angle angle[direction][n],where, direction = 0(aoa), 1(zoa).
       // TODO should I include the "alfa" term for the Doppler of delayed paths?
-      double temp_doppler = 2 * M_PI * ((sin (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * cos (params->m_angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180) * uSpeed.x
-                                         + sin (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * sin (params->m_angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180) * uSpeed.y
-                                         + cos (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * uSpeed.z)
-                                         + (sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * cos (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.x
-                                         + sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sin (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.y
-                                         + cos (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sSpeed.z))
-        * slotTime * GetFrequency () / 3e8;
-      doppler.push_back (exp (std::complex<double> (0, temp_doppler)));
+      const Vector &uDir = longTerm->m_uDirection[cIndex];
+      const Vector &sDir = longTerm->m_sDirection[cIndex];
+      double temp_doppler = 2 * M_PI * ((uDir.x * uSpeed.x + uDir.y * uSpeed.y + uDir.z * uSpeed.z)
+                                        + (sDir.x * sSpeed.x + sDir.y * sSpeed.y + sDir.z * sSpeed.z))
+        * slotTime * frequency / 3e8;
+      clusterGain.push_back (longTerm->m_longTerm[cIndex] * exp (std::complex<double> (0, temp_doppler)));
     }
 
-  // apply the doppler term and the propagation delay to the long term component
-  // to obtain the beamforming gain
-  auto vit = tempPsd->ValuesBegin (); // psd iterator
-  auto sbit = tempPsd->ConstBandsBegin(); // band iterator
-  while (vit != tempPsd->ValuesEnd ())
+  // apply the propagation delay to obtain the beamforming gain of all the
+  // sub-bands, as the product between the matrix of the delay phase shifts
+  // and the vector of the cluster gains
+  ThreeGppAntennaArrayModel::ComplexVector subbandGain (numBands);
+  for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+      ComplexAxpy (numBands, clusterGain[cIndex], &longTerm->m_delayPhasors[cIndex * numBands], subbandGain.data ());
+    }
+
+  auto vit = psd->ValuesBegin (); // psd iterator
+  for (size_t bIndex = 0; bIndex < numBands; bIndex++, vit++)
     {
-      std::complex<double> subsbandGain (0.0,0.0);
       if ((*vit) != 0.00)
         {
-          double fsb = (*sbit).fc; // center frequency of the sub-band
-          for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
-            {
-              double delay = -2 * M_PI * fsb * (params->m_delay[cIndex]);
-              subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] * exp (std::complex<double> (0, delay));
-            }
-          *vit = (*vit) * (norm (subsbandGain));
+          *vit = (*vit) * (norm (subbandGain[bIndex]));
         }
-      vit++;
-      sbit++;
     }
-  return tempPsd;
+  return psd;
 }
 
-ThreeGppAntennaArrayModel::ComplexVector
+Ptr<ThreeGppSpectrumPropagationLossModel::LongTerm>
 ThreeGppSpectrumPropagationLossModel::GetLongTerm (uint32_t aId, uint32_t bId,
                                                    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                                   const ThreeGppAntennaArrayModel::ComplexVector &aW,
-                                                   const ThreeGppAntennaArrayModel::ComplexVector &bW) const
+                                                   Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                                   Ptr<const ThreeGppAntennaArrayModel> bAntenna) const
 {
-  ThreeGppAntennaArrayModel::ComplexVector longTerm; // vector containing the long term component for each cluster
-
   // check if the channel matrix was generated considering a as the s-node and
   // b as the u-node or viceversa
-  ThreeGppAntennaArrayModel::ComplexVector sW, uW;
-  if (!channelMatrix->IsReverse (aId, bId))
+  Ptr<const ThreeGppAntennaArrayModel> sAntenna = aAntenna;
+  Ptr<const ThreeGppAntennaArrayModel> uAntenna = bAntenna;
+  if (channelMatrix->IsReverse (aId, bId))
   {
-    sW = aW;
-    uW = bW;
-  }
-  else
-  {
-    sW = bW;
-    uW = aW;
+    sAntenna = bAntenna;
+    uAntenna = aAntenna;
   }
+  uint64_t sWHash = sAntenna->GetBeamformingVectorHash ();
+  uint64_t uWHash = uAntenna->GetBeamformingVectorHash ();
 
   // compute the long term key, the key is unique for each tx-rx pair
   uint32_t x1 = std::min (aId, bId);
   uint32_t x2 = std::max (aId, bId);
   uint32_t longTermId = MatrixBasedChannelModel::GetKey (x1, x2);
 
-  bool update = false; // indicates whether the long term has to be updated
-  bool notFound = false; // indicates if the long term has not been computed yet
-
   // look for the long term in the map and check if it is valid
-  if (m_longTermMap.find (longTermId) != m_longTermMap.end ())
+  Ptr<LongTerm> &longTerm = m_longTermMap[longTermId];
+  if (longTerm)
   {
     NS_LOG_DEBUG ("found the long term component in the map");
-    longTerm = m_longTermMap[longTermId]->m_longTerm;
 
     // check if the channel matrix has been updated
     // or the s beam has been changed
     // or the u beam has been changed
-    update = (m_longTermMap[longTermId]->m_channel->m_generatedTime != channelMatrix->m_generatedTime
-              || m_longTermMap[longTermId]->m_sW != sW
-              || m_longTermMap[longTermId]->m_uW != uW);
-
+    if (longTerm->m_channel->m_generatedTime == channelMatrix->m_generatedTime
+        && longTerm->m_sWHash == sWHash
+        && longTerm->m_uWHash == uWHash)
+      {
+        return longTerm;
+      }
   }
   else
   {
     NS_LOG_DEBUG ("long term component NOT found");
-    notFound = true;
   }
 
-  if (update || notFound)
+  if (!longTerm || longTerm->m_channel->m_generatedTime != channelMatrix->m_generatedTime)
     {
-      NS_LOG_DEBUG ("compute the long term");
-      // compute the long term component
-      longTerm = CalcLongTerm (channelMatrix, sW, uW);
-
-      // store the long term
-      Ptr<LongTerm> longTermItem = Create<LongTerm> ();
-      longTermItem->m_longTerm = longTerm;
-      longTermItem->m_channel = channelMatrix;
-      longTermItem->m_sW = sW;
-      longTermItem->m_uW = uW;
-
-      m_longTermMap[longTermId] = longTermItem;
+      // the terms depending on the channel matrix have to be computed again
+      longTerm = Create<LongTerm> ();
+      longTerm->m_channel = channelMatrix;
+      longTerm->m_delayModelUid = 0;
     }
 
+  NS_LOG_DEBUG ("compute the long term");
+  longTerm->m_longTerm = CalcLongTerm (channelMatrix, sAntenna->GetBeamformingVector (), uAntenna->GetBeamformingVector ());
+  longTerm->m_sWHash = sWHash;
+  longTerm->m_uWHash = uWHash;
   return longTerm;
 }
 
@@ -302,12 +350,8 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
 
   Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = m_channelModel->GetChannel (a, b, aAntenna, bAntenna);
 
-  // get the precoding and combining vectors
-  ThreeGppAntennaArrayModel::ComplexVector aW = aAntenna->GetBeamformingVector ();
-  ThreeGppAntennaArrayModel::ComplexVector bW = bAntenna->GetBeamformingVector ();
-
   // retrieve the long term component
-  ThreeGppAntennaArrayModel::ComplexVector longTerm = GetLongTerm (aId, bId, channelMatrix, aW, bW);
+  Ptr<LongTerm> longTerm = GetLongTerm (aId, bId, channelMatrix, aAntenna, bAntenna);
 
   // apply the beamforming gain
   rxPsd = CalcBeamformingGain (rxPsd, longTerm, channelMatrix, a->GetVelocity (), b->GetVelocity ());
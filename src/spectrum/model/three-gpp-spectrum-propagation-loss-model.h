@@ -131,14 +131,20 @@ public:
 
 private:
   /**
-   * Data structure that stores the long term component for a tx-rx pair
+   * Data structure that stores the long term component for a tx-rx pair,
+   * together with the terms of the beamforming gain which only depend on
+   * the channel matrix
    */
   struct LongTerm : public SimpleRefCount<LongTerm>
   {
     ThreeGppAntennaArrayModel::ComplexVector m_longTerm; //!< vector containing the long term component for each cluster
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel; //!< pointer to the channel matrix used to compute the long term
-    ThreeGppAntennaArrayModel::ComplexVector m_sW; //!< the beamforming vector for the node s used to compute the long term
-    ThreeGppAntennaArrayModel::ComplexVector m_uW; //!< the beamforming vector for the node u used to compute the long term
+    uint64_t m_sWHash; //!< the hash of the beamforming vector for the node s used to compute the long term
+    uint64_t m_uWHash; //!< the hash of the beamforming vector for the node u used to compute the long term
+    std::vector<Vector> m_sDirection; //!< the unit vector pointing to the departure direction of each cluster
+    std::vector<Vector> m_uDirection; //!< the unit vector pointing to the arrival direction of each cluster
+    SpectrumModelUid_t m_delayModelUid; //!< the uid of the spectrum model m_delayPhasors refers to, 0 if none
+    ThreeGppAntennaArrayModel::ComplexVector m_delayPhasors; //!< the phase shift due to the delay of each cluster n at the center frequency of each band b, stored at n * numBands + b
   };
 
   /**
@@ -149,21 +155,24 @@ private:
 
   /**
    * Looks for the long term component in m_longTermMap. If found, checks
-   * whether it has to be updated. If not found or if it has to be updated,
-   * calls the method CalcLongTerm to compute it.
+   * whether it has to be updated, i.e., whether the channel matrix was
+   * generated again or the hash of a beamforming vector changed. If not found
+   * or if it has to be updated, calls the method CalcLongTerm to compute it.
    * \param aId id of the first node
    * \param bId id of the second node
    * \param channelMatrix the channel matrix
-   * \param aW the beamforming vector of the first device
-   * \param bW the beamforming vector of the second device
-   * \return vector containing the long term compoenent for each cluster
+   * \param aAntenna the antenna array of the first device
+   * \param bAntenna the antenna array of the second device
+   * \return the long term component for each cluster
    */
-  ThreeGppAntennaArrayModel::ComplexVector GetLongTerm (uint32_t aId, uint32_t bId,
-                                                        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                                        const ThreeGppAntennaArrayModel::ComplexVector &aW,
-                                                        const ThreeGppAntennaArrayModel::ComplexVector &bW) const;
+  Ptr<LongTerm> GetLongTerm (uint32_t aId, uint32_t bId,
+                             Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                             Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                             Ptr<const ThreeGppAntennaArrayModel> bAntenna) const;
   /**
-   * Computes the long term component
+   * Computes the long term component, i.e., uW^T H_n sW for each cluster n.
+   * The product is batched over the clusters, whose coefficients are
+   * contiguous in the channel matrix.
    * \param channelMatrix the channel matrix H
    * \param sW the beamforming vector of the s device
    * \param uW the beamforming vector of the u device
@@ -174,21 +183,24 @@ private:
                                                          const ThreeGppAntennaArrayModel::ComplexVector &uW) const;
 
   /**
-   * Computes the beamforming gain and applies it to the tx PSD
-   * \param txPsd the tx PSD
+   * Computes the beamforming gain and applies it to the PSD. The phase
+   * shifts due to the cluster delays are computed once per channel matrix
+   * and spectrum model, and the gain of all the bands is then obtained as a
+   * matrix-vector product.
+   * \param psd the tx PSD, which is turned into the rx PSD in place
    * \param longTerm the long term component
    * \param params The channel matrix
    * \param sSpeed speed of the first node
    * \param uSpeed speed of the second node
    * \return the rx PSD
    */
-  Ptr<SpectrumValue> CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                          ThreeGppAntennaArrayModel::ComplexVector longTerm,
+  Ptr<SpectrumValue> CalcBeamformingGain (Ptr<SpectrumValue> psd,
+                                          Ptr<LongTerm> longTerm,
                                           Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
                                           const Vector &sSpeed, const Vector &uSpeed) const;
 
   std::unordered_map <uint32_t, Ptr<const ThreeGppAntennaArrayModel> > m_deviceAntennaMap; //!< map containig the <node, antenna> associations
-  mutable std::unordered_map < uint32_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable std::unordered_map < uint32_t, Ptr<LongTerm> > m_longTermMap; //!< map containing the long term components
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
@@ -223,6 +223,18 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv9b, v9, "tv9b =  doubleValue * v1"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div v1"), TestCase::QUICK);
 
+  SpectrumValue tv3c (f), tv9c (f);
+  tv3c = v1;
+  tv3c.AddScaled (v2, 1);
+  tv9c.AddScaled (v1, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv3c, v3, "tv3c = v1, tv3c.AddScaled (v2, 1)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv9c, v9, "tv9c = 0, tv9c.AddScaled (v1, doubleValue)"), TestCase::QUICK);
+
+  SpectrumValue integral (f), tvIntegral (f);
+  integral = Integral (v1 * v2);
+  tvIntegral = Integral (v1, v2);
+  AddTestCase (new SpectrumValueTestCase (tvIntegral, integral, "Integral (v1, v2) = Integral (v1 * v2)"), TestCase::QUICK);
+
 
 
 
@@ -27,6 +27,7 @@
 #include "ns3/pointer.h"
 #include "ns3/node-container.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/three-gpp-antenna-array-model.h"
 #include "ns3/three-gpp-channel-model.h"
 #include "ns3/simple-net-device.h"
@@ -34,6 +35,7 @@
 #include "ns3/channel-condition-model.h"
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/wifi-spectrum-value-helper.h"
+#include <algorithm>
 
 using namespace ns3;
 
@@ -94,7 +96,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   double channelNorm = 0;
-  uint8_t numTotClusters = channelMatrix->m_channel.at (0).at (0).size ();
+  uint8_t numTotClusters = channelMatrix->m_channel.GetNumPages ();
   for (uint8_t cIndex = 0; cIndex < numTotClusters; cIndex++)
   {
     double clusterNorm = 0;
@@ -102,7 +104,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
     {
       for (uint32_t uIndex = 0; uIndex < rxAntennaElements; uIndex++)
       {
-        clusterNorm += std::pow (std::abs (channelMatrix->m_channel.at (uIndex).at (sIndex).at (cIndex)), 2);
+        clusterNorm += std::pow (std::abs (channelMatrix->m_channel (uIndex, sIndex, cIndex)), 2);
       }
     }
     channelNorm += clusterNorm;
@@ -160,8 +162,8 @@ ThreeGppChannelMatrixComputationTest::DoRun (void)
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   // check the channel matrix dimensions
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.at (0).size (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.size (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumCols (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumRows (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
 
   // test if the channel matrix is correctly generated
   uint16_t numIt = 1000;
@@ -333,6 +335,166 @@ ThreeGppChannelMatrixUpdateTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Test case for the channel bank of the ThreeGppChannelModel class.
+ * 1) checks if the channels of all the links whose update period has expired
+ *    are generated together
+ * 2) checks if the realizations depend neither on the number of threads nor
+ *    on the order in which the links are requested
+ */
+class ThreeGppChannelBankTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppChannelBankTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppChannelBankTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Request the channels of the links between the first node and the others
+   * \param channelModel the ThreeGppChannelModel object
+   * \param order the indices of the other nodes, in the order of the requests
+   */
+  void DoGetChannels (Ptr<ThreeGppChannelModel> channelModel, std::vector<uint32_t> order);
+
+  /**
+   * Check the generation time of the channels and compare the channels of
+   * two models
+   * \param firstModel the first ThreeGppChannelModel object
+   * \param secondModel the second ThreeGppChannelModel object
+   * \param generationTime the expected generation time of all the channels
+   */
+  void DoCheckChannels (Ptr<ThreeGppChannelModel> firstModel, Ptr<ThreeGppChannelModel> secondModel, Time generationTime);
+
+  std::vector<Ptr<MobilityModel> > m_mobs; //!< the mobility models of the nodes
+  Ptr<ThreeGppAntennaArrayModel> m_bsAntenna; //!< the antenna of the first node
+  Ptr<ThreeGppAntennaArrayModel> m_utAntenna; //!< the antenna of the other nodes
+};
+
+ThreeGppChannelBankTest::ThreeGppChannelBankTest ()
+  : TestCase ("Check the channel bank of the ThreeGppChannelModel")
+{
+}
+
+ThreeGppChannelBankTest::~ThreeGppChannelBankTest ()
+{
+}
+
+void
+ThreeGppChannelBankTest::DoGetChannels (Ptr<ThreeGppChannelModel> channelModel, std::vector<uint32_t> order)
+{
+  for (uint32_t i : order)
+    {
+      channelModel->GetChannel (m_mobs[0], m_mobs[i], m_bsAntenna, m_utAntenna);
+    }
+}
+
+void
+ThreeGppChannelBankTest::DoCheckChannels (Ptr<ThreeGppChannelModel> firstModel, Ptr<ThreeGppChannelModel> secondModel, Time generationTime)
+{
+  for (uint32_t i = 1; i < m_mobs.size (); i++)
+    {
+      Ptr<const ThreeGppChannelModel::ChannelMatrix> first = firstModel->GetChannel (m_mobs[0], m_mobs[i], m_bsAntenna, m_utAntenna);
+      Ptr<const ThreeGppChannelModel::ChannelMatrix> second = secondModel->GetChannel (m_mobs[0], m_mobs[i], m_bsAntenna, m_utAntenna);
+      NS_TEST_ASSERT_MSG_EQ (first->m_generatedTime, generationTime, "The channel of link " << i << " was not generated with the others");
+      NS_TEST_ASSERT_MSG_EQ (second->m_generatedTime, generationTime, "The channel of link " << i << " was not generated with the others");
+
+      NS_TEST_ASSERT_MSG_EQ (first->m_channel.GetNumPages (), second->m_channel.GetNumPages (), "Different number of clusters for link " << i);
+      NS_TEST_ASSERT_MSG_EQ ((first->m_delay == second->m_delay), true, "Different delays for link " << i);
+      bool equal = true;
+      for (uint64_t uIndex = 0; uIndex < m_utAntenna->GetNumberOfElements (); uIndex++)
+        {
+          for (uint64_t sIndex = 0; sIndex < m_bsAntenna->GetNumberOfElements (); sIndex++)
+            {
+              for (uint64_t cIndex = 0; cIndex < first->m_channel.GetNumPages (); cIndex++)
+                {
+                  equal = equal && (first->m_channel (uIndex, sIndex, cIndex) == second->m_channel (uIndex, sIndex, cIndex));
+                }
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (equal, true, "Different channel matrices for link " << i);
+    }
+}
+
+void
+ThreeGppChannelBankTest::DoRun (void)
+{
+  // Build the scenario for the test
+  uint32_t numUts = 6;
+  uint32_t updatePeriodMs = 100; // update period in ms
+
+  // create the nodes and their mobility models, the first node is the BS
+  NodeContainer nodes;
+  nodes.Create (numUts + 1);
+  for (uint32_t i = 0; i <= numUts; i++)
+    {
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      if (i == 0)
+        {
+          mob->SetPosition (Vector (0.0, 0.0, 25.0));
+        }
+      else
+        {
+          mob->SetPosition (Vector (30.0 * i, 100.0 - 20.0 * i, 1.5));
+        }
+      nodes.Get (i)->AggregateObject (mob);
+      m_mobs.push_back (mob);
+    }
+
+  m_bsAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (4), "NumRows", UintegerValue (2));
+  m_utAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (2), "NumRows", UintegerValue (2), "IsotropicElements", BooleanValue (true));
+
+  // create two channel models using different numbers of threads
+  std::vector<Ptr<ThreeGppChannelModel> > channelModels;
+  for (uint32_t numThreads : {1, 4})
+    {
+      Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+      channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+      channelModel->SetAttribute ("Scenario", StringValue ("UMa"));
+      channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+      channelModel->SetAttribute ("UpdatePeriod", TimeValue (MilliSeconds (updatePeriodMs)));
+      channelModel->SetAttribute ("PrecomputeChannels", BooleanValue (true));
+      channelModel->SetAttribute ("NumThreads", UintegerValue (numThreads));
+      NS_TEST_ASSERT_MSG_EQ (channelModel->AssignStreams (1), 3, "The channel bank uses a third stream");
+      channelModels.push_back (channelModel);
+    }
+
+  // request the links in opposite orders
+  std::vector<uint32_t> order;
+  for (uint32_t i = 1; i <= numUts; i++)
+    {
+      order.push_back (i);
+    }
+  Simulator::Schedule (MilliSeconds (1), &ThreeGppChannelBankTest::DoGetChannels, this, channelModels[0], order);
+  std::reverse (order.begin (), order.end ());
+  Simulator::Schedule (MilliSeconds (1), &ThreeGppChannelBankTest::DoGetChannels, this, channelModels[1], order);
+  Simulator::Schedule (MilliSeconds (2), &ThreeGppChannelBankTest::DoCheckChannels, this, channelModels[0], channelModels[1], MilliSeconds (1));
+
+  // once the update period has expired, requesting a single link updates
+  // all of them
+  Simulator::Schedule (MilliSeconds (updatePeriodMs + 10), &ThreeGppChannelBankTest::DoGetChannels, this, channelModels[0], std::vector<uint32_t> {1});
+  Simulator::Schedule (MilliSeconds (updatePeriodMs + 10), &ThreeGppChannelBankTest::DoGetChannels, this, channelModels[1], std::vector<uint32_t> {numUts});
+  Simulator::Schedule (MilliSeconds (updatePeriodMs + 20), &ThreeGppChannelBankTest::DoCheckChannels, this, channelModels[0], channelModels[1], MilliSeconds (updatePeriodMs + 10));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_mobs.clear ();
+  m_bsAntenna = 0;
+  m_utAntenna = 0;
+}
+
 /**
  * Test case for the ThreeGppSpectrumPropagationLossModelTest class.
  * 1) checks if the long term components for the direct and the reverse link
@@ -543,6 +705,207 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * Test case for the beamforming gain computed by the
+ * ThreeGppSpectrumPropagationLossModel class.
+ * 1) checks that the rx PSD of a moving node equals the one computed from
+ *    the channel matrix with a straightforward implementation of the model
+ * 2) checks that going back to a previous beamforming vector gives back the
+ *    previous rx PSD
+ */
+class ThreeGppBeamformingGainTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppBeamformingGainTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppBeamformingGainTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Compute the rx PSD and compare it with the reference one
+   */
+  void DoCheckGain (void);
+
+  /**
+   * Compute the rx PSD as the squared module of
+   * sum_n (uW^T H_n sW) exp (j 2 pi f_d,n t) exp (-j 2 pi f tau_n)
+   * \param channel the channel matrix
+   * \return the rx PSD
+   */
+  Ptr<SpectrumValue> CalcReferenceRxPsd (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel) const;
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> m_lossModel; //!< the loss model under test
+  Ptr<SpectrumValue> m_txPsd; //!< the tx PSD
+  Ptr<MobilityModel> m_txMob; //!< the mobility model of the tx device
+  Ptr<MobilityModel> m_rxMob; //!< the mobility model of the rx device
+  Ptr<ThreeGppAntennaArrayModel> m_txAntenna; //!< the antenna of the tx device
+  Ptr<ThreeGppAntennaArrayModel> m_rxAntenna; //!< the antenna of the rx device
+};
+
+ThreeGppBeamformingGainTest::ThreeGppBeamformingGainTest ()
+  : TestCase ("Check the beamforming gain computed by the ThreeGppSpectrumPropagationLossModel")
+{
+}
+
+ThreeGppBeamformingGainTest::~ThreeGppBeamformingGainTest ()
+{
+}
+
+Ptr<SpectrumValue>
+ThreeGppBeamformingGainTest::CalcReferenceRxPsd (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel) const
+{
+  uint32_t txId = m_txMob->GetObject<Node> ()->GetId ();
+  uint32_t rxId = m_rxMob->GetObject<Node> ()->GetId ();
+  bool reverse = channel->IsReverse (txId, rxId);
+  const ThreeGppAntennaArrayModel::ComplexVector &sW = reverse ? m_rxAntenna->GetBeamformingVector () : m_txAntenna->GetBeamformingVector ();
+  const ThreeGppAntennaArrayModel::ComplexVector &uW = reverse ? m_txAntenna->GetBeamformingVector () : m_rxAntenna->GetBeamformingVector ();
+  // the loss model applies the speed of the tx node to the departure angles
+  Vector sSpeed = m_txMob->GetVelocity ();
+  Vector uSpeed = m_rxMob->GetVelocity ();
+  double t = Simulator::Now ().GetSeconds ();
+  double frequency = 28.0e9;
+
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (m_txPsd);
+  auto band = rxPsd->ConstBandsBegin ();
+  for (auto value = rxPsd->ValuesBegin (); value != rxPsd->ValuesEnd (); value++, band++)
+    {
+      std::complex<double> gain (0.0, 0.0);
+      for (size_t n = 0; n < channel->m_channel.GetNumPages (); n++)
+        {
+          std::complex<double> longTerm (0.0, 0.0);
+          for (size_t u = 0; u < uW.size (); u++)
+            {
+              for (size_t s = 0; s < sW.size (); s++)
+                {
+                  longTerm += uW[u] * channel->m_channel (u, s, n) * sW[s];
+                }
+            }
+          double zoa = channel->m_angle[MatrixBasedChannelModel::ZOA_INDEX][n] * M_PI / 180;
+          double aoa = channel->m_angle[MatrixBasedChannelModel::AOA_INDEX][n] * M_PI / 180;
+          double zod = channel->m_angle[MatrixBasedChannelModel::ZOD_INDEX][n] * M_PI / 180;
+          double aod = channel->m_angle[MatrixBasedChannelModel::AOD_INDEX][n] * M_PI / 180;
+          Vector rxDir (sin (zoa) * cos (aoa), sin (zoa) * sin (aoa), cos (zoa));
+          Vector txDir (sin (zod) * cos (aod), sin (zod) * sin (aod), cos (zod));
+          double doppler = (rxDir.x * uSpeed.x + rxDir.y * uSpeed.y + rxDir.z * uSpeed.z
+                            + txDir.x * sSpeed.x + txDir.y * sSpeed.y + txDir.z * sSpeed.z) * frequency / 3e8;
+          gain += longTerm * std::polar (1.0, 2 * M_PI * doppler * t) * std::polar (1.0, -2 * M_PI * band->fc * channel->m_delay[n]);
+        }
+      *value *= std::norm (gain);
+    }
+  return rxPsd;
+}
+
+void
+ThreeGppBeamformingGainTest::DoCheckGain (void)
+{
+  Ptr<SpectrumValue> rxPsd = m_lossModel->DoCalcRxPowerSpectralDensity (m_txPsd, m_txMob, m_rxMob);
+  Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel = m_lossModel->GetChannelModel ()->GetChannel (m_txMob, m_rxMob, m_txAntenna, m_rxAntenna);
+  Ptr<SpectrumValue> refPsd = CalcReferenceRxPsd (channel);
+
+  for (uint32_t i = 0; i < rxPsd->GetSpectrumModel ()->GetNumBands (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*rxPsd)[i], (*refPsd)[i], 1e-9 * (*refPsd)[i], "Wrong rx PSD in band " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ ((*rxPsd)[3], 0.0, "A band which is not used has non-zero power");
+
+  // switch to another beam and back
+  ThreeGppAntennaArrayModel::ComplexVector txW = m_txAntenna->GetBeamformingVector ();
+  ThreeGppAntennaArrayModel::ComplexVector otherW = txW;
+  std::reverse (otherW.begin (), otherW.end ());
+  m_txAntenna->SetBeamformingVector (otherW);
+  Ptr<SpectrumValue> otherPsd = m_lossModel->DoCalcRxPowerSpectralDensity (m_txPsd, m_txMob, m_rxMob);
+  NS_TEST_ASSERT_MSG_EQ (std::equal (otherPsd->ConstValuesBegin (), otherPsd->ConstValuesEnd (), rxPsd->ConstValuesBegin ()), false, "The rx PSD did not change with the beam");
+  refPsd = CalcReferenceRxPsd (channel);
+  for (uint32_t i = 0; i < otherPsd->GetSpectrumModel ()->GetNumBands (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*otherPsd)[i], (*refPsd)[i], 1e-9 * (*refPsd)[i], "Wrong rx PSD in band " << i << " with the other beam");
+    }
+
+  m_txAntenna->SetBeamformingVector (txW);
+  otherPsd = m_lossModel->DoCalcRxPowerSpectralDensity (m_txPsd, m_txMob, m_rxMob);
+  NS_TEST_ASSERT_MSG_EQ (std::equal (otherPsd->ConstValuesBegin (), otherPsd->ConstValuesEnd (), rxPsd->ConstValuesBegin ()), true, "The rx PSD changed going back to the previous beam");
+}
+
+void
+ThreeGppBeamformingGainTest::DoRun (void)
+{
+  // Build the scenario for the test
+  m_lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  m_lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (28.0e9));
+  m_lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMa"));
+  m_lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  m_lossModel->SetChannelModelAttribute ("UpdatePeriod", TimeValue (MilliSeconds (0)));
+
+  // create the tx and rx nodes, the rx node is moving
+  NodeContainer nodes;
+  nodes.Create (2);
+  m_txMob = CreateObject<ConstantPositionMobilityModel> ();
+  m_txMob->SetPosition (Vector (0.0, 0.0, 25.0));
+  Ptr<ConstantVelocityMobilityModel> rxMob = CreateObject<ConstantVelocityMobilityModel> ();
+  rxMob->SetPosition (Vector (60.0, 20.0, 1.5));
+  rxMob->SetVelocity (Vector (10.0, -5.0, 0.0));
+  m_rxMob = rxMob;
+  nodes.Get (0)->AggregateObject (m_txMob);
+  nodes.Get (1)->AggregateObject (m_rxMob);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  nodes.Get (0)->AddDevice (txDev);
+  txDev->SetNode (nodes.Get (0));
+  nodes.Get (1)->AddDevice (rxDev);
+  rxDev->SetNode (nodes.Get (1));
+
+  // a 64 element array at the tx node and a 16 element array at the rx node
+  m_txAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (8), "NumRows", UintegerValue (8));
+  m_rxAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (4), "NumRows", UintegerValue (4));
+  m_lossModel->AddDevice (txDev, m_txAntenna);
+  m_lossModel->AddDevice (rxDev, m_rxAntenna);
+
+  // use beamforming vectors whose elements have different phases
+  for (Ptr<ThreeGppAntennaArrayModel> antenna : {m_txAntenna, m_rxAntenna})
+    {
+      ThreeGppAntennaArrayModel::ComplexVector w;
+      uint64_t numElements = antenna->GetNumberOfElements ();
+      for (uint64_t i = 0; i < numElements; i++)
+        {
+          w.push_back (std::polar (1 / sqrt (numElements), 0.3 * i * i));
+        }
+      antenna->SetBeamformingVector (w);
+    }
+
+  // a tx PSD made of 20 bands around the carrier frequency, one of which
+  // is not used
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      freqs.push_back (28.0e9 + (i - 10.0) * 180e3);
+    }
+  m_txPsd = Create<SpectrumValue> (Create<SpectrumModel> (freqs));
+  (*m_txPsd) = 1e-6;
+  (*m_txPsd)[3] = 0.0;
+
+  Simulator::Schedule (MilliSeconds (5), &ThreeGppBeamformingGainTest::DoCheckGain, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_lossModel = 0;
+  m_txMob = 0;
+  m_rxMob = 0;
+  m_txAntenna = 0;
+  m_rxAntenna = 0;
+}
+
 /**
  * \ingroup spectrum
  *
@@ -562,7 +925,9 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
 {
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppChannelBankTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppBeamformingGainTest, TestCase::QUICK);
 }
 
 static ThreeGppChannelTestSuite myTestSuite;
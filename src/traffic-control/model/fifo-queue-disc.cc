@@ -149,4 +149,10 @@ FifoQueueDisc::InitializeParams (void)
   NS_LOG_FUNCTION (this);
 }
 
+bool
+FifoQueueDisc::CanBypass (void) const
+{
+  return true;
+}
+
 } // namespace ns3
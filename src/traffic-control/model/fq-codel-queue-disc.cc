@@ -106,6 +106,8 @@ FqCoDelFlow::GetIndex (void) const
 
 NS_OBJECT_ENSURE_REGISTERED (FqCoDelQueueDisc);
 
+const uint32_t FqCoDelQueueDisc::NO_FLOW;
+
 TypeId FqCoDelQueueDisc::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::FqCoDelQueueDisc")
@@ -172,6 +174,8 @@ FqCoDelQueueDisc::FqCoDelQueueDisc ()
     m_quantum (0)
 {
   NS_LOG_FUNCTION (this);
+  m_newFlows.head = m_newFlows.tail = NO_FLOW;
+  m_oldFlows.head = m_oldFlows.tail = NO_FLOW;
 }
 
 FqCoDelQueueDisc::~FqCoDelQueueDisc ()
@@ -203,24 +207,57 @@ FqCoDelQueueDisc::SetAssociativeHash (uint32_t flowHash)
 
   for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-      auto it = m_flowsIndices.find (i);
+      FlowSlot &slot = m_flowTable[i];
 
-      if (it == m_flowsIndices.end ()
-          || (m_tags.find (i) != m_tags.end () && m_tags[i] == flowHash)
-          || StaticCast<FqCoDelFlow> (GetQueueDiscClass (it->second))->GetStatus () == FqCoDelFlow::INACTIVE)
+      if (!slot.flow
+          || slot.tag == flowHash
+          || slot.flow->GetStatus () == FqCoDelFlow::INACTIVE)
         {
           // this queue has not been created yet or is associated with this flow
           // or is inactive, hence we can use it
-          m_tags[i] = flowHash;
+          slot.tag = flowHash;
           return i;
         }
     }
 
   // all the queues of the set are used. Use the first queue of the set
-  m_tags[outerHash] = flowHash;
+  m_flowTable[outerHash].tag = flowHash;
   return outerHash;
 }
 
+void
+FqCoDelQueueDisc::PushBack (FlowList &list, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+
+  m_flowTable[index].next = NO_FLOW;
+  if (list.tail == NO_FLOW)
+    {
+      list.head = index;
+    }
+  else
+    {
+      m_flowTable[list.tail].next = index;
+    }
+  list.tail = index;
+}
+
+uint32_t
+FqCoDelQueueDisc::PopFront (FlowList &list)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (list.head != NO_FLOW);
+
+  uint32_t index = list.head;
+  list.head = m_flowTable[index].next;
+  if (list.head == NO_FLOW)
+    {
+      list.tail = NO_FLOW;
+    }
+  m_flowTable[index].next = NO_FLOW;
+  return index;
+}
+
 bool
 FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
@@ -257,11 +294,11 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       h = flowHash % m_flows;
     }
 
-  Ptr<FqCoDelFlow> flow;
-  if (m_flowsIndices.find (h) == m_flowsIndices.end ())
+  FlowSlot &slot = m_flowTable[h];
+  if (!slot.flow)
     {
       NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
-      flow = m_flowFactory.Create<FqCoDelFlow> ();
+      Ptr<FqCoDelFlow> flow = m_flowFactory.Create<FqCoDelFlow> ();
       Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc> ();
       // If CoDel, Set values of CoDelQueueDisc to match this QueueDisc
       Ptr<CoDelQueueDisc> codel = qd->GetObject<CoDelQueueDisc> ();
@@ -275,23 +312,21 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       flow->SetIndex (h);
       AddQueueDiscClass (flow);
 
-      m_flowsIndices[h] = GetNQueueDiscClasses () - 1;
-    }
-  else
-    {
-      flow = StaticCast<FqCoDelFlow> (GetQueueDiscClass (m_flowsIndices[h]));
+      slot.flow = flow;
     }
 
+  FqCoDelFlow *flow = PeekPointer (slot.flow);
+
   if (flow->GetStatus () == FqCoDelFlow::INACTIVE)
     {
       flow->SetStatus (FqCoDelFlow::NEW_FLOW);
       flow->SetDeficit (m_quantum);
-      m_newFlows.push_back (flow);
+      PushBack (m_newFlows, h);
     }
 
   flow->GetQueueDisc ()->Enqueue (item);
 
-  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
 
   if (GetCurrentSize () > GetMaxSize ())
     {
@@ -307,24 +342,23 @@ FqCoDelQueueDisc::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<FqCoDelFlow> flow;
+  FqCoDelFlow *flow = 0;
   Ptr<QueueDiscItem> item;
 
   do
     {
       bool found = false;
 
-      while (!found && !m_newFlows.empty ())
+      while (!found && m_newFlows.head != NO_FLOW)
         {
-          flow = m_newFlows.front ();
+          flow = PeekPointer (m_flowTable[m_newFlows.head].flow);
 
           if (flow->GetDeficit () <= 0)
             {
               NS_LOG_DEBUG ("Increase deficit for new flow index " << flow->GetIndex ());
               flow->IncreaseDeficit (m_quantum);
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              PushBack (m_oldFlows, PopFront (m_newFlows));
             }
           else
             {
@@ -333,16 +367,15 @@ FqCoDelQueueDisc::DoDequeue (void)
             }
         }
 
-      while (!found && !m_oldFlows.empty ())
+      while (!found && m_oldFlows.head != NO_FLOW)
         {
-          flow = m_oldFlows.front ();
+          flow = PeekPointer (m_flowTable[m_oldFlows.head].flow);
 
           if (flow->GetDeficit () <= 0)
             {
               NS_LOG_DEBUG ("Increase deficit for old flow index " << flow->GetIndex ());
               flow->IncreaseDeficit (m_quantum);
-              m_oldFlows.push_back (flow);
-              m_oldFlows.pop_front ();
+              PushBack (m_oldFlows, PopFront (m_oldFlows));
             }
           else
             {
@@ -362,16 +395,15 @@ FqCoDelQueueDisc::DoDequeue (void)
       if (!item)
         {
           NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
-          if (!m_newFlows.empty ())
+          if (m_newFlows.head != NO_FLOW)
             {
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              PushBack (m_oldFlows, PopFront (m_newFlows));
             }
           else
             {
               flow->SetStatus (FqCoDelFlow::INACTIVE);
-              m_oldFlows.pop_front ();
+              PopFront (m_oldFlows);
             }
         }
       else
@@ -443,6 +475,11 @@ FqCoDelQueueDisc::InitializeParams (void)
   m_queueDiscFactory.Set ("MaxSize", QueueSizeValue (GetMaxSize ()));
   m_queueDiscFactory.Set ("Interval", StringValue (m_interval));
   m_queueDiscFactory.Set ("Target", StringValue (m_target));
+
+  FlowSlot empty;
+  empty.tag = 0;
+  empty.next = NO_FLOW;
+  m_flowTable.assign (m_flows, empty);
 }
 
 uint32_t
@@ -24,8 +24,7 @@
 
 #include "ns3/queue-disc.h"
 #include "ns3/object-factory.h"
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -107,6 +106,15 @@ private:
  * \ingroup traffic-control
  *
  * \brief A FqCoDel packet queue disc
+ *
+ * The flow queues are kept in a flat table, directly indexed by the
+ * (possibly set associative) hash of the flows and allocated when the
+ * queue disc is initialized.  The table also stores the tags used by set
+ * associative hash and the links of the lists of new and old flows, so that
+ * classifying a packet and scheduling the flows does not allocate memory
+ * nor perform lookups in associative containers.  A flow queue object,
+ * and its child queue disc, is only created the first time a packet is
+ * classified into a slot of the table.
  */
 
 class FqCoDelQueueDisc : public QueueDisc {
@@ -163,6 +171,41 @@ private:
    */
   uint32_t SetAssociativeHash (uint32_t flowHash);
 
+  /// Index denoting the absence of a flow queue in the lists of flows
+  static const uint32_t NO_FLOW = 0xffffffff;
+
+  /**
+   * \brief A slot of the table of flow queues
+   */
+  struct FlowSlot
+  {
+    Ptr<FqCoDelFlow> flow;  //!< the flow queue, if created
+    uint32_t tag;           //!< the hash of the flow using the slot (used by set associative hash)
+    uint32_t next;          //!< index of the next flow queue in the list of new or old flows
+  };
+
+  /**
+   * \brief A list of flow queues linked through the table of flow queues
+   */
+  struct FlowList
+  {
+    uint32_t head;  //!< index of the first flow queue, or NO_FLOW
+    uint32_t tail;  //!< index of the last flow queue, or NO_FLOW
+  };
+
+  /**
+   * \brief Append a flow queue to a list of flows
+   * \param list the list
+   * \param index the index of the flow queue in the table
+   */
+  void PushBack (FlowList &list, uint32_t index);
+  /**
+   * \brief Remove the first flow queue from a non empty list of flows
+   * \param list the list
+   * \return the index of the flow queue removed
+   */
+  uint32_t PopFront (FlowList &list);
+
   std::string m_interval;    //!< CoDel interval attribute
   std::string m_target;      //!< CoDel target attribute
   uint32_t m_quantum;        //!< Deficit assigned to flows at each round
@@ -173,11 +216,9 @@ private:
   Time m_ceThreshold;        //!< Threshold above which to CE mark
   bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
 
-  std::list<Ptr<FqCoDelFlow> > m_newFlows;    //!< The list of new flows
-  std::list<Ptr<FqCoDelFlow> > m_oldFlows;    //!< The list of old flows
-
-  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
-  std::map<uint32_t, uint32_t> m_tags;            //!< Tags used by set associative hash
+  FlowList m_newFlows;                //!< The list of new flows
+  FlowList m_oldFlows;                //!< The list of old flows
+  std::vector<FlowSlot> m_flowTable;  //!< The flow queues, indexed by flow hash
 
   ObjectFactory m_flowFactory;         //!< Factory to create a new flow
   ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
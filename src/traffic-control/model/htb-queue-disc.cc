@@ -0,0 +1,841 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * HTB, the Hierarchical Token Bucket queueing discipline
+ *
+ * This implementation is based on the linux kernel code (net/sched/sch_htb.c)
+ * by Martin Devera, <devik@cdi.cz>
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/net-device-queue-interface.h"
+#include "htb-queue-disc.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HtbQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (HtbClass);
+
+/// Maximum time (ns) a class may accumulate in its buckets, as in Linux
+static const int64_t HTB_MAX_BUFFER = 60000000000LL;
+
+/**
+ * \param mask a bitmap of priorities, which must not be empty
+ * \return the highest priority (i.e., the lowest bit) set in the bitmap
+ */
+static uint32_t
+FirstPrio (uint32_t mask)
+{
+  NS_ASSERT (mask != 0);
+#if defined (__GNUC__)
+  return __builtin_ctz (mask);
+#else
+  uint32_t prio = 0;
+  while ((mask & 1) == 0)
+    {
+      mask >>= 1;
+      prio++;
+    }
+  return prio;
+#endif
+}
+
+TypeId
+HtbClass::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HtbClass")
+    .SetParent<QueueDiscClass> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<HtbClass> ()
+    .AddAttribute ("Rate",
+                   "The rate guaranteed to the class.",
+                   DataRateValue (DataRate ("1Mbps")),
+                   MakeDataRateAccessor (&HtbClass::m_rate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Ceil",
+                   "The maximum rate of the class, including what it borrows. "
+                   "If zero, the class cannot borrow (the ceil rate is the rate).",
+                   DataRateValue (DataRate ("0bps")),
+                   MakeDataRateAccessor (&HtbClass::m_ceil),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Burst",
+                   "The size of the bucket of the rate, in bytes. If zero, "
+                   "the bytes sent in 1ms at the rate plus one MTU.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_burst),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Cburst",
+                   "The size of the bucket of the ceil rate, in bytes. If zero, "
+                   "the bytes sent in 1ms at the ceil rate plus one MTU.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_cburst),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Parent",
+                   "The index of the parent class, or a negative value for a root class.",
+                   IntegerValue (-1),
+                   MakeIntegerAccessor (&HtbClass::m_parentId),
+                   MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("Priority",
+                   "The priority of a leaf class when borrowing (0 is the highest).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_prio),
+                   MakeUintegerChecker<uint32_t> (0, N_PRIO - 1))
+    .AddAttribute ("Quantum",
+                   "The number of bytes a leaf class may send in a round when "
+                   "borrowing. If zero, the bytes sent in 100ms at the rate "
+                   "(between 1000 and 200000 bytes).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_quantum),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+HtbClass::HtbClass ()
+  : m_parent (0),
+    m_nChildren (0),
+    m_level (0),
+    m_mode (CAN_SEND),
+    m_rateNsPerByte (0),
+    m_ceilNsPerByte (0),
+    m_buffer (0),
+    m_cbuffer (0),
+    m_tokens (0),
+    m_ctokens (0),
+    m_checkpoint (0),
+    m_prioActivity (0),
+    m_waiting (false),
+    m_nBorrows (0),
+    m_nLends (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HtbClass::~HtbClass ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HtbClass::Mode
+HtbClass::GetMode (void) const
+{
+  return m_mode;
+}
+
+uint32_t
+HtbClass::GetLevel (void) const
+{
+  return m_level;
+}
+
+uint64_t
+HtbClass::GetNBorrows (void) const
+{
+  return m_nBorrows;
+}
+
+uint64_t
+HtbClass::GetNLends (void) const
+{
+  return m_nLends;
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (HtbQueueDisc);
+
+TypeId
+HtbQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HtbQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<HtbQueueDisc> ()
+    .AddAttribute ("DefaultClass",
+                   "The index of the leaf class of the packets not classified "
+                   "by the filters. If negative, such packets are dropped.",
+                   IntegerValue (-1),
+                   MakeIntegerAccessor (&HtbQueueDisc::m_defaultClass),
+                   MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("Mtu",
+                   "The MTU used to compute the default burst sizes. If zero, "
+                   "the MTU of the device (or 1500 bytes if there is no device).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbQueueDisc::m_mtu),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+HtbQueueDisc::HtbQueueDisc ()
+  : QueueDisc (QueueDiscSizePolicy::NO_LIMITS)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HtbQueueDisc::~HtbQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HtbQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_wakeup.Cancel ();
+  m_htbClasses.clear ();
+  m_waitQueue.clear ();
+  std::fill (&m_row[0][0], &m_row[0][0] + HtbClass::MAX_DEPTH * HtbClass::N_PRIO, nullptr);
+  QueueDisc::DoDispose ();
+}
+
+void
+HtbQueueDisc::Link (RoundRobin &list, HtbClass *cl, uint32_t prio)
+{
+  HtbClass::Node &node = cl->m_node[prio];
+  if (list == 0)
+    {
+      node.prev = node.next = cl;
+      list = cl;
+      return;
+    }
+  // insert the class at the tail, i.e., just before the class to serve next
+  HtbClass *tail = list->m_node[prio].prev;
+  node.prev = tail;
+  node.next = list;
+  tail->m_node[prio].next = cl;
+  list->m_node[prio].prev = cl;
+}
+
+void
+HtbQueueDisc::Unlink (RoundRobin &list, HtbClass *cl, uint32_t prio)
+{
+  HtbClass::Node &node = cl->m_node[prio];
+  if (node.next == cl)
+    {
+      list = 0;
+    }
+  else
+    {
+      node.prev->m_node[prio].next = node.next;
+      node.next->m_node[prio].prev = node.prev;
+      if (list == cl)
+        {
+          list = node.next;
+        }
+    }
+  node.prev = node.next = 0;
+}
+
+void
+HtbQueueDisc::AddToRow (HtbClass *cl, uint8_t mask)
+{
+  NS_LOG_FUNCTION (this << cl << +mask);
+  while (mask)
+    {
+      uint32_t prio = FirstPrio (mask);
+      mask &= ~(1 << prio);
+      if (m_row[cl->m_level][prio] == 0)
+        {
+          m_rowMask[cl->m_level] |= (1 << prio);
+        }
+      Link (m_row[cl->m_level][prio], cl, prio);
+    }
+}
+
+void
+HtbQueueDisc::RemoveFromRow (HtbClass *cl, uint8_t mask)
+{
+  NS_LOG_FUNCTION (this << cl << +mask);
+  while (mask)
+    {
+      uint32_t prio = FirstPrio (mask);
+      mask &= ~(1 << prio);
+      Unlink (m_row[cl->m_level][prio], cl, prio);
+      if (m_row[cl->m_level][prio] == 0)
+        {
+          m_rowMask[cl->m_level] &= ~(1 << prio);
+        }
+    }
+}
+
+void
+HtbQueueDisc::ActivatePrios (HtbClass *cl)
+{
+  NS_LOG_FUNCTION (this << cl);
+  HtbClass *p = cl->m_parent;
+  uint8_t mask = cl->m_prioActivity;
+
+  while (cl->m_mode == HtbClass::MAY_BORROW && p && mask)
+    {
+      uint8_t m = mask;
+      while (m)
+        {
+          uint32_t prio = FirstPrio (m);
+          m &= ~(1 << prio);
+          if (p->m_feed[prio])
+            {
+              // the parent is already active for this priority
+              mask &= ~(1 << prio);
+            }
+          Link (p->m_feed[prio], cl, prio);
+        }
+      p->m_prioActivity |= mask;
+      cl = p;
+      p = cl->m_parent;
+    }
+  if (cl->m_mode == HtbClass::CAN_SEND && mask)
+    {
+      AddToRow (cl, mask);
+    }
+}
+
+void
+HtbQueueDisc::DeactivatePrios (HtbClass *cl)
+{
+  NS_LOG_FUNCTION (this << cl);
+  HtbClass *p = cl->m_parent;
+  uint8_t mask = cl->m_prioActivity;
+
+  while (cl->m_mode == HtbClass::MAY_BORROW && p && mask)
+    {
+      uint8_t m = mask;
+      mask = 0;
+      while (m)
+        {
+          uint32_t prio = FirstPrio (m);
+          m &= ~(1 << prio);
+          Unlink (p->m_feed[prio], cl, prio);
+          if (p->m_feed[prio] == 0)
+            {
+              // the parent is no longer active for this priority
+              mask |= (1 << prio);
+            }
+        }
+      p->m_prioActivity &= ~mask;
+      cl = p;
+      p = cl->m_parent;
+    }
+  if (cl->m_mode == HtbClass::CAN_SEND && mask)
+    {
+      RemoveFromRow (cl, mask);
+    }
+}
+
+void
+HtbQueueDisc::Activate (HtbClass *cl)
+{
+  NS_LOG_FUNCTION (this << cl);
+  NS_ASSERT (cl->m_level == 0 && cl->m_prioActivity == 0);
+  cl->m_prioActivity = (1 << cl->m_prio);
+  ActivatePrios (cl);
+}
+
+void
+HtbQueueDisc::Deactivate (HtbClass *cl)
+{
+  NS_LOG_FUNCTION (this << cl);
+  NS_ASSERT (cl->m_prioActivity);
+  DeactivatePrios (cl);
+  cl->m_prioActivity = 0;
+}
+
+HtbClass::Mode
+HtbQueueDisc::ClassMode (HtbClass *cl, int64_t &diff) const
+{
+  int64_t toks = cl->m_ctokens + diff;
+  if (toks < 0)
+    {
+      diff = -toks;
+      return HtbClass::CANT_SEND;
+    }
+
+  toks = cl->m_tokens + diff;
+  if (toks >= 0)
+    {
+      return HtbClass::CAN_SEND;
+    }
+
+  diff = -toks;
+  return HtbClass::MAY_BORROW;
+}
+
+void
+HtbQueueDisc::ChangeClassMode (HtbClass *cl, int64_t &diff)
+{
+  HtbClass::Mode newMode = ClassMode (cl, diff);
+
+  if (newMode == cl->m_mode)
+    {
+      return;
+    }
+
+  NS_LOG_LOGIC ("Class " << cl << " changes mode from " << cl->m_mode << " to " << newMode);
+
+  if (cl->m_prioActivity)
+    {
+      if (cl->m_mode != HtbClass::CANT_SEND)
+        {
+          DeactivatePrios (cl);
+        }
+      cl->m_mode = newMode;
+      if (newMode != HtbClass::CANT_SEND)
+        {
+          ActivatePrios (cl);
+        }
+    }
+  else
+    {
+      cl->m_mode = newMode;
+    }
+}
+
+void
+HtbQueueDisc::AddToWaitQueue (HtbClass *cl, int64_t delay)
+{
+  NS_ASSERT (!cl->m_waiting);
+  int64_t key = Simulator::Now ().GetNanoSeconds () + std::max<int64_t> (delay, 1);
+  cl->m_wait = m_waitQueue.insert (std::make_pair (key, cl));
+  cl->m_waiting = true;
+}
+
+void
+HtbQueueDisc::RemoveFromWaitQueue (HtbClass *cl)
+{
+  NS_ASSERT (cl->m_waiting);
+  m_waitQueue.erase (cl->m_wait);
+  cl->m_waiting = false;
+}
+
+void
+HtbQueueDisc::DoEvents (void)
+{
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+
+  while (!m_waitQueue.empty () && m_waitQueue.begin ()->first <= now)
+    {
+      HtbClass *cl = m_waitQueue.begin ()->second;
+      RemoveFromWaitQueue (cl);
+      int64_t diff = std::min (now - cl->m_checkpoint, HTB_MAX_BUFFER);
+      ChangeClassMode (cl, diff);
+      if (cl->m_mode != HtbClass::CAN_SEND)
+        {
+          AddToWaitQueue (cl, diff);
+        }
+    }
+}
+
+void
+HtbQueueDisc::Charge (HtbClass *cl, uint32_t level, uint32_t bytes)
+{
+  NS_LOG_FUNCTION (this << cl << level << bytes);
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+
+  while (cl)
+    {
+      int64_t diff = std::min (now - cl->m_checkpoint, HTB_MAX_BUFFER);
+      if (cl->m_level >= level)
+        {
+          if (cl->m_level == level)
+            {
+              cl->m_nLends++;
+            }
+          int64_t toks = std::min (cl->m_tokens + diff, cl->m_buffer)
+                         - std::llround (bytes * cl->m_rateNsPerByte);
+          cl->m_tokens = std::max (toks, 1 - HTB_MAX_BUFFER);
+        }
+      else
+        {
+          cl->m_nBorrows++;
+          // we moved the checkpoint, update the tokens
+          cl->m_tokens += diff;
+        }
+      int64_t ctoks = std::min (cl->m_ctokens + diff, cl->m_cbuffer)
+                      - std::llround (bytes * cl->m_ceilNsPerByte);
+      cl->m_ctokens = std::max (ctoks, 1 - HTB_MAX_BUFFER);
+      cl->m_checkpoint = now;
+
+      HtbClass::Mode oldMode = cl->m_mode;
+      diff = 0;
+      ChangeClassMode (cl, diff);
+      if (oldMode != cl->m_mode)
+        {
+          if (oldMode != HtbClass::CAN_SEND)
+            {
+              RemoveFromWaitQueue (cl);
+            }
+          if (cl->m_mode != HtbClass::CAN_SEND)
+            {
+              AddToWaitQueue (cl, diff);
+            }
+        }
+
+      cl = cl->m_parent;
+    }
+}
+
+HtbClass *
+HtbQueueDisc::LookupLeaf (uint32_t prio, uint32_t level) const
+{
+  HtbClass *cl = m_row[level][prio];
+
+  // inner classes serve their borrowing children in round robin
+  while (cl && cl->m_level > 0)
+    {
+      cl = cl->m_feed[prio];
+    }
+  return cl;
+}
+
+void
+HtbQueueDisc::NextLeaf (HtbClass *cl, uint32_t prio, uint32_t level)
+{
+  RoundRobin &list = (level ? cl->m_parent->m_feed[prio] : m_row[0][prio]);
+  NS_ASSERT (list == cl);
+  list = cl->m_node[prio].next;
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DequeueTree (uint32_t prio, uint32_t level)
+{
+  NS_LOG_FUNCTION (this << prio << level);
+
+  Ptr<QueueDiscItem> item;
+  HtbClass *start = LookupLeaf (prio, level);
+  HtbClass *cl = start;
+
+  while (true)
+    {
+      if (cl == 0)
+        {
+          return 0;
+        }
+
+      if (cl->GetQueueDisc ()->GetNPackets () == 0)
+        {
+          // the child queue disc dropped its packets when they were
+          // dequeued: deactivate the class and look at the next one
+          Deactivate (cl);
+          // the row might have become empty
+          if ((m_rowMask[level] & (1 << prio)) == 0)
+            {
+              return 0;
+            }
+          HtbClass *next = LookupLeaf (prio, level);
+          if (cl == start)
+            {
+              start = next;
+            }
+          cl = next;
+          continue;
+        }
+
+      item = cl->GetQueueDisc ()->Dequeue ();
+      if (item)
+        {
+          break;
+        }
+
+      NS_LOG_DEBUG ("Class " << cl << " is backlogged but did not return a packet");
+      NextLeaf (cl, prio, level);
+      cl = LookupLeaf (prio, level);
+      if (cl == start)
+        {
+          // a full round without a packet
+          return 0;
+        }
+    }
+
+  cl->m_deficit[level] -= item->GetSize ();
+  if (cl->m_deficit[level] < 0)
+    {
+      cl->m_deficit[level] += cl->m_quantum;
+      NextLeaf (cl, prio, level);
+    }
+
+  if (cl->GetQueueDisc ()->GetNPackets () == 0)
+    {
+      Deactivate (cl);
+    }
+
+  Charge (cl, level, item->GetSize ());
+  return item;
+}
+
+void
+HtbQueueDisc::ScheduleWakeup (void)
+{
+  if (m_waitQueue.empty ())
+    {
+      return;
+    }
+
+  Time when = NanoSeconds (m_waitQueue.begin ()->first);
+  if (m_wakeup.IsRunning ()
+      && Simulator::Now () + Simulator::GetDelayLeft (m_wakeup) <= when)
+    {
+      return;
+    }
+
+  NS_LOG_LOGIC ("Wake up at " << when);
+  m_wakeup.Cancel ();
+  m_wakeup = Simulator::Schedule (when - Simulator::Now (), &QueueDisc::Run, this);
+}
+
+bool
+HtbQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  HtbClass *cl = 0;
+  int32_t ret = Classify (item);
+
+  if (ret >= 0 && static_cast<uint32_t> (ret) < m_htbClasses.size ()
+      && m_htbClasses[ret]->m_nChildren == 0)
+    {
+      cl = m_htbClasses[ret];
+    }
+  else if (m_defaultClass >= 0)
+    {
+      NS_LOG_DEBUG ("Packet filters returned " << ret << ", using the default class");
+      cl = m_htbClasses[m_defaultClass];
+    }
+
+  if (cl == 0)
+    {
+      NS_LOG_DEBUG ("No class for the packet");
+      DropBeforeEnqueue (item, UNCLASSIFIED_DROP);
+      return false;
+    }
+
+  bool retval = cl->GetQueueDisc ()->Enqueue (item);
+
+  // If Queue::Enqueue fails, QueueDisc::Drop is called by the child queue disc
+  // because QueueDisc::AddQueueDiscClass sets the drop callback
+
+  if (retval && cl->m_prioActivity == 0)
+    {
+      Activate (cl);
+    }
+
+  return retval;
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (GetNPackets () == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  DoEvents ();
+
+  Ptr<QueueDiscItem> item;
+  for (uint32_t level = 0; level < HtbClass::MAX_DEPTH; level++)
+    {
+      uint8_t mask = m_rowMask[level];
+      while (mask)
+        {
+          uint32_t prio = FirstPrio (mask);
+          mask &= ~(1 << prio);
+          if ((item = DequeueTree (prio, level)) != 0)
+            {
+              return item;
+            }
+        }
+    }
+
+  NS_LOG_LOGIC ("No class can send");
+  ScheduleWakeup ();
+  return 0;
+}
+
+bool
+HtbQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("HtbQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  if (GetNPacketFilters () == 0 && m_defaultClass < 0)
+    {
+      NS_LOG_WARN ("HtbQueueDisc has no packet filter nor default class: all packets will be dropped");
+    }
+
+  uint32_t nClasses = GetNQueueDiscClasses ();
+  if (nClasses == 0)
+    {
+      NS_LOG_ERROR ("HtbQueueDisc needs at least one class");
+      return false;
+    }
+
+  m_htbClasses.clear ();
+  for (uint32_t i = 0; i < nClasses; i++)
+    {
+      Ptr<HtbClass> cl = DynamicCast<HtbClass> (GetQueueDiscClass (i));
+      if (!cl)
+        {
+          NS_LOG_ERROR ("The classes of HtbQueueDisc must be HtbClass objects");
+          return false;
+        }
+      if (cl->m_rate.GetBitRate () == 0)
+        {
+          NS_LOG_ERROR ("The rate of HTB class " << i << " is null");
+          return false;
+        }
+      cl->m_parent = 0;
+      cl->m_nChildren = 0;
+      m_htbClasses.push_back (PeekPointer (cl));
+    }
+
+  for (uint32_t i = 0; i < nClasses; i++)
+    {
+      int32_t parentId = m_htbClasses[i]->m_parentId;
+      if (parentId < 0)
+        {
+          continue;
+        }
+      if (static_cast<uint32_t> (parentId) >= nClasses || static_cast<uint32_t> (parentId) == i)
+        {
+          NS_LOG_ERROR ("Invalid parent " << parentId << " for HTB class " << i);
+          return false;
+        }
+      m_htbClasses[i]->m_parent = m_htbClasses[parentId];
+      m_htbClasses[parentId]->m_nChildren++;
+    }
+
+  // the depth check also detects loops
+  for (uint32_t i = 0; i < nClasses; i++)
+    {
+      uint32_t depth = 0;
+      for (HtbClass *p = m_htbClasses[i]->m_parent; p; p = p->m_parent)
+        {
+          if (++depth >= HtbClass::MAX_DEPTH)
+            {
+              NS_LOG_ERROR ("The hierarchy of HTB classes is too deep or has loops");
+              return false;
+            }
+        }
+    }
+
+  if (m_defaultClass >= 0
+      && (static_cast<uint32_t> (m_defaultClass) >= nClasses
+          || m_htbClasses[m_defaultClass]->m_nChildren > 0))
+    {
+      NS_LOG_ERROR ("The default class must be a leaf class");
+      return false;
+    }
+
+  if (m_mtu == 0)
+    {
+      Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface ();
+      Ptr<NetDevice> dev;
+      // if the NetDeviceQueueInterface object is aggregated to a
+      // NetDevice, get the MTU of such NetDevice
+      if (ndqi && (dev = ndqi->GetObject<NetDevice> ()))
+        {
+          m_mtu = dev->GetMtu ();
+        }
+      else
+        {
+          m_mtu = 1500;
+        }
+    }
+
+  return true;
+}
+
+void
+HtbQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+
+  for (auto cl : m_htbClasses)
+    {
+      // inner classes are placed one level below their parent, starting
+      // from the top level; leaf classes are always at level 0
+      if (cl->m_nChildren == 0)
+        {
+          cl->m_level = 0;
+        }
+      else
+        {
+          uint32_t depth = 0;
+          for (HtbClass *p = cl->m_parent; p; p = p->m_parent)
+            {
+              depth++;
+            }
+          cl->m_level = HtbClass::MAX_DEPTH - 1 - depth;
+        }
+
+      if (cl->m_ceil.GetBitRate () == 0)
+        {
+          cl->m_ceil = cl->m_rate;
+        }
+      if (cl->m_burst == 0)
+        {
+          cl->m_burst = cl->m_rate.GetBitRate () / 8000 + m_mtu;
+        }
+      if (cl->m_cburst == 0)
+        {
+          cl->m_cburst = cl->m_ceil.GetBitRate () / 8000 + m_mtu;
+        }
+      if (cl->m_quantum == 0)
+        {
+          cl->m_quantum = std::min<uint64_t> (std::max<uint64_t> (cl->m_rate.GetBitRate () / 80, 1000), 200000);
+        }
+
+      cl->m_rateNsPerByte = 8e9 / cl->m_rate.GetBitRate ();
+      cl->m_ceilNsPerByte = 8e9 / cl->m_ceil.GetBitRate ();
+      cl->m_buffer = std::llround (cl->m_burst * cl->m_rateNsPerByte);
+      cl->m_cbuffer = std::llround (cl->m_cburst * cl->m_ceilNsPerByte);
+      cl->m_tokens = cl->m_buffer;
+      cl->m_ctokens = cl->m_cbuffer;
+      cl->m_checkpoint = now;
+      cl->m_mode = HtbClass::CAN_SEND;
+      cl->m_prioActivity = 0;
+      cl->m_waiting = false;
+      std::fill (cl->m_deficit, cl->m_deficit + HtbClass::MAX_DEPTH, 0);
+      for (uint32_t prio = 0; prio < HtbClass::N_PRIO; prio++)
+        {
+          cl->m_node[prio].prev = cl->m_node[prio].next = 0;
+          cl->m_feed[prio] = 0;
+        }
+
+      NS_LOG_DEBUG ("HTB class " << cl << " level " << cl->m_level << " rate " << cl->m_rate
+                    << " ceil " << cl->m_ceil << " burst " << cl->m_burst << " cburst "
+                    << cl->m_cburst << " quantum " << cl->m_quantum);
+    }
+
+  std::fill (&m_row[0][0], &m_row[0][0] + HtbClass::MAX_DEPTH * HtbClass::N_PRIO, nullptr);
+  std::fill (m_rowMask, m_rowMask + HtbClass::MAX_DEPTH, 0);
+  m_waitQueue.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * HTB, the Hierarchical Token Bucket queueing discipline
+ *
+ * This implementation is based on the linux kernel code (net/sched/sch_htb.c)
+ * by Martin Devera, <devik@cdi.cz>
+ */
+#ifndef HTB_QUEUE_DISC_H
+#define HTB_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include <map>
+
+namespace ns3 {
+
+class HtbQueueDisc;
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A class of the HTB queue disc
+ *
+ * Each class has a guaranteed rate and may borrow unused bandwidth from its
+ * ancestors up to its ceil rate. Classes having children (inner classes)
+ * only lend their tokens to their descendants, while the classes without
+ * children (leaf classes) store packets in their queue disc.
+ */
+class HtbClass : public QueueDiscClass
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  HtbClass ();
+  virtual ~HtbClass ();
+
+  /// Maximum depth of the hierarchy of classes (as in Linux)
+  static const uint32_t MAX_DEPTH = 8;
+  /// Number of priorities (as in Linux)
+  static const uint32_t N_PRIO = 8;
+
+  /**
+   * \enum Mode
+   * \brief The mode of a class
+   */
+  enum Mode
+    {
+      CANT_SEND,    //!< the class exceeded its ceil rate
+      MAY_BORROW,   //!< the class exceeded its rate, but not its ceil rate
+      CAN_SEND      //!< the class did not exceed its rate
+    };
+
+  /**
+   * \return the current mode of the class
+   */
+  Mode GetMode (void) const;
+  /**
+   * \return the level of the class (0 for leaf classes)
+   */
+  uint32_t GetLevel (void) const;
+  /**
+   * \return the number of times the class had to borrow from an ancestor
+   */
+  uint64_t GetNBorrows (void) const;
+  /**
+   * \return the number of times the class sent or lent its own tokens
+   */
+  uint64_t GetNLends (void) const;
+
+private:
+  friend class HtbQueueDisc;
+
+  /// Links of a class in a round robin list of classes of the same priority
+  struct Node
+  {
+    HtbClass *prev;  //!< previous class in the list
+    HtbClass *next;  //!< next class in the list
+  };
+
+  // attributes
+  DataRate m_rate;     //!< guaranteed rate
+  DataRate m_ceil;     //!< maximum rate
+  uint32_t m_burst;    //!< size of the bucket of the rate (bytes)
+  uint32_t m_cburst;   //!< size of the bucket of the ceil rate (bytes)
+  int32_t m_parentId;  //!< index of the parent class, negative for root classes
+  uint32_t m_prio;     //!< priority of a leaf class (0 is the highest)
+  uint32_t m_quantum;  //!< deficit assigned at each round (bytes)
+
+  // state maintained by the queue disc
+  HtbClass *m_parent;           //!< the parent class, if any
+  uint32_t m_nChildren;         //!< number of children
+  uint32_t m_level;             //!< level of the class in the hierarchy
+  Mode m_mode;                  //!< current mode
+  double m_rateNsPerByte;       //!< transmission time of a byte at the rate (ns)
+  double m_ceilNsPerByte;       //!< transmission time of a byte at the ceil rate (ns)
+  int64_t m_buffer;             //!< bucket of the rate, in transmission time (ns)
+  int64_t m_cbuffer;            //!< bucket of the ceil rate, in transmission time (ns)
+  int64_t m_tokens;             //!< tokens of the rate bucket (ns)
+  int64_t m_ctokens;            //!< tokens of the ceil rate bucket (ns)
+  int64_t m_checkpoint;         //!< time at which the tokens have been updated (ns)
+  uint8_t m_prioActivity;       //!< priorities for which the class is active
+  int32_t m_deficit[MAX_DEPTH]; //!< deficit of a leaf class at each level
+  Node m_node[N_PRIO];          //!< links in the row or in the parent feed of each priority
+  HtbClass *m_feed[N_PRIO];     //!< children borrowing from an inner class, per priority
+  bool m_waiting;                                  //!< true if in the wait queue
+  std::multimap<int64_t, HtbClass *>::iterator m_wait; //!< position in the wait queue
+  uint64_t m_nBorrows;          //!< number of borrows
+  uint64_t m_nLends;            //!< number of lends
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief An HTB (Hierarchical Token Bucket) queue disc
+ *
+ * The classes of the queue disc must be HtbClass objects. Their hierarchy
+ * is defined by the Parent attribute of each class, which is the index of
+ * the parent class (classes with a negative parent are root classes).
+ * Packets are classified by the packet filters, which must return the index
+ * of a leaf class. Packets not classified (or classified into an inner class)
+ * are enqueued into the class given by the DefaultClass attribute or, if no
+ * valid default class is set, dropped.
+ *
+ * As in Linux, the leaf classes which are backlogged and did not exceed their
+ * rate are linked in per-level, per-priority round robin lists (rows), while
+ * those which may borrow are linked in the per-priority lists (feeds) of their
+ * parent, which are in turn linked in the row of their level if the parent can
+ * send, and so on. A bitmap of the active priorities of each level allows to
+ * find the class to serve in constant time. Classes which exceeded their rate
+ * are kept in a wait queue sorted by the time at which they change mode, which
+ * is only processed when a packet is dequeued. No event is scheduled per packet
+ * or per class: when no class can send, a single wakeup is scheduled for the
+ * earliest mode change.
+ */
+class HtbQueueDisc : public QueueDisc
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief HtbQueueDisc constructor
+   */
+  HtbQueueDisc ();
+
+  virtual ~HtbQueueDisc ();
+
+  // Reasons for dropping packets
+  static constexpr const char* UNCLASSIFIED_DROP = "Unclassified drop";  //!< No class for the packet
+
+protected:
+  /**
+   * \brief Dispose of the object
+   */
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /// A round robin list of classes, identified by the class to serve next
+  typedef HtbClass *RoundRobin;
+
+  /**
+   * \brief Link a class in a round robin list
+   * \param list the list
+   * \param cl the class
+   * \param prio the priority of the list
+   */
+  static void Link (RoundRobin &list, HtbClass *cl, uint32_t prio);
+  /**
+   * \brief Unlink a class from a round robin list
+   * \param list the list
+   * \param cl the class
+   * \param prio the priority of the list
+   */
+  static void Unlink (RoundRobin &list, HtbClass *cl, uint32_t prio);
+
+  /**
+   * \brief Add a class to the rows of the given priorities of its level
+   * \param cl the class
+   * \param mask the priorities
+   */
+  void AddToRow (HtbClass *cl, uint8_t mask);
+  /**
+   * \brief Remove a class from the rows of the given priorities of its level
+   * \param cl the class
+   * \param mask the priorities
+   */
+  void RemoveFromRow (HtbClass *cl, uint8_t mask);
+  /**
+   * \brief Make the active priorities of a class visible to the scheduler,
+   * through the feeds of its ancestors if it may borrow
+   * \param cl the class
+   */
+  void ActivatePrios (HtbClass *cl);
+  /**
+   * \brief Hide the active priorities of a class from the scheduler
+   * \param cl the class
+   */
+  void DeactivatePrios (HtbClass *cl);
+  /**
+   * \brief Called when a leaf class becomes backlogged
+   * \param cl the leaf class
+   */
+  void Activate (HtbClass *cl);
+  /**
+   * \brief Called when a leaf class becomes empty
+   * \param cl the leaf class
+   */
+  void Deactivate (HtbClass *cl);
+
+  /**
+   * \brief Compute the mode of a class given the time elapsed since its checkpoint
+   * \param cl the class
+   * \param [in,out] diff the time elapsed (ns); on return, the time until the mode changes
+   * \return the mode of the class
+   */
+  HtbClass::Mode ClassMode (HtbClass *cl, int64_t &diff) const;
+  /**
+   * \brief Update the mode of a class and its visibility to the scheduler
+   * \param cl the class
+   * \param [in,out] diff the time elapsed (ns); on return, the time until the mode changes
+   */
+  void ChangeClassMode (HtbClass *cl, int64_t &diff);
+  /**
+   * \brief Insert a class in the wait queue
+   * \param cl the class
+   * \param delay the time until the mode of the class changes (ns)
+   */
+  void AddToWaitQueue (HtbClass *cl, int64_t delay);
+  /**
+   * \brief Remove a class from the wait queue
+   * \param cl the class
+   */
+  void RemoveFromWaitQueue (HtbClass *cl);
+  /**
+   * \brief Update the mode of the classes whose wait time elapsed
+   */
+  void DoEvents (void);
+  /**
+   * \brief Charge a leaf class and its ancestors for a dequeued packet
+   * \param cl the leaf class
+   * \param level the level at which the packet has been dequeued
+   * \param bytes the size of the packet
+   */
+  void Charge (HtbClass *cl, uint32_t level, uint32_t bytes);
+  /**
+   * \brief Find the leaf class to serve from a row
+   * \param prio the priority
+   * \param level the level
+   * \return the leaf class
+   */
+  HtbClass *LookupLeaf (uint32_t prio, uint32_t level) const;
+  /**
+   * \brief Move the round robin pointer past a leaf class
+   * \param cl the leaf class
+   * \param prio the priority
+   * \param level the level at which the leaf class has been served
+   */
+  void NextLeaf (HtbClass *cl, uint32_t prio, uint32_t level);
+  /**
+   * \brief Dequeue a packet from the classes of a row
+   * \param prio the priority
+   * \param level the level
+   * \return the packet, or null
+   */
+  Ptr<QueueDiscItem> DequeueTree (uint32_t prio, uint32_t level);
+  /**
+   * \brief Schedule a wakeup of the queue disc at the earliest mode change
+   */
+  void ScheduleWakeup (void);
+
+  int32_t m_defaultClass;      //!< index of the class for unclassified packets
+  uint32_t m_mtu;              //!< MTU used to compute the default burst sizes
+
+  std::vector<HtbClass *> m_htbClasses;                    //!< the classes
+  RoundRobin m_row[HtbClass::MAX_DEPTH][HtbClass::N_PRIO]; //!< rows of classes able to send
+  uint8_t m_rowMask[HtbClass::MAX_DEPTH];                  //!< active priorities of each level
+  std::multimap<int64_t, HtbClass *> m_waitQueue;          //!< classes waiting for a mode change
+  EventId m_wakeup;                                        //!< event to wake the queue disc up
+};
+
+} // namespace ns3
+
+#endif /* HTB_QUEUE_DISC_H */
@@ -198,4 +198,10 @@ PfifoFastQueueDisc::InitializeParams (void)
   NS_LOG_FUNCTION (this);
 }
 
+bool
+PfifoFastQueueDisc::CanBypass (void) const
+{
+  return true;
+}
+
 } // namespace ns3
@@ -972,6 +972,41 @@ QueueDisc::Run (void)
     }
 }
 
+bool
+QueueDisc::Bypass (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (!CanBypass () || m_nPackets.Get () != 0 || m_requeued || m_running
+      || (m_devQueueIface && m_devQueueIface->GetTxQueue (item->GetTxQueueIndex ())->IsStopped ()))
+    {
+      return false;
+    }
+
+  // the item goes through the queue disc without being stored, hence it is
+  // accounted as received, enqueued and dequeued
+  uint32_t size = item->GetSize ();
+  m_stats.nTotalReceivedPackets++;
+  m_stats.nTotalReceivedBytes += size;
+  m_stats.nTotalEnqueuedPackets++;
+  m_stats.nTotalEnqueuedBytes += size;
+  m_stats.nTotalDequeuedPackets++;
+  m_stats.nTotalDequeuedBytes += size;
+
+  NS_LOG_LOGIC ("Bypass the queue disc");
+  m_running = true;
+  item->AddHeader ();
+  Transmit (item);
+  m_running = false;
+  return true;
+}
+
+bool
+QueueDisc::CanBypass (void) const
+{
+  return false;
+}
+
 bool
 QueueDisc::RunBegin (void)
 {
@@ -418,6 +418,20 @@ public:
    */
   void Run (void);
 
+  /**
+   * Modelled after the bypass performed by the Linux function __dev_xmit_skb
+   * (net/core/dev.c) for queue discs having the TCQ_F_CAN_BYPASS flag set.
+   * If this queue disc allows bypass (see CanBypass), stores no packet, is not
+   * running and the device queue selected for the given item is not stopped,
+   * the item is sent to the device straight away.  The item is accounted in the
+   * statistics of the queue disc as enqueued and dequeued, but the traces of the
+   * queue disc are not fired.
+   * \param item the item to send
+   * \return true if the item has been sent to the device, false otherwise (in
+   *         which case the item has to be enqueued as usual)
+   */
+  bool Bypass (Ptr<QueueDiscItem> item);
+
   /// Internal queues store QueueDiscItem objects
   typedef Queue<QueueDiscItem> InternalQueue;
 
@@ -636,6 +650,15 @@ private:
    */
   virtual void InitializeParams (void) = 0;
 
+  /**
+   * Check whether a packet arriving when this queue disc is empty can be sent
+   * to the device without being enqueued (see Bypass). This only holds for
+   * work-conserving queue discs which never delay nor drop a packet arriving
+   * when they are empty. The default implementation returns false.
+   * \return true if this queue disc can be bypassed when empty
+   */
+  virtual bool CanBypass (void) const;
+
   /**
    * Modelled after the Linux function qdisc_run_begin (include/net/sch_generic.h).
    * \return false if the qdisc is already running; otherwise, set the qdisc as running and return true.
@@ -24,6 +24,7 @@
 #include "ns3/packet.h"
 #include "ns3/socket.h"
 #include "ns3/queue-disc.h"
+#include "ns3/boolean.h"
 #include <tuple>
 
 namespace ns3 {
@@ -44,6 +45,14 @@ TrafficControlLayer::GetTypeId (void)
                    MakeObjectMapAccessor (&TrafficControlLayer::GetNDevices,
                                           &TrafficControlLayer::GetRootQueueDiscOnDeviceByIndex),
                    MakeObjectMapChecker<QueueDisc> ())
+    .AddAttribute ("Bypass",
+                   "If true, packets are sent straight to the device when the root "
+                   "queue disc is empty and can be bypassed (e.g., FIFO queue discs) and "
+                   "the device queue is not stopped. Such packets are accounted in the "
+                   "queue disc statistics but do not fire the queue disc traces.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TrafficControlLayer::m_bypass),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -55,7 +64,8 @@ TrafficControlLayer::GetInstanceTypeId (void) const
 }
 
 TrafficControlLayer::TrafficControlLayer ()
-  : Object ()
+  : Object (),
+    m_bypass (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -393,6 +403,10 @@ TrafficControlLayer::Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
 
       Ptr<QueueDisc> qDisc = ndi->second.m_queueDiscsToWake[txq];
       NS_ASSERT (qDisc);
+      if (m_bypass && qDisc->Bypass (item))
+        {
+          return;
+        }
       qDisc->Enqueue (item);
       qDisc->Run ();
     }
@@ -254,6 +254,7 @@ private:
   /// Map storing the required information for each device with a queue disc installed
   std::map<Ptr<NetDevice>, NetDeviceInfo> m_netDevices;
   ProtocolHandlerList m_handlers;  //!< List of upper-layer handlers
+  bool m_bypass;                   //!< True if empty queue discs can be bypassed
 };
 
 } // namespace ns3
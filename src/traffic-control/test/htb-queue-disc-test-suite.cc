@@ -0,0 +1,498 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/htb-queue-disc.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/packet-filter.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/traffic-control-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Item
+ */
+class HtbQueueDiscTestItem : public QueueDiscItem
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param p the packet
+   * \param addr the address
+   * \param cls the index of the class of the packet
+   */
+  HtbQueueDiscTestItem (Ptr<Packet> p, const Address & addr, int32_t cls);
+  virtual ~HtbQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+  /**
+   * \return the index of the class of the packet
+   */
+  int32_t GetClass (void) const;
+
+private:
+  int32_t m_cls;  //!< the index of the class of the packet
+};
+
+HtbQueueDiscTestItem::HtbQueueDiscTestItem (Ptr<Packet> p, const Address & addr, int32_t cls)
+  : QueueDiscItem (p, addr, 0),
+    m_cls (cls)
+{
+}
+
+HtbQueueDiscTestItem::~HtbQueueDiscTestItem ()
+{
+}
+
+void
+HtbQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+HtbQueueDiscTestItem::Mark (void)
+{
+  return false;
+}
+
+int32_t
+HtbQueueDiscTestItem::GetClass (void) const
+{
+  return m_cls;
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Packet Filter, returning the class of HtbQueueDiscTestItem
+ */
+class HtbQueueDiscTestFilter : public PacketFilter
+{
+public:
+  HtbQueueDiscTestFilter ();
+  virtual ~HtbQueueDiscTestFilter ();
+
+private:
+  virtual bool CheckProtocol (Ptr<QueueDiscItem> item) const;
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const;
+};
+
+HtbQueueDiscTestFilter::HtbQueueDiscTestFilter ()
+{
+}
+
+HtbQueueDiscTestFilter::~HtbQueueDiscTestFilter ()
+{
+}
+
+bool
+HtbQueueDiscTestFilter::CheckProtocol (Ptr<QueueDiscItem> item) const
+{
+  return (DynamicCast<HtbQueueDiscTestItem> (item) != 0);
+}
+
+int32_t
+HtbQueueDiscTestFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  return DynamicCast<HtbQueueDiscTestItem> (item)->GetClass ();
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Child Queue Disc, dropping all its packets when dequeued
+ */
+class HtbQueueDiscTestDropper : public QueueDisc
+{
+public:
+  /**
+   * Constructor
+   */
+  HtbQueueDiscTestDropper ();
+  virtual ~HtbQueueDiscTestDropper ();
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  static constexpr const char* AFTER_DEQUEUE = "After dequeue";  //!< Drop after dequeue
+};
+
+HtbQueueDiscTestDropper::HtbQueueDiscTestDropper ()
+  : QueueDisc (QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
+{
+}
+
+HtbQueueDiscTestDropper::~HtbQueueDiscTestDropper ()
+{
+}
+
+bool
+HtbQueueDiscTestDropper::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  return GetInternalQueue (0)->Enqueue (item);
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDiscTestDropper::DoDequeue (void)
+{
+  Ptr<QueueDiscItem> item;
+  while ((item = GetInternalQueue (0)->Dequeue ()) != 0)
+    {
+      DropAfterDequeue (item, AFTER_DEQUEUE);
+    }
+  return 0;
+}
+
+bool
+HtbQueueDiscTestDropper::CheckConfig (void)
+{
+  AddInternalQueue (CreateObject<DropTailQueue<QueueDiscItem> > ());
+  return true;
+}
+
+void
+HtbQueueDiscTestDropper::InitializeParams (void)
+{
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Case
+ *
+ * A root class of 2Mbps is shared by two leaf classes (classes 1 and 2),
+ * which may borrow up to the rate of the root class. The leaf classes are
+ * backlogged at time 0 and the bytes dequeued from each class in 2 seconds
+ * are checked.
+ */
+class HtbQueueDiscSharingTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param name the name of the test case
+   * \param leafRate the rate of the leaf classes
+   * \param prio1 the priority of class 1
+   * \param prio2 the priority of class 2
+   * \param nPkts1 the number of 1000 bytes packets sent to class 1
+   * \param nPkts2 the number of 1000 bytes packets sent to class 2
+   * \param expected1 the expected number of bytes dequeued from class 1
+   * \param expected2 the expected number of bytes dequeued from class 2
+   */
+  HtbQueueDiscSharingTestCase (std::string name, DataRate leafRate, uint32_t prio1, uint32_t prio2,
+                               uint32_t nPkts1, uint32_t nPkts2, uint32_t expected1, uint32_t expected2);
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Dequeue trace sink
+   * \param item the dequeued item
+   */
+  void Dequeue (Ptr<const QueueDiscItem> item);
+
+  DataRate m_leafRate;          //!< the rate of the leaf classes
+  uint32_t m_prio[2];           //!< the priorities of the leaf classes
+  uint32_t m_nPkts[2];          //!< the number of packets sent to the leaf classes
+  uint32_t m_expected[2];       //!< the expected number of bytes dequeued
+  uint32_t m_dequeued[3];       //!< the bytes dequeued from each class
+};
+
+HtbQueueDiscSharingTestCase::HtbQueueDiscSharingTestCase (std::string name, DataRate leafRate,
+                                                          uint32_t prio1, uint32_t prio2,
+                                                          uint32_t nPkts1, uint32_t nPkts2,
+                                                          uint32_t expected1, uint32_t expected2)
+  : TestCase (name),
+    m_leafRate (leafRate),
+    m_prio {prio1, prio2},
+    m_nPkts {nPkts1, nPkts2},
+    m_expected {expected1, expected2},
+    m_dequeued {0, 0, 0}
+{
+}
+
+void
+HtbQueueDiscSharingTestCase::Dequeue (Ptr<const QueueDiscItem> item)
+{
+  Ptr<const HtbQueueDiscTestItem> htbItem = DynamicCast<const HtbQueueDiscTestItem> (item);
+  m_dequeued[htbItem->GetClass ()] += item->GetSize ();
+}
+
+void
+HtbQueueDiscSharingTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  n.Get (0)->AggregateObject (tc);
+  n.Get (1)->AggregateObject (CreateObject<TrafficControlLayer> ());
+
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Mbps")));
+  NetDeviceContainer devices = simple.Install (n);
+
+  TrafficControlHelper tch;
+  uint16_t handle = tch.SetRootQueueDisc ("ns3::HtbQueueDisc", "Mtu", UintegerValue (1500));
+  TrafficControlHelper::ClassIdList cid;
+  cid.push_back (tch.AddQueueDiscClasses (handle, 1, "ns3::HtbClass",
+                                          "Rate", DataRateValue (DataRate ("2Mbps"))).front ());
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      cid.push_back (tch.AddQueueDiscClasses (handle, 1, "ns3::HtbClass",
+                                              "Rate", DataRateValue (m_leafRate),
+                                              "Ceil", DataRateValue (DataRate ("2Mbps")),
+                                              "Parent", IntegerValue (0),
+                                              "Priority", UintegerValue (m_prio[i])).front ());
+    }
+  tch.AddChildQueueDiscs (handle, cid, "ns3::FifoQueueDisc", "MaxSize", StringValue ("5000p"));
+  Ptr<QueueDisc> qdisc = tch.Install (devices.Get (0)).Get (0);
+  qdisc->AddPacketFilter (CreateObject<HtbQueueDiscTestFilter> ());
+  qdisc->TraceConnectWithoutContext ("Dequeue", MakeCallback (&HtbQueueDiscSharingTestCase::Dequeue, this));
+
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      for (uint32_t j = 0; j < m_nPkts[i]; j++)
+        {
+          Simulator::Schedule (Seconds (0), &TrafficControlLayer::Send, tc, devices.Get (0),
+                               Create<HtbQueueDiscTestItem> (Create<Packet> (1000), devices.Get (1)->GetAddress (), i + 1));
+        }
+    }
+
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_dequeued[0], 0, "No packet should be dequeued from the inner class");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      double tol = m_expected[i] * 0.05 + 2000;
+      NS_TEST_EXPECT_MSG_EQ_TOL (static_cast<double> (m_dequeued[i + 1]), m_expected[i], tol,
+                                 "Unexpected number of bytes dequeued from class " << i + 1);
+    }
+
+  Ptr<HtbClass> cl = DynamicCast<HtbClass> (qdisc->GetQueueDiscClass (0));
+  NS_TEST_EXPECT_MSG_EQ (cl->GetLevel (), HtbClass::MAX_DEPTH - 1, "Unexpected level of the root class");
+  if (m_nPkts[1] == 0)
+    {
+      cl = DynamicCast<HtbClass> (qdisc->GetQueueDiscClass (1));
+      NS_TEST_EXPECT_MSG_GT (cl->GetNBorrows (), 0, "Class 1 should have borrowed from the root class");
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Classification Test Case
+ *
+ * Check that the packets which are not classified into a leaf class are
+ * enqueued into the default class or, if there is none, dropped.
+ */
+class HtbQueueDiscClassifyTestCase : public TestCase
+{
+public:
+  HtbQueueDiscClassifyTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Run a test
+   * \param defaultClass the value of the DefaultClass attribute
+   */
+  void RunHtbTest (int32_t defaultClass);
+};
+
+HtbQueueDiscClassifyTestCase::HtbQueueDiscClassifyTestCase ()
+  : TestCase ("Check the classification of packets by the HTB queue disc")
+{
+}
+
+void
+HtbQueueDiscClassifyTestCase::RunHtbTest (int32_t defaultClass)
+{
+  Ptr<HtbQueueDisc> qdisc = CreateObjectWithAttributes<HtbQueueDisc> ("DefaultClass", IntegerValue (defaultClass));
+  qdisc->AddPacketFilter (CreateObject<HtbQueueDiscTestFilter> ());
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<HtbClass> cl = CreateObjectWithAttributes<HtbClass> ("Rate", DataRateValue (DataRate ("1Mbps")),
+                                                               "Parent", IntegerValue (i ? 0 : -1));
+      Ptr<QueueDisc> child = CreateObject<FifoQueueDisc> ();
+      child->Initialize ();
+      cl->SetQueueDisc (child);
+      qdisc->AddQueueDiscClass (cl);
+    }
+  qdisc->Initialize ();
+
+  Address dest;
+  // class 1 is a leaf class, class 0 an inner class and class 5 does not exist
+  qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (100), dest, 1));
+  qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (100), dest, 0));
+  qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (100), dest, 5));
+
+  uint32_t nDefault = (defaultClass >= 0 ? 2 : 0);
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (),
+                         1 + (defaultClass == 1 ? nDefault : 0), "Unexpected number of packets in class 1");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetQueueDiscClass (2)->GetQueueDisc ()->GetNPackets (),
+                         (defaultClass == 2 ? nDefault : 0), "Unexpected number of packets in class 2");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 0,
+                         "No packet should be enqueued into the inner class");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetStats ().GetNDroppedPackets (HtbQueueDisc::UNCLASSIFIED_DROP), 2 - nDefault,
+                         "Unexpected number of unclassified packets");
+
+  // the packets are released as long as the leaf classes have tokens
+  for (uint32_t i = 0; i < 1 + nDefault; i++)
+    {
+      NS_TEST_EXPECT_MSG_NE (qdisc->Dequeue (), 0, "A packet should be dequeued");
+    }
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 0, "The queue disc should be empty");
+
+  qdisc->Dispose ();
+  Simulator::Destroy ();
+}
+
+void
+HtbQueueDiscClassifyTestCase::DoRun (void)
+{
+  RunHtbTest (-1);
+  RunHtbTest (1);
+  RunHtbTest (2);
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Empty Class Test Case
+ *
+ * Check that the other classes are still served when the round robin
+ * reaches a class whose child queue disc dropped its packets at dequeue.
+ */
+class HtbQueueDiscEmptyClassTestCase : public TestCase
+{
+public:
+  HtbQueueDiscEmptyClassTestCase ();
+  virtual void DoRun (void);
+};
+
+HtbQueueDiscEmptyClassTestCase::HtbQueueDiscEmptyClassTestCase ()
+  : TestCase ("Check that HTB serves the other classes when a child queue disc drops at dequeue")
+{
+}
+
+void
+HtbQueueDiscEmptyClassTestCase::DoRun (void)
+{
+  Ptr<HtbQueueDisc> qdisc = CreateObject<HtbQueueDisc> ();
+  qdisc->AddPacketFilter (CreateObject<HtbQueueDiscTestFilter> ());
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      // a quantum of one packet moves the round robin after each packet
+      Ptr<HtbClass> cl = CreateObjectWithAttributes<HtbClass> ("Rate", DataRateValue (DataRate ("1Mbps")),
+                                                               "Parent", IntegerValue (i ? 0 : -1),
+                                                               "Quantum", UintegerValue (100));
+      Ptr<QueueDisc> child;
+      if (i == 1)
+        {
+          child = CreateObject<HtbQueueDiscTestDropper> ();
+        }
+      else
+        {
+          child = CreateObject<FifoQueueDisc> ();
+        }
+      child->Initialize ();
+      cl->SetQueueDisc (child);
+      qdisc->AddQueueDiscClass (cl);
+    }
+  qdisc->Initialize ();
+
+  // class 1 is served first, but its packet is dropped at dequeue
+  Address dest;
+  qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (100), dest, 1));
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (100), dest, 2));
+    }
+
+  // once class 1 is empty, the round robin comes back to it after each
+  // packet of class 2, which has to be served nonetheless
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<QueueDiscItem> item = qdisc->Dequeue ();
+      NS_TEST_ASSERT_MSG_NE (item, 0, "A packet of class 2 should be dequeued");
+      NS_TEST_EXPECT_MSG_EQ (DynamicCast<HtbQueueDiscTestItem> (item)->GetClass (), 2,
+                             "The packet should belong to class 2");
+    }
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 0, "The queue disc should be empty");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetStats ()
+                         .GetNDroppedPackets (HtbQueueDiscTestDropper::AFTER_DEQUEUE), 1,
+                         "The packet of class 1 should have been dropped");
+
+  qdisc->Dispose ();
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Suite
+ */
+static class HtbQueueDiscTestSuite : public TestSuite
+{
+public:
+  HtbQueueDiscTestSuite ()
+    : TestSuite ("htb-queue-disc", UNIT)
+  {
+    // the leaf classes share the rate of the root class equally
+    AddTestCase (new HtbQueueDiscSharingTestCase ("Two backlogged classes borrowing equally",
+                                                  DataRate ("1Mbps"), 0, 0, 2000, 2000,
+                                                  250000, 250000), TestCase::QUICK);
+    // a single backlogged class borrows all the rate of the root class
+    AddTestCase (new HtbQueueDiscSharingTestCase ("A single backlogged class borrowing",
+                                                  DataRate ("1Mbps"), 0, 0, 2000, 0,
+                                                  500000, 0), TestCase::QUICK);
+    // the excess rate is lent to the class with the highest priority
+    AddTestCase (new HtbQueueDiscSharingTestCase ("Borrowing by priority",
+                                                  DataRate ("500kbps"), 0, 1, 2000, 2000,
+                                                  375000, 125000), TestCase::QUICK);
+    AddTestCase (new HtbQueueDiscClassifyTestCase (), TestCase::QUICK);
+    AddTestCase (new HtbQueueDiscEmptyClassTestCase (), TestCase::QUICK);
+  }
+} g_htbQueueDiscTestSuite; ///< the test suite
@@ -34,6 +34,8 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/queue.h"
 #include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/queue-disc.h"
 
 using namespace ns3;
 
@@ -363,6 +365,132 @@ TcFlowControlTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Traffic Control Bypass Test Case
+ */
+class TcBypassTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param bypass whether empty queue discs can be bypassed
+   */
+  TcBypassTestCase (bool bypass);
+  virtual ~TcBypassTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Instruct a node to send a specified number of packets
+   * \param n the node
+   * \param nPackets the number of packets to send
+   */
+  void SendPackets (Ptr<Node> n, uint16_t nPackets);
+  /**
+   * Check the number of packets in the device queue and in the queue disc
+   * \param dev the device
+   * \param nDevPackets the expected number of packets stored in the device queue
+   * \param nQdPackets the expected number of packets stored in the queue disc
+   */
+  void CheckPackets (Ptr<NetDevice> dev, uint16_t nDevPackets, uint16_t nQdPackets);
+  /**
+   * Count the packets enqueued in the queue disc
+   * \param item the item enqueued
+   */
+  void Enqueue (Ptr<const QueueDiscItem> item);
+  bool m_bypass;         //!< whether empty queue discs can be bypassed
+  uint32_t m_nEnqueued;  //!< number of times the Enqueue trace has been fired
+};
+
+TcBypassTestCase::TcBypassTestCase (bool bypass)
+  : TestCase (std::string ("Test the bypass of empty queue discs (bypass ") + (bypass ? "enabled)" : "disabled)")),
+    m_bypass (bypass),
+    m_nEnqueued (0)
+{
+}
+
+TcBypassTestCase::~TcBypassTestCase ()
+{
+}
+
+void
+TcBypassTestCase::SendPackets (Ptr<Node> n, uint16_t nPackets)
+{
+  Ptr<TrafficControlLayer> tc = n->GetObject<TrafficControlLayer> ();
+  for (uint16_t i = 0; i < nPackets; i++)
+    {
+      tc->Send (n->GetDevice (0), Create<QueueDiscTestItem> (Create<Packet> (1000)));
+    }
+}
+
+void
+TcBypassTestCase::CheckPackets (Ptr<NetDevice> dev, uint16_t nDevPackets, uint16_t nQdPackets)
+{
+  PointerValue ptr;
+  dev->GetAttributeFailSafe ("TxQueue", ptr);
+  Ptr<Queue<Packet> > queue = ptr.Get<Queue<Packet> > ();
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), nDevPackets, "Unexpected number of packets in the device queue");
+  Ptr<TrafficControlLayer> tc = dev->GetNode ()->GetObject<TrafficControlLayer> ();
+  NS_TEST_EXPECT_MSG_EQ (tc->GetRootQueueDiscOnDevice (dev)->GetNPackets (), nQdPackets,
+                         "Unexpected number of packets in the queue disc");
+}
+
+void
+TcBypassTestCase::Enqueue (Ptr<const QueueDiscItem> item)
+{
+  m_nEnqueued++;
+}
+
+void
+TcBypassTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  tc->SetAttribute ("Bypass", BooleanValue (m_bypass));
+  n.Get (0)->AggregateObject (tc);
+  n.Get (1)->AggregateObject (CreateObject<TrafficControlLayer> ());
+
+  SimpleNetDeviceHelper simple;
+
+  NetDeviceContainer rxDevC = simple.Install (n.Get (1));
+
+  simple.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("1Mb/s")));
+  simple.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue ("5p"));
+
+  Ptr<NetDevice> txDev;
+  txDev = simple.Install (n.Get (0), DynamicCast<SimpleChannel> (rxDevC.Get (0)->GetChannel ())).Get (0);
+  txDev->SetMtu (2500);
+
+  TrafficControlHelper tch;
+  tch.SetRootQueueDisc ("ns3::FifoQueueDisc");
+  QueueDiscContainer qdiscs = tch.Install (txDev);
+  qdiscs.Get (0)->TraceConnectWithoutContext ("Enqueue", MakeCallback (&TcBypassTestCase::Enqueue, this));
+
+  // transmit 10 packets at time 0
+  Simulator::Schedule (Time (Seconds (0)), &TcBypassTestCase::SendPackets, this, n.Get (0), 10);
+
+  // The first packet is being transmitted and the next five packets fill the device
+  // queue, which is then stopped. Whether they bypassed the queue disc or not, the
+  // remaining four packets are stored in the queue disc.
+  Simulator::Schedule (Time (MilliSeconds (1)), &TcBypassTestCase::CheckPackets, this, txDev, 5, 4);
+  Simulator::Schedule (Time (MilliSeconds (81)), &TcBypassTestCase::CheckPackets, this, txDev, 0, 0);
+
+  Simulator::Run ();
+
+  const QueueDisc::Stats& stats = qdiscs.Get (0)->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.nTotalReceivedPackets, 10, "Unexpected number of received packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.nTotalEnqueuedPackets, 10, "Unexpected number of enqueued packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.nTotalSentPackets, 10, "Unexpected number of sent packets");
+  NS_TEST_EXPECT_MSG_EQ (m_nEnqueued, (m_bypass ? 4 : 10), "Unexpected number of Enqueue traces");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup traffic-control-test
  * \ingroup tests
@@ -377,5 +505,7 @@ public:
   {
     AddTestCase (new TcFlowControlTestCase (QueueSizeUnit::PACKETS), TestCase::QUICK);
     AddTestCase (new TcFlowControlTestCase (QueueSizeUnit::BYTES), TestCase::QUICK);
+    AddTestCase (new TcBypassTestCase (false), TestCase::QUICK);
+    AddTestCase (new TcBypassTestCase (true), TestCase::QUICK);
   }
 } g_tcFlowControlTestSuite; ///< the test suite
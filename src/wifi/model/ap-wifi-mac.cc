@@ -23,6 +23,7 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/abort.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
 #include "ns3/random-variable-stream.h"
@@ -37,6 +38,7 @@
 #include "wifi-net-device.h"
 #include "ht-configuration.h"
 #include "he-configuration.h"
+#include "sta-wifi-mac.h"
 
 namespace ns3 {
 
@@ -44,6 +46,9 @@ NS_LOG_COMPONENT_DEFINE ("ApWifiMac");
 
 NS_OBJECT_ENSURE_REGISTERED (ApWifiMac);
 
+/// The APs that fast-forward their beacons, indexed by BSSID
+static std::map<Mac48Address, ApWifiMac *> g_beaconFastForwardAps;
+
 TypeId
 ApWifiMac::GetTypeId (void)
 {
@@ -78,6 +83,16 @@ ApWifiMac::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&ApWifiMac::SetBeaconGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("EnableBeaconFastForward",
+                   "If true, a beacon that repeats the previous one is not transmitted when the AP neither "
+                   "transmitted nor received another frame since the previous beacon and all the "
+                   "stations that received the previous one are static and awake on the channel of the AP: "
+                   "these stations are credited with the beacon instead, even if a random propagation loss "
+                   "(e.g., fading) could have made them miss it. "
+                   "Stations can only discover such an AP by active probing once it has associated stations.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ApWifiMac::m_enableBeaconFastForward),
+                   MakeBooleanChecker ())
     .AddAttribute ("EnableNonErpProtection", "Whether or not protection mechanism should be used when non-ERP STAs are present within the BSS."
                    "This parameter is only used when ERP is supported by the AP.",
                    BooleanValue (true),
@@ -93,7 +108,9 @@ ApWifiMac::GetTypeId (void)
 }
 
 ApWifiMac::ApWifiMac ()
-  : m_enableBeaconGeneration (false)
+  : m_enableBeaconGeneration (false),
+    m_beaconVersion (0),
+    m_mediumBusy (false)
 {
   NS_LOG_FUNCTION (this);
   m_beaconTxop = CreateObject<Txop> ();
@@ -130,6 +147,12 @@ ApWifiMac::DoDispose ()
   m_enableBeaconGeneration = false;
   m_beaconEvent.Cancel ();
   m_cfpEvent.Cancel ();
+  auto it = g_beaconFastForwardAps.find (GetAddress ());
+  if (it != g_beaconFastForwardAps.end () && it->second == this)
+    {
+      g_beaconFastForwardAps.erase (it);
+    }
+  m_beaconFollowers.clear ();
   RegularWifiMac::DoDispose ();
 }
 
@@ -915,8 +938,20 @@ ApWifiMac::SendOneBeacon (void)
     }
   packet->AddHeader (beacon);
 
-  //The beacon has it's own special queue, so we load it in there
-  m_beaconTxop->Queue (packet, hdr);
+  if (m_enableBeaconFastForward && CanFastForwardBeacon (packet))
+    {
+      NS_LOG_DEBUG ("Fast-forward beacon to " << m_beaconFollowers.size () << " stations");
+      for (auto &follower : m_beaconFollowers)
+        {
+          follower.first->NotifyFastForwardedBeacon (GetBeaconInterval ());
+        }
+    }
+  else
+    {
+      //The beacon has it's own special queue, so we load it in there
+      m_beaconTxop->Queue (packet, hdr);
+    }
+  m_mediumBusy = false;
   m_beaconEvent = Simulator::Schedule (GetBeaconInterval (), &ApWifiMac::SendOneBeacon, this);
 
   //If a STA that does not support Short Slot Time associates,
@@ -1562,6 +1597,80 @@ ApWifiMac::DeaggregateAmsduAndForward (Ptr<WifiMacQueueItem> mpdu)
     }
 }
 
+bool
+ApWifiMac::CanFastForwardBeacon (Ptr<const Packet> beacon)
+{
+  NS_LOG_FUNCTION (this << beacon);
+  //Skip the timestamp, which is the only field that changes with every beacon
+  std::vector<uint8_t> content (beacon->GetSize ());
+  beacon->CopyData (content.data (), content.size ());
+  content.erase (content.begin (), content.begin () + 8);
+  if (content != m_lastBeacon)
+    {
+      m_lastBeacon.swap (content);
+      m_beaconVersion++;
+      return false;
+    }
+  //A beacon sent while the BSS is active could collide with, or delay, other frames
+  if (m_mediumBusy || m_beaconFollowers.empty () || m_phy->IsStateOff () || m_phy->IsStateSleep ())
+    {
+      return false;
+    }
+  for (const auto &follower : m_beaconFollowers)
+    {
+      if (follower.second != m_beaconVersion || !follower.first->CanReceiveFastForwardedBeacon ())
+        {
+          NS_LOG_DEBUG ("Station " << follower.first->GetAddress () << " needs a beacon");
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+ApWifiMac::PhyTxBegin (Ptr<const Packet> mpdu, double txPowerW)
+{
+  NS_LOG_FUNCTION (this << mpdu << txPowerW);
+  if (!m_mediumBusy)
+    {
+      WifiMacHeader hdr;
+      mpdu->PeekHeader (hdr);
+      m_mediumBusy = !hdr.IsBeacon ();
+    }
+}
+
+void
+ApWifiMac::PhyRxBegin (Ptr<const Packet> mpdu)
+{
+  NS_LOG_FUNCTION (this << mpdu);
+  m_mediumBusy = true;
+}
+
+Ptr<ApWifiMac>
+ApWifiMac::GetBeaconFastForwardAp (Mac48Address bssid)
+{
+  auto it = g_beaconFastForwardAps.find (bssid);
+  if (it == g_beaconFastForwardAps.end ())
+    {
+      return 0;
+    }
+  return it->second;
+}
+
+void
+ApWifiMac::AddBeaconFollower (Ptr<StaWifiMac> sta)
+{
+  NS_LOG_FUNCTION (this << sta);
+  m_beaconFollowers[sta] = m_beaconVersion;
+}
+
+void
+ApWifiMac::RemoveBeaconFollower (Ptr<StaWifiMac> sta)
+{
+  NS_LOG_FUNCTION (this << sta);
+  m_beaconFollowers.erase (sta);
+}
+
 void
 ApWifiMac::DoInitialize (void)
 {
@@ -1582,6 +1691,14 @@ ApWifiMac::DoInitialize (void)
           m_beaconEvent = Simulator::ScheduleNow (&ApWifiMac::SendOneBeacon, this);
         }
     }
+  if (m_enableBeaconFastForward)
+    {
+      NS_ABORT_MSG_IF (g_beaconFastForwardAps.find (GetAddress ()) != g_beaconFastForwardAps.end (),
+                       "Two APs fast-forwarding their beacons share the BSSID " << GetAddress ());
+      g_beaconFastForwardAps[GetAddress ()] = this;
+      m_phy->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&ApWifiMac::PhyTxBegin, this));
+      m_phy->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&ApWifiMac::PhyRxBegin, this));
+    }
   RegularWifiMac::DoInitialize ();
 }
 
@@ -36,6 +36,7 @@ class HtOperation;
 class VhtOperation;
 class HeOperation;
 class CfParameterSet;
+class StaWifiMac;
 
 /**
  * \brief Wi-Fi AP state machine
@@ -121,6 +122,24 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \param bssid the BSSID of an AP
+   * \return the AP with the given BSSID if it fast-forwards its beacons, 0 otherwise
+   */
+  static Ptr<ApWifiMac> GetBeaconFastForwardAp (Mac48Address bssid);
+  /**
+   * Notify that a station associated to this AP received one of its beacons.
+   * Until it is removed, the station is notified of the beacons that are
+   * fast-forwarded, as long as it can receive them.
+   *
+   * \param sta the station
+   */
+  void AddBeaconFollower (Ptr<StaWifiMac> sta);
+  /**
+   * \param sta the station that no longer receives the beacons of this AP
+   */
+  void RemoveBeaconFollower (Ptr<StaWifiMac> sta);
+
 
 private:
   void Receive (Ptr<WifiMacQueueItem> mpdu);
@@ -191,6 +210,30 @@ private:
    * Forward a beacon packet to the beacon special DCF.
    */
   void SendOneBeacon (void);
+  /**
+   * Return whether a beacon can be fast-forwarded, i.e., whether it only
+   * repeats the previous beacon to stations that would receive it as they
+   * received the previous one.
+   *
+   * \param beacon the beacon (without MAC header)
+   * \return true if the beacon can be fast-forwarded
+   */
+  bool CanFastForwardBeacon (Ptr<const Packet> beacon);
+  /**
+   * Callback invoked when the PHY of the AP starts transmitting an MPDU.
+   * Any transmission but a beacon means that the BSS is not idle.
+   *
+   * \param mpdu the MPDU, with its MAC header
+   * \param txPowerW the transmit power in Watts
+   */
+  void PhyTxBegin (Ptr<const Packet> mpdu, double txPowerW);
+  /**
+   * Callback invoked when the PHY of the AP starts receiving an MPDU,
+   * which means that the medium is not idle.
+   *
+   * \param mpdu the MPDU, with its MAC header
+   */
+  void PhyRxBegin (Ptr<const Packet> mpdu);
   /**
    * Determine what is the next PCF frame and trigger its transmission.
    */
@@ -299,6 +342,11 @@ private:
   EventId m_cfpEvent;                        //!< Event to generate one PCF frame
   Ptr<UniformRandomVariable> m_beaconJitter; //!< UniformRandomVariable used to randomize the time of the first beacon
   bool m_enableBeaconJitter;                 //!< Flag whether the first beacon should be generated at random time
+  bool m_enableBeaconFastForward;            //!< Flag whether repeated beacons are fast-forwarded
+  std::vector<uint8_t> m_lastBeacon;         //!< Content of the last transmitted beacon, without timestamp
+  uint32_t m_beaconVersion;                  //!< Number of times the content of the beacons changed
+  bool m_mediumBusy;                         //!< Flag whether the PHY of the AP transmitted or received another frame than its beacons since the previous beacon
+  std::map<Ptr<StaWifiMac>, uint32_t> m_beaconFollowers; //!< Stations credited with the fast-forwarded beacons, with the version of the last beacon they received
   std::map<uint16_t, Mac48Address> m_staList; //!< Map of all stations currently associated to the AP with their association ID
   std::list<Mac48Address> m_nonErpStations;  //!< List of all non-ERP stations currently associated to the AP
   std::list<Mac48Address> m_nonHtStations;   //!< List of all non-HT stations currently associated to the AP
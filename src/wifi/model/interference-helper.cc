@@ -19,6 +19,7 @@
  *          Sébastien Deronne <sebastien.deronne@gmail.com>
  */
 
+#include <algorithm>
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
@@ -229,11 +230,51 @@ InterferenceHelper::AppendEvent (Ptr<Event> event)
       m_niChanges.erase (++(m_niChanges.begin ()),
                          GetNextPosition (event->GetStartTime ()));
     }
-  auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
-  auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
-  for (auto i = first; i != last; ++i)
+  else
     {
-      i->second.AddPower (event->GetRxPowerW ());
+      PruneNiChanges ();
+    }
+  std::size_t first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
+  std::size_t last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
+  for (std::size_t i = first; i != last; ++i)
+    {
+      m_niChanges[i].second.AddPower (event->GetRxPowerW ());
+    }
+}
+
+void
+InterferenceHelper::PruneNiChanges (void)
+{
+  NS_LOG_FUNCTION (this);
+  // The medium may never be idle (hence the NiChanges never be erased by
+  // AppendEvent) in saturated scenarios: the NiChanges before the start of
+  // the oldest signal in flight, which has its end NiChange after now, are
+  // not needed anymore.
+  Time now = Simulator::Now ();
+  Time oldestStart = now;
+  for (auto it = m_niChanges.rbegin (); it != m_niChanges.rend () && it->first >= now; ++it)
+    {
+      Ptr<Event> event = it->second.GetEvent ();
+      if (event != 0 && event->GetStartTime () < oldestStart)
+        {
+          oldestStart = event->GetStartTime ();
+        }
+    }
+  auto keep = std::lower_bound (m_niChanges.cbegin (), m_niChanges.cend (), oldestStart,
+                                [] (const std::pair<Time, NiChange> &change, Time moment)
+                                { return change.first < moment; });
+  // Also keep the two NiChanges before now, looked up at the end of a reception
+  auto previous = GetPreviousPosition (now);
+  if (previous - m_niChanges.cbegin () < 2)
+    {
+      return;
+    }
+  keep = std::min (keep, previous - 1);
+  if (keep - m_niChanges.cbegin () > 1)
+    {
+      NS_LOG_DEBUG ("Remove " << keep - m_niChanges.cbegin () - 1 << " NiChanges before " << keep->first);
+      // Always leave the first zero power noise event in the list
+      m_niChanges.erase (++(m_niChanges.cbegin ()), keep);
     }
 }
 
@@ -264,19 +305,20 @@ double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
 {
   double noiseInterferenceW = m_firstPower;
-  auto it = m_niChanges.find (event->GetStartTime ());
+  auto it = Find (event->GetStartTime ());
   for (; it != m_niChanges.end () && it->first < Simulator::Now (); ++it)
     {
       noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW ();
     }
-  it = m_niChanges.find (event->GetStartTime ());
+  it = Find (event->GetStartTime ());
   for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
+  // the NiChanges between the start and the end of the event are in order
+  ni->emplace_back (event->GetStartTime (), NiChange (0, event));
   while (++it != m_niChanges.end () && it->second.GetEvent () != event)
     {
-      ni->insert (*it);
+      ni->push_back (*it);
     }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
+  ni->emplace_back (event->GetEndTime (), NiChange (0, event));
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -294,6 +336,12 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
   return csr;
 }
 
+std::size_t
+InterferenceHelper::GetNNiChanges (void) const
+{
+  return m_niChanges.size ();
+}
+
 double
 InterferenceHelper::CalculatePayloadChunkSuccessRate (double snir, Time duration, WifiTxVector txVector) const
 {
@@ -820,7 +868,22 @@ InterferenceHelper::EraseEvents (void)
 InterferenceHelper::NiChanges::const_iterator
 InterferenceHelper::GetNextPosition (Time moment) const
 {
-  return m_niChanges.upper_bound (moment);
+  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), moment,
+                           [] (Time t, const std::pair<Time, NiChange> &change)
+                           { return t < change.first; });
+}
+
+InterferenceHelper::NiChanges::const_iterator
+InterferenceHelper::Find (Time moment) const
+{
+  auto it = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), moment,
+                              [] (const std::pair<Time, NiChange> &change, Time t)
+                              { return change.first < t; });
+  if (it != m_niChanges.end () && it->first != moment)
+    {
+      return m_niChanges.end ();
+    }
+  return it;
 }
 
 InterferenceHelper::NiChanges::const_iterator
@@ -833,10 +896,11 @@ InterferenceHelper::GetPreviousPosition (Time moment) const
   return it;
 }
 
-InterferenceHelper::NiChanges::iterator
+std::size_t
 InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change)
 {
-  return m_niChanges.insert (GetNextPosition (moment), std::make_pair (moment, change));
+  auto it = m_niChanges.insert (GetNextPosition (moment), std::make_pair (moment, change));
+  return it - m_niChanges.begin ();
 }
 
 void
@@ -23,7 +23,7 @@
 
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
-#include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -265,6 +265,10 @@ protected:
    * \return the success rate
    */
   double CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * \return the number of noise and interference changes kept
+   */
+  std::size_t GetNNiChanges (void) const;
 
 
 private:
@@ -307,9 +311,12 @@ private:
   };
 
   /**
-   * typedef for a multimap of NiChanges
+   * typedef for a time-ordered sequence of NiChanges. Most changes are
+   * appended near the end (the end of the signals in flight), and the
+   * oldest ones are removed from the front, so that a deque is used
+   * rather than a node-based map.
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::deque<std::pair<Time, NiChange> > NiChanges;
 
   /**
    * Append the given Event.
@@ -317,6 +324,11 @@ private:
    * \param event
    */
   void AppendEvent (Ptr<Event> event);
+  /**
+   * Remove the NiChanges which are not needed anymore while receiving,
+   * i.e., the ones before the start of the oldest signal in flight.
+   */
+  void PruneNiChanges (void);
   /**
    * Calculate noise and interference power in W.
    *
@@ -402,13 +414,22 @@ private:
 
   /**
    * Add NiChange to the list at the appropriate position and
-   * return the iterator of the new event.
+   * return the index of the new event.
    *
    * \param moment time to check from
    * \param change the NiChange to add
-   * \returns the iterator of the new event
+   * \returns the index of the new event (the iterators of the list are
+   *          invalidated by the insertion)
+   */
+  std::size_t AddNiChangeEvent (Time moment, NiChange change);
+  /**
+   * Returns an iterator to the first NiChange at the given moment
+   *
+   * \param moment time to check from
+   * \returns an iterator to the list of NiChanges (its end if there is
+   *          no NiChange at this moment)
    */
-  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change);
+  NiChanges::const_iterator Find (Time moment) const;
 };
 
 } //namespace ns3
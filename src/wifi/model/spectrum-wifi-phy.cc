@@ -61,6 +61,7 @@ SpectrumWifiPhy::GetTypeId (void)
 }
 
 SpectrumWifiPhy::SpectrumWifiPhy ()
+  : m_rfFilterChannelWidth (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -76,6 +77,7 @@ SpectrumWifiPhy::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_channel = 0;
   m_wifiSpectrumPhyInterface = 0;
+  m_rfFilter = 0;
   WifiPhy::DoDispose ();
 }
 
@@ -206,11 +208,16 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
   // spectral mask representing our filtering allows) to find the
   // total energy apparent to the "demodulator".
   uint16_t channelWidth = GetChannelWidth ();
-  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (GetFrequency (), channelWidth, GetBandBandwidth (), GetGuardBandwidth (channelWidth));
-  SpectrumValue filteredSignal = (*filter) * (*receivedSignalPsd);
+  if (m_rfFilter == 0 || m_rfFilter->GetSpectrumModel () != receivedSignalPsd->GetSpectrumModel ()
+      || m_rfFilterChannelWidth != channelWidth)
+    {
+      m_rfFilter = WifiSpectrumValueHelper::CreateRfFilter (GetFrequency (), channelWidth, GetBandBandwidth (), GetGuardBandwidth (channelWidth));
+      m_rfFilterChannelWidth = channelWidth;
+    }
+  double filteredPowerW = Integral (*m_rfFilter, *receivedSignalPsd);
   // Add receiver antenna gain
-  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << Integral (filteredSignal));
-  double rxPowerW = Integral (filteredSignal) * DbToRatio (GetRxGain ());
+  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << filteredPowerW);
+  double rxPowerW = filteredPowerW * DbToRatio (GetRxGain ());
   NS_LOG_DEBUG ("Signal power received after antenna gain: " << rxPowerW << " W (" << WToDbm (rxPowerW) << " dBm)");
 
   Ptr<WifiSpectrumSignalParameters> wifiRxParams = DynamicCast<WifiSpectrumSignalParameters> (rxParams);
@@ -241,8 +248,7 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
     }
 
   NS_LOG_INFO ("Received Wi-Fi signal");
-  Ptr<WifiPpdu> ppdu = Copy (wifiRxParams->ppdu);
-  StartReceivePreamble (ppdu, rxPowerW);
+  StartReceivePreamble (wifiRxParams->ppdu, rxPowerW);
 }
 
 Ptr<AntennaModel>
@@ -313,7 +319,7 @@ SpectrumWifiPhy::GetCenterFrequencyForChannelWidth (WifiTxVector txVector) const
 }
 
 void
-SpectrumWifiPhy::StartTx (Ptr<WifiPpdu> ppdu)
+SpectrumWifiPhy::StartTx (Ptr<const WifiPpdu> ppdu)
 {
   NS_LOG_FUNCTION (this << ppdu);
   WifiTxVector txVector = ppdu->GetTxVector ();
@@ -61,7 +61,7 @@ public:
   virtual ~SpectrumWifiPhy ();
 
   // Implementation of pure virtual method.
-  void StartTx (Ptr<WifiPpdu> ppdu);
+  void StartTx (Ptr<const WifiPpdu> ppdu);
   Ptr<Channel> GetChannel (void) const;
 
   /**
@@ -186,6 +186,8 @@ private:
   Ptr<WifiSpectrumPhyInterface> m_wifiSpectrumPhyInterface; //!< Spectrum PHY interface
   Ptr<AntennaModel> m_antenna;                              //!< antenna model
   mutable Ptr<const SpectrumModel> m_rxSpectrumModel;       //!< receive spectrum model
+  Ptr<SpectrumValue> m_rfFilter;                            //!< receive filter, kept while the spectrum model and the channel width are unchanged
+  uint16_t m_rfFilterChannelWidth;                          //!< channel width of the receive filter (MHz)
   bool m_disableWifiReception;                              //!< forces this PHY to fail to sync on any signal
   TracedCallback<bool, uint32_t, double, Time> m_signalCb;  //!< Signal callback
 
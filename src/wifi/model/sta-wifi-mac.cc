@@ -23,7 +23,9 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
 #include "sta-wifi-mac.h"
+#include "ap-wifi-mac.h"
 #include "wifi-phy.h"
 #include "mac-low.h"
 #include "mgt-headers.h"
@@ -92,7 +94,9 @@ StaWifiMac::StaWifiMac ()
     m_waitBeaconEvent (),
     m_probeRequestEvent (),
     m_assocRequestEvent (),
-    m_beaconWatchdogEnd (Seconds (0))
+    m_beaconWatchdogEnd (Seconds (0)),
+    m_courseChanges (0),
+    m_apCourseChanges (0)
 {
   NS_LOG_FUNCTION (this);
 
@@ -113,6 +117,14 @@ StaWifiMac::~StaWifiMac ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+StaWifiMac::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  UnfollowBeacons ();
+  RegularWifiMac::DoDispose ();
+}
+
 uint16_t
 StaWifiMac::GetAssociationId (void) const
 {
@@ -419,6 +431,71 @@ StaWifiMac::RestartBeaconWatchdog (Time delay)
     }
 }
 
+void
+StaWifiMac::FollowBeacons (Mac48Address bssid)
+{
+  NS_LOG_FUNCTION (this << bssid);
+  Ptr<ApWifiMac> ap = ApWifiMac::GetBeaconFastForwardAp (bssid);
+  if (ap != m_beaconFastForwardAp)
+    {
+      UnfollowBeacons ();
+    }
+  if (ap == 0)
+    {
+      return;
+    }
+  Ptr<MobilityModel> mobility = m_phy->GetMobility ();
+  Ptr<MobilityModel> apMobility = ap->GetWifiPhy ()->GetMobility ();
+  if (mobility == 0 || apMobility == 0)
+    {
+      return;
+    }
+  m_courseChanges = mobility->GetCourseChangeCount ();
+  m_apCourseChanges = apMobility->GetCourseChangeCount ();
+  m_beaconFastForwardAp = ap;
+  ap->AddBeaconFollower (this);
+}
+
+void
+StaWifiMac::UnfollowBeacons (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_beaconFastForwardAp != 0)
+    {
+      m_beaconFastForwardAp->RemoveBeaconFollower (this);
+      m_beaconFastForwardAp = 0;
+    }
+}
+
+bool
+StaWifiMac::CanReceiveFastForwardedBeacon (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsAssociated () || m_beaconFastForwardAp == 0)
+    {
+      return false;
+    }
+  Ptr<WifiPhy> apPhy = m_beaconFastForwardAp->GetWifiPhy ();
+  if (m_phy->IsStateOff () || m_phy->IsStateSleep () || m_phy->GetFrequency () != apPhy->GetFrequency ())
+    {
+      return false;
+    }
+  //A static pair of nodes keeps the same propagation loss, fading aside
+  Ptr<MobilityModel> mobility = m_phy->GetMobility ();
+  Ptr<MobilityModel> apMobility = apPhy->GetMobility ();
+  return mobility->GetCourseChangeCount () == m_courseChanges
+         && apMobility->GetCourseChangeCount () == m_apCourseChanges
+         && mobility->GetVelocity () == Vector ()
+         && apMobility->GetVelocity () == Vector ();
+}
+
+void
+StaWifiMac::NotifyFastForwardedBeacon (Time beaconInterval)
+{
+  NS_LOG_FUNCTION (this << beaconInterval);
+  RestartBeaconWatchdog (beaconInterval * m_maxMissedBeacons);
+}
+
 bool
 StaWifiMac::IsAssociated (void) const
 {
@@ -626,6 +703,7 @@ StaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
           Time delay = MicroSeconds (beacon.GetBeaconIntervalUs () * m_maxMissedBeacons);
           RestartBeaconWatchdog (delay);
           UpdateApInfoFromBeacon (beacon, hdr->GetAddr2 (), hdr->GetAddr3 ());
+          FollowBeacons (hdr->GetAddr3 ());
         }
       if (goodBeacon && m_state == WAIT_BEACON)
         {
@@ -1152,6 +1230,7 @@ StaWifiMac::SetState (MacState value)
   else if (value != ASSOCIATED
            && m_state == ASSOCIATED)
     {
+      UnfollowBeacons ();
       m_deAssocLogger (GetBssid ());
     }
   m_state = value;
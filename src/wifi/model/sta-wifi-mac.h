@@ -34,6 +34,7 @@ namespace ns3  {
 
 class SupportedRates;
 class CapabilityInformation;
+class ApWifiMac;
 
 /**
  * \ingroup wifi
@@ -157,6 +158,24 @@ public:
    */
   uint16_t GetAssociationId (void) const;
 
+  /**
+   * Return whether this station would receive a beacon fast-forwarded by
+   * its AP as it received the last beacon of the AP, i.e., whether it is
+   * still associated, awake on the channel of the AP, and whether neither
+   * the station nor the AP moved since.  A random propagation loss, such
+   * as fading, is not taken into account.
+   *
+   * \return true if the station can receive a fast-forwarded beacon
+   */
+  bool CanReceiveFastForwardedBeacon (void) const;
+  /**
+   * Notify the reception of a beacon fast-forwarded by the AP. The beacon is
+   * not traced as a beacon arrival.
+   *
+   * \param beaconInterval the beacon interval of the AP
+   */
+  void NotifyFastForwardedBeacon (Time beaconInterval);
+
 private:
   /**
    * The current MAC state of the STA.
@@ -278,6 +297,17 @@ private:
    * \param delay the delay before the watchdog fires
    */
   void RestartBeaconWatchdog (Time delay);
+  /**
+   * Register with the AP, if it fast-forwards its beacons, after the
+   * reception of one of its beacons.
+   *
+   * \param bssid the BSSID of the AP
+   */
+  void FollowBeacons (Mac48Address bssid);
+  /**
+   * Stop being credited with the beacons fast-forwarded by the AP.
+   */
+  void UnfollowBeacons (void);
   /**
    * Return an instance of SupportedRates that contains all rates that we support
    * including HT rates.
@@ -314,6 +344,7 @@ private:
   void PhyCapabilitiesChanged (void);
 
   void DoInitialize (void);
+  void DoDispose (void);
 
   MacState m_state;            ///< MAC state
   uint16_t m_aid;              ///< Association AID
@@ -327,6 +358,9 @@ private:
   Time m_beaconWatchdogEnd;    ///< beacon watchdog end
   uint32_t m_maxMissedBeacons; ///< maximum missed beacons
   bool m_activeProbing;        ///< active probing
+  Ptr<ApWifiMac> m_beaconFastForwardAp; ///< the AP fast-forwarding its beacons to this station
+  uint32_t m_courseChanges;    ///< number of course changes of this station at the last beacon
+  uint32_t m_apCourseChanges;  ///< number of course changes of the AP at the last beacon
   std::vector<ApInfo> m_candidateAps; ///< list of candidate APs to associate to
   // Note: std::multiset<ApInfo> might be a candidate container to implement
   // this sorted list, but we are using a std::vector because we want to sort
@@ -0,0 +1,356 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "table-based-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TableBasedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TableBasedErrorRateModel);
+
+namespace {
+
+/// The magic number of the table files ("WERT")
+const uint32_t TABLE_FILE_MAGIC = 0x54524557;
+/// The version of the table file format
+const uint32_t TABLE_FILE_VERSION = 1;
+/// The lower bound of the tabulated log (-log (bit success rate)) values
+const double TABLE_VALUE_MIN = -700;
+/// The upper bound of the tabulated values (a null bit success rate)
+const double TABLE_VALUE_MAX = 7;
+
+/**
+ * \brief Write a value to a table file.
+ * \param os the file
+ * \param value the value
+ */
+template <typename T>
+void
+WriteValue (std::ostream &os, T value)
+{
+  os.write (reinterpret_cast<const char *> (&value), sizeof (T));
+}
+
+/**
+ * \brief Read a value from a table file.
+ * \param is the file
+ * \return the value
+ */
+template <typename T>
+T
+ReadValue (std::istream &is)
+{
+  T value = T ();
+  is.read (reinterpret_cast<char *> (&value), sizeof (T));
+  return value;
+}
+
+/**
+ * \brief Write a string to a table file.
+ * \param os the file
+ * \param value the string
+ */
+void
+WriteString (std::ostream &os, const std::string &value)
+{
+  WriteValue<uint32_t> (os, value.size ());
+  os.write (value.data (), value.size ());
+}
+
+/**
+ * \brief Read a string from a table file.
+ * \param is the file
+ * \return the string
+ */
+std::string
+ReadString (std::istream &is)
+{
+  uint32_t size = ReadValue<uint32_t> (is);
+  std::string value (size, '\0');
+  is.read (&value[0], size);
+  return value;
+}
+
+} // unnamed namespace
+
+TypeId
+TableBasedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableBasedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TableBasedErrorRateModel> ()
+    .AddAttribute ("FallbackErrorRateModel",
+                   "The error rate model the tables are generated from.",
+                   PointerValue (CreateObject<NistErrorRateModel> ()),
+                   MakePointerAccessor (&TableBasedErrorRateModel::m_fallbackModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The first SNR (dB) of the tables. Below it, the fallback model is used.",
+                   DoubleValue (-20),
+                   MakeDoubleAccessor (&TableBasedErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The last SNR (dB) of the tables. Above it, the fallback model is used.",
+                   DoubleValue (60),
+                   MakeDoubleAccessor (&TableBasedErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The SNR step (dB) of the tables.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TableBasedErrorRateModel::m_snrStepDb),
+                   MakeDoubleChecker<double> (0.001))
+    .AddAttribute ("TableFile",
+                   "The file the tables are loaded from, before any table is generated "
+                   "(no file if empty).",
+                   StringValue (""),
+                   MakeStringAccessor (&TableBasedErrorRateModel::m_tableFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TableBasedErrorRateModel::TableBasedErrorRateModel ()
+  : m_lastKey (0),
+    m_last (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TableBasedErrorRateModel::~TableBasedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TableBasedErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_fallbackModel = 0;
+  m_tableSet = 0;
+  m_last = 0;
+  ErrorRateModel::DoDispose ();
+}
+
+uint32_t
+TableBasedErrorRateModel::GetNPoints (void) const
+{
+  NS_ASSERT (m_maxSnrDb > m_minSnrDb);
+  return static_cast<uint32_t> (std::lround ((m_maxSnrDb - m_minSnrDb) / m_snrStepDb)) + 1;
+}
+
+uint64_t
+TableBasedErrorRateModel::GetKey (WifiMode mode, uint16_t channelWidth, uint16_t guardInterval, uint8_t nss)
+{
+  NS_ASSERT (guardInterval < 4096 && nss < 16);
+  return (static_cast<uint64_t> (mode.GetUid ()) << 32) | (static_cast<uint64_t> (channelWidth) << 16)
+         | (guardInterval << 4) | nss;
+}
+
+void
+TableBasedErrorRateModel::GetTableSet (void) const
+{
+  NS_LOG_FUNCTION (this);
+  static std::map<std::string, Ptr<TableSet> > tableSets;
+  std::ostringstream oss;
+  // the error rate models have no state: a model freed and replaced by a
+  // model of the same type at the same address has the same tables
+  oss << PeekPointer (m_fallbackModel) << " "
+      << (m_fallbackModel ? m_fallbackModel->GetInstanceTypeId ().GetName () : "") << " "
+      << m_minSnrDb << " " << m_snrStepDb << " " << GetNPoints ();
+  Ptr<TableSet> &tableSet = tableSets[oss.str ()];
+  if (tableSet == 0)
+    {
+      tableSet = Create<TableSet> ();
+    }
+  m_tableSet = tableSet;
+  if (!m_tableFile.empty () && m_tableSet->files.insert (m_tableFile).second)
+    {
+      ReadTables (m_tableFile);
+    }
+}
+
+const std::vector<double> &
+TableBasedErrorRateModel::GetTable (WifiMode mode, const WifiTxVector &txVector) const
+{
+  uint64_t key = GetKey (mode, txVector.GetChannelWidth (), txVector.GetGuardInterval (), txVector.GetNss ());
+  if (m_last != 0 && key == m_lastKey)
+    {
+      return *m_last;
+    }
+  if (m_tableSet == 0)
+    {
+      GetTableSet ();
+    }
+  auto it = m_tableSet->tables.find (key);
+  if (it == m_tableSet->tables.end ())
+    {
+      NS_LOG_DEBUG ("Generate the table of " << mode << " width=" << txVector.GetChannelWidth ()
+                    << " gi=" << txVector.GetGuardInterval () << " nss=" << +txVector.GetNss ());
+      NS_ABORT_MSG_IF (m_fallbackModel == 0, "No error rate model to generate the tables from");
+      Table table;
+      table.mode = mode;
+      table.channelWidth = txVector.GetChannelWidth ();
+      table.guardInterval = txVector.GetGuardInterval ();
+      table.nss = txVector.GetNss ();
+      uint32_t nPoints = GetNPoints ();
+      table.values.resize (nPoints);
+      for (uint32_t i = 0; i < nPoints; i++)
+        {
+          double snr = std::pow (10.0, (m_minSnrDb + i * m_snrStepDb) / 10.0);
+          // log of the bit success rate, in [-inf, 0]
+          double logPs = std::log (m_fallbackModel->GetChunkSuccessRate (mode, txVector, snr, 1));
+          double value = std::log (-logPs);
+          table.values[i] = std::max (TABLE_VALUE_MIN, std::min (value, TABLE_VALUE_MAX));
+        }
+      it = m_tableSet->tables.insert (std::make_pair (key, std::move (table))).first;
+    }
+  // the elements of an unordered map are not moved by a rehash
+  m_lastKey = key;
+  m_last = &it->second.values;
+  return *m_last;
+}
+
+double
+TableBasedErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  const std::vector<double> &values = GetTable (mode, txVector);
+  double x = (10.0 * std::log10 (snr) - m_minSnrDb) / m_snrStepDb;
+  double value;
+  if (x >= 0 && x < values.size () - 1)
+    {
+      std::size_t i = static_cast<std::size_t> (x);
+      double frac = x - i;
+      value = values[i] + frac * (values[i + 1] - values[i]);
+    }
+  else if (m_fallbackModel != 0)
+    {
+      return m_fallbackModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  else
+    {
+      value = (x < 0 || std::isnan (x)) ? values.front () : values.back ();
+    }
+  return std::exp (-static_cast<double> (nbits) * std::exp (value));
+}
+
+void
+TableBasedErrorRateModel::GenerateTable (WifiMode mode, WifiTxVector txVector)
+{
+  NS_LOG_FUNCTION (this << mode << txVector);
+  GetTable (mode, txVector);
+}
+
+uint32_t
+TableBasedErrorRateModel::GetNTables (void) const
+{
+  if (m_tableSet == 0)
+    {
+      GetTableSet ();
+    }
+  return m_tableSet->tables.size ();
+}
+
+void
+TableBasedErrorRateModel::SaveTables (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ofstream os (filename.c_str (), std::ios::binary);
+  NS_ABORT_MSG_UNLESS (os.is_open (), "Cannot open the table file " << filename);
+  if (m_tableSet == 0)
+    {
+      GetTableSet ();
+    }
+  uint32_t nPoints = GetNPoints ();
+  WriteValue<uint32_t> (os, TABLE_FILE_MAGIC);
+  WriteValue<uint32_t> (os, TABLE_FILE_VERSION);
+  WriteString (os, m_fallbackModel ? m_fallbackModel->GetInstanceTypeId ().GetName () : "");
+  WriteValue<double> (os, m_minSnrDb);
+  WriteValue<double> (os, m_snrStepDb);
+  WriteValue<uint32_t> (os, nPoints);
+  WriteValue<uint32_t> (os, m_tableSet->tables.size ());
+  for (const auto &it : m_tableSet->tables)
+    {
+      const Table &table = it.second;
+      NS_ASSERT (table.values.size () == nPoints);
+      WriteString (os, table.mode.GetUniqueName ());
+      WriteValue<uint16_t> (os, table.channelWidth);
+      WriteValue<uint16_t> (os, table.guardInterval);
+      WriteValue<uint8_t> (os, table.nss);
+      os.write (reinterpret_cast<const char *> (table.values.data ()), nPoints * sizeof (double));
+    }
+  NS_ABORT_MSG_UNLESS (os.good (), "Cannot write the table file " << filename);
+}
+
+void
+TableBasedErrorRateModel::LoadTables (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (m_tableSet == 0)
+    {
+      GetTableSet ();
+    }
+  ReadTables (filename);
+}
+
+void
+TableBasedErrorRateModel::ReadTables (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  NS_ABORT_MSG_UNLESS (is.is_open (), "Cannot open the table file " << filename);
+  NS_ABORT_MSG_UNLESS (ReadValue<uint32_t> (is) == TABLE_FILE_MAGIC
+                       && ReadValue<uint32_t> (is) == TABLE_FILE_VERSION,
+                       filename << " is not a table file");
+  std::string fallback = ReadString (is);
+  NS_ABORT_MSG_UNLESS (m_fallbackModel == 0 || fallback == m_fallbackModel->GetInstanceTypeId ().GetName (),
+                       "The tables of " << filename << " were generated from " << fallback);
+  double minSnrDb = ReadValue<double> (is);
+  double snrStepDb = ReadValue<double> (is);
+  uint32_t nPoints = ReadValue<uint32_t> (is);
+  NS_ABORT_MSG_UNLESS (minSnrDb == m_minSnrDb && snrStepDb == m_snrStepDb && nPoints == GetNPoints (),
+                       "The SNR grid of " << filename << " is not the one of the model");
+  uint32_t nTables = ReadValue<uint32_t> (is);
+  for (uint32_t t = 0; t < nTables; t++)
+    {
+      Table table;
+      table.mode = WifiMode (ReadString (is));
+      table.channelWidth = ReadValue<uint16_t> (is);
+      table.guardInterval = ReadValue<uint16_t> (is);
+      table.nss = ReadValue<uint8_t> (is);
+      table.values.resize (nPoints);
+      is.read (reinterpret_cast<char *> (table.values.data ()), nPoints * sizeof (double));
+      NS_ABORT_MSG_UNLESS (is.good (), "Truncated table file " << filename);
+      uint64_t key = GetKey (table.mode, table.channelWidth, table.guardInterval, table.nss);
+      m_tableSet->tables[key] = std::move (table);
+    }
+  // a table may have been replaced
+  m_last = 0;
+}
+
+} //namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABLE_BASED_ERROR_RATE_MODEL_H
+#define TABLE_BASED_ERROR_RATE_MODEL_H
+
+#include "ns3/simple-ref-count.h"
+#include "error-rate-model.h"
+#include "wifi-mode.h"
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * \brief An error rate model looking up precomputed error rate tables.
+ *
+ * The error rates of the fallback error rate model (NistErrorRateModel by
+ * default) are tabulated, for each mode and each channel width, guard
+ * interval and number of spatial streams of the TXVECTOR, on a uniform SNR
+ * grid (in dB). A chunk success rate is then a direct table lookup and a
+ * linear interpolation instead of the evaluation of the closed-form BER
+ * expressions of the fallback model.
+ *
+ * Like the other error rate models, the fallback model is assumed to
+ * compute the success rate of a chunk of n bits as (1 - p)^n, where p is
+ * the (coded) bit error probability at the SNR of the chunk. The tables
+ * thus store the success rate of a single bit, as log (-log (1 - p)),
+ * which varies smoothly with the SNR in dB over the whole waterfall
+ * region, and the success rate of any chunk size is derived from it.
+ *
+ * The tables are generated from the fallback model the first time a mode
+ * is used, or explicitly with GenerateTable, and are shared by all the
+ * models with the same fallback model and SNR grid (i.e., by all the PHYs
+ * using the default fallback model). They can be saved to a binary file with
+ * SaveTables, and loaded from it (TableFile attribute), so that the tables
+ * of a scenario are computed offline once.
+ */
+class TableBasedErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TableBasedErrorRateModel ();
+  virtual ~TableBasedErrorRateModel ();
+
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+  /**
+   * \brief Generate the table of a mode, if not done yet.
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR giving the channel width, guard interval
+   *        and number of spatial streams
+   */
+  void GenerateTable (WifiMode mode, WifiTxVector txVector);
+
+  /**
+   * \return the number of tables generated or loaded
+   */
+  uint32_t GetNTables (void) const;
+
+  /**
+   * \brief Save all the tables generated or loaded.
+   * \param filename the name of the file
+   */
+  void SaveTables (std::string filename) const;
+
+  /**
+   * \brief Load the tables of a file.
+   *
+   * The SNR grid and the fallback model of the file must be the ones of
+   * this model.
+   *
+   * \param filename the name of the file
+   */
+  void LoadTables (std::string filename);
+
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * \brief Read the tables of a file.
+   * \param filename the name of the file
+   */
+  void ReadTables (std::string filename) const;
+
+  /**
+   * \return the number of SNRs of the grid
+   */
+  uint32_t GetNPoints (void) const;
+
+  /**
+   * \brief Get the key of the table of a mode.
+   * \param mode the Wi-Fi mode
+   * \param channelWidth the channel width (MHz)
+   * \param guardInterval the guard interval (ns)
+   * \param nss the number of spatial streams
+   * \return the key of the table
+   */
+  static uint64_t GetKey (WifiMode mode, uint16_t channelWidth, uint16_t guardInterval, uint8_t nss);
+
+  /**
+   * \brief Get the tables shared with the models of the same fallback model
+   * and SNR grid.
+   */
+  void GetTableSet (void) const;
+
+  /**
+   * \brief Get the table of a mode, generating it if needed.
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR
+   * \return the table
+   */
+  const std::vector<double> & GetTable (WifiMode mode, const WifiTxVector &txVector) const;
+
+  /// A table and the TXVECTOR parameters it was generated with
+  struct Table
+  {
+    WifiMode mode;               //!< the Wi-Fi mode
+    uint16_t channelWidth;       //!< the channel width (MHz)
+    uint16_t guardInterval;      //!< the guard interval (ns)
+    uint8_t nss;                 //!< the number of spatial streams
+    std::vector<double> values;  //!< log (-log (bit success rate)) at each SNR of the grid
+  };
+
+  /// The tables of a fallback model type and SNR grid
+  struct TableSet : public SimpleRefCount<TableSet>
+  {
+    std::unordered_map<uint64_t, Table> tables; //!< the tables, by key
+    std::set<std::string> files;                //!< the files read
+  };
+
+  Ptr<ErrorRateModel> m_fallbackModel; //!< the model the tables are generated from
+  double m_minSnrDb;                   //!< the first SNR of the grid (dB)
+  double m_maxSnrDb;                   //!< the last SNR of the grid (dB)
+  double m_snrStepDb;                  //!< the SNR step of the grid (dB)
+  std::string m_tableFile;             //!< the file the tables are loaded from
+
+  mutable Ptr<TableSet> m_tableSet;            //!< the tables
+  mutable uint64_t m_lastKey;                  //!< the key of the last table looked up
+  mutable const std::vector<double> *m_last;   //!< the last table looked up
+};
+
+} //namespace ns3
+
+#endif /* TABLE_BASED_ERROR_RATE_MODEL_H */
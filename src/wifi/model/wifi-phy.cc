@@ -2694,7 +2694,7 @@ WifiPhy::ContinueReceiveHeader (Ptr<Event> event)
 }
 
 void
-WifiPhy::StartReceivePreamble (Ptr<WifiPpdu> ppdu, double rxPowerW)
+WifiPhy::StartReceivePreamble (Ptr<const WifiPpdu> ppdu, double rxPowerW)
 {
   NS_LOG_FUNCTION (this << *ppdu << rxPowerW);
   WifiTxVector txVector = ppdu->GetTxVector ();
@@ -29,6 +29,7 @@
 #include "wifi-phy-standard.h"
 #include "interference-helper.h"
 #include "wifi-phy-state-helper.h"
+#include <map>
 
 namespace ns3 {
 
@@ -195,7 +196,7 @@ public:
    * \param ppdu the arriving PPDU
    * \param rxPowerW the receive power in W
    */
-  void StartReceivePreamble (Ptr<WifiPpdu> ppdu, double rxPowerW);
+  void StartReceivePreamble (Ptr<const WifiPpdu> ppdu, double rxPowerW);
 
   /**
    * Start receiving the PHY header of a PPDU (i.e. after the end of receiving the preamble).
@@ -249,7 +250,7 @@ public:
   /**
    * \param ppdu the PPDU to send
    */
-  virtual void StartTx (Ptr<WifiPpdu> ppdu) = 0;
+  virtual void StartTx (Ptr<const WifiPpdu> ppdu) = 0;
 
   /**
    * Put in sleep mode.
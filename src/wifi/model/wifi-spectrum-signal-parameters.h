@@ -51,7 +51,7 @@ struct WifiSpectrumSignalParameters : public SpectrumSignalParameters
    */
   WifiSpectrumSignalParameters (const WifiSpectrumSignalParameters& p);
 
-  Ptr<WifiPpdu> ppdu; ///< The PPDU being transmitted
+  Ptr<const WifiPpdu> ppdu; ///< The PPDU being transmitted, shared by all the receivers
 };
 
 }  // namespace ns3
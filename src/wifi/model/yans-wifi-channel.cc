@@ -21,11 +21,13 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/mobility-model.h"
+#include "ns3/spatial-grid.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "wifi-utils.h"
@@ -53,11 +55,20 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The distance (m) beyond which the PPDUs are not propagated to the receivers. "
+                   "The receivers within range are then found with a uniform grid "
+                   "over their positions instead of by considering all the receivers. "
+                   "Zero means an unlimited range.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -88,23 +99,43 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
   NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  std::size_t nReceivers = m_phyList.size ();
+  if (m_maxRange > 0)
     {
-      if (sender != (*i))
+      if (m_grid == 0)
+        {
+          m_grid = Create<SpatialGrid> (m_maxRange);
+          for (const auto & phy : m_phyList)
+            {
+              m_grid->Add (phy->GetMobility ());
+            }
+        }
+      m_grid->GetNeighbors (senderMobility->GetPosition (), m_maxRange, m_neighbors);
+      nReceivers = m_neighbors.size ();
+    }
+  for (std::size_t n = 0; n < nReceivers; n++)
+    {
+      Ptr<YansWifiPhy> phy = m_phyList[m_maxRange > 0 ? m_neighbors[n] : n];
+      if (sender != phy)
         {
           //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (phy->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> receiverMobility = phy->GetMobility ()->GetObject<MobilityModel> ();
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<WifiPpdu> copy = Copy (ppdu);
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
+          // The receiver would drop a signal that is too weak, do not even schedule its reception
+          if ((rxPowerDbm + phy->GetRxGain ()) < phy->GetRxSensitivity ())
+            {
+              NS_LOG_INFO ("Received signal too weak to process: " << rxPowerDbm << " dBm");
+              continue;
+            }
+          Ptr<NetDevice> dstNetDevice = phy->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
             {
@@ -115,15 +146,16 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
               dstNode = dstNetDevice->GetNode ()->GetId ();
             }
 
+          // The PPDU is not modified by the receivers, which all share it
           Simulator::ScheduleWithContext (dstNode,
                                           delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm);
+                                          phy, ppdu, rxPowerDbm);
         }
     }
 }
 
 void
-YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<WifiPpdu> ppdu, double rxPowerDbm)
+YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<const WifiPpdu> ppdu, double rxPowerDbm)
 {
   NS_LOG_FUNCTION (phy << ppdu << rxPowerDbm);
   // Do no further processing if signal is too weak
@@ -153,6 +185,7 @@ YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  m_grid = 0;
 }
 
 int64_t
@@ -32,6 +32,7 @@ class YansWifiPhy;
 class Packet;
 class Time;
 class WifiPpdu;
+class SpatialGrid;
 
 /**
  * \brief a channel to interconnect ns3::YansWifiPhy objects.
@@ -41,6 +42,11 @@ class WifiPpdu;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * If the MaxRange attribute is set, the PPDUs are only propagated to the
+ * receivers within that distance of the sender, which are found with a
+ * SpatialGrid over the positions of the PHYs. The mobility models of the
+ * PHYs must then be set before the first transmission.
  */
 class YansWifiChannel : public Channel
 {
@@ -113,11 +119,14 @@ private:
    * \param ppdu the PPDU being sent
    * \param txPowerDbm the TX power associated to the packet being sent (dBm)
    */
-  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double txPowerDbm);
+  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<const WifiPpdu> ppdu, double txPowerDbm);
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< the distance beyond which PPDUs are not propagated (m)
+  mutable Ptr<SpatialGrid> m_grid;     //!< the positions of the PHYs, if the range is limited
+  mutable std::vector<uint32_t> m_neighbors; //!< the indexes of the PHYs within range of the sender
 };
 
 } //namespace ns3
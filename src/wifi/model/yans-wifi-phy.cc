@@ -75,7 +75,7 @@ YansWifiPhy::SetChannel (const Ptr<YansWifiChannel> channel)
 }
 
 void
-YansWifiPhy::StartTx (Ptr<WifiPpdu> ppdu)
+YansWifiPhy::StartTx (Ptr<const WifiPpdu> ppdu)
 {
   NS_LOG_FUNCTION (this << ppdu);
   WifiTxVector txVector = ppdu->GetTxVector ();
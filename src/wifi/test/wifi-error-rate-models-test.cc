@@ -21,6 +21,11 @@
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/table-based-error-rate-model.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
 #include "ns3/wifi-phy.h"
 #include "ns3/wifi-utils.h"
 
@@ -450,6 +455,120 @@ WifiErrorRateModelsTestCaseMimo::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (chunkSuccess, sisoChunkSuccess, 0.000001, "CSR not within tolerance for 4x4:4 MIMO");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Table-based
+ */
+class WifiErrorRateModelsTestCaseTableBased : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTableBased ();
+  virtual ~WifiErrorRateModelsTestCaseTableBased ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the chunk success rates of a table-based model with the ones of
+   * its fallback model.
+   *
+   * \param table the table-based model
+   * \param fallback the fallback model
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR
+   */
+  void CompareModels (Ptr<TableBasedErrorRateModel> table, Ptr<ErrorRateModel> fallback,
+                      WifiMode mode, WifiTxVector txVector);
+};
+
+WifiErrorRateModelsTestCaseTableBased::WifiErrorRateModelsTestCaseTableBased ()
+  : TestCase ("WifiErrorRateModel test case table-based")
+{
+}
+
+WifiErrorRateModelsTestCaseTableBased::~WifiErrorRateModelsTestCaseTableBased ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTableBased::CompareModels (Ptr<TableBasedErrorRateModel> table, Ptr<ErrorRateModel> fallback,
+                                                      WifiMode mode, WifiTxVector txVector)
+{
+  const uint64_t sizes[] = { 1, 8 * 14, 8 * 1500, 8 * 65535 };
+  for (double snrDb = -25; snrDb <= 65; snrDb += 0.37)
+    {
+      double snr = std::pow (10.0, snrDb / 10.0);
+      for (uint64_t nbits : sizes)
+        {
+          double expected = fallback->GetChunkSuccessRate (mode, txVector, snr, nbits);
+          double ps = table->GetChunkSuccessRate (mode, txVector, snr, nbits);
+          // the widest gaps are at the sharp cutoff of the NIST model, where the
+          // bit error rate bound reaches 1
+          NS_TEST_EXPECT_MSG_EQ_TOL (ps, expected, 0.005, "Wrong chunk success rate for " << mode
+                                     << " at " << snrDb << " dB for " << nbits << " bits");
+        }
+    }
+  txVector.SetMode (mode);
+  NS_TEST_EXPECT_MSG_EQ_TOL (table->CalculateSnr (txVector, 1e-6), fallback->CalculateSnr (txVector, 1e-6),
+                             fallback->CalculateSnr (txVector, 1e-6) * 0.01, "Wrong SNR threshold for " << mode);
+}
+
+void
+WifiErrorRateModelsTestCaseTableBased::DoRun (void)
+{
+  WifiTxVector txVector;
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TableBasedErrorRateModel> table = CreateObject<TableBasedErrorRateModel> ();
+  table->SetAttribute ("FallbackErrorRateModel", PointerValue (nist));
+  const char *modes[] = { "DsssRate1Mbps", "DsssRate11Mbps", "OfdmRate6Mbps", "OfdmRate54Mbps",
+                          "HtMcs3", "VhtMcs8", "HeMcs11" };
+  for (const char *mode : modes)
+    {
+      CompareModels (table, nist, WifiMode (mode), txVector);
+    }
+
+  // the YANS model depends on the channel width
+  Ptr<YansErrorRateModel> yans = CreateObject<YansErrorRateModel> ();
+  Ptr<TableBasedErrorRateModel> yansTable = CreateObject<TableBasedErrorRateModel> ();
+  yansTable->SetAttribute ("FallbackErrorRateModel", PointerValue (yans));
+  txVector.SetChannelWidth (20);
+  CompareModels (yansTable, yans, WifiPhy::GetVhtMcs4 (), txVector);
+  txVector.SetChannelWidth (80);
+  CompareModels (yansTable, yans, WifiPhy::GetVhtMcs4 (), txVector);
+  NS_TEST_EXPECT_MSG_EQ (yansTable->GetNTables (), 2, "Tables not generated per channel width");
+
+  // the tables are shared by the models with the same fallback model and grid
+  Ptr<TableBasedErrorRateModel> other = CreateObject<TableBasedErrorRateModel> ();
+  other->SetAttribute ("FallbackErrorRateModel", PointerValue (yans));
+  NS_TEST_EXPECT_MSG_EQ (other->GetNTables (), 2, "Tables not shared");
+
+  // the tables are saved to and loaded from a file
+  std::string filename = CreateTempDirFilename ("wifi-error-rate-tables.bin");
+  Ptr<TableBasedErrorRateModel> saved = CreateObject<TableBasedErrorRateModel> ();
+  saved->SetAttribute ("FallbackErrorRateModel", PointerValue (nist));
+  saved->SetAttribute ("SnrStep", DoubleValue (0.1));
+  saved->GenerateTable (WifiMode ("OfdmRate12Mbps"), WifiTxVector ());
+  saved->GenerateTable (WifiMode ("OfdmRate24Mbps"), WifiTxVector ());
+  saved->SaveTables (filename);
+  Ptr<TableBasedErrorRateModel> loaded = CreateObject<TableBasedErrorRateModel> ();
+  loaded->SetAttribute ("SnrStep", DoubleValue (0.1));
+  loaded->SetAttribute ("MinSnr", DoubleValue (-20.0));
+  loaded->SetAttribute ("FallbackErrorRateModel", PointerValue (CreateObject<NistErrorRateModel> ()));
+  NS_TEST_EXPECT_MSG_EQ (loaded->GetNTables (), 0, "Tables shared with another fallback model");
+  loaded->LoadTables (filename);
+  NS_TEST_EXPECT_MSG_EQ (loaded->GetNTables (), 2, "Tables not loaded");
+  double snr = std::pow (10.0, 5.0 / 10.0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (loaded->GetChunkSuccessRate (WifiMode ("OfdmRate12Mbps"), WifiTxVector (), snr, 8000),
+                             nist->GetChunkSuccessRate (WifiMode ("OfdmRate12Mbps"), WifiTxVector (), snr, 8000),
+                             0.002, "Wrong chunk success rate from the loaded tables");
+  Ptr<TableBasedErrorRateModel> fromFile = CreateObject<TableBasedErrorRateModel> ();
+  fromFile->SetAttribute ("SnrStep", DoubleValue (0.1));
+  fromFile->SetAttribute ("FallbackErrorRateModel", PointerValue (CreateObject<NistErrorRateModel> ()));
+  fromFile->SetAttribute ("TableFile", StringValue (filename));
+  NS_TEST_EXPECT_MSG_EQ (fromFile->GetNTables (), 2, "Tables not loaded from the TableFile");
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -468,6 +587,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseMimo, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTableBased, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
@@ -28,6 +28,7 @@
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/ap-wifi-mac.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/test.h"
@@ -47,7 +48,10 @@
 #include "ns3/ht-configuration.h"
 #include "ns3/wifi-ppdu.h"
 #include "ns3/wifi-psdu.h"
+#include "ns3/interference-helper.h"
 #include "ns3/waypoint-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
 
 using namespace ns3;
 
@@ -370,6 +374,277 @@ InterferenceHelperSequenceTest::DoRun (void)
 }
 
 
+/**
+ * Make sure that the history of noise and interference changes of an
+ * InterferenceHelper is bounded when the medium is never idle, i.e. when the
+ * signals overlap and a signal is always being received.
+ */
+class InterferenceHelperHistoryTest : public TestCase
+{
+public:
+  InterferenceHelperHistoryTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /// InterferenceHelper exposing the number of noise and interference changes
+  class TestInterferenceHelper : public InterferenceHelper
+  {
+  public:
+    using InterferenceHelper::GetNNiChanges;
+  };
+
+  /**
+   * Add a signal to the interference helper.
+   * \param check whether to check the SNR of the signal once the next one started
+   */
+  void AddSignal (bool check);
+  /**
+   * Check the SNR of a signal.
+   * \param event the signal
+   */
+  void CheckSnr (Ptr<Event> event);
+
+  TestInterferenceHelper m_interference; ///< the interference helper
+  std::size_t m_maxNiChanges;            ///< the highest number of noise and interference changes
+  uint32_t m_nSnrChecks;                 ///< the number of SNRs checked
+};
+
+InterferenceHelperHistoryTest::InterferenceHelperHistoryTest ()
+  : TestCase ("InterferenceHelper history is bounded on a busy medium"),
+    m_maxNiChanges (0),
+    m_nSnrChecks (0)
+{
+}
+
+void
+InterferenceHelperHistoryTest::CheckSnr (Ptr<Event> event)
+{
+  // the next signal is the interference
+  double noiseFloor = 1.3803e-23 * 290 * 20e6;
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_interference.CalculateSnr (event), 1e-9 / (noiseFloor + 1e-9), 1e-9, "Wrong SNR");
+  m_nSnrChecks++;
+}
+
+void
+InterferenceHelperHistoryTest::AddSignal (bool check)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  Time duration = MicroSeconds (100);
+  Ptr<WifiPpdu> ppdu = Create<WifiPpdu> (Create<WifiPsdu> (Create<Packet> (0), hdr), WifiTxVector (), duration, 0);
+  Ptr<Event> event = m_interference.Add (ppdu, WifiTxVector (), duration, 1e-9);
+  m_interference.NotifyRxStart ();
+  m_maxNiChanges = std::max (m_maxNiChanges, m_interference.GetNNiChanges ());
+  if (check)
+    {
+      Simulator::Schedule (MicroSeconds (80), &InterferenceHelperHistoryTest::CheckSnr, this, event);
+    }
+}
+
+void
+InterferenceHelperHistoryTest::DoRun (void)
+{
+  m_interference.SetNoiseFigure (1);
+  m_interference.SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  // a new 100 us signal every 60 us: two signals overlap for 40 us, and the
+  // medium is never idle
+  const uint32_t nSignals = 10000;
+  for (uint32_t i = 0; i < nSignals; i++)
+    {
+      Simulator::Schedule (MicroSeconds (60 * i), &InterferenceHelperHistoryTest::AddSignal, this, i + 1 < nSignals);
+    }
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_LT (m_maxNiChanges, 10, "History of noise and interference changes not bounded");
+  NS_TEST_EXPECT_MSG_EQ (m_nSnrChecks, nSignals - 1, "SNRs not checked");
+
+  m_interference.EraseEvents ();
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Make sure that a YansWifiChannel with a limited range only propagates the
+ * PPDUs to the receivers within range, including the ones that moved into
+ * range since the channel indexed their positions.
+ */
+class YansWifiChannelMaxRangeTest : public TestCase
+{
+public:
+  YansWifiChannelMaxRangeTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Send a broadcast packet.
+   * \param dev the sending device
+   */
+  void SendOnePacket (Ptr<NetDevice> dev);
+  /**
+   * Callback invoked when a PHY starts receiving a PSDU.
+   * \param context the context
+   * \param p the packet
+   */
+  void RxBegin (std::string context, Ptr<const Packet> p);
+
+  std::vector<uint32_t> m_nRx; ///< the number of receptions of each node
+};
+
+YansWifiChannelMaxRangeTest::YansWifiChannelMaxRangeTest ()
+  : TestCase ("YansWifiChannel only propagates PPDUs within range"),
+    m_nRx (4, 0)
+{
+}
+
+void
+YansWifiChannelMaxRangeTest::SendOnePacket (Ptr<NetDevice> dev)
+{
+  dev->Send (Create<Packet> (100), dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelMaxRangeTest::RxBegin (std::string context, Ptr<const Packet> p)
+{
+  // context is "/NodeList/<id>/DeviceList/..."
+  std::string::size_type start = std::string ("/NodeList/").size ();
+  uint32_t nodeId = std::stoul (context.substr (start, context.find ('/', start) - start));
+  m_nRx.at (nodeId)++;
+}
+
+void
+YansWifiChannelMaxRangeTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+
+  YansWifiChannelHelper channelHelper;
+  channelHelper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  // the receivers would all receive the PPDUs without the range limit
+  channelHelper.AddPropagationLoss ("ns3::FixedRssLossModel", "Rss", DoubleValue (-50));
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channel->SetAttribute ("MaxRange", DoubleValue (100));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (50.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (0.0, 150.0, 0.0));
+  positionAlloc->Add (Vector (300.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  // the last node is 250 m away from the sender at 1 s, and 50 m away at 5 s
+  nodes.Get (3)->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (Vector (-50.0, 0.0, 0.0));
+
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/$ns3::WifiPhy/PhyRxBegin",
+                   MakeCallback (&YansWifiChannelMaxRangeTest::RxBegin, this));
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelMaxRangeTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Schedule (Seconds (5.0), &YansWifiChannelMaxRangeTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Stop (Seconds (6.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_nRx[0], 0, "The sender received its PPDUs");
+  NS_TEST_EXPECT_MSG_EQ (m_nRx[1], 2, "PPDUs not received within range");
+  NS_TEST_EXPECT_MSG_EQ (m_nRx[2], 0, "PPDUs received out of range");
+  NS_TEST_EXPECT_MSG_EQ (m_nRx[3], 1, "PPDUs not received by the receiver that moved into range");
+}
+
+
+/**
+ * Make sure that a YansWifiChannel hands the same PPDU to all the receivers,
+ * instead of a copy per receiver.
+ */
+class YansWifiChannelSharedPpduTest : public TestCase
+{
+public:
+  YansWifiChannelSharedPpduTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Callback invoked when a PHY starts receiving a PSDU.
+   * \param p the packet
+   */
+  void RxBegin (Ptr<const Packet> p);
+
+  uint32_t m_nRx; ///< the number of receptions
+};
+
+YansWifiChannelSharedPpduTest::YansWifiChannelSharedPpduTest ()
+  : TestCase ("YansWifiChannel shares the PPDUs among the receivers"),
+    m_nRx (0)
+{
+}
+
+void
+YansWifiChannelSharedPpduTest::RxBegin (Ptr<const Packet> p)
+{
+  m_nRx++;
+}
+
+void
+YansWifiChannelSharedPpduTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (-50);
+  channel->SetPropagationLossModel (loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (10.0 * i, 0.0, 0.0));
+      phy->SetMobility (mobility);
+      phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->SetChannel (channel);
+      phy->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&YansWifiChannelSharedPpduTest::RxBegin, this));
+      phys.push_back (phy);
+    }
+
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_DATA);
+  hdr.SetAddr1 (Mac48Address::GetBroadcast ());
+  Ptr<WifiPsdu> psdu = Create<WifiPsdu> (Create<Packet> (1000), hdr);
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 20, false, false);
+  Time txDuration = WifiPhy::CalculateTxDuration (psdu->GetSize (), txVector, phys[0]->GetFrequency ());
+  Ptr<WifiPpdu> ppdu = Create<WifiPpdu> (psdu, txVector, txDuration, phys[0]->GetFrequency ());
+
+  channel->Send (phys[0], ppdu, 16);
+  // one reference held here, and one by the reception scheduled for each receiver
+  NS_TEST_EXPECT_MSG_EQ (ppdu->GetReferenceCount (), 3, "The PPDU is not shared by the receivers");
+
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_nRx, 2, "The receivers did not receive the shared PPDU");
+
+  for (auto &phy : phys)
+    {
+      phy->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that when multiple broadcast packets are queued on the same
@@ -1397,7 +1672,7 @@ Bug2843TestCase::StoreDistinctTuple (std::string context,  Ptr<SpectrumSignalPar
   // Get channel bandwidth and modulation class
   Ptr<const WifiSpectrumSignalParameters> wifiTxParams = DynamicCast<WifiSpectrumSignalParameters> (txParams);
 
-  Ptr<WifiPpdu> ppdu = Copy (wifiTxParams->ppdu);
+  Ptr<const WifiPpdu> ppdu = wifiTxParams->ppdu;
   WifiTxVector txVector = ppdu->GetTxVector ();
   m_channelWidth = txVector.GetChannelWidth ();
   WifiModulationClass modulationClass = txVector.GetMode ().GetModulationClass ();
@@ -1871,6 +2146,169 @@ StaWifiMacScanningTestCase::DoRun (void)
   }
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that an AP fast-forwarding its beacons only transmits the
+ * beacons needed by its associated station, and that the station still
+ * detects the loss of the beacons:
+ *   - the AP does not transmit beacons while the AP and the STA are static;
+ *   - the AP transmits all its beacons while the STA sends packets to the
+ *     AP, from 2 s to 3 s;
+ *   - the AP transmits all its beacons while the STA moves, from 4 s to 6 s;
+ *   - the AP stops generating beacons at 9 s, after which the STA detects
+ *     that it misses beacons.
+ */
+class BeaconFastForwardTestCase : public TestCase
+{
+public:
+  BeaconFastForwardTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Callback invoked when the AP PHY starts transmitting a packet.
+   * \param p the packet
+   * \param txPowerW the transmit power in Watts
+   */
+  void ApTxBegin (Ptr<const Packet> p, double txPowerW);
+  /**
+   * Callback invoked when the STA disassociates.
+   * \param bssid the BSSID of the AP
+   */
+  void DeAssoc (Mac48Address bssid);
+  /**
+   * \param start the start of the interval
+   * \param end the end of the interval
+   * \return the number of beacons transmitted by the AP during the interval
+   */
+  uint32_t CountBeacons (Time start, Time end) const;
+  /**
+   * Turn beacon generation off on the AP
+   * \param mac the AP MAC
+   */
+  void TurnBeaconGenerationOff (Ptr<WifiMac> mac);
+  /**
+   * Send a packet
+   * \param device the device sending the packet
+   * \param to the destination of the packet
+   */
+  void SendPacket (Ptr<NetDevice> device, Mac48Address to);
+
+  std::vector<Time> m_beacons; ///< the transmission times of the beacons
+  Time m_deAssoc;              ///< the disassociation time of the STA
+};
+
+BeaconFastForwardTestCase::BeaconFastForwardTestCase ()
+  : TestCase ("Test case for the beacons fast-forwarded by an AP")
+{
+}
+
+void
+BeaconFastForwardTestCase::ApTxBegin (Ptr<const Packet> p, double txPowerW)
+{
+  WifiMacHeader hdr;
+  p->PeekHeader (hdr);
+  if (hdr.IsBeacon ())
+    {
+      m_beacons.push_back (Simulator::Now ());
+    }
+}
+
+void
+BeaconFastForwardTestCase::DeAssoc (Mac48Address bssid)
+{
+  m_deAssoc = Simulator::Now ();
+}
+
+void
+BeaconFastForwardTestCase::TurnBeaconGenerationOff (Ptr<WifiMac> mac)
+{
+  mac->SetAttribute ("BeaconGeneration", BooleanValue (false));
+}
+
+void
+BeaconFastForwardTestCase::SendPacket (Ptr<NetDevice> device, Mac48Address to)
+{
+  device->Send (Create<Packet> (1000), to, 1);
+}
+
+uint32_t
+BeaconFastForwardTestCase::CountBeacons (Time start, Time end) const
+{
+  uint32_t count = 0;
+  for (const auto &t : m_beacons)
+    {
+      if (t >= start && t < end)
+        {
+          count++;
+        }
+    }
+  return count;
+}
+
+void
+BeaconFastForwardTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+
+  WifiMacHelper mac;
+  mac.SetType ("ns3::ApWifiMac",
+               "EnableBeaconFastForward", BooleanValue (true));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, nodes.Get (0));
+  mac.SetType ("ns3::StaWifiMac");
+  NetDeviceContainer staDevice = wifi.Install (phy, mac, nodes.Get (1));
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (5.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+
+  Ptr<WifiNetDevice> ap = DynamicCast<WifiNetDevice> (apDevice.Get (0));
+  ap->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&BeaconFastForwardTestCase::ApTxBegin, this));
+  Ptr<WifiNetDevice> sta = DynamicCast<WifiNetDevice> (staDevice.Get (0));
+  sta->GetMac ()->TraceConnectWithoutContext ("DeAssoc", MakeCallback (&BeaconFastForwardTestCase::DeAssoc, this));
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (Seconds (2.0) + MilliSeconds (10 * i), &BeaconFastForwardTestCase::SendPacket, this,
+                           sta, ap->GetMac ()->GetAddress ());
+    }
+  Ptr<ConstantVelocityMobilityModel> staMobility = nodes.Get (1)->GetObject<ConstantVelocityMobilityModel> ();
+  Simulator::Schedule (Seconds (4.0), &ConstantVelocityMobilityModel::SetVelocity, staMobility, Vector (1.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (6.0), &ConstantVelocityMobilityModel::SetVelocity, staMobility, Vector (0.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (9.0), &BeaconFastForwardTestCase::TurnBeaconGenerationOff, this, ap->GetMac ());
+
+  Simulator::Stop (Seconds (11.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (CountBeacons (Seconds (1.0), Seconds (2.0)), 0, "Beacons transmitted to a static STA");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (CountBeacons (Seconds (2.1), Seconds (3.0)), 8, "Beacons not transmitted in an active BSS");
+  // the first beacon after the traffic is transmitted too
+  NS_TEST_EXPECT_MSG_EQ (CountBeacons (Seconds (3.25), Seconds (4.0)), 0, "Beacons transmitted in an idle BSS");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (CountBeacons (Seconds (4.0), Seconds (6.0)), 19, "Beacons not transmitted to a moving STA");
+  NS_TEST_EXPECT_MSG_EQ (CountBeacons (Seconds (7.0), Seconds (9.0)), 0, "Beacons transmitted to a STA that stopped");
+  // the last beacon is fast-forwarded less than a beacon interval before 9 s,
+  // and the STA misses beacons 10 beacon intervals after it
+  NS_TEST_EXPECT_MSG_GT (m_deAssoc, Seconds (9.0 + 9 * 0.1024), "Beacons missed too early");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_deAssoc, Seconds (9.0 + 10 * 0.1024), "Missed beacons not detected");
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that the ADDBA handshake process is protected.
@@ -2944,6 +3382,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
+  AddTestCase (new InterferenceHelperHistoryTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelMaxRangeTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelSharedPpduTest, TestCase::QUICK);
   AddTestCase (new DcfImmediateAccessBroadcastTestCase, TestCase::QUICK);
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
   AddTestCase (new QosFragmentationTestCase, TestCase::QUICK);
@@ -2952,6 +3393,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2843TestCase, TestCase::QUICK); //Bug 2843
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
   AddTestCase (new StaWifiMacScanningTestCase, TestCase::QUICK); //Bug 2399
+  AddTestCase (new BeaconFastForwardTestCase, TestCase::QUICK);
   AddTestCase (new Bug2470TestCase, TestCase::QUICK); //Bug 2470
   AddTestCase (new Issue40TestCase, TestCase::QUICK); //Issue #40
   AddTestCase (new Issue169TestCase, TestCase::QUICK); //Issue #169
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the setup of a large topology:
+// the creation of the nodes, the installation of the internet stack and
+// the assignment of the addresses on a chain of point-to-point links.
+// Sample usage:  ./waf --run 'bench-stack-install --nNodes=100000 --bulk=1'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 10000;
+  bool ipv6 = true;
+  bool bulk = false;
+  bool links = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the setup of a large internet topology");
+  cmd.AddValue ("nNodes", "number of nodes", nNodes);
+  cmd.AddValue ("ipv6", "install the IPv6 stack too", ipv6);
+  cmd.AddValue ("bulk", "use the bulk installation of the internet stack", bulk);
+  cmd.AddValue ("links", "connect the nodes in a chain and assign IPv4 addresses", links);
+  cmd.Parse (argc, argv);
+
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  int64_t createTime = clock.End ();
+
+  clock.Start ();
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (ipv6);
+  if (bulk)
+    {
+      internet.InstallBulk (nodes);
+    }
+  else
+    {
+      internet.Install (nodes);
+    }
+  int64_t installTime = clock.End ();
+
+  int64_t linkTime = 0;
+  if (links)
+    {
+      clock.Start ();
+      PointToPointHelper p2p;
+      Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+      for (uint32_t i = 1; i < nNodes; i++)
+        {
+          NetDeviceContainer devices = p2p.Install (nodes.Get (i - 1), nodes.Get (i));
+          address.Assign (devices);
+          address.NewNetwork ();
+        }
+      linkTime = clock.End ();
+    }
+
+  clock.Start ();
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  int64_t runTime = clock.End ();
+
+  clock.Start ();
+  Simulator::Destroy ();
+  int64_t destroyTime = clock.End ();
+
+  std::cout << nNodes << " nodes, " << (bulk ? "bulk" : "per-node") << " install"
+            << (ipv6 ? ", IPv4 and IPv6" : ", IPv4") << std::endl
+            << "  node creation:  " << createTime << " ms" << std::endl
+            << "  stack install:  " << installTime << " ms ("
+            << (nNodes ? installTime * 1000.0 / nNodes : 0) << " us per node)" << std::endl;
+  if (links)
+    {
+      std::cout << "  links, addresses: " << linkTime << " ms" << std::endl;
+    }
+  std::cout << "  first second:   " << runTime << " ms" << std::endl
+            << "  destroy:        " << destroyTime << " ms" << std::endl;
+
+  return 0;
+}
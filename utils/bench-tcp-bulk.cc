@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark a TCP bulk transfer over a path
+// with a large bandwidth-delay product, where the TCP buffers hold tens
+// of thousands of segments.  Losses can be added to exercise the SACK
+// scoreboard and the loss recovery.  Several flows can share the link, and
+// their timers can be kept in a per-node TimerWheel.
+// Sample usage:  ./waf --run 'bench-tcp-bulk --dataRate=10Gbps --delay=50ms --stopTime=2'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string dataRate = "10Gbps";
+  std::string delay = "50ms";
+  double errorRate = 0;
+  uint32_t segmentSize = 1448;
+  uint32_t queueSize = 100000;
+  double stopTime = 2;
+  uint32_t nFlows = 1;
+  bool timerWheel = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark a high bandwidth-delay product TCP bulk transfer");
+  cmd.AddValue ("dataRate", "link data rate", dataRate);
+  cmd.AddValue ("delay", "one way link delay", delay);
+  cmd.AddValue ("errorRate", "packet error rate on the receiver side", errorRate);
+  cmd.AddValue ("segmentSize", "TCP segment size in bytes", segmentSize);
+  cmd.AddValue ("queueSize", "queue size in packets, at the device and at the queue disc", queueSize);
+  cmd.AddValue ("stopTime", "simulated time in seconds", stopTime);
+  cmd.AddValue ("nFlows", "number of TCP flows", nFlows);
+  cmd.AddValue ("timerWheel", "keep the TCP timers in a per-node TimerWheel", timerWheel);
+  cmd.Parse (argc, argv);
+
+  // Buffers able to hold twice the bandwidth-delay product
+  uint64_t bdp = DataRate (dataRate).GetBitRate () / 8 * Time (delay).GetSeconds () * 2;
+  uint32_t bufSize = static_cast<uint32_t> (std::min<uint64_t> (2 * bdp, 0x7fffffff));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (bufSize));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (bufSize));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (segmentSize));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (true));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+  p2p.SetChannelAttribute ("Delay", StringValue (delay));
+  p2p.SetQueue ("ns3::DropTailQueue", "MaxSize",
+                QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, queueSize)));
+  NetDeviceContainer devices = p2p.Install (nodes);
+
+  if (errorRate > 0)
+    {
+      Ptr<RateErrorModel> em = CreateObject<RateErrorModel> ();
+      em->SetAttribute ("ErrorRate", DoubleValue (errorRate));
+      em->SetAttribute ("ErrorUnit", StringValue ("ERROR_UNIT_PACKET"));
+      devices.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (em));
+    }
+
+  InternetStackHelper stack;
+  stack.SetTimerWheel (timerWheel);
+  stack.Install (nodes);
+
+  TrafficControlHelper tch;
+  tch.SetRootQueueDisc ("ns3::FifoQueueDisc", "MaxSize",
+                        QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, queueSize)));
+  tch.Install (devices);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  ApplicationContainer sinkApps;
+  for (uint32_t i = 0; i < nFlows; i++)
+    {
+      uint16_t port = 50000 + i;
+      BulkSendHelper source ("ns3::TcpSocketFactory",
+                             InetSocketAddress (interfaces.GetAddress (1), port));
+      source.SetAttribute ("MaxBytes", UintegerValue (0));
+      source.SetAttribute ("SendSize", UintegerValue (segmentSize));
+      ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+      sourceApps.Start (Seconds (0.0));
+
+      PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                             InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinkApps.Add (sink.Install (nodes.Get (1)));
+    }
+  sinkApps.Start (Seconds (0.0));
+
+  std::cout << "Running bench-tcp-bulk with dataRate=" << dataRate << " delay=" << delay
+            << " errorRate=" << errorRate << " buffers=" << bufSize << " bytes"
+            << " nFlows=" << nFlows << " timerWheel=" << timerWheel << std::endl;
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (stopTime));
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+  if (ms == 0)
+    {
+      ms = 1;
+    }
+
+  uint64_t received = 0;
+  for (uint32_t i = 0; i < sinkApps.GetN (); i++)
+    {
+      received += DynamicCast<PacketSink> (sinkApps.Get (i))->GetTotalRx ();
+    }
+  std::cout << "Received " << received << " bytes, goodput "
+            << received * 8 / stopTime / 1e6 << " Mbps" << std::endl;
+  std::cout << "Wall clock " << ms << " ms, "
+            << stopTime * 1000 / ms << " simulated seconds per second, "
+            << received / 1e6 / (ms / 1000.0) << " MB transferred per second" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the computation of the beamforming
+// gain in ThreeGppSpectrumPropagationLossModel, by default between a 64
+// element (8x8) and a 16 element (4x4) antenna array.  Each iteration
+// computes the received PSD of one transmission, one microsecond after the
+// previous one.  With beamSweep, the
+// transmitter switches between two beams at every iteration, so that the
+// long term component has to be computed again each time.
+// Sample usage:  ./waf --run 'bench-three-gpp-beamforming --numBands=275 --beamSweep=1'
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/three-gpp-antenna-array-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Compute a beamforming vector steering the beam of an antenna array
+ * \param antenna the antenna array
+ * \param phi the azimuth angle in radians
+ * \param theta the zenith angle in radians
+ * \return the beamforming vector
+ */
+static ThreeGppAntennaArrayModel::ComplexVector
+Steer (Ptr<ThreeGppAntennaArrayModel> antenna, double phi, double theta)
+{
+  ThreeGppAntennaArrayModel::ComplexVector w;
+  uint64_t numElements = antenna->GetNumberOfElements ();
+  double power = 1 / sqrt (numElements);
+  for (uint64_t i = 0; i < numElements; i++)
+    {
+      Vector loc = antenna->GetElementLocation (i);
+      double phase = -2 * M_PI * (sin (theta) * cos (phi) * loc.x
+                                  + sin (theta) * sin (phi) * loc.y
+                                  + cos (theta) * loc.z);
+      w.push_back (std::polar (power, phase));
+    }
+  return w;
+}
+
+/**
+ * Computes the received PSDs, one per event
+ */
+class BeamformingBench
+{
+public:
+  Ptr<ThreeGppSpectrumPropagationLossModel> m_lossModel; //!< the loss model under test
+  Ptr<SpectrumValue> m_txPsd; //!< the PSD of the transmitted signal
+  Ptr<MobilityModel> m_txMob; //!< the mobility model of the transmitter
+  Ptr<MobilityModel> m_rxMob; //!< the mobility model of the receiver
+  Ptr<ThreeGppAntennaArrayModel> m_txAntenna; //!< the antenna array of the transmitter
+  ThreeGppAntennaArrayModel::ComplexVector m_txBeams[2]; //!< the beams the transmitter switches between
+  bool m_beamSweep; //!< whether to switch the beam at every iteration
+  uint32_t m_iterations; //!< the number of iterations left
+  double m_check; //!< the sum of the received PSDs
+
+  /**
+   * Computes a received PSD and schedules the next iteration
+   */
+  void Receive (void)
+  {
+    if (m_beamSweep)
+      {
+        m_txAntenna->SetBeamformingVector (m_txBeams[m_iterations % 2]);
+      }
+    m_check += Sum (*m_lossModel->CalcRxPowerSpectralDensity (m_txPsd, m_txMob, m_rxMob));
+    if (--m_iterations > 0)
+      {
+        Simulator::Schedule (MicroSeconds (1), &BeamformingBench::Receive, this);
+      }
+  }
+};
+
+int main (int argc, char *argv[])
+{
+  uint32_t txRows = 8;
+  uint32_t txColumns = 8;
+  uint32_t rxRows = 4;
+  uint32_t rxColumns = 4;
+  uint32_t numBands = 100;
+  uint32_t iterations = 20000;
+  bool beamSweep = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the beamforming gain computed by ThreeGppSpectrumPropagationLossModel");
+  cmd.AddValue ("txRows", "number of rows of the transmitter array", txRows);
+  cmd.AddValue ("txColumns", "number of columns of the transmitter array", txColumns);
+  cmd.AddValue ("rxRows", "number of rows of the receiver array", rxRows);
+  cmd.AddValue ("rxColumns", "number of columns of the receiver array", rxColumns);
+  cmd.AddValue ("numBands", "number of 180 kHz bands of the PSD", numBands);
+  cmd.AddValue ("iterations", "number of received PSDs to compute", iterations);
+  cmd.AddValue ("beamSweep", "switch the transmitter beam at every iteration", beamSweep);
+  cmd.Parse (argc, argv);
+
+  double frequency = 28e9;
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (frequency));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMa"));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel",
+                                       PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  lossModel->SetChannelModelAttribute ("UpdatePeriod", TimeValue (MilliSeconds (0)));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  Ptr<MobilityModel> txMob = CreateObject<ConstantVelocityMobilityModel> ();
+  txMob->SetPosition (Vector (0.0, 0.0, 25.0));
+  Ptr<ConstantVelocityMobilityModel> rxMob = CreateObject<ConstantVelocityMobilityModel> ();
+  rxMob->SetPosition (Vector (100.0, 20.0, 1.5));
+  rxMob->SetVelocity (Vector (1.0, 0.5, 0.0));
+  nodes.Get (0)->AggregateObject (txMob);
+  nodes.Get (1)->AggregateObject (rxMob);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  nodes.Get (0)->AddDevice (txDev);
+  txDev->SetNode (nodes.Get (0));
+  nodes.Get (1)->AddDevice (rxDev);
+  rxDev->SetNode (nodes.Get (1));
+
+  Ptr<ThreeGppAntennaArrayModel> txAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (txColumns),
+                                                                                                    "NumRows", UintegerValue (txRows));
+  Ptr<ThreeGppAntennaArrayModel> rxAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (rxColumns),
+                                                                                                    "NumRows", UintegerValue (rxRows));
+  lossModel->AddDevice (txDev, txAntenna);
+  lossModel->AddDevice (rxDev, rxAntenna);
+
+  // two transmitter beams, both roughly pointed towards the receiver
+  BeamformingBench bench;
+  bench.m_txBeams[0] = Steer (txAntenna, 0.2, 1.6);
+  bench.m_txBeams[1] = Steer (txAntenna, 0.1, 1.7);
+  txAntenna->SetBeamformingVector (bench.m_txBeams[0]);
+  rxAntenna->SetBeamformingVector (Steer (rxAntenna, M_PI + 0.2, 1.4));
+
+  // a PSD made of numBands resource blocks centered on the carrier frequency
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < numBands; i++)
+    {
+      freqs.push_back (frequency + (i - numBands / 2.0) * 180e3);
+    }
+  Ptr<SpectrumModel> sm = Create<SpectrumModel> (freqs);
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (sm);
+  (*txPsd) = 1e-9;
+
+  std::cout << "Running bench-three-gpp-beamforming with " << txAntenna->GetNumberOfElements ()
+            << "x" << rxAntenna->GetNumberOfElements () << " elements, " << numBands << " bands"
+            << ", beamSweep=" << beamSweep << std::endl;
+
+  // generate the channel matrix before starting the clock
+  bench.m_check = Sum (*lossModel->CalcRxPowerSpectralDensity (txPsd, txMob, rxMob));
+
+  bench.m_lossModel = lossModel;
+  bench.m_txPsd = txPsd;
+  bench.m_txMob = txMob;
+  bench.m_rxMob = rxMob;
+  bench.m_txAntenna = txAntenna;
+  bench.m_beamSweep = beamSweep;
+  bench.m_iterations = iterations;
+  if (iterations > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &BeamformingBench::Receive, &bench);
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+  if (ms == 0)
+    {
+      ms = 1;
+    }
+
+  std::cout << "Checksum " << std::setprecision (17) << bench.m_check << std::setprecision (6) << std::endl;
+  std::cout << "Wall clock " << ms << " ms, "
+            << ms * 1000.0 / iterations << " us per received PSD" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,623 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the data path of the Wi-Fi stack.
+// It builds a BSS made of an AP and nStations stations, which saturate the
+// uplink with packet socket traffic, and measures the cost of a fixed
+// simulated duration, once the stations are associated (the program aborts
+// if some are not by the end of the 1 s warmup): the events per
+// second, the wall clock time per simulated second, the allocations per
+// MPDU delivered to the AP and the peak resident set size.  On Linux,
+// --breakdown=1 also breaks the time and the allocations down by MacLow,
+// QosTxop (and its base class Txop), InterferenceHelper and WifiPhy (and
+// its subclasses), by sampling the call stack every millisecond of CPU time
+// and every 16 allocations.  A sample is charged to the innermost of these
+// classes on the call stack, or to "other" if none is.  Sampling slows down
+// the simulation, hence it is disabled by default so that the time is
+// measured on its own.  With --csv,
+// the results are appended to a file, to track them across releases.
+// Sample usage:  ./waf --run 'bench-wifi --standard=11ac --phy=spectrum --nStations=20'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sys/resource.h>
+
+#if defined (__linux__) && defined (__GLIBC__)
+#define BENCH_WIFI_PROFILER 1
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+using namespace ns3;
+
+/// The classes the time and the allocations are charged to
+enum Component
+{
+  MAC_LOW = 0,
+  QOS_TXOP,
+  INTERFERENCE_HELPER,
+  WIFI_PHY,
+  OTHER,
+  NUM_COMPONENTS
+};
+
+/// The names of the components
+static const char *g_componentNames[NUM_COMPONENTS] = {"MacLow", "QosTxop", "InterferenceHelper", "WifiPhy", "other"};
+
+static bool g_countAllocations = false; //!< whether allocations are being counted
+static uint64_t g_allocations = 0; //!< the number of allocations counted
+
+#ifdef BENCH_WIFI_PROFILER
+static uint64_t g_allocationSamples[NUM_COMPONENTS]; //!< the number of sampled allocations charged to each component
+static const uint32_t ALLOCATION_SAMPLE_PERIOD = 16; //!< one allocation in ALLOCATION_SAMPLE_PERIOD is sampled
+static const int MAX_FRAMES = 32; //!< the maximum number of stack frames of a sample
+static const uint32_t MAX_TIME_SAMPLES = 16384; //!< the maximum number of time samples
+
+static bool g_profile = false; //!< whether the profiler is running
+static volatile sig_atomic_t g_inProfiler = 0; //!< set while an allocation is being sampled
+static void **g_timeSamples = 0; //!< the frames of the time samples, MAX_FRAMES per sample
+static int *g_timeSampleDepth = 0; //!< the number of frames of each time sample
+static volatile uint32_t g_numTimeSamples = 0; //!< the number of time samples taken
+static volatile uint32_t g_droppedTimeSamples = 0; //!< the number of time samples dropped
+
+/// Entry of the table caching the component each code address belongs to
+struct AddressEntry
+{
+  void *address; //!< the code address, 0 if the entry is free
+  int component; //!< the component, or -1 if the address does not belong to any
+};
+static const uint32_t ADDRESS_TABLE_SIZE = 1 << 16; //!< the size of the address table
+static AddressEntry g_addressTable[ADDRESS_TABLE_SIZE]; //!< the address table, with linear probing
+
+/// The prefixes of the names of the functions of each component
+static const struct
+{
+  const char *prefix; //!< the prefix of the demangled function name
+  Component component; //!< the component
+} g_prefixes[] = {
+  {"ns3::MacLow::", MAC_LOW},
+  {"ns3::QosTxop::", QOS_TXOP},
+  {"ns3::Txop::", QOS_TXOP},
+  {"ns3::InterferenceHelper::", INTERFERENCE_HELPER},
+  {"ns3::Event::", INTERFERENCE_HELPER},
+  {"ns3::WifiPhy::", WIFI_PHY},
+  {"ns3::YansWifiPhy::", WIFI_PHY},
+  {"ns3::SpectrumWifiPhy::", WIFI_PHY},
+  {"ns3::WifiPhyStateHelper::", WIFI_PHY},
+  {"ns3::WifiSpectrumPhyInterface::", WIFI_PHY},
+};
+
+/**
+ * Find the component a code address belongs to. Since this function may
+ * be called while sampling an allocation, it only uses malloc, and never
+ * operator new.
+ * \param address the code address
+ * \return the component, or -1 if the address does not belong to any
+ */
+static int
+ClassifyAddress (void *address)
+{
+  uint32_t slot = (reinterpret_cast<uintptr_t> (address) * 2654435761u) % ADDRESS_TABLE_SIZE;
+  for (uint32_t probe = 0; probe < ADDRESS_TABLE_SIZE; probe++, slot = (slot + 1) % ADDRESS_TABLE_SIZE)
+    {
+      if (g_addressTable[slot].address == address)
+        {
+          return g_addressTable[slot].component;
+        }
+      if (g_addressTable[slot].address == 0)
+        {
+          break;
+        }
+    }
+
+  // the symbol is formatted as "object(mangled+offset) [address]"
+  int component = -1;
+  char **symbols = backtrace_symbols (&address, 1);
+  if (symbols != 0)
+    {
+      char *begin = std::strchr (symbols[0], '(');
+      char *end = begin ? std::strchr (begin, '+') : 0;
+      if (end != 0 && end > begin + 1)
+        {
+          *end = '\0';
+          int status;
+          char *name = abi::__cxa_demangle (begin + 1, 0, 0, &status);
+          for (uint32_t i = 0; name != 0 && i < sizeof (g_prefixes) / sizeof (g_prefixes[0]); i++)
+            {
+              if (std::strncmp (name, g_prefixes[i].prefix, std::strlen (g_prefixes[i].prefix)) == 0)
+                {
+                  component = g_prefixes[i].component;
+                  break;
+                }
+            }
+          std::free (name);
+        }
+      std::free (symbols);
+    }
+
+  if (g_addressTable[slot].address == 0)
+    {
+      g_addressTable[slot].address = address;
+      g_addressTable[slot].component = component;
+    }
+  return component;
+}
+
+/**
+ * Charge a call stack to the innermost component on it
+ * \param frames the return addresses, innermost first
+ * \param depth the number of return addresses
+ * \return the component
+ */
+static Component
+ClassifyStack (void **frames, int depth)
+{
+  for (int i = 0; i < depth; i++)
+    {
+      int component = ClassifyAddress (frames[i]);
+      if (component >= 0)
+        {
+          return static_cast<Component> (component);
+        }
+    }
+  return OTHER;
+}
+
+/**
+ * Take a time sample; the frames are classified once the simulation is over
+ */
+static void
+TakeTimeSample (int)
+{
+  if (g_inProfiler || g_numTimeSamples >= MAX_TIME_SAMPLES)
+    {
+      g_droppedTimeSamples = g_droppedTimeSamples + 1;
+      return;
+    }
+  uint32_t sample = g_numTimeSamples;
+  g_timeSampleDepth[sample] = backtrace (g_timeSamples + sample * MAX_FRAMES, MAX_FRAMES);
+  g_numTimeSamples = sample + 1;
+}
+
+/**
+ * Start or stop the profiler
+ * \param enable whether to start the profiler
+ */
+static void
+EnableProfiler (bool enable)
+{
+  struct itimerval timer;
+  std::memset (&timer, 0, sizeof (timer));
+  if (enable)
+    {
+      // the first call to backtrace may allocate memory
+      void *frame;
+      backtrace (&frame, 1);
+      g_timeSamples = static_cast<void **> (std::malloc (MAX_TIME_SAMPLES * MAX_FRAMES * sizeof (void *)));
+      g_timeSampleDepth = static_cast<int *> (std::malloc (MAX_TIME_SAMPLES * sizeof (int)));
+
+      struct sigaction action;
+      std::memset (&action, 0, sizeof (action));
+      action.sa_handler = &TakeTimeSample;
+      action.sa_flags = SA_RESTART;
+      sigemptyset (&action.sa_mask);
+      sigaction (SIGPROF, &action, 0);
+      timer.it_interval.tv_usec = 1000;
+      timer.it_value.tv_usec = 1000;
+    }
+  g_profile = enable;
+  setitimer (ITIMER_PROF, &timer, 0);
+}
+#endif /* BENCH_WIFI_PROFILER */
+
+/**
+ * Count an allocation and, if the profiler is running, sample it
+ */
+static void
+CountAllocation (void)
+{
+  g_allocations++;
+#ifdef BENCH_WIFI_PROFILER
+  if (g_profile && !g_inProfiler && g_allocations % ALLOCATION_SAMPLE_PERIOD == 0)
+    {
+      g_inProfiler = 1;
+      void *frames[MAX_FRAMES];
+      int depth = backtrace (frames, MAX_FRAMES);
+      g_allocationSamples[ClassifyStack (frames, depth)]++;
+      g_inProfiler = 0;
+    }
+#endif
+}
+
+void *
+operator new (size_t size)
+{
+  void *p = std::malloc (size ? size : 1);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  if (g_countAllocations)
+    {
+      CountAllocation ();
+    }
+  return p;
+}
+
+void *
+operator new[] (size_t size)
+{
+  return operator new (size);
+}
+
+void
+operator delete (void *p) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete[] (void *p) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete (void *p, size_t) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete[] (void *p, size_t) noexcept
+{
+  std::free (p);
+}
+
+static uint64_t g_delivered = 0; //!< the number of MPDUs delivered to the AP
+
+/**
+ * Count an MPDU delivered to the AP
+ * \param p the packet
+ */
+static void
+Delivered (Ptr<const Packet> p)
+{
+  g_delivered++;
+}
+
+static uint32_t g_associated = 0; //!< the number of stations associated with the AP
+
+/**
+ * Count a station associating with the AP
+ * \param address the address of the AP
+ */
+static void
+Associated (Mac48Address address)
+{
+  g_associated++;
+}
+
+/**
+ * Count a station losing its association with the AP
+ * \param address the address of the AP
+ */
+static void
+Deassociated (Mac48Address address)
+{
+  g_associated--;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string standard = "11n";
+  std::string phyType = "yans";
+  bool ampdu = true;
+  uint32_t nStations = 10;
+  double duration = 10;
+  uint32_t packetSize = 1000;
+  std::string dataMode = "";
+  bool breakdown = false;
+  std::string csv = "";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the data path of the Wi-Fi stack");
+  cmd.AddValue ("standard", "the standard: 11a, 11n, 11ac or 11ax", standard);
+  cmd.AddValue ("phy", "the PHY model: yans or spectrum", phyType);
+  cmd.AddValue ("ampdu", "enable A-MPDU aggregation (from 11n on)", ampdu);
+  cmd.AddValue ("nStations", "number of stations", nStations);
+  cmd.AddValue ("duration", "simulated time in seconds, once the stations are associated", duration);
+  cmd.AddValue ("packetSize", "size of the packets in bytes", packetSize);
+  cmd.AddValue ("dataMode", "the data mode; if empty, the highest single stream mode of the standard", dataMode);
+  cmd.AddValue ("breakdown", "break the time and the allocations down by component", breakdown);
+  cmd.AddValue ("csv", "if not empty, the file to append the results to", csv);
+  cmd.Parse (argc, argv);
+
+  WifiHelper wifi;
+  if (standard == "11a")
+    {
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+      dataMode = dataMode.empty () ? "OfdmRate54Mbps" : dataMode;
+    }
+  else if (standard == "11n")
+    {
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+      dataMode = dataMode.empty () ? "HtMcs7" : dataMode;
+    }
+  else if (standard == "11ac")
+    {
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211ac);
+      dataMode = dataMode.empty () ? "VhtMcs9" : dataMode;
+    }
+  else if (standard == "11ax")
+    {
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+      dataMode = dataMode.empty () ? "HeMcs11" : dataMode;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unsupported standard " << standard);
+    }
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue (dataMode),
+                                "ControlMode", StringValue ("OfdmRate24Mbps"));
+
+  NodeContainer apNode;
+  apNode.Create (1);
+  NodeContainer staNodes;
+  staNodes.Create (nStations);
+
+  WifiMacHelper mac;
+  Ssid ssid = Ssid ("bench-wifi");
+  uint32_t maxAmpduSize = ampdu ? 65535 : 0;
+  NetDeviceContainer apDevice;
+  NetDeviceContainer staDevices;
+  if (phyType == "yans")
+    {
+      YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+      YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+      phy.SetChannel (channel.Create ());
+      mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid), "QosSupported", BooleanValue (true),
+                   "BE_MaxAmpduSize", UintegerValue (maxAmpduSize));
+      apDevice = wifi.Install (phy, mac, apNode);
+      mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid), "QosSupported", BooleanValue (true),
+                   "BE_MaxAmpduSize", UintegerValue (maxAmpduSize));
+      staDevices = wifi.Install (phy, mac, staNodes);
+    }
+  else if (phyType == "spectrum")
+    {
+      Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+      channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+      channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+      SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+      phy.SetChannel (channel);
+      mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid), "QosSupported", BooleanValue (true),
+                   "BE_MaxAmpduSize", UintegerValue (maxAmpduSize));
+      apDevice = wifi.Install (phy, mac, apNode);
+      mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid), "QosSupported", BooleanValue (true),
+                   "BE_MaxAmpduSize", UintegerValue (maxAmpduSize));
+      staDevices = wifi.Install (phy, mac, staNodes);
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unsupported PHY model " << phyType);
+    }
+  wifi.AssignStreams (apDevice, 1);
+  wifi.AssignStreams (staDevices, 1 + 1000);
+
+  // the stations are on a circle of radius 5 m around the AP
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      positionAlloc->Add (Vector (5.0 * cos (2 * M_PI * i / nStations), 5.0 * sin (2 * M_PI * i / nStations), 0.0));
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  mobility.Install (staNodes);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (apNode);
+  packetSocket.Install (staNodes);
+
+  // the stations offer 20% more than the PHY rate, to saturate the uplink
+  Ptr<WifiPhy> apPhy = DynamicCast<WifiNetDevice> (apDevice.Get (0))->GetPhy ();
+  uint64_t phyRate = WifiMode (dataMode).GetDataRate (apPhy->GetChannelWidth (), 800, 1);
+  Time interval = Seconds (packetSize * 8.0 * nStations / (1.2 * phyRate));
+
+  PacketSocketAddress socketAddr;
+  socketAddr.SetSingleDevice (apDevice.Get (0)->GetIfIndex ());
+  socketAddr.SetPhysicalAddress (apDevice.Get (0)->GetAddress ());
+  socketAddr.SetProtocol (1);
+  Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+  server->SetLocal (socketAddr);
+  apNode.Get (0)->AddApplication (server);
+
+  double warmup = 1.0; // time left to the stations to associate
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      PacketSocketAddress remote;
+      remote.SetSingleDevice (staDevices.Get (i)->GetIfIndex ());
+      remote.SetPhysicalAddress (apDevice.Get (0)->GetAddress ());
+      remote.SetProtocol (1);
+      Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+      client->SetRemote (remote);
+      client->SetAttribute ("PacketSize", UintegerValue (packetSize));
+      client->SetAttribute ("MaxPackets", UintegerValue (0));
+      client->SetAttribute ("Interval", TimeValue (interval));
+      client->SetStartTime (Seconds (warmup * (i + 1) / (nStations + 1)));
+      staNodes.Get (i)->AddApplication (client);
+    }
+
+  apDevice.Get (0)->GetObject<WifiNetDevice> ()->GetMac ()->TraceConnectWithoutContext ("MacRx", MakeCallback (&Delivered));
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Ptr<WifiMac> staMac = staDevices.Get (i)->GetObject<WifiNetDevice> ()->GetMac ();
+      staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&Associated));
+      staMac->TraceConnectWithoutContext ("DeAssoc", MakeCallback (&Deassociated));
+    }
+
+  std::cout << "Running bench-wifi with standard=" << standard << " phy=" << phyType
+            << " ampdu=" << ampdu << " nStations=" << nStations << " dataMode=" << dataMode
+            << " duration=" << duration << "s" << std::endl;
+
+  Simulator::Stop (Seconds (warmup));
+  Simulator::Run ();
+  // the measurement is only meaningful once all the stations take part in it
+  NS_ABORT_MSG_IF (g_associated != nStations, g_associated << " out of " << nStations
+                   << " stations associated after the warmup of " << warmup << "s");
+
+  uint64_t events = Simulator::GetEventCount ();
+  g_delivered = 0;
+  g_allocations = 0;
+  g_countAllocations = true;
+#ifdef BENCH_WIFI_PROFILER
+  if (breakdown)
+    {
+      EnableProfiler (true);
+    }
+#endif
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+#ifdef BENCH_WIFI_PROFILER
+  if (breakdown)
+    {
+      EnableProfiler (false);
+    }
+#endif
+  g_countAllocations = false;
+  events = Simulator::GetEventCount () - events;
+  if (ms == 0)
+    {
+      ms = 1;
+    }
+  uint64_t delivered = std::max<uint64_t> (g_delivered, 1);
+
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  long peakRss = usage.ru_maxrss;
+#ifdef __APPLE__
+  peakRss /= 1024;
+#endif
+
+  std::cout << "Delivered " << g_delivered << " MPDUs, throughput "
+            << g_delivered * packetSize * 8 / duration / 1e6 << " Mbps" << std::endl;
+  std::cout << "Wall clock " << ms << " ms, " << events << " events, "
+            << events * 1000.0 / ms << " events per second, "
+            << ms / duration << " ms per simulated second" << std::endl;
+  std::cout << "Allocations " << g_allocations << ", "
+            << static_cast<double> (g_allocations) / delivered << " per delivered MPDU" << std::endl;
+  std::cout << "Peak RSS " << peakRss << " kB" << std::endl;
+
+  double timeShare[NUM_COMPONENTS] = {0};
+  double allocationShare[NUM_COMPONENTS] = {0};
+  bool haveBreakdown = false;
+#ifdef BENCH_WIFI_PROFILER
+  if (breakdown)
+    {
+      haveBreakdown = true;
+      uint64_t allocationSamples = 0;
+      for (uint32_t c = 0; c < NUM_COMPONENTS; c++)
+        {
+          allocationSamples += g_allocationSamples[c];
+        }
+      uint32_t timeSamples[NUM_COMPONENTS] = {0};
+      for (uint32_t s = 0; s < g_numTimeSamples; s++)
+        {
+          timeSamples[ClassifyStack (g_timeSamples + s * MAX_FRAMES, g_timeSampleDepth[s])]++;
+        }
+      for (uint32_t c = 0; c < NUM_COMPONENTS; c++)
+        {
+          timeShare[c] = g_numTimeSamples ? static_cast<double> (timeSamples[c]) / g_numTimeSamples : 0;
+          allocationShare[c] = allocationSamples ? static_cast<double> (g_allocationSamples[c]) / allocationSamples : 0;
+        }
+      std::free (g_timeSamples);
+      std::free (g_timeSampleDepth);
+
+      std::cout << "Breakdown over " << g_numTimeSamples << " time samples (" << g_droppedTimeSamples
+                << " dropped) and " << allocationSamples << " allocation samples:" << std::endl;
+      std::cout << std::left << std::setw (20) << "component" << std::right << std::setw (12) << "time %"
+                << std::setw (16) << "ms/sim second" << std::setw (16) << "allocs/MPDU" << std::endl;
+      for (uint32_t c = 0; c < NUM_COMPONENTS; c++)
+        {
+          std::cout << std::left << std::setw (20) << g_componentNames[c] << std::right << std::fixed << std::setprecision (2)
+                    << std::setw (12) << 100 * timeShare[c]
+                    << std::setw (16) << timeShare[c] * ms / duration
+                    << std::setw (16) << allocationShare[c] * g_allocations / delivered << std::endl;
+        }
+      std::cout.unsetf (std::ios_base::floatfield);
+      std::cout << std::setprecision (6);
+    }
+#else
+  if (breakdown)
+    {
+      std::cout << "The breakdown by component is not supported on this platform" << std::endl;
+    }
+#endif
+
+  if (!csv.empty ())
+    {
+      std::ifstream existing (csv.c_str ());
+      bool header = !existing.good () || existing.peek () == std::ifstream::traits_type::eof ();
+      existing.close ();
+      std::ofstream out (csv.c_str (), std::ios_base::app);
+      if (header)
+        {
+          out << "standard,phy,ampdu,nStations,dataMode,duration,delivered,events,wallMs,eventsPerSecond,"
+              << "msPerSimSecond,allocsPerMpdu,peakRssKb";
+          for (uint32_t c = 0; c < NUM_COMPONENTS; c++)
+            {
+              out << ",time" << g_componentNames[c] << ",allocs" << g_componentNames[c];
+            }
+          out << std::endl;
+        }
+      out << standard << "," << phyType << "," << ampdu << "," << nStations << "," << dataMode << ","
+          << duration << "," << g_delivered << "," << events << "," << ms << "," << events * 1000.0 / ms << ","
+          << ms / duration << "," << static_cast<double> (g_allocations) / delivered << "," << peakRss;
+      for (uint32_t c = 0; c < NUM_COMPONENTS; c++)
+        {
+          if (haveBreakdown)
+            {
+              out << "," << timeShare[c] << "," << allocationShare[c] * g_allocations / delivered;
+            }
+          else
+            {
+              out << ",,";
+            }
+        }
+      out << std::endl;
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts a CSV file or a pcap file into the binary trace
+// format replayed by the TraceReplayApplication.
+// Sample usage:  ./waf --run 'trace-replay-convert --input=flows.csv --output=flows.trace'
+
+#include "ns3/core-module.h"
+#include "ns3/trace-replay-file.h"
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  std::string format;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Convert a CSV or pcap file into a trace for the TraceReplayApplication");
+  cmd.AddValue ("input", "the CSV or pcap file", input);
+  cmd.AddValue ("output", "the trace file", output);
+  cmd.AddValue ("format", "csv or pcap (by default, deduced from the extension of the input file)", format);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << "The input and output files are required" << std::endl;
+      return 1;
+    }
+  if (format.empty ())
+    {
+      std::string::size_type dot = input.rfind ('.');
+      format = (dot != std::string::npos && input.substr (dot) == ".csv") ? "csv" : "pcap";
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t nRecords = 0;
+  if (format == "csv")
+    {
+      nRecords = TraceReplayFile::ConvertCsv (input, output);
+    }
+  else if (format == "pcap")
+    {
+      nRecords = TraceReplayFile::ConvertPcap (input, output);
+    }
+  else
+    {
+      std::cerr << "Unknown format " << format << std::endl;
+      return 1;
+    }
+
+  std::cout << nRecords << " packets written to " << output
+            << " in " << clock.End () << " ms" << std::endl;
+  return 0;
+}